@@ -0,0 +1,32 @@
+/*
+ **********************************************************************
+ ** murmur3.h -- Header file for the 128-bit x64 variant of          **
+ ** MurmurHash3                                                      **
+ ** MurmurHash3 was written by Austin Appleby, and is placed in the  **
+ ** public domain. The author hereby disclaims copyright to this     **
+ ** source code.                                                     **
+ ** Slightly edited: 11/2018 for TileDB                              **
+ **********************************************************************
+ */
+
+#ifndef TILEDB_MURMUR3_H
+#define TILEDB_MURMUR3_H
+
+#include <cstdint>
+
+namespace murmur3 {
+
+/**
+ * Computes the 128-bit x64 MurmurHash3 of a buffer.
+ *
+ * @param key The buffer to hash.
+ * @param len The buffer size in bytes.
+ * @param seed The hash seed.
+ * @param out Set to the 128-bit hash, as two `uint64_t` values.
+ */
+void MurmurHash3_x64_128(
+    const void* key, uint64_t len, uint32_t seed, uint64_t out[2]);
+
+}  // namespace murmur3
+
+#endif  // TILEDB_MURMUR3_H
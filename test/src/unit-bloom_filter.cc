@@ -0,0 +1,81 @@
+/**
+ * @file   unit-bloom_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the `BloomFilter` class.
+ */
+
+#include <catch.hpp>
+#include <random>
+#include "tiledb/sm/fragment/bloom_filter.h"
+#include "tiledb/sm/misc/constants.h"
+
+using namespace tiledb::sm;
+
+TEST_CASE("BloomFilter: Test empty filter", "[bloom-filter]") {
+  BloomFilter filter;
+  CHECK(filter.empty());
+  CHECK(filter.may_contain(1, 2));
+  filter.add(1, 2);
+  CHECK(filter.may_contain(3, 4));
+}
+
+TEST_CASE("BloomFilter: Test membership", "[bloom-filter]") {
+  const uint64_t key_num = 10000;
+  std::mt19937_64 gen(0);
+  std::vector<std::pair<uint64_t, uint64_t>> keys(key_num);
+  for (auto& key : keys)
+    key = std::make_pair(gen(), gen());
+
+  BloomFilter filter(
+      key_num,
+      constants::bloom_filter_bits_per_key,
+      constants::bloom_filter_hash_num);
+  CHECK(!filter.empty());
+  CHECK(filter.words().size() % constants::bloom_filter_block_words == 0);
+  for (const auto& key : keys)
+    filter.add(key.first, key.second);
+
+  // No false negatives
+  for (const auto& key : keys)
+    CHECK(filter.may_contain(key.first, key.second));
+
+  // Few false positives
+  uint64_t false_positives = 0;
+  for (uint64_t i = 0; i < key_num; ++i) {
+    if (filter.may_contain(gen(), gen()))
+      ++false_positives;
+  }
+  CHECK(false_positives < key_num / 20);
+
+  // Round trip through the words
+  auto words = filter.words();
+  BloomFilter copy(std::move(words), filter.hash_num());
+  for (const auto& key : keys)
+    CHECK(copy.may_contain(key.first, key.second));
+}
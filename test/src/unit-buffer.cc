@@ -145,3 +145,30 @@ TEST_CASE("Buffer: Test swap", "[buffer]") {
   CHECK(buff3.alloced_size() == 5);
   CHECK(std::memcmp(buff3.data(), &data2, sizeof(data2)) == 0);
 }
+
+TEST_CASE("Buffer: Test reserve and direct write", "[buffer]") {
+  Status st;
+  char data[3] = {1, 2, 3};
+  Buffer buff;
+  st = buff.write(data, sizeof(data));
+  REQUIRE(st.ok());
+
+  // Reserving grows the buffer like a write would
+  st = buff.reserve(4);
+  REQUIRE(st.ok());
+  CHECK(buff.offset() == 3);
+  CHECK(buff.size() == 3);
+  CHECK(buff.alloced_size() >= 7);
+
+  // Write directly and commit
+  std::memcpy(buff.cur_data(), "abcd", 4);
+  buff.advance_offset(4);
+  buff.set_size(buff.offset());
+  CHECK(buff.size() == 7);
+  CHECK(std::memcmp(buff.data(), data, sizeof(data)) == 0);
+  CHECK(std::memcmp(buff.data(3), "abcd", 4) == 0);
+
+  // A buffer that does not own its data cannot reserve space
+  Buffer buff2(data, sizeof(data), false);
+  CHECK(!buff2.reserve(1).ok());
+}
@@ -0,0 +1,228 @@
+/**
+ * @file unit-buffer_pool.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the `BufferPool` and `Arena` classes.
+ */
+
+#include "tiledb/sm/buffer/arena.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/buffer_pool.h"
+#include "tiledb/sm/global_state/global_state.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/storage_manager/storage_manager.h"
+
+#include <catch.hpp>
+#include <cstddef>
+#include <cstring>
+
+using namespace tiledb::sm;
+
+TEST_CASE("BufferPool: Test size classes", "[buffer-pool]") {
+  auto& pool = BufferPool::buffer_pool();
+  uint64_t min_size = constants::buffer_pool_min_block_size;
+  uint64_t capacity = 0;
+
+  // Requests below the minimum block size are allocated exactly
+  void* data = pool.allocate(10, &capacity);
+  REQUIRE(data != nullptr);
+  CHECK(capacity == 10);
+  pool.deallocate(data, capacity);
+
+  // Requests above the maximum block size are allocated exactly
+  uint64_t max_size = constants::buffer_pool_max_block_size;
+  data = pool.allocate(max_size + 1, &capacity);
+  REQUIRE(data != nullptr);
+  CHECK(capacity == max_size + 1);
+  pool.deallocate(data, capacity);
+
+  // Pooled requests are rounded up to 4 classes per power of two
+  data = pool.allocate(min_size, &capacity);
+  CHECK(capacity == min_size);
+  pool.deallocate(data, capacity);
+  data = pool.allocate(min_size + 1, &capacity);
+  CHECK(capacity == min_size + min_size / 4);
+  pool.deallocate(data, capacity);
+  data = pool.allocate(2 * min_size - 1, &capacity);
+  CHECK(capacity == 2 * min_size);
+  pool.deallocate(data, capacity);
+  data = pool.allocate(3 * min_size, &capacity);
+  CHECK(capacity == 3 * min_size);
+  pool.deallocate(data, capacity);
+}
+
+TEST_CASE("BufferPool: Test block reuse", "[buffer-pool]") {
+  auto& pool = BufferPool::buffer_pool();
+  uint64_t capacity = 0, capacity_2 = 0;
+
+  // A released block is handed out again by the same thread
+  void* data = pool.allocate(10000, &capacity);
+  REQUIRE(data != nullptr);
+  std::memset(data, 1, capacity);
+  pool.deallocate(data, capacity);
+  void* data_2 = pool.allocate(capacity, &capacity_2);
+  CHECK(data_2 == data);
+  CHECK(capacity_2 == capacity);
+  pool.deallocate(data_2, capacity_2);
+
+  // Clearing only affects the shared cache
+  pool.clear();
+  CHECK(pool.cached_size() == 0);
+}
+
+TEST_CASE("BufferPool: Test buffer growth", "[buffer-pool]") {
+  Buffer buff;
+  std::vector<char> data(5000, 'a');
+
+  // The allocated size is exact, even if the pooled block is larger
+  REQUIRE(buff.write(&data[0], data.size()).ok());
+  CHECK(buff.size() == data.size());
+  CHECK(buff.alloced_size() == data.size());
+
+  // Growing within the pooled block keeps the data in place
+  void* old_data = buff.data();
+  REQUIRE(buff.realloc(5100).ok());
+  CHECK(buff.data() == old_data);
+  CHECK(buff.alloced_size() == 5100);
+
+  // Growing beyond the pooled block preserves the contents
+  REQUIRE(buff.realloc(100000).ok());
+  CHECK(buff.alloced_size() == 100000);
+  CHECK(std::memcmp(buff.data(), &data[0], data.size()) == 0);
+}
+
+TEST_CASE("BufferPool: Test large buffer growth", "[buffer-pool]") {
+  // Buffers beyond the pooled sizes grow with realloc
+  uint64_t max_size = constants::buffer_pool_max_block_size;
+  Buffer buff;
+  REQUIRE(buff.realloc(max_size + 1).ok());
+  std::memset(buff.data(), 7, max_size + 1);
+  REQUIRE(buff.realloc(2 * max_size).ok());
+  CHECK(buff.alloced_size() == 2 * max_size);
+  auto data = static_cast<const char*>(buff.data());
+  CHECK(data[0] == 7);
+  CHECK(data[max_size] == 7);
+}
+
+TEST_CASE("BufferPool: Test cache sizes and trim", "[buffer-pool]") {
+  auto& pool = BufferPool::buffer_pool();
+  uint64_t capacity = 0;
+  pool.trim();
+
+  // Without a thread cache, released blocks go to the shared cache
+  pool.set_cache_sizes(constants::buffer_pool_shared_cache_size, 0);
+  void* data = pool.allocate(10000, &capacity);
+  REQUIRE(data != nullptr);
+  pool.deallocate(data, capacity);
+  CHECK(pool.cached_size() == capacity);
+
+  // Shrinking the shared cache frees the blocks beyond its size
+  pool.set_cache_sizes(0, 0);
+  CHECK(pool.cached_size() == 0);
+  data = pool.allocate(10000, &capacity);
+  REQUIRE(data != nullptr);
+  pool.deallocate(data, capacity);
+  CHECK(pool.cached_size() == 0);
+
+  // Trimming empties the caches
+  pool.set_cache_sizes(
+      constants::buffer_pool_shared_cache_size,
+      constants::buffer_pool_thread_cache_size);
+  data = pool.allocate(10000, &capacity);
+  REQUIRE(data != nullptr);
+  void* data_2 = pool.allocate(10000, &capacity);
+  REQUIRE(data_2 != nullptr);
+  pool.deallocate(data, capacity);
+  pool.set_cache_sizes(constants::buffer_pool_shared_cache_size, 0);
+  pool.deallocate(data_2, capacity);
+  CHECK(pool.cached_size() == capacity);
+  pool.trim();
+  CHECK(pool.cached_size() == 0);
+  pool.set_cache_sizes(
+      constants::buffer_pool_shared_cache_size,
+      constants::buffer_pool_thread_cache_size);
+}
+
+TEST_CASE(
+    "BufferPool: Test contexts leave the pool untouched", "[buffer-pool]") {
+  // Size the pool as the first context of the process would
+  REQUIRE(global_state::GlobalState::GetGlobalState().initialize(nullptr).ok());
+  auto& pool = BufferPool::buffer_pool();
+  uint64_t capacity = 0;
+  pool.trim();
+  pool.set_cache_sizes(constants::buffer_pool_shared_cache_size, 0);
+  void* data = pool.allocate(10000, &capacity);
+  REQUIRE(data != nullptr);
+  pool.deallocate(data, capacity);
+  CHECK(pool.cached_size() == capacity);
+
+  // Neither creating nor destroying another context resizes or trims the
+  // pool, which other contexts may be using
+  {
+    Config config;
+    REQUIRE(config.set("sm.buffer_pool.shared_cache_size", "0").ok());
+    StorageManager storage_manager;
+    REQUIRE(storage_manager.init(&config).ok());
+    CHECK(pool.cached_size() >= capacity);
+  }
+  CHECK(pool.cached_size() >= capacity);
+
+  pool.trim();
+  pool.set_cache_sizes(
+      constants::buffer_pool_shared_cache_size,
+      constants::buffer_pool_thread_cache_size);
+}
+
+TEST_CASE("Arena: Test allocate and reset", "[arena]") {
+  Arena arena;
+  CHECK(arena.size() == 0);
+
+  // Allocations are aligned
+  auto a = arena.allocate_array<char>(3);
+  auto b = arena.allocate_array<uint64_t>(10);
+  REQUIRE(a != nullptr);
+  REQUIRE(b != nullptr);
+  CHECK((uintptr_t)b % alignof(std::max_align_t) == 0);
+  CHECK(arena.size() >= 3 + 10 * sizeof(uint64_t));
+  for (int i = 0; i < 10; ++i)
+    b[i] = i;
+
+  // Allocations larger than a block get their own block
+  auto c = arena.allocate_array<char>(2 * constants::arena_block_size);
+  REQUIRE(c != nullptr);
+  std::memset(c, 0, 2 * constants::arena_block_size);
+  for (int i = 0; i < 10; ++i)
+    CHECK(b[i] == (uint64_t)i);
+
+  // After a reset, the first block is reused
+  arena.reset();
+  CHECK(arena.size() == 0);
+  auto d = arena.allocate_array<char>(3);
+  CHECK(d == a);
+}
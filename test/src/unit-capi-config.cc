@@ -180,11 +180,29 @@ void check_save_to_file() {
 
   std::stringstream ss;
   ss << "sm.array_schema_cache_size 10000000\n";
+  ss << "sm.buffer_pool.shared_cache_size 268435456\n";
+  ss << "sm.buffer_pool.thread_cache_size 33554432\n";
   ss << "sm.check_coord_dups true\n";
   ss << "sm.check_coord_oob true\n";
+  ss << "sm.consolidation.background false\n";
+  ss << "sm.consolidation.background_frag_bytes 0\n";
+  ss << "sm.consolidation.background_frag_num 8\n";
+  ss << "sm.consolidation.background_interval_ms 1000\n";
+  ss << "sm.consolidation.background_latency_ms 0\n";
+  ss << "sm.consolidation.num_threads " << std::thread::hardware_concurrency()
+     << "\n";
+  ss << "sm.consolidation.step_max_bytes 0\n";
+  ss << "sm.consolidation.step_max_frags 4294967295\n";
+  ss << "sm.consolidation.step_min_frags 2\n";
+  ss << "sm.consolidation.step_size_ratio 0\n";
   ss << "sm.dedup_coords false\n";
   ss << "sm.enable_signal_handlers true\n";
+  ss << "sm.fragment_manifest false\n";
   ss << "sm.fragment_metadata_cache_size 10000000\n";
+  ss << "sm.kv.flush_threshold 0\n";
+  ss << "sm.kv.wal false\n";
+  ss << "sm.kv.wal_sync true\n";
+  ss << "sm.memory_budget 5000000000\n";
   ss << "sm.num_async_threads 1\n";
   ss << "sm.num_reader_threads 1\n";
   ss << "sm.num_tbb_threads -1\n";
@@ -354,8 +372,26 @@ TEST_CASE("C API: Test config iter", "[capi], [config]") {
   all_param_values["sm.check_coord_dups"] = "true";
   all_param_values["sm.check_coord_oob"] = "true";
   all_param_values["sm.tile_cache_size"] = "100";
+  all_param_values["sm.memory_budget"] = "5000000000";
+  all_param_values["sm.buffer_pool.shared_cache_size"] = "268435456";
+  all_param_values["sm.buffer_pool.thread_cache_size"] = "33554432";
+  all_param_values["sm.consolidation.step_min_frags"] = "2";
+  all_param_values["sm.consolidation.step_max_frags"] = "4294967295";
+  all_param_values["sm.consolidation.step_size_ratio"] = "0";
+  all_param_values["sm.consolidation.step_max_bytes"] = "0";
+  all_param_values["sm.consolidation.num_threads"] =
+      std::to_string(std::thread::hardware_concurrency());
+  all_param_values["sm.consolidation.background"] = "false";
+  all_param_values["sm.consolidation.background_interval_ms"] = "1000";
+  all_param_values["sm.consolidation.background_frag_num"] = "8";
+  all_param_values["sm.consolidation.background_frag_bytes"] = "0";
+  all_param_values["sm.consolidation.background_latency_ms"] = "0";
   all_param_values["sm.array_schema_cache_size"] = "1000";
   all_param_values["sm.fragment_metadata_cache_size"] = "10000000";
+  all_param_values["sm.fragment_manifest"] = "false";
+  all_param_values["sm.kv.wal"] = "false";
+  all_param_values["sm.kv.wal_sync"] = "true";
+  all_param_values["sm.kv.flush_threshold"] = "0";
   all_param_values["sm.enable_signal_handlers"] = "true";
   all_param_values["sm.num_async_threads"] = "1";
   all_param_values["sm.num_reader_threads"] = "1";
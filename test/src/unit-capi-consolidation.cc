@@ -32,9 +32,22 @@
 
 #include "catch.hpp"
 #include "test/src/helpers.h"
+#include "tiledb/sm/array/array.h"
 #include "tiledb/sm/c_api/tiledb.h"
+#include "tiledb/sm/filesystem/vfs.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/storage_manager/consolidation_service.h"
+#include "tiledb/sm/storage_manager/storage_manager.h"
+#include "tiledb/sm/tile/tile_io.h"
 
 #include <cstring>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 /** Tests for C API consolidation. */
 struct ConsolidationFx {
@@ -62,6 +75,7 @@ struct ConsolidationFx {
   void write_dense_subarray();
   void write_dense_unordered();
   void write_sparse_full();
+  void write_sparse_full_half(unsigned half);
   void write_sparse_unordered();
   void write_kv_keys_abc();
   void write_kv_keys_acd();
@@ -75,11 +89,20 @@ struct ConsolidationFx {
   void consolidate_dense();
   void consolidate_sparse();
   void consolidate_kv();
+  void consolidate_metadata(const char* array_name);
   void remove_dense_array();
   void remove_sparse_array();
   void remove_kv();
   void remove_array(const std::string& array_name);
   bool is_array(const std::string& array_name);
+  void set_config(
+      const std::vector<std::pair<std::string, std::string>>& params);
+  uint64_t get_fragment_num(const std::string& array_name);
+  bool has_consolidated_metadata(const std::string& array_name);
+  void write_consolidated_metadata(
+      const std::string& array_name, tiledb::sm::Buffer* buff);
+  bool can_open_for_reads(const std::string& array_name);
+  std::set<std::string> get_manifest_fragments(const std::string& array_name);
 };
 
 ConsolidationFx::ConsolidationFx() {
@@ -660,6 +683,105 @@ void ConsolidationFx::write_sparse_full() {
   tiledb_query_free(&query);
 }
 
+void ConsolidationFx::write_sparse_full_half(unsigned half) {
+  // Prepare cell buffers with one half of the cells of `write_sparse_full`
+  // (0 for the first and 1 for the second half in the global order)
+  int all_a1[] = {0, 1, 2, 3, 4, 5, 6, 7};
+  uint64_t all_a2[] = {0, 1, 3, 6, 10, 11, 13, 16};
+  char all_var_a2[] = "abbcccddddeffggghhhh";
+  float all_a3[] = {0.1f,
+                    0.2f,
+                    1.1f,
+                    1.2f,
+                    2.1f,
+                    2.2f,
+                    3.1f,
+                    3.2f,
+                    4.1f,
+                    4.2f,
+                    5.1f,
+                    5.2f,
+                    6.1f,
+                    6.2f,
+                    7.1f,
+                    7.2f};
+  uint64_t all_coords[] = {1, 1, 1, 2, 1, 4, 2, 3, 3, 1, 4, 2, 3, 3, 3, 4};
+  uint64_t var_start = all_a2[4 * half];
+  uint64_t var_end = (half == 0) ? all_a2[4] : sizeof(all_var_a2) - 1;
+  uint64_t buffer_a2[4];
+  for (unsigned i = 0; i < 4; ++i)
+    buffer_a2[i] = all_a2[4 * half + i] - var_start;
+  void* buffers[] = {&all_a1[4 * half],
+                     buffer_a2,
+                     &all_var_a2[var_start],
+                     &all_a3[8 * half],
+                     &all_coords[8 * half]};
+  uint64_t buffer_sizes[] = {4 * sizeof(int),
+                             sizeof(buffer_a2),
+                             var_end - var_start,
+                             8 * sizeof(float),
+                             8 * sizeof(uint64_t)};
+
+  // Open array
+  tiledb_array_t* array;
+  int rc = tiledb_array_alloc(ctx_, SPARSE_ARRAY_NAME, &array);
+  CHECK(rc == TILEDB_OK);
+  if (encryption_type == TILEDB_NO_ENCRYPTION) {
+    rc = tiledb_array_open(ctx_, array, TILEDB_WRITE);
+  } else {
+    rc = tiledb_array_open_with_key(
+        ctx_,
+        array,
+        TILEDB_WRITE,
+        encryption_type,
+        encryption_key,
+        (uint32_t)strlen(encryption_key));
+  }
+  REQUIRE(rc == TILEDB_OK);
+
+  // Create query
+  tiledb_query_t* query;
+  const char* attributes[] = {"a1", "a2", "a3", TILEDB_COORDS};
+  rc = tiledb_query_alloc(ctx_, array, TILEDB_WRITE, &query);
+  CHECK(rc == TILEDB_OK);
+  rc = tiledb_query_set_layout(ctx_, query, TILEDB_GLOBAL_ORDER);
+  CHECK(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffer(
+      ctx_, query, attributes[0], buffers[0], &buffer_sizes[0]);
+  CHECK(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffer_var(
+      ctx_,
+      query,
+      attributes[1],
+      (uint64_t*)buffers[1],
+      &buffer_sizes[1],
+      buffers[2],
+      &buffer_sizes[2]);
+  CHECK(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffer(
+      ctx_, query, attributes[2], buffers[3], &buffer_sizes[3]);
+  CHECK(rc == TILEDB_OK);
+  rc = tiledb_query_set_buffer(
+      ctx_, query, attributes[3], buffers[4], &buffer_sizes[4]);
+  CHECK(rc == TILEDB_OK);
+
+  // Submit query
+  rc = tiledb_query_submit(ctx_, query);
+  CHECK(rc == TILEDB_OK);
+
+  // Finalize query
+  rc = tiledb_query_finalize(ctx_, query);
+  CHECK(rc == TILEDB_OK);
+
+  // Close array
+  rc = tiledb_array_close(ctx_, array);
+  CHECK(rc == TILEDB_OK);
+
+  // Clean up
+  tiledb_array_free(&array);
+  tiledb_query_free(&query);
+}
+
 void ConsolidationFx::write_sparse_unordered() {
   // Prepare cell buffers
   int buffer_a1[] = {107, 104, 106, 105};
@@ -1604,6 +1726,126 @@ bool ConsolidationFx::is_array(const std::string& array_name) {
   return type == TILEDB_ARRAY || type == TILEDB_KEY_VALUE;
 }
 
+void ConsolidationFx::set_config(
+    const std::vector<std::pair<std::string, std::string>>& params) {
+  tiledb_config_t* config = nullptr;
+  tiledb_error_t* error = nullptr;
+  REQUIRE(tiledb_config_alloc(&config, &error) == TILEDB_OK);
+  REQUIRE(error == nullptr);
+  for (const auto& p : params) {
+    REQUIRE(
+        tiledb_config_set(config, p.first.c_str(), p.second.c_str(), &error) ==
+        TILEDB_OK);
+    REQUIRE(error == nullptr);
+  }
+
+  tiledb_ctx_free(&ctx_);
+  REQUIRE(tiledb_ctx_alloc(config, &ctx_) == TILEDB_OK);
+  tiledb_config_free(&config);
+}
+
+void ConsolidationFx::consolidate_metadata(const char* array_name) {
+  int rc;
+  if (encryption_type == TILEDB_NO_ENCRYPTION) {
+    rc = tiledb_array_consolidate_metadata(ctx_, array_name);
+  } else {
+    rc = tiledb_array_consolidate_metadata_with_key(
+        ctx_,
+        array_name,
+        encryption_type,
+        encryption_key,
+        (uint32_t)strlen(encryption_key));
+  }
+  REQUIRE(rc == TILEDB_OK);
+}
+
+bool ConsolidationFx::has_consolidated_metadata(
+    const std::string& array_name) {
+  tiledb::sm::VFS vfs;
+  REQUIRE(vfs.init(tiledb::sm::Config().vfs_params()).ok());
+  bool is_file = false;
+  auto uri = tiledb::sm::URI(array_name).join_path(
+      tiledb::sm::constants::consolidated_fragment_metadata_filename);
+  REQUIRE(vfs.is_file(uri, &is_file).ok());
+  return is_file;
+}
+
+void ConsolidationFx::write_consolidated_metadata(
+    const std::string& array_name, tiledb::sm::Buffer* buff) {
+  tiledb::sm::StorageManager storage_manager;
+  REQUIRE(storage_manager.init(nullptr).ok());
+  auto uri = tiledb::sm::URI(array_name).join_path(
+      tiledb::sm::constants::consolidated_fragment_metadata_filename);
+  buff->reset_offset();
+  tiledb::sm::Tile tile(
+      tiledb::sm::constants::generic_tile_datatype,
+      tiledb::sm::constants::generic_tile_cell_size,
+      0,
+      buff,
+      false);
+  tiledb::sm::TileIO tile_io(&storage_manager, uri);
+  REQUIRE(tile_io.write_generic(&tile, tiledb::sm::EncryptionKey()).ok());
+  REQUIRE(storage_manager.close_file(uri).ok());
+}
+
+bool ConsolidationFx::can_open_for_reads(const std::string& array_name) {
+  tiledb_array_t* array;
+  REQUIRE(tiledb_array_alloc(ctx_, array_name.c_str(), &array) == TILEDB_OK);
+  int rc = tiledb_array_open(ctx_, array, TILEDB_READ);
+  if (rc == TILEDB_OK)
+    REQUIRE(tiledb_array_close(ctx_, array) == TILEDB_OK);
+  tiledb_array_free(&array);
+  return rc == TILEDB_OK;
+}
+
+std::set<std::string> ConsolidationFx::get_manifest_fragments(
+    const std::string& array_name) {
+  tiledb::sm::VFS vfs;
+  REQUIRE(vfs.init(tiledb::sm::Config().vfs_params()).ok());
+  auto uri = tiledb::sm::URI(array_name).join_path(
+      tiledb::sm::constants::fragment_manifest_filename);
+  uint64_t size = 0;
+  REQUIRE(vfs.file_size(uri, &size).ok());
+  std::vector<char> data(size);
+  REQUIRE(vfs.read(uri, 0, data.data(), size).ok());
+
+  // Apply the manifest records
+  std::set<std::string> names;
+  uint64_t offset = 0;
+  while (offset < size) {
+    uint8_t op = (uint8_t)data[offset];
+    uint64_t name_size;
+    std::memcpy(&name_size, &data[offset + 1], sizeof(uint64_t));
+    offset += 1 + sizeof(uint64_t);
+    std::string name(&data[offset], name_size);
+    offset += name_size;
+    if (op != 0)
+      names.insert(name);
+    else
+      names.erase(name);
+  }
+  REQUIRE(offset == size);
+
+  return names;
+}
+
+uint64_t ConsolidationFx::get_fragment_num(const std::string& array_name) {
+  tiledb::sm::VFS vfs;
+  REQUIRE(vfs.init(tiledb::sm::Config().vfs_params()).ok());
+  std::vector<tiledb::sm::URI> uris;
+  REQUIRE(vfs.ls(tiledb::sm::URI(array_name), &uris).ok());
+
+  // Every directory in the array directory is a fragment
+  uint64_t fragment_num = 0;
+  for (const auto& uri : uris) {
+    bool is_dir = false;
+    REQUIRE(vfs.is_dir(uri, &is_dir).ok());
+    fragment_num += (is_dir) ? 1 : 0;
+  }
+
+  return fragment_num;
+}
+
 TEST_CASE_METHOD(
     ConsolidationFx,
     "C API: Test consolidation, dense",
@@ -1671,6 +1913,32 @@ TEST_CASE_METHOD(
     read_sparse_unordered_full();
   }
 
+  SECTION("- write second half, first half (tile copy), unordered") {
+    write_sparse_full_half(1);
+    write_sparse_full_half(0);
+    consolidate_sparse();
+    CHECK(get_fragment_num(SPARSE_ARRAY_NAME) == 1);
+    write_sparse_unordered();
+    read_sparse_full_unordered();
+    consolidate_sparse();
+    CHECK(get_fragment_num(SPARSE_ARRAY_NAME) == 1);
+    read_sparse_full_unordered();
+  }
+
+  SECTION("- write (encrypted) halves (tile copy), unordered") {
+    remove_sparse_array();
+    encryption_type = TILEDB_AES_256_GCM;
+    encryption_key = "0123456789abcdeF0123456789abcdeF";
+    create_sparse_array();
+    write_sparse_full_half(0);
+    write_sparse_full_half(1);
+    consolidate_sparse();
+    CHECK(get_fragment_num(SPARSE_ARRAY_NAME) == 1);
+    write_sparse_unordered();
+    consolidate_sparse();
+    read_sparse_full_unordered();
+  }
+
   SECTION("- write (encrypted) unordered, full") {
     remove_sparse_array();
     encryption_type = TILEDB_AES_256_GCM;
@@ -1718,4 +1986,345 @@ TEST_CASE_METHOD(
   }
 
   remove_kv();
-}
\ No newline at end of file
+}
+
+TEST_CASE_METHOD(
+    ConsolidationFx,
+    "C API: Test consolidation steps, dense",
+    "[capi], [consolidation], [dense-consolidation], "
+    "[consolidation-steps]") {
+  remove_dense_array();
+  create_dense_array();
+
+  SECTION("- fan-in 2") {
+    set_config({{"sm.consolidation.step_max_frags", "2"}});
+    write_dense_full();
+    write_dense_subarray();
+    write_dense_unordered();
+    CHECK(get_fragment_num(DENSE_ARRAY_NAME) == 3);
+    consolidate_dense();
+    CHECK(get_fragment_num(DENSE_ARRAY_NAME) == 2);
+    read_dense_full_subarray_unordered();
+    consolidate_dense();
+    CHECK(get_fragment_num(DENSE_ARRAY_NAME) == 1);
+    read_dense_full_subarray_unordered();
+  }
+
+  SECTION("- fewer fragments than the minimum") {
+    set_config({{"sm.consolidation.step_min_frags", "4"}});
+    write_dense_full();
+    write_dense_subarray();
+    write_dense_unordered();
+    consolidate_dense();
+    CHECK(get_fragment_num(DENSE_ARRAY_NAME) == 3);
+    read_dense_full_subarray_unordered();
+  }
+
+  remove_dense_array();
+}
+
+TEST_CASE_METHOD(
+    ConsolidationFx,
+    "C API: Test consolidation steps, sparse",
+    "[capi], [consolidation], [sparse-consolidation], "
+    "[consolidation-steps]") {
+  remove_sparse_array();
+  create_sparse_array();
+
+  SECTION("- fan-in 2") {
+    set_config({{"sm.consolidation.step_max_frags", "2"}});
+    write_sparse_full();
+    write_sparse_full();
+    write_sparse_unordered();
+    consolidate_sparse();
+    CHECK(get_fragment_num(SPARSE_ARRAY_NAME) == 2);
+    read_sparse_full_unordered();
+    consolidate_sparse();
+    CHECK(get_fragment_num(SPARSE_ARRAY_NAME) == 1);
+    read_sparse_full_unordered();
+  }
+
+  SECTION("- size ratio") {
+    set_config({{"sm.consolidation.step_size_ratio", "1.0"}});
+    write_sparse_full();
+    write_sparse_unordered();
+    consolidate_sparse();
+    CHECK(get_fragment_num(SPARSE_ARRAY_NAME) == 2);
+    read_sparse_full_unordered();
+  }
+
+  SECTION("- max bytes") {
+    set_config({{"sm.consolidation.step_max_bytes", "1"}});
+    write_sparse_full();
+    write_sparse_unordered();
+    consolidate_sparse();
+    CHECK(get_fragment_num(SPARSE_ARRAY_NAME) == 2);
+    read_sparse_full_unordered();
+  }
+
+  remove_sparse_array();
+}
+
+TEST_CASE_METHOD(
+    ConsolidationFx,
+    "C API: Test consolidation partitions",
+    "[capi], [consolidation], [consolidation-partitions]") {
+  SECTION("- dense, 4 threads") {
+    set_config({{"sm.consolidation.num_threads", "4"}});
+    remove_dense_array();
+    create_dense_array();
+    write_dense_subarray();
+    write_dense_full();
+    write_dense_unordered();
+    consolidate_dense();
+    CHECK(get_fragment_num(DENSE_ARRAY_NAME) == 1);
+    read_dense_subarray_full_unordered();
+    remove_dense_array();
+  }
+
+  SECTION("- dense, 1 thread, memory budget") {
+    set_config({{"sm.consolidation.num_threads", "1"},
+                {"sm.memory_budget", "1048576"}});
+    remove_dense_array();
+    create_dense_array();
+    write_dense_full();
+    write_dense_subarray();
+    write_dense_unordered();
+    consolidate_dense();
+    CHECK(get_fragment_num(DENSE_ARRAY_NAME) == 1);
+    read_dense_full_subarray_unordered();
+    remove_dense_array();
+  }
+
+  SECTION("- sparse, 4 threads") {
+    set_config({{"sm.consolidation.num_threads", "4"}});
+    remove_sparse_array();
+    create_sparse_array();
+    write_sparse_unordered();
+    write_sparse_full();
+    consolidate_sparse();
+    CHECK(get_fragment_num(SPARSE_ARRAY_NAME) == 1);
+    read_sparse_unordered_full();
+    remove_sparse_array();
+  }
+}
+
+TEST_CASE_METHOD(
+    ConsolidationFx,
+    "C API: Test background consolidation",
+    "[capi], [consolidation], [background-consolidation]") {
+  remove_sparse_array();
+  create_sparse_array();
+  write_sparse_unordered();
+  write_sparse_full();
+
+  // The period is long enough for the checks below to be the only ones,
+  // apart from the retry triggered by closing the array
+  tiledb::sm::Config config;
+  REQUIRE(config.set("sm.consolidation.background", "true").ok());
+  REQUIRE(
+      config.set("sm.consolidation.background_interval_ms", "3600000").ok());
+  REQUIRE(config.set("sm.consolidation.background_frag_num", "2").ok());
+  tiledb::sm::StorageManager storage_manager;
+  REQUIRE(storage_manager.init(&config).ok());
+  auto service = storage_manager.consolidation_service();
+
+  // Opening the array registers it with the service, which skips it while
+  // it is open
+  tiledb::sm::Array array(
+      tiledb::sm::URI(SPARSE_ARRAY_NAME), &storage_manager);
+  auto st = array.open(
+      tiledb::sm::QueryType::READ,
+      tiledb::sm::EncryptionType::NO_ENCRYPTION,
+      nullptr,
+      0);
+  REQUIRE(st.ok());
+  CHECK(service->check_arrays().ok());
+  CHECK(get_fragment_num(SPARSE_ARRAY_NAME) == 2);
+
+  // Once the array is closed, the check waits for the retry to finish or
+  // consolidates the array itself
+  REQUIRE(array.close().ok());
+  CHECK(service->check_arrays().ok());
+  CHECK(get_fragment_num(SPARSE_ARRAY_NAME) == 1);
+  read_sparse_unordered_full();
+
+  remove_sparse_array();
+}
+
+TEST_CASE_METHOD(
+    ConsolidationFx,
+    "C API: Test fragment metadata consolidation",
+    "[capi], [consolidation], [metadata-consolidation]") {
+  SECTION("- dense, fragment written after consolidation") {
+    remove_dense_array();
+    create_dense_array();
+    write_dense_subarray();
+    write_dense_full();
+    consolidate_metadata(DENSE_ARRAY_NAME);
+    CHECK(has_consolidated_metadata(DENSE_ARRAY_NAME));
+    write_dense_unordered();
+    read_dense_subarray_full_unordered();
+    remove_dense_array();
+  }
+
+  SECTION("- sparse, fragments consolidated afterwards") {
+    remove_sparse_array();
+    create_sparse_array();
+    write_sparse_unordered();
+    write_sparse_full();
+    consolidate_metadata(SPARSE_ARRAY_NAME);
+    CHECK(has_consolidated_metadata(SPARSE_ARRAY_NAME));
+    read_sparse_unordered_full();
+    consolidate_sparse();
+    read_sparse_unordered_full();
+    remove_sparse_array();
+  }
+
+  SECTION("- sparse, encrypted") {
+    remove_sparse_array();
+    encryption_type = TILEDB_AES_256_GCM;
+    encryption_key = "0123456789abcdeF0123456789abcdeF";
+    create_sparse_array();
+    write_sparse_unordered();
+    write_sparse_full();
+    consolidate_metadata(SPARSE_ARRAY_NAME);
+    CHECK(has_consolidated_metadata(SPARSE_ARRAY_NAME));
+    read_sparse_unordered_full();
+    remove_sparse_array();
+  }
+
+  SECTION("- sparse, unsupported version") {
+    remove_sparse_array();
+    create_sparse_array();
+    write_sparse_unordered();
+    write_sparse_full();
+    tiledb::sm::Buffer buff;
+    uint32_t version = tiledb::sm::constants::format_version + 1;
+    uint64_t fragment_num = 0;
+    REQUIRE(buff.write(&version, sizeof(uint32_t)).ok());
+    REQUIRE(buff.write(&fragment_num, sizeof(uint64_t)).ok());
+    write_consolidated_metadata(SPARSE_ARRAY_NAME, &buff);
+    CHECK(!can_open_for_reads(SPARSE_ARRAY_NAME));
+    remove_sparse_array();
+  }
+
+  SECTION("- sparse, corrupted file") {
+    remove_sparse_array();
+    create_sparse_array();
+    write_sparse_unordered();
+    write_sparse_full();
+    tiledb::sm::Buffer buff;
+    uint32_t version = tiledb::sm::constants::format_version;
+    uint64_t fragment_num = 1;
+    uint64_t name_size = std::numeric_limits<uint64_t>::max();
+    REQUIRE(buff.write(&version, sizeof(uint32_t)).ok());
+    REQUIRE(buff.write(&fragment_num, sizeof(uint64_t)).ok());
+    REQUIRE(buff.write(&name_size, sizeof(uint64_t)).ok());
+    write_consolidated_metadata(SPARSE_ARRAY_NAME, &buff);
+    CHECK(!can_open_for_reads(SPARSE_ARRAY_NAME));
+    remove_sparse_array();
+  }
+}
+
+TEST_CASE_METHOD(
+    ConsolidationFx,
+    "C API: Test fragment manifest",
+    "[capi], [consolidation], [fragment-manifest]") {
+  remove_sparse_array();
+  create_sparse_array();
+
+  SECTION("- writes and consolidation") {
+    set_config({{"sm.fragment_manifest", "true"}});
+    write_sparse_unordered();
+    CHECK(get_manifest_fragments(SPARSE_ARRAY_NAME).size() == 1);
+
+    // Reopening picks up the fragments appended to the manifest
+    tiledb_array_t* array;
+    REQUIRE(tiledb_array_alloc(ctx_, SPARSE_ARRAY_NAME, &array) == TILEDB_OK);
+    REQUIRE(tiledb_array_open(ctx_, array, TILEDB_READ) == TILEDB_OK);
+    write_sparse_full();
+    CHECK(get_manifest_fragments(SPARSE_ARRAY_NAME).size() == 2);
+    REQUIRE(tiledb_array_reopen(ctx_, array) == TILEDB_OK);
+    REQUIRE(tiledb_array_close(ctx_, array) == TILEDB_OK);
+    tiledb_array_free(&array);
+    read_sparse_unordered_full();
+
+    consolidate_sparse();
+    CHECK(get_manifest_fragments(SPARSE_ARRAY_NAME).size() == 1);
+    read_sparse_unordered_full();
+  }
+
+  SECTION("- existing fragments") {
+    write_sparse_unordered();
+    set_config({{"sm.fragment_manifest", "true"}});
+    write_sparse_full();
+    CHECK(get_manifest_fragments(SPARSE_ARRAY_NAME).size() == 2);
+    read_sparse_unordered_full();
+  }
+
+  SECTION("- uncommitted fragment") {
+    set_config({{"sm.fragment_manifest", "true"}});
+    write_sparse_unordered();
+    write_sparse_full();
+
+    // A writer that crashes before committing leaves its fragment in the
+    // manifest without a metadata file, which readers skip
+    tiledb::sm::Config config;
+    REQUIRE(config.set("sm.fragment_manifest", "true").ok());
+    tiledb::sm::StorageManager storage_manager;
+    REQUIRE(storage_manager.init(&config).ok());
+    auto array_uri = tiledb::sm::URI(SPARSE_ARRAY_NAME);
+    auto fragment_uri = array_uri.join_path("__uncommitted_1");
+    REQUIRE(storage_manager.vfs()->create_dir(fragment_uri).ok());
+    REQUIRE(storage_manager
+                .store_fragment_manifest(array_uri, {fragment_uri}, {})
+                .ok());
+    CHECK(get_manifest_fragments(SPARSE_ARRAY_NAME).size() == 3);
+    read_sparse_unordered_full();
+  }
+
+  SECTION("- concurrent writers") {
+    set_config({{"sm.fragment_manifest", "true"}});
+    write_sparse_unordered();
+
+    // Every storage manager records fragment names of its own, which must
+    // all be read back from the manifest
+    const int writer_num = 4, record_num = 50;
+    tiledb::sm::Config config;
+    REQUIRE(config.set("sm.fragment_manifest", "true").ok());
+    std::vector<std::unique_ptr<tiledb::sm::StorageManager>> writers;
+    for (int i = 0; i < writer_num; ++i) {
+      writers.emplace_back(new tiledb::sm::StorageManager());
+      REQUIRE(writers.back()->init(&config).ok());
+    }
+    auto array_uri = tiledb::sm::URI(SPARSE_ARRAY_NAME);
+    std::vector<int> failures(writer_num, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < writer_num; ++i) {
+      threads.emplace_back([&, i]() {
+        for (int j = 0; j < record_num; ++j) {
+          auto name = "writer_" + std::to_string(i) + "_" + std::to_string(j);
+          auto st = writers[i]->store_fragment_manifest(
+              array_uri, {array_uri.join_path(name)}, {});
+          failures[i] += st.ok() ? 0 : 1;
+        }
+      });
+    }
+    for (auto& t : threads)
+      t.join();
+    for (int i = 0; i < writer_num; ++i)
+      CHECK(failures[i] == 0);
+
+    auto names = get_manifest_fragments(SPARSE_ARRAY_NAME);
+    CHECK(names.size() == 1 + writer_num * record_num);
+    for (int i = 0; i < writer_num; ++i) {
+      for (int j = 0; j < record_num; ++j) {
+        auto name = "writer_" + std::to_string(i) + "_" + std::to_string(j);
+        CHECK(names.count(name) == 1);
+      }
+    }
+  }
+
+  remove_sparse_array();
+}
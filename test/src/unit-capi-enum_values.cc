@@ -118,11 +118,19 @@ TEST_CASE("C API: Test enum values", "[capi], [enums]") {
   REQUIRE(TILEDB_FILTER_BYTESHUFFLE == 15);
   REQUIRE(TILEDB_FILTER_POSITIVE_DELTA == 16);
   REQUIRE((uint8_t)FilterType::INTERNAL_FILTER_AES_256_GCM == 17);
+  REQUIRE(TILEDB_FILTER_DICTIONARY == 18);
+  REQUIRE(TILEDB_FILTER_XOR == 19);
+  REQUIRE(TILEDB_FILTER_BIT_PACKING == 20);
+  REQUIRE(TILEDB_FILTER_AUTO == 21);
+  REQUIRE(TILEDB_FILTER_CHECKSUM_CRC32C == 22);
+  REQUIRE(TILEDB_FILTER_CHECKSUM_XXHASH64 == 23);
 
   /** Filter option */
   REQUIRE(TILEDB_COMPRESSION_LEVEL == 0);
   REQUIRE(TILEDB_BIT_WIDTH_MAX_WINDOW == 1);
   REQUIRE(TILEDB_POSITIVE_DELTA_MAX_WINDOW == 2);
+  REQUIRE(TILEDB_XOR_BYTE_PLANES == 3);
+  REQUIRE(TILEDB_BIT_PACKING_DELTA == 4);
 
   /** Encryption type */
   REQUIRE(TILEDB_NO_ENCRYPTION == 0);
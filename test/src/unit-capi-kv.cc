@@ -37,9 +37,15 @@
 #include "tiledb/sm/filesystem/posix.h"
 #endif
 #include "test/src/helpers.h"
+#include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
 #include "tiledb/sm/c_api/tiledb.h"
+#include "tiledb/sm/misc/constants.h"
 #include "tiledb/sm/misc/utils.h"
 
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <thread>
@@ -92,10 +98,14 @@ struct KVFx {
   tiledb_encryption_type_t encryption_type_ = TILEDB_NO_ENCRYPTION;
   const char* encryption_key_ = nullptr;
 
+  // Key hash function
+  tiledb_kv_hash_t kv_hash_ = TILEDB_KV_HASH_MD5;
+
   // Functions
   KVFx();
   ~KVFx();
   void check_single_read(const std::string& path);
+  void check_batch_read(const std::string& path);
   void check_iter(const std::string& path);
   void check_kv_item();
   void check_kv_item(tiledb_kv_item_t* kv_item);
@@ -237,6 +247,8 @@ void KVFx::create_kv(const std::string& path) {
   CHECK(rc == TILEDB_OK);
   rc = tiledb_kv_schema_set_capacity(ctx_, kv_schema, 10);
   CHECK(rc == TILEDB_OK);
+  rc = tiledb_kv_schema_set_hash(ctx_, kv_schema, kv_hash_);
+  CHECK(rc == TILEDB_OK);
 
   // Check array schema
   rc = tiledb_kv_schema_check(ctx_, kv_schema);
@@ -281,6 +293,11 @@ void KVFx::create_kv(const std::string& path) {
   CHECK(rc == TILEDB_OK);
   CHECK(capacity == 10);
 
+  tiledb_kv_hash_t kv_hash;
+  rc = tiledb_kv_schema_get_hash(ctx_, kv_schema, &kv_hash);
+  CHECK(rc == TILEDB_OK);
+  CHECK(kv_hash == kv_hash_);
+
   // Clean up again
   tiledb_kv_schema_free(&kv_schema);
 }
@@ -726,6 +743,73 @@ void KVFx::check_single_read(const std::string& path) {
   tiledb_kv_item_free(&kv_item4);
 }
 
+void KVFx::check_batch_read(const std::string& path) {
+  // Open key-value store
+  tiledb_kv_t* kv;
+  int rc = tiledb_kv_alloc(ctx_, path.c_str(), &kv);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_kv_open(ctx_, kv, TILEDB_READ);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Prepare keys, including an invalid one and a duplicate
+  int key1 = 100;
+  float key2 = 200.0;
+  double key3[] = {300.0, 300.1};
+  const char* key4 = "key_4";
+  const char* key5 = "invalid";
+  const void* keys[] = {key4, &key1, key5, key3, &key2, &key1};
+  tiledb_datatype_t key_types[] = {TILEDB_CHAR,
+                                   TILEDB_INT32,
+                                   TILEDB_CHAR,
+                                   TILEDB_FLOAT64,
+                                   TILEDB_FLOAT32,
+                                   TILEDB_INT32};
+  uint64_t key_sizes[] = {strlen(key4) + 1,
+                          sizeof(int),
+                          strlen(key5) + 1,
+                          2 * sizeof(double),
+                          sizeof(float),
+                          sizeof(int)};
+  int a1_values[] = {KEY4_A1, KEY1_A1, 0, KEY3_A1, KEY2_A1, KEY1_A1};
+  const char* a2_values[] = {KEY4_A2, KEY1_A2, "", KEY3_A2, KEY2_A2, KEY1_A2};
+
+  // Get the items in a single batch
+  tiledb_kv_item_t* kv_items[6];
+  rc = tiledb_kv_get_items(ctx_, kv, keys, key_types, key_sizes, 6, kv_items);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Check the items
+  const void *a1, *a2;
+  uint64_t a1_size, a2_size;
+  tiledb_datatype_t a1_type, a2_type;
+  for (int i = 0; i < 6; ++i) {
+    if (keys[i] == key5) {
+      CHECK(kv_items[i] == nullptr);
+      continue;
+    }
+    REQUIRE(kv_items[i] != nullptr);
+    rc = tiledb_kv_item_get_value(
+        ctx_, kv_items[i], ATTR_1.c_str(), &a1, &a1_type, &a1_size);
+    CHECK(rc == TILEDB_OK);
+    CHECK(*(int*)a1 == a1_values[i]);
+    CHECK(a1_size == sizeof(int));
+    rc = tiledb_kv_item_get_value(
+        ctx_, kv_items[i], ATTR_2, &a2, &a2_type, &a2_size);
+    CHECK(rc == TILEDB_OK);
+    CHECK(!strcmp((const char*)a2, a2_values[i]));
+    CHECK(a2_size == strlen(a2_values[i]) + 1);
+  }
+
+  // Close key-value store
+  rc = tiledb_kv_close(ctx_, kv);
+  REQUIRE(rc == TILEDB_OK);
+
+  // Clean up
+  tiledb_kv_free(&kv);
+  for (int i = 0; i < 6; ++i)
+    tiledb_kv_item_free(&kv_items[i]);
+}
+
 void KVFx::check_kv_item(tiledb_kv_item_t* kv_item) {
   const void *key, *value;
   tiledb_datatype_t key_type, value_type;
@@ -976,6 +1060,7 @@ TEST_CASE_METHOD(
     check_kv_item();
     check_write(array_name);
     check_single_read(array_name);
+    check_batch_read(array_name);
     check_iter(array_name);
     remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
   }
@@ -1020,6 +1105,79 @@ TEST_CASE_METHOD(
   }
 }
 
+TEST_CASE_METHOD(
+    KVFx,
+    "C API: Test key-value write, read and iter, MurmurHash3 keys",
+    "[capi], [kv], [kv-hash]") {
+  kv_hash_ = TILEDB_KV_HASH_MURMUR3_128;
+
+  std::string array_name;
+  create_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+  array_name = FILE_URI_PREFIX + FILE_TEMP_DIR + KV_NAME;
+  create_kv(array_name);
+  check_write(array_name);
+  check_single_read(array_name);
+  check_batch_read(array_name);
+  check_iter(array_name);
+  remove_temp_dir(FILE_URI_PREFIX + FILE_TEMP_DIR);
+}
+
+TEST_CASE(
+    "C API: Test key-value schema, invalid key hash",
+    "[capi], [kv], [kv-hash]") {
+  tiledb_ctx_t* ctx;
+  REQUIRE(tiledb_ctx_alloc(nullptr, &ctx) == TILEDB_OK);
+  tiledb_kv_schema_t* kv_schema;
+  REQUIRE(tiledb_kv_schema_alloc(ctx, &kv_schema) == TILEDB_OK);
+  CHECK(
+      tiledb_kv_schema_set_hash(ctx, kv_schema, (tiledb_kv_hash_t)42) ==
+      TILEDB_ERR);
+  tiledb_kv_hash_t kv_hash;
+  REQUIRE(tiledb_kv_schema_get_hash(ctx, kv_schema, &kv_hash) == TILEDB_OK);
+  CHECK(kv_hash == TILEDB_KV_HASH_MD5);
+  tiledb_kv_schema_free(&kv_schema);
+  tiledb_ctx_free(&ctx);
+
+  // A stored schema with an unknown trailing key hash is rejected
+  tiledb::sm::ArraySchema array_schema;
+  REQUIRE(array_schema.set_as_kv().ok());
+  tiledb::sm::Buffer buff;
+  REQUIRE(array_schema.serialize(&buff).ok());
+  tiledb::sm::ConstBuffer cbuff(buff.data(), buff.size());
+  tiledb::sm::ArraySchema loaded;
+  CHECK(loaded.deserialize(&cbuff, true).ok());
+  static_cast<uint8_t*>(buff.data())[buff.size() - 1] = 42;
+  tiledb::sm::ConstBuffer corrupt_cbuff(buff.data(), buff.size());
+  tiledb::sm::ArraySchema corrupt;
+  CHECK(!corrupt.deserialize(&corrupt_cbuff, true).ok());
+}
+
+TEST_CASE(
+    "C API: Test key-value schema, key hash format version",
+    "[capi], [kv], [kv-hash]") {
+  tiledb::sm::ArraySchema array_schema;
+  REQUIRE(array_schema.set_as_kv().ok());
+  REQUIRE(array_schema.set_kv_hash(tiledb::sm::KVHash::KV_HASH_MURMUR3_128)
+              .ok());
+  tiledb::sm::Buffer buff;
+  REQUIRE(array_schema.serialize(&buff).ok());
+
+  // A schema of a newer format version is rejected
+  uint32_t version = tiledb::sm::constants::format_version + 1;
+  std::memcpy(buff.data(), &version, sizeof(uint32_t));
+  tiledb::sm::ConstBuffer newer_cbuff(buff.data(), buff.size());
+  tiledb::sm::ArraySchema newer;
+  CHECK(!newer.deserialize(&newer_cbuff, true).ok());
+
+  // A schema of format version 1 has no key hash, and uses MD5
+  version = 1;
+  std::memcpy(buff.data(), &version, sizeof(uint32_t));
+  tiledb::sm::ConstBuffer v1_cbuff(buff.data(), buff.size() - 1);
+  tiledb::sm::ArraySchema v1;
+  REQUIRE(v1.deserialize(&v1_cbuff, true).ok());
+  CHECK(v1.kv_hash() == tiledb::sm::KVHash::KV_HASH_MD5);
+}
+
 TEST_CASE_METHOD(
     KVFx,
     "C API: Test key-value, anonymous attribute",
@@ -1262,3 +1420,165 @@ TEST_CASE_METHOD(
 
   remove_temp_dir(temp_dir);
 }
+
+TEST_CASE_METHOD(
+    KVFx,
+    "C API: Test key-value write-ahead log and background flush",
+    "[capi], [kv], [kv-wal]") {
+  std::string temp_dir = FILE_URI_PREFIX + FILE_TEMP_DIR;
+  std::string kv_name = temp_dir + KV_NAME;
+  create_temp_dir(temp_dir);
+  create_simple_kv(kv_name);
+
+  // Create a context with the write-ahead log enabled
+  auto alloc_ctx = [](const char* flush_threshold, tiledb_ctx_t** ctx) {
+    tiledb_config_t* config = nullptr;
+    tiledb_error_t* error = nullptr;
+    REQUIRE(tiledb_config_alloc(&config, &error) == TILEDB_OK);
+    REQUIRE(
+        tiledb_config_set(config, "sm.kv.wal", "true", &error) == TILEDB_OK);
+    REQUIRE(
+        tiledb_config_set(
+            config, "sm.kv.flush_threshold", flush_threshold, &error) ==
+        TILEDB_OK);
+    REQUIRE(tiledb_ctx_alloc(config, ctx) == TILEDB_OK);
+    tiledb_config_free(&config);
+  };
+
+  // Add items to a key-value store open for writes
+  auto add = [&](tiledb_ctx_t* ctx, tiledb_kv_t* kv, int first, int num) {
+    for (int i = first; i < first + num; ++i) {
+      tiledb_kv_item_t* item;
+      REQUIRE(tiledb_kv_item_alloc(ctx, &item) == TILEDB_OK);
+      CHECK(
+          tiledb_kv_item_set_key(ctx, item, &i, TILEDB_INT32, sizeof(i)) ==
+          TILEDB_OK);
+      int v = 10 * i;
+      CHECK(
+          tiledb_kv_item_set_value(
+              ctx, item, "a", &v, TILEDB_INT32, sizeof(v)) == TILEDB_OK);
+      CHECK(tiledb_kv_add_item(ctx, kv, item) == TILEDB_OK);
+      tiledb_kv_item_free(&item);
+    }
+  };
+
+  // Add items without flushing them
+  auto write = [&](tiledb_ctx_t* ctx, int first, int num) {
+    tiledb_kv_t* kv;
+    REQUIRE(tiledb_kv_alloc(ctx, kv_name.c_str(), &kv) == TILEDB_OK);
+    REQUIRE(tiledb_kv_open(ctx, kv, TILEDB_WRITE) == TILEDB_OK);
+    add(ctx, kv, first, num);
+    CHECK(tiledb_kv_close(ctx, kv) == TILEDB_OK);
+    tiledb_kv_free(&kv);
+  };
+
+  // Count the items that can be read
+  auto count = [&](tiledb_ctx_t* ctx, int first, int num) {
+    tiledb_kv_t* kv;
+    REQUIRE(tiledb_kv_alloc(ctx, kv_name.c_str(), &kv) == TILEDB_OK);
+    REQUIRE(tiledb_kv_open(ctx, kv, TILEDB_READ) == TILEDB_OK);
+    int found = 0;
+    for (int i = first; i < first + num; ++i) {
+      tiledb_kv_item_t* item;
+      REQUIRE(
+          tiledb_kv_get_item(ctx, kv, &i, TILEDB_INT32, sizeof(i), &item) ==
+          TILEDB_OK);
+      if (item == nullptr)
+        continue;
+      const void* v;
+      uint64_t v_size;
+      tiledb_datatype_t v_type;
+      CHECK(
+          tiledb_kv_item_get_value(ctx, item, "a", &v, &v_type, &v_size) ==
+          TILEDB_OK);
+      CHECK(*(const int*)v == 10 * i);
+      tiledb_kv_item_free(&item);
+      ++found;
+    }
+    CHECK(tiledb_kv_close(ctx, kv) == TILEDB_OK);
+    tiledb_kv_free(&kv);
+    return found;
+  };
+
+  tiledb_ctx_t* wal_ctx;
+  alloc_ctx("0", &wal_ctx);
+
+  // Unflushed items are only in the log
+  write(wal_ctx, 0, 5);
+  CHECK(count(ctx_, 0, 5) == 0);
+  CHECK(count(wal_ctx, 0, 5) == 5);
+
+  // Opening for writes flushes the items left in the log
+  write(wal_ctx, 5, 0);
+  CHECK(count(ctx_, 0, 5) == 5);
+
+  // The log of a writer that is still open is left to it
+  tiledb_kv_t* live_kv;
+  REQUIRE(tiledb_kv_alloc(wal_ctx, kv_name.c_str(), &live_kv) == TILEDB_OK);
+  REQUIRE(tiledb_kv_open(wal_ctx, live_kv, TILEDB_WRITE) == TILEDB_OK);
+  add(wal_ctx, live_kv, 20, 5);
+  write(wal_ctx, 25, 0);
+  CHECK(count(ctx_, 20, 5) == 0);
+  CHECK(count(wal_ctx, 20, 5) == 5);
+  CHECK(tiledb_kv_close(wal_ctx, live_kv) == TILEDB_OK);
+  tiledb_kv_free(&live_kv);
+  write(wal_ctx, 25, 0);
+  CHECK(count(ctx_, 20, 5) == 5);
+
+  // Items are flushed in the background past the threshold
+  tiledb_ctx_t* flush_ctx;
+  alloc_ctx("1", &flush_ctx);
+  write(flush_ctx, 5, 10);
+  CHECK(count(ctx_, 0, 15) == 15);
+
+  // Read the value of a key
+  auto get = [&](tiledb_ctx_t* ctx, int key) {
+    tiledb_kv_t* kv;
+    REQUIRE(tiledb_kv_alloc(ctx, kv_name.c_str(), &kv) == TILEDB_OK);
+    REQUIRE(tiledb_kv_open(ctx, kv, TILEDB_READ) == TILEDB_OK);
+    tiledb_kv_item_t* item;
+    REQUIRE(
+        tiledb_kv_get_item(ctx, kv, &key, TILEDB_INT32, sizeof(key), &item) ==
+        TILEDB_OK);
+    REQUIRE(item != nullptr);
+    const void* v;
+    uint64_t v_size;
+    tiledb_datatype_t v_type;
+    CHECK(
+        tiledb_kv_item_get_value(ctx, item, "a", &v, &v_type, &v_size) ==
+        TILEDB_OK);
+    int value = *(const int*)v;
+    tiledb_kv_item_free(&item);
+    CHECK(tiledb_kv_close(ctx, kv) == TILEDB_OK);
+    tiledb_kv_free(&kv);
+    return value;
+  };
+
+  // A log left before a newer write does not override it
+  write(wal_ctx, 30, 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  tiledb_kv_t* kv;
+  REQUIRE(tiledb_kv_alloc(ctx_, kv_name.c_str(), &kv) == TILEDB_OK);
+  REQUIRE(tiledb_kv_open(ctx_, kv, TILEDB_WRITE) == TILEDB_OK);
+  tiledb_kv_item_t* item;
+  REQUIRE(tiledb_kv_item_alloc(ctx_, &item) == TILEDB_OK);
+  int key = 30, v = 1;
+  CHECK(
+      tiledb_kv_item_set_key(ctx_, item, &key, TILEDB_INT32, sizeof(key)) ==
+      TILEDB_OK);
+  CHECK(
+      tiledb_kv_item_set_value(ctx_, item, "a", &v, TILEDB_INT32, sizeof(v)) ==
+      TILEDB_OK);
+  CHECK(tiledb_kv_add_item(ctx_, kv, item) == TILEDB_OK);
+  CHECK(tiledb_kv_flush(ctx_, kv) == TILEDB_OK);
+  CHECK(tiledb_kv_close(ctx_, kv) == TILEDB_OK);
+  tiledb_kv_item_free(&item);
+  tiledb_kv_free(&kv);
+  CHECK(get(wal_ctx, 30) == 1);
+  write(wal_ctx, 31, 0);
+  CHECK(get(ctx_, 30) == 1);
+
+  tiledb_ctx_free(&wal_ctx);
+  tiledb_ctx_free(&flush_ctx);
+  remove_temp_dir(temp_dir);
+}
@@ -220,3 +220,57 @@ TEST_CASE(
   delete decomp_out_buff;
   delete[] data;
 }
+
+TEST_CASE(
+    "Compression-DoubleDelta: Test output format",
+    "[compression], [double-delta]") {
+  // Deltas 1, 2, 3 give double deltas 1, 1, stored with bitsize 1
+  int data[] = {1, 2, 4, 7};
+  tiledb::sm::ConstBuffer comp_in_buff(data, sizeof(data));
+  tiledb::sm::Buffer comp_out_buff;
+  auto st = tiledb::sm::DoubleDelta::compress(
+      tiledb::sm::Datatype::INT32, &comp_in_buff, &comp_out_buff);
+  REQUIRE(st.ok());
+  REQUIRE(comp_out_buff.size() == 1 + 8 + 2 * sizeof(int) + 8);
+  CHECK(comp_out_buff.value<uint8_t>(0) == 1);
+  CHECK(comp_out_buff.value<uint64_t>(1) == 4);
+  CHECK(comp_out_buff.value<int>(9) == 1);
+  CHECK(comp_out_buff.value<int>(13) == 2);
+  CHECK(comp_out_buff.value<uint64_t>(17) == 0x5000000000000000);
+
+  // Decompress
+  tiledb::sm::ConstBuffer decomp_in_buff(
+      comp_out_buff.data(), comp_out_buff.size());
+  int decomp_data[4];
+  tiledb::sm::PreallocatedBuffer prealloc_buf(
+      decomp_data, sizeof(decomp_data));
+  st = tiledb::sm::DoubleDelta::decompress(
+      tiledb::sm::Datatype::INT32, &decomp_in_buff, &prealloc_buf);
+  REQUIRE(st.ok());
+  CHECK(std::memcmp(data, decomp_data, sizeof(data)) == 0);
+}
+
+TEST_CASE(
+    "Compression-DoubleDelta: Test uncompressed case",
+    "[compression], [double-delta]") {
+  // The double deltas need more bits than the values, so the values are
+  // stored as they are
+  int16_t data[] = {0, 30000, -30000, 30000, 0};
+  tiledb::sm::ConstBuffer comp_in_buff(data, sizeof(data));
+  tiledb::sm::Buffer comp_out_buff;
+  auto st = tiledb::sm::DoubleDelta::compress(
+      tiledb::sm::Datatype::INT16, &comp_in_buff, &comp_out_buff);
+  REQUIRE(st.ok());
+  CHECK(comp_out_buff.size() == 1 + 8 + sizeof(data));
+
+  // Decompress
+  tiledb::sm::ConstBuffer decomp_in_buff(
+      comp_out_buff.data(), comp_out_buff.size());
+  int16_t decomp_data[5];
+  tiledb::sm::PreallocatedBuffer prealloc_buf(
+      decomp_data, sizeof(decomp_data));
+  st = tiledb::sm::DoubleDelta::decompress(
+      tiledb::sm::Datatype::INT16, &decomp_in_buff, &prealloc_buf);
+  REQUIRE(st.ok());
+  CHECK(std::memcmp(data, decomp_data, sizeof(data)) == 0);
+}
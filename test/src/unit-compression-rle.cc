@@ -33,6 +33,7 @@
 
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 #include "catch.hpp"
 #include "tiledb/sm/compressors/rle_compressor.h"
@@ -290,3 +291,48 @@ TEST_CASE(
   delete compressed;
   delete decompressed;
 }
+
+TEST_CASE("Compression-RLE: Test output format", "[compression], [rle]") {
+  // Each run is the value followed by its big-endian, two-byte length
+  const char data[] = "aaab";
+  ConstBuffer input(data, 4);
+  Buffer compressed;
+  CHECK(RLE::compress(1, &input, &compressed).ok());
+  const unsigned char expected[] = {'a', 0, 3, 'b', 0, 1};
+  REQUIRE(compressed.size() == sizeof(expected));
+  CHECK_FALSE(memcmp(compressed.data(), expected, sizeof(expected)));
+}
+
+TEST_CASE(
+    "Compression-RLE: Test long runs and odd value sizes",
+    "[compression], [rle]") {
+  // Runs longer than the maximum run length are split
+  const uint64_t value_num = 200000;
+  for (uint64_t value_size : {1, 3, 4, 8, 10}) {
+    std::vector<unsigned char> data(value_num * value_size);
+    for (uint64_t i = 0; i < value_num; ++i) {
+      unsigned char value = (i < 150000) ? 7 : (unsigned char)(i % 3);
+      memset(&data[i * value_size], value, value_size);
+    }
+
+    ConstBuffer input(data.data(), data.size());
+    Buffer compressed;
+    CHECK(RLE::compress(value_size, &input, &compressed).ok());
+    CHECK(compressed.size() == (3 + 50000) * (value_size + 2));
+    CHECK(compressed.value<unsigned char>(value_size) == 0xff);
+    CHECK(compressed.value<unsigned char>(value_size + 1) == 0xff);
+
+    std::vector<unsigned char> decompressed(data.size());
+    PreallocatedBuffer prealloc_buf(decompressed.data(), decompressed.size());
+    ConstBuffer compressed_input(compressed.data(), compressed.size());
+    CHECK(RLE::decompress(value_size, &compressed_input, &prealloc_buf).ok());
+    CHECK(decompressed == data);
+
+    // The output must fit the decompressed runs
+    PreallocatedBuffer small_buf(
+        decompressed.data(), decompressed.size() - 1);
+    ConstBuffer compressed_input2(compressed.data(), compressed.size());
+    CHECK_FALSE(
+        RLE::decompress(value_size, &compressed_input2, &small_buf).ok());
+  }
+}
@@ -32,6 +32,7 @@
 
 #include "catch.hpp"
 #include "tiledb/sm/cpp_api/tiledb"
+#include "tiledb/sm/filesystem/vfs.h"
 
 static void check_filters(
     const tiledb::FilterList& answer, const tiledb::FilterList& check) {
@@ -193,4 +194,107 @@ TEST_CASE("C++ API: Filter lists on array", "[cppapi], [filter]") {
   // Clean up
   if (vfs.is_dir(array_name))
     vfs.remove_dir(array_name);
-}
\ No newline at end of file
+}
+TEST_CASE(
+    "C++ API: Dictionary filter on var-sized attributes",
+    "[cppapi], [filter]") {
+  using namespace tiledb;
+  Context ctx;
+
+  FilterList filters(ctx);
+  filters.add_filter({ctx, TILEDB_FILTER_DICTIONARY});
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d1", {{0, 100}}, 10));
+
+  // Fixed-sized attributes are accepted
+  auto a1 = Attribute::create<int>(ctx, "a1");
+  a1.set_filter_list(filters);
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain);
+  schema.add_attribute(a1);
+  REQUIRE_NOTHROW(schema.check());
+
+  // Var-sized attributes are rejected
+  auto a2 = Attribute::create<std::string>(ctx, "a2");
+  a2.set_filter_list(filters);
+  schema.add_attribute(a2);
+  REQUIRE_THROWS_AS(schema.check(), TileDBError);
+}
+
+TEST_CASE(
+    "C++ API: Checksum filter detects corrupted data", "[cppapi], [filter]") {
+  using namespace tiledb;
+  Context ctx;
+  VFS vfs(ctx);
+  std::string array_name = "cpp_unit_array";
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create and write a dense array with a checksummed attribute
+  FilterList filters(ctx);
+  filters.add_filter({ctx, TILEDB_FILTER_CHECKSUM_CRC32C});
+  auto a = Attribute::create<int>(ctx, "a");
+  a.set_filter_list(filters);
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 4}}, 4));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain).add_attribute(a);
+  Array::create(array_name, schema);
+
+  std::vector<int> data = {1, 2, 3, 4};
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_ROW_MAJOR).set_buffer("a", data);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  array.close();
+
+  // Flip the last byte of the attribute file, which holds tile data
+  tiledb::sm::VFS sm_vfs;
+  REQUIRE(sm_vfs.init(tiledb::sm::Config().vfs_params()).ok());
+  std::vector<tiledb::sm::URI> uris;
+  REQUIRE(sm_vfs.ls(tiledb::sm::URI(array_name), &uris).ok());
+  tiledb::sm::URI attr_uri;
+  for (const auto& uri : uris) {
+    bool is_dir = false;
+    REQUIRE(sm_vfs.is_dir(uri, &is_dir).ok());
+    if (is_dir)
+      attr_uri = uri.join_path("a.tdb");
+  }
+  uint64_t size = 0;
+  REQUIRE(sm_vfs.file_size(attr_uri, &size).ok());
+  std::vector<char> bytes(size);
+  REQUIRE(sm_vfs.read(attr_uri, 0, bytes.data(), size).ok());
+  bytes[size - 1] ^= 1;
+  REQUIRE(sm_vfs.remove_file(attr_uri).ok());
+  REQUIRE(sm_vfs.write(attr_uri, bytes.data(), size).ok());
+  REQUIRE(sm_vfs.close_file(attr_uri).ok());
+
+  // The C API reports the corruption with its own return code
+  Context ctx_r;
+  std::vector<int> subarray = {1, 4};
+  std::vector<int> data_r(4);
+  Array array_r(ctx_r, array_name, TILEDB_READ);
+  Query query_r(ctx_r, array_r);
+  query_r.set_subarray(subarray)
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", data_r);
+  CHECK(
+      tiledb_query_submit(ctx_r.ptr().get(), query_r.ptr().get()) ==
+      TILEDB_CHECKSUM_ERR);
+  array_r.close();
+
+  // The C++ API throws a dedicated exception
+  array_r.open(TILEDB_READ);
+  Query query_r2(ctx_r, array_r);
+  query_r2.set_subarray(subarray)
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", data_r);
+  CHECK_THROWS_AS(query_r2.submit(), ChecksumError);
+  array_r.close();
+
+  // Clean up
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
@@ -151,6 +151,13 @@ TEST_CASE_METHOD(CPPMapFx, "C++ API: Map", "[cppapi], [cppapi-map]") {
   CHECK(std::get<2>(ret).size() == 2);
   CHECK(std::get<2>(ret)[0] == 4.2);
 
+  // Batched lookup
+  auto items = map.get_items(std::vector<int>{3453463, simple_key});
+  REQUIRE(items.size() == 2);
+  CHECK(!items[0].good());
+  CHECK(items[1].good());
+  CHECK(items[1].get<std::string>("a2") == "someval");
+
   map.close();
   CHECK(!map.is_open());
 }
@@ -540,4 +540,67 @@ TEST_CASE("FilterBuffer: Test read-only", "[filter], [filter-buffer]") {
   CHECK(fbuf.read(data, 2).ok());
   check_buf(data, {1, 2});
   CHECK(!fbuf.read(data, 1).ok());
-}
\ No newline at end of file
+}
+TEST_CASE("FilterBuffer: Test storage reuse", "[filter], [filter-buffer]") {
+  FilterStorage storage;
+  CHECK(storage.reserve(2, 1024).ok());
+  CHECK(storage.num_available() == 2);
+  CHECK(storage.num_in_use() == 0);
+
+  Buffer* buf_ptr = nullptr;
+  {
+    FilterBuffer fbuf(&storage), fbuf2(&storage);
+    char data[512] = {0};
+    CHECK(fbuf.prepend_buffer(sizeof(data)).ok());
+    CHECK(fbuf.write(data, sizeof(data)).ok());
+    CHECK(fbuf2.append_view(&fbuf).ok());
+    CHECK(storage.num_available() == 1);
+    CHECK(storage.num_in_use() == 1);
+    buf_ptr = fbuf.buffer_ptr(0);
+    CHECK(buf_ptr->alloced_size() >= 1024);
+
+    // The buffer is still viewed by the other FilterBuffer
+    CHECK(fbuf.clear().ok());
+    CHECK(storage.num_in_use() == 1);
+  }
+
+  // Destroying the FilterBuffers returns the buffer to the storage
+  CHECK(storage.num_available() == 2);
+  CHECK(storage.num_in_use() == 0);
+
+  // The returned buffer is handed out next, keeping its allocation
+  auto buf = storage.get_buffer();
+  CHECK(buf.get() == buf_ptr);
+  CHECK(buf->size() == 0);
+  CHECK(buf->alloced_size() >= 1024);
+}
+
+TEST_CASE(
+    "FilterBuffer: Test storage retention limits",
+    "[filter], [filter-buffer]") {
+  FilterStorage storage;
+  CHECK(storage.reserve(1, 1024).ok());
+  CHECK(storage.num_available() == 1);
+
+  {
+    FilterBuffer fbuf(&storage), fbuf2(&storage), fbuf3(&storage);
+    CHECK(fbuf.prepend_buffer(512).ok());
+    CHECK(fbuf2.prepend_buffer(512).ok());
+    // Allocates more than the retained size
+    CHECK(fbuf3.prepend_buffer(4096).ok());
+    CHECK(storage.num_available() == 0);
+    CHECK(storage.num_in_use() == 3);
+  }
+
+  // Only the reserved number of buffers is retained
+  CHECK(storage.num_available() == 1);
+  CHECK(storage.num_in_use() == 0);
+
+  // A smaller reservation trims the pool and replaces the oversized buffers
+  CHECK(storage.reserve(3, 4096).ok());
+  CHECK(storage.num_available() == 3);
+  CHECK(storage.reserve(1, 1024).ok());
+  CHECK(storage.num_available() == 1);
+  auto buf = storage.get_buffer();
+  CHECK(buf->alloced_size() == 1024);
+}
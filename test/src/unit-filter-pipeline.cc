@@ -33,18 +33,26 @@
 
 #include "tiledb/sm/array_schema/array_schema.h"
 #include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/filter/auto_filter.h"
+#include "tiledb/sm/filter/bit_packing_filter.h"
 #include "tiledb/sm/filter/bit_width_reduction_filter.h"
 #include "tiledb/sm/filter/bitshuffle_filter.h"
 #include "tiledb/sm/filter/byteshuffle_filter.h"
+#include "tiledb/sm/filter/checksum_filter.h"
 #include "tiledb/sm/filter/compression_filter.h"
+#include "tiledb/sm/filter/dictionary_filter.h"
 #include "tiledb/sm/filter/encryption_aes256gcm_filter.h"
 #include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/filter/filter_storage.h"
 #include "tiledb/sm/filter/positive_delta_filter.h"
+#include "tiledb/sm/filter/xor_filter.h"
+#include "tiledb/sm/misc/checksum.h"
 #include "tiledb/sm/tile/tile.h"
 
 #include <catch.hpp>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <random>
 
 using namespace tiledb::sm;
@@ -740,6 +748,58 @@ TEST_CASE("Filter: Test mixed in- and out-of-place pipeline", "[filter]") {
     CHECK(buff.value<uint64_t>(i * sizeof(uint64_t)) == i);
 }
 
+TEST_CASE("Filter: Test storage reuse across runs", "[filter]") {
+  const uint64_t nelts = 100;
+  FilterPipeline pipeline;
+  CHECK(pipeline.add_filter(Add1OutOfPlace()).ok());
+  CHECK(pipeline.add_filter(Add1OutOfPlace()).ok());
+
+  // Filter a single-chunk tile, which runs on the calling thread
+  auto run = [&]() {
+    Buffer buff;
+    for (uint64_t i = 0; i < nelts; i++)
+      CHECK(buff.write(&i, sizeof(uint64_t)).ok());
+    Tile tile(Datatype::UINT64, sizeof(uint64_t), 0, &buff, false);
+    CHECK(pipeline.run_forward(&tile).ok());
+  };
+
+  // Returns the data of each buffer available in the thread storage
+  auto storage_data = []() {
+    auto& storage = FilterStorage::thread_storage();
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    while (storage.num_available() > 0)
+      buffers.push_back(storage.get_buffer());
+    std::map<Buffer*, void*> data;
+    for (auto& buffer : buffers) {
+      auto ptr = buffer.get();
+      data[ptr] = ptr->data();
+      buffer.reset();
+      CHECK(storage.reclaim(ptr).ok());
+    }
+    return data;
+  };
+
+  // Count the storage buffers that were (re)allocated by each run, or that
+  // the next run has to allocate
+  run();
+  auto data = storage_data();
+  CHECK(!data.empty());
+  uint64_t num_allocs = 0;
+  for (int r = 0; r < 10; r++) {
+    run();
+    auto new_data = storage_data();
+    for (const auto& it : new_data) {
+      auto old = data.find(it.first);
+      if (it.second == nullptr || old == data.end() ||
+          old->second != it.second)
+        num_allocs++;
+    }
+    CHECK(new_data.size() == data.size());
+    data = new_data;
+  }
+  CHECK(num_allocs == 0);
+}
+
 TEST_CASE("Filter: Test compression", "[filter], [compression]") {
   // Set up test data
   const uint64_t nelts = 100;
@@ -828,6 +888,140 @@ TEST_CASE("Filter: Test compression", "[filter], [compression]") {
   }
 }
 
+TEST_CASE(
+    "Filter: Test compressor context reuse", "[filter], [compression]") {
+  const uint64_t nelts = 10000;
+  const Compressor compressors[] = {Compressor::GZIP, Compressor::ZSTD};
+
+  // The thread contexts are reused across tiles and levels
+  for (auto compressor : compressors) {
+    for (int iter = 0; iter < 6; iter++) {
+      Buffer buff;
+      for (uint64_t i = 0; i < nelts; i++) {
+        uint64_t val = i / (iter + 1);
+        CHECK(buff.write(&val, sizeof(uint64_t)).ok());
+      }
+      Tile tile(Datatype::UINT64, sizeof(uint64_t), 0, &buff, false);
+
+      FilterPipeline pipeline;
+      CompressionFilter filter(compressor, 1 + iter % 3);
+      CHECK(pipeline.add_filter(filter).ok());
+      CHECK(pipeline.run_forward(&tile).ok());
+      CHECK(tile.buffer()->size() < nelts * sizeof(uint64_t));
+
+      // A failed decompression does not affect the next one. Zstd does not
+      // necessarily detect the corruption, as it writes no checksum.
+      if (iter == 3) {
+        Buffer corrupt;
+        auto size = tile.buffer()->size();
+        CHECK(corrupt.write(tile.buffer()->data(), size).ok());
+        auto data = static_cast<char*>(corrupt.data());
+        for (uint64_t i = size - 16; i < size; i++)
+          data[i] = (char)~data[i];
+        Tile corrupt_tile(
+            Datatype::UINT64, sizeof(uint64_t), 0, &corrupt, false);
+        auto st = pipeline.run_reverse(&corrupt_tile);
+        if (compressor == Compressor::GZIP)
+          CHECK(!st.ok());
+      }
+
+      CHECK(pipeline.run_reverse(&tile).ok());
+      CHECK(tile.buffer()->size() == nelts * sizeof(uint64_t));
+      for (uint64_t i = 0; i < nelts; i++)
+        CHECK(
+            tile.buffer()->value<uint64_t>(i * sizeof(uint64_t)) ==
+            i / (iter + 1));
+    }
+  }
+}
+
+TEST_CASE("Filter: Test zstd dictionary", "[filter], [compression]") {
+  // Set up small JSON-like records sharing their structure
+  auto record = [](uint64_t i) {
+    return "{\"id\": " + std::to_string(i * 7919 % 100003) +
+           ", \"name\": \"user_" + std::to_string(i * 31 % 997) +
+           "\", \"country\": \"" + (i % 3 == 0 ? "FRA" : "USA") +
+           "\", \"active\": " + (i % 2 == 0 ? "true" : "false") + "}";
+  };
+  std::string samples;
+  std::vector<uint64_t> sample_sizes;
+  for (uint64_t i = 0; i < 2000; i++) {
+    auto r = record(i);
+    samples += r;
+    sample_sizes.push_back(r.size());
+  }
+
+  std::string data;
+  for (uint64_t i = 5000; i < 5010; i++)
+    data += record(i);
+  Buffer buff;
+  CHECK(buff.write(data.data(), data.size()).ok());
+  Tile tile(Datatype::CHAR, 1, 0, &buff, false);
+
+  CompressionFilter filter(Compressor::ZSTD, 5);
+  CHECK(filter.zstd_dictionary_size() == 0);
+
+  // Compress without a dictionary for reference
+  FilterPipeline pipeline;
+  CHECK(pipeline.add_filter(filter).ok());
+  CHECK(pipeline.run_forward(&tile).ok());
+  auto plain_size = tile.buffer()->size();
+  CHECK(pipeline.run_reverse(&tile).ok());
+  CHECK(tile.buffer()->size() == data.size());
+
+  CHECK(filter.train_zstd_dictionary(samples.data(), sample_sizes, 4096).ok());
+  CHECK(filter.zstd_dictionary_size() > 0);
+  CHECK(filter.zstd_dictionary_size() <= 4096);
+
+  SECTION("- Round trip") {
+    FilterPipeline dict_pipeline;
+    CHECK(dict_pipeline.add_filter(filter).ok());
+    CHECK(dict_pipeline.run_forward(&tile).ok());
+    CHECK(tile.buffer()->size() < plain_size);
+
+    CHECK(dict_pipeline.run_reverse(&tile).ok());
+    CHECK(tile.buffer()->size() == data.size());
+    CHECK(
+        std::string((const char*)tile.buffer()->data(), data.size()) == data);
+  }
+
+  SECTION("- Serialization") {
+    FilterPipeline dict_pipeline;
+    CHECK(dict_pipeline.add_filter(filter).ok());
+    CHECK(dict_pipeline.run_forward(&tile).ok());
+
+    // Decompress with a pipeline deserialized from the schema metadata
+    Buffer metadata;
+    CHECK(dict_pipeline.serialize(&metadata).ok());
+    ConstBuffer const_metadata(&metadata);
+    FilterPipeline read_pipeline;
+    CHECK(read_pipeline.deserialize(&const_metadata).ok());
+    auto read_filter = read_pipeline.get_filter<CompressionFilter>();
+    REQUIRE(read_filter != nullptr);
+    CHECK(read_filter->zstd_dictionary_size() == filter.zstd_dictionary_size());
+
+    CHECK(read_pipeline.run_reverse(&tile).ok());
+    CHECK(
+        std::string((const char*)tile.buffer()->data(), data.size()) == data);
+  }
+
+  SECTION("- Level change") {
+    filter.set_compression_level(10);
+    CHECK(filter.zstd_dictionary_size() > 0);
+    FilterPipeline dict_pipeline;
+    CHECK(dict_pipeline.add_filter(filter).ok());
+    CHECK(dict_pipeline.run_forward(&tile).ok());
+    CHECK(dict_pipeline.run_reverse(&tile).ok());
+    CHECK(
+        std::string((const char*)tile.buffer()->data(), data.size()) == data);
+  }
+
+  SECTION("- Invalid compressor") {
+    CompressionFilter gzip(Compressor::GZIP, 5);
+    CHECK(!gzip.train_zstd_dictionary(samples.data(), sample_sizes, 4096).ok());
+  }
+}
+
 TEST_CASE("Filter: Test pseudo-checksum", "[filter]") {
   // Set up test data
   const uint64_t nelts = 100;
@@ -1056,6 +1250,68 @@ TEST_CASE("Filter: Test pipeline copy", "[filter]") {
     CHECK(buff.value<uint64_t>(i * sizeof(uint64_t)) == i);
 }
 
+TEST_CASE("Filter: Test partial reverse pipeline", "[filter]") {
+  // Set up test data
+  const uint64_t nelts = 100;
+  Buffer buff;
+  for (uint64_t i = 0; i < nelts; i++)
+    CHECK(buff.write(&i, sizeof(uint64_t)).ok());
+  CHECK(buff.size() == nelts * sizeof(uint64_t));
+
+  Tile tile(Datatype::UINT64, sizeof(uint64_t), 0, &buff, false);
+
+  // Use chunks of 10 cells
+  FilterPipeline pipeline;
+  CHECK(pipeline.add_filter(Add1InPlace()).ok());
+  CHECK(pipeline.add_filter(Add1OutOfPlace()).ok());
+  CHECK(pipeline.add_filter(PseudoChecksumFilter()).ok());
+  pipeline.set_max_chunk_size(10 * sizeof(uint64_t));
+  CHECK(pipeline.run_forward(&tile).ok());
+
+  SECTION("- Range within two chunks") {
+    std::vector<std::pair<uint64_t, uint64_t>> ranges = {
+        {25 * sizeof(uint64_t), 35 * sizeof(uint64_t)}};
+    uint64_t skipped_chunk_num = 0;
+    CHECK(pipeline.run_reverse(&tile, ranges, &skipped_chunk_num).ok());
+    CHECK(skipped_chunk_num == 8);
+    CHECK(tile.buffer()->size() == nelts * sizeof(uint64_t));
+    for (uint64_t i = 20; i < 40; i++)
+      CHECK(buff.value<uint64_t>(i * sizeof(uint64_t)) == i);
+  }
+
+  SECTION("- Overlapping ranges past the tile end") {
+    std::vector<std::pair<uint64_t, uint64_t>> ranges = {
+        {0, sizeof(uint64_t)},
+        {95 * sizeof(uint64_t), std::numeric_limits<uint64_t>::max()},
+        {92 * sizeof(uint64_t), 96 * sizeof(uint64_t)}};
+    uint64_t skipped_chunk_num = 0;
+    CHECK(pipeline.run_reverse(&tile, ranges, &skipped_chunk_num).ok());
+    CHECK(skipped_chunk_num == 8);
+    for (uint64_t i = 0; i < 10; i++)
+      CHECK(buff.value<uint64_t>(i * sizeof(uint64_t)) == i);
+    for (uint64_t i = 90; i < nelts; i++)
+      CHECK(buff.value<uint64_t>(i * sizeof(uint64_t)) == i);
+  }
+
+  SECTION("- No ranges") {
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    uint64_t skipped_chunk_num = 0;
+    CHECK(pipeline.run_reverse(&tile, ranges, &skipped_chunk_num).ok());
+    CHECK(skipped_chunk_num == 10);
+    CHECK(tile.buffer()->size() == nelts * sizeof(uint64_t));
+  }
+
+  SECTION("- Range covering all chunks") {
+    std::vector<std::pair<uint64_t, uint64_t>> ranges = {
+        {5 * sizeof(uint64_t), 95 * sizeof(uint64_t)}};
+    uint64_t skipped_chunk_num = 0;
+    CHECK(pipeline.run_reverse(&tile, ranges, &skipped_chunk_num).ok());
+    CHECK(skipped_chunk_num == 0);
+    for (uint64_t i = 0; i < nelts; i++)
+      CHECK(buff.value<uint64_t>(i * sizeof(uint64_t)) == i);
+  }
+}
+
 TEST_CASE("Filter: Test random pipeline", "[filter]") {
   // Set up test data
   const uint64_t nelts = 10000;
@@ -1080,11 +1336,17 @@ TEST_CASE("Filter: Test random pipeline", "[filter]") {
       []() { return new Add1InPlace(); },
       []() { return new Add1OutOfPlace(); },
       []() { return new Add1IncludingMetadataFilter(); },
+      []() { return new AutoFilter(); },
+      []() { return new BitPackingFilter(); },
       []() { return new BitWidthReductionFilter(); },
       []() { return new BitshuffleFilter(); },
       []() { return new ByteshuffleFilter(); },
+      []() { return new ChecksumFilter(FilterType::FILTER_CHECKSUM_CRC32C); },
+      []() { return new ChecksumFilter(FilterType::FILTER_CHECKSUM_XXHASH64); },
       []() { return new CompressionFilter(Compressor::BZIP2, -1); },
+      []() { return new DictionaryFilter(); },
       []() { return new PseudoChecksumFilter(); },
+      []() { return new XORFilter(); },
       [&encryption_key]() {
         return new EncryptionAES256GCMFilter(encryption_key);
       },
@@ -1264,6 +1526,115 @@ TEST_CASE("Filter: Test bit width reduction", "[filter]") {
   }
 }
 
+TEST_CASE("Filter: Test auto filter", "[filter]") {
+  // Set up a tile with a constant, a sorted and a random chunk
+  const uint64_t chunk_nelts =
+      constants::max_tile_chunk_size / sizeof(uint64_t);
+  const uint64_t nelts = 3 * chunk_nelts;
+  std::vector<uint64_t> vals(nelts);
+  std::mt19937_64 gen(42);
+  Buffer buff;
+  for (uint64_t i = 0; i < nelts; i++) {
+    if (i < chunk_nelts)
+      vals[i] = 7;
+    else if (i < 2 * chunk_nelts)
+      vals[i] = 1000 + 5 * i;
+    else
+      vals[i] = gen();
+    CHECK(buff.write(&vals[i], sizeof(uint64_t)).ok());
+  }
+
+  Tile tile(Datatype::UINT64, sizeof(uint64_t), 0, &buff, false);
+
+  FilterPipeline pipeline;
+  CHECK(pipeline.add_filter(AutoFilter()).ok());
+
+  CHECK(pipeline.run_forward(&tile).ok());
+  // The first two chunks shrink to almost nothing, the last is unmodified.
+  CHECK(tile.buffer()->size() < (chunk_nelts + 1024) * sizeof(uint64_t));
+  CHECK(pipeline.run_reverse(&tile).ok());
+  CHECK(tile.buffer()->size() == nelts * sizeof(uint64_t));
+  for (uint64_t i = 0; i < nelts; i++)
+    REQUIRE(tile.buffer()->value<uint64_t>(i * sizeof(uint64_t)) == vals[i]);
+
+  // Pipeline copies share the Zstandard level
+  int32_t level = 9;
+  CHECK(pipeline.get_filter<AutoFilter>()
+            ->set_option(FilterOption::COMPRESSION_LEVEL, &level)
+            .ok());
+  FilterPipeline pipeline_copy(pipeline);
+  CHECK(pipeline_copy.get_filter<AutoFilter>()->zstd_level() == 9);
+}
+
+TEST_CASE("Filter: Test bit packing", "[filter]") {
+  // Set up test data with small values and a few outliers
+  const uint64_t nelts = 1000;
+  std::vector<int64_t> vals(nelts);
+  Buffer buff;
+  for (uint64_t i = 0; i < nelts; i++) {
+    vals[i] = -100 + (int64_t)(i % 13);
+    if (i % 97 == 0)
+      vals[i] = (int64_t)1 << 40;
+    CHECK(buff.write(&vals[i], sizeof(int64_t)).ok());
+  }
+  CHECK(buff.size() == nelts * sizeof(int64_t));
+
+  Tile tile(Datatype::INT64, sizeof(int64_t), 0, &buff, false);
+
+  FilterPipeline pipeline;
+  CHECK(pipeline.add_filter(BitPackingFilter()).ok());
+
+  SECTION("- Exceptions") {
+    CHECK(pipeline.run_forward(&tile).ok());
+    // 4-bit elements, plus block headers and exceptions
+    CHECK(tile.buffer()->size() < nelts / 2 + 200);
+    CHECK(pipeline.run_reverse(&tile).ok());
+    CHECK(tile.buffer()->size() == nelts * sizeof(int64_t));
+    for (uint64_t i = 0; i < nelts; i++)
+      CHECK(tile.buffer()->value<int64_t>(i * sizeof(int64_t)) == vals[i]);
+  }
+
+  SECTION("- Delta") {
+    uint32_t delta = 1;
+    CHECK(pipeline.get_filter<BitPackingFilter>()
+              ->set_option(FilterOption::BIT_PACKING_DELTA, &delta)
+              .ok());
+    Buffer buff2;
+    for (uint32_t i = 0; i < nelts; i++) {
+      uint32_t val = 1000000 + i * 3 + (i % 2);
+      CHECK(buff2.write(&val, sizeof(uint32_t)).ok());
+    }
+    CHECK(buff2.write("XY", 2).ok());
+    Tile tile2(Datatype::UINT32, sizeof(uint32_t), 0, &buff2, false);
+
+    CHECK(pipeline.run_forward(&tile2).ok());
+    CHECK(tile2.buffer()->size() < nelts / 2);
+    CHECK(pipeline.run_reverse(&tile2).ok());
+    CHECK(tile2.buffer()->size() == nelts * sizeof(uint32_t) + 2);
+    for (uint32_t i = 0; i < nelts; i++)
+      CHECK(
+          tile2.buffer()->value<uint32_t>(i * sizeof(uint32_t)) ==
+          1000000 + i * 3 + (i % 2));
+  }
+
+  SECTION("- Random values") {
+    std::mt19937_64 gen(42);
+    Buffer buff2;
+    std::vector<uint64_t> vals2(nelts);
+    for (auto& v : vals2) {
+      v = gen() >> (gen() % 64);
+      CHECK(buff2.write(&v, sizeof(uint64_t)).ok());
+    }
+    Tile tile2(Datatype::UINT64, sizeof(uint64_t), 0, &buff2, false);
+
+    CHECK(pipeline.run_forward(&tile2).ok());
+    CHECK(pipeline.run_reverse(&tile2).ok());
+    CHECK(tile2.buffer()->size() == nelts * sizeof(uint64_t));
+    for (uint64_t i = 0; i < nelts; i++)
+      CHECK(tile2.buffer()->value<uint64_t>(i * sizeof(uint64_t)) == vals2[i]);
+  }
+}
+
 TEST_CASE("Filter: Test positive-delta encoding", "[filter]") {
   // Set up test data
   const uint64_t nelts = 1000;
@@ -1416,6 +1787,184 @@ TEST_CASE("Filter: Test byteshuffle", "[filter]") {
   }
 }
 
+TEST_CASE("Filter: Test dictionary encoding", "[filter]") {
+  // Set up test data with few distinct values
+  const uint64_t nelts = 1000;
+  Buffer buff;
+  for (uint64_t i = 0; i < nelts; i++) {
+    uint64_t val = 1000000 + (i % 7) * 12345;
+    CHECK(buff.write(&val, sizeof(uint64_t)).ok());
+  }
+  CHECK(buff.size() == nelts * sizeof(uint64_t));
+
+  Tile tile(Datatype::UINT64, sizeof(uint64_t), 0, &buff, false);
+
+  FilterPipeline pipeline;
+  CHECK(pipeline.add_filter(DictionaryFilter()).ok());
+
+  SECTION("- Single stage") {
+    CHECK(pipeline.run_forward(&tile).ok());
+    // 7 entries and 3-bit codes, plus the chunk and filter metadata
+    CHECK(tile.buffer()->size() < 7 * sizeof(uint64_t) + nelts * 3 / 8 + 64);
+
+    CHECK(pipeline.run_reverse(&tile).ok());
+    CHECK(tile.buffer()->size() == nelts * sizeof(uint64_t));
+    for (uint64_t i = 0; i < nelts; i++)
+      CHECK(
+          tile.buffer()->value<uint64_t>(i * sizeof(uint64_t)) ==
+          1000000 + (i % 7) * 12345);
+  }
+
+  SECTION("- Fixed-length strings with trailing bytes") {
+    const uint64_t ncells = 1001;
+    const char* values[] = {"USA", "GBR", "FRA", "DEU"};
+    Buffer buff2;
+    for (uint64_t i = 0; i < ncells; i++)
+      CHECK(buff2.write(values[(i * i) % 4], 3).ok());
+    CHECK(buff2.write("XY", 2).ok());
+    Tile tile2(Datatype::CHAR, 3, 0, &buff2, false);
+
+    CHECK(pipeline.run_forward(&tile2).ok());
+    CHECK(tile2.buffer()->size() < ncells * 3 / 2);
+    CHECK(pipeline.run_reverse(&tile2).ok());
+    CHECK(tile2.buffer()->size() == ncells * 3 + 2);
+    auto data = static_cast<const char*>(tile2.buffer()->data());
+    for (uint64_t i = 0; i < ncells; i++)
+      CHECK(std::string(data + i * 3, 3) == values[(i * i) % 4]);
+    CHECK(std::string(data + ncells * 3, 2) == "XY");
+  }
+
+  SECTION("- Distinct values") {
+    Buffer buff2;
+    for (uint64_t i = 0; i < nelts; i++)
+      CHECK(buff2.write(&i, sizeof(uint64_t)).ok());
+    Tile tile2(Datatype::UINT64, sizeof(uint64_t), 0, &buff2, false);
+
+    CHECK(pipeline.run_forward(&tile2).ok());
+    CHECK(tile2.buffer()->size() > nelts * sizeof(uint64_t));
+    CHECK(pipeline.run_reverse(&tile2).ok());
+    CHECK(tile2.buffer()->size() == nelts * sizeof(uint64_t));
+    for (uint64_t i = 0; i < nelts; i++)
+      CHECK(tile2.buffer()->value<uint64_t>(i * sizeof(uint64_t)) == i);
+  }
+}
+
+TEST_CASE("Filter: Test XOR encoding", "[filter]") {
+  // Set up a slowly changing time series
+  const uint64_t nelts = 1000;
+  Buffer buff;
+  for (uint64_t i = 0; i < nelts; i++) {
+    double val = 20.0 + (i / 10) * 0.25;
+    CHECK(buff.write(&val, sizeof(double)).ok());
+  }
+  CHECK(buff.size() == nelts * sizeof(double));
+
+  Tile tile(Datatype::FLOAT64, sizeof(double), 0, &buff, false);
+
+  FilterPipeline pipeline;
+  CHECK(pipeline.add_filter(XORFilter()).ok());
+
+  SECTION("- Gorilla") {
+    CHECK(pipeline.run_forward(&tile).ok());
+    CHECK(tile.buffer()->size() < nelts * sizeof(double) / 4);
+    CHECK(pipeline.run_reverse(&tile).ok());
+    CHECK(tile.buffer()->size() == nelts * sizeof(double));
+    for (uint64_t i = 0; i < nelts; i++)
+      CHECK(
+          tile.buffer()->value<double>(i * sizeof(double)) ==
+          20.0 + (i / 10) * 0.25);
+  }
+
+  SECTION("- Byte planes") {
+    uint32_t byte_planes = 1;
+    CHECK(pipeline.get_filter<XORFilter>()
+              ->set_option(FilterOption::XOR_BYTE_PLANES, &byte_planes)
+              .ok());
+    CHECK(pipeline.run_forward(&tile).ok());
+    CHECK(pipeline.run_reverse(&tile).ok());
+    CHECK(tile.buffer()->size() == nelts * sizeof(double));
+    for (uint64_t i = 0; i < nelts; i++)
+      CHECK(
+          tile.buffer()->value<double>(i * sizeof(double)) ==
+          20.0 + (i / 10) * 0.25);
+  }
+
+  SECTION("- Random float32 values with trailing bytes") {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-1e6f, 1e6f);
+    std::vector<float> vals(1001);
+    Buffer buff2;
+    for (auto& v : vals) {
+      v = dist(gen);
+      CHECK(buff2.write(&v, sizeof(float)).ok());
+    }
+    CHECK(buff2.write("XY", 2).ok());
+    Tile tile2(Datatype::FLOAT32, sizeof(float), 0, &buff2, false);
+
+    CHECK(pipeline.run_forward(&tile2).ok());
+    CHECK(pipeline.run_reverse(&tile2).ok());
+    CHECK(tile2.buffer()->size() == vals.size() * sizeof(float) + 2);
+    for (uint64_t i = 0; i < vals.size(); i++)
+      CHECK(tile2.buffer()->value<float>(i * sizeof(float)) == vals[i]);
+    auto data = static_cast<const char*>(tile2.buffer()->data());
+    CHECK(std::string(data + vals.size() * sizeof(float), 2) == "XY");
+  }
+}
+
+TEST_CASE("Filter: Test checksum", "[filter]") {
+  SECTION("- Known values") {
+    CHECK(checksum::crc32c(0, "", 0) == 0);
+    CHECK(checksum::crc32c(0, "123456789", 9) == 0xE3069283);
+    CHECK(
+        checksum::crc32c(checksum::crc32c(0, "1234", 4), "56789", 5) ==
+        0xE3069283);
+    CHECK(checksum::xxhash64("", 0) == 0xEF46DB3751D8E999ULL);
+    CHECK(checksum::xxhash64("abc", 3) == 0x44BC2CF5AD770999ULL);
+    const std::string str = "Nobody inspects the spammish repetition";
+    CHECK(
+        checksum::xxhash64(str.data(), str.size()) == 0xFBCEA83C8A378BF1ULL);
+
+    // Incremental hashing across the 32-byte stripe boundaries
+    checksum::XXHash64 xxhash;
+    for (uint64_t i = 0; i < str.size(); i += 7)
+      xxhash.update(str.data() + i, std::min<uint64_t>(7, str.size() - i));
+    CHECK(xxhash.digest() == 0xFBCEA83C8A378BF1ULL);
+  }
+
+  SECTION("- Round trip and corrupted data") {
+    const FilterType types[] = {FilterType::FILTER_CHECKSUM_CRC32C,
+                                FilterType::FILTER_CHECKSUM_XXHASH64};
+    for (auto type : types) {
+      // Set up test data
+      const uint64_t nelts = 100000;
+      Buffer buff;
+      for (uint64_t i = 0; i < nelts; i++)
+        CHECK(buff.write(&i, sizeof(uint64_t)).ok());
+      CHECK(buff.size() == nelts * sizeof(uint64_t));
+
+      Tile tile(Datatype::UINT64, sizeof(uint64_t), 0, &buff, false);
+
+      FilterPipeline pipeline;
+      CHECK(pipeline.add_filter(CompressionFilter(Compressor::GZIP, 1)).ok());
+      CHECK(pipeline.add_filter(ChecksumFilter(type)).ok());
+
+      CHECK(pipeline.run_forward(&tile).ok());
+      CHECK(pipeline.run_reverse(&tile).ok());
+      CHECK(tile.buffer()->size() == nelts * sizeof(uint64_t));
+      for (uint64_t i = 0; i < nelts; i++)
+        CHECK(tile.buffer()->value<uint64_t>(i * sizeof(uint64_t)) == i);
+
+      // Flip a bit of the filtered data
+      CHECK(pipeline.run_forward(&tile).ok());
+      auto data = static_cast<char*>(tile.buffer()->data());
+      data[tile.buffer()->size() - 1] ^= 0x10;
+      auto st = pipeline.run_reverse(&tile);
+      CHECK(!st.ok());
+      CHECK(st.code() == StatusCode::ChecksumError);
+    }
+  }
+}
+
 TEST_CASE("Filter: Test encryption", "[filter], [encryption]") {
   // Set up test data
   const uint64_t nelts = 1000;
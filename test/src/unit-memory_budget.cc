@@ -0,0 +1,145 @@
+/**
+ * @file   unit-memory_budget.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the `MemoryBudget` and `MemoryReservation` classes.
+ */
+
+#include <atomic>
+#include <memory>
+#include <catch.hpp>
+#include <thread>
+#include "tiledb/sm/misc/memory_budget.h"
+
+using namespace tiledb::sm;
+
+TEST_CASE("MemoryBudget: Test try reserve", "[memory-budget]") {
+  MemoryBudget budget;
+  REQUIRE(budget.init(100).ok());
+  CHECK(budget.budget() == 100);
+  CHECK(budget.try_reserve(60));
+  CHECK(!budget.try_reserve(50));
+  CHECK(budget.in_use() == 60);
+  CHECK(budget.try_reserve(40));
+  budget.release(100);
+  CHECK(budget.in_use() == 0);
+}
+
+TEST_CASE("MemoryBudget: Test unlimited", "[memory-budget]") {
+  MemoryBudget budget;
+  REQUIRE(budget.init(0).ok());
+  CHECK(budget.try_reserve(1000000));
+  {
+    MemoryReservation reservation(&budget);
+    CHECK(reservation.reserve(1000000).ok());
+    CHECK(budget.in_use() == 2000000);
+  }
+  CHECK(budget.in_use() == 1000000);
+  budget.release(1000000);
+}
+
+TEST_CASE("MemoryBudget: Test reservation", "[memory-budget]") {
+  MemoryBudget budget;
+  REQUIRE(budget.init(100).ok());
+
+  {
+    MemoryReservation reservation(&budget);
+    // A single holder is always admitted, even beyond the budget
+    CHECK(reservation.reserve(150).ok());
+    CHECK(reservation.reserve(10).ok());
+    CHECK(reservation.size() == 160);
+    CHECK(budget.in_use() == 160);
+    CHECK(!budget.try_reserve(1));
+  }
+  CHECK(budget.in_use() == 0);
+
+  // A null budget is a no-op
+  MemoryReservation null_reservation(nullptr);
+  CHECK(null_reservation.reserve(100).ok());
+  CHECK(null_reservation.size() == 0);
+}
+
+TEST_CASE("MemoryBudget: Test admission control", "[memory-budget]") {
+  MemoryBudget budget;
+  REQUIRE(budget.init(100).ok());
+
+  std::atomic<bool> admitted(false);
+  std::unique_ptr<MemoryReservation> first(new MemoryReservation(&budget));
+  REQUIRE(first->reserve(80).ok());
+
+  std::thread t([&budget, &admitted]() {
+    MemoryReservation second(&budget);
+    CHECK(second.reserve(50).ok());
+    admitted = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  CHECK(!admitted);
+
+  // Releasing the first reservation admits the second
+  first.reset(nullptr);
+  t.join();
+  CHECK(admitted);
+  CHECK(budget.in_use() == 0);
+}
+
+TEST_CASE("MemoryBudget: Test blocking reserve", "[memory-budget]") {
+  MemoryBudget budget;
+  REQUIRE(budget.init(100).ok());
+
+  // Without holders, the bytes are reserved even beyond the budget
+  REQUIRE(budget.try_reserve(80));
+  budget.reserve(50);
+  CHECK(budget.in_use() == 130);
+  budget.release(130);
+
+  std::atomic<bool> reserved(false);
+  std::unique_ptr<MemoryReservation> holder(new MemoryReservation(&budget));
+  REQUIRE(holder->reserve(80).ok());
+
+  std::thread t([&budget, &reserved]() {
+    budget.reserve(50);
+    reserved = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  CHECK(!reserved);
+
+  // Releasing the holder lets the reservation through
+  holder.reset(nullptr);
+  t.join();
+  CHECK(reserved);
+  CHECK(budget.in_use() == 50);
+
+  // The caller of `reserve` is not a holder, so queries are still admitted
+  MemoryReservation query(&budget);
+  CHECK(query.reserve(80).ok());
+  query.release();
+  budget.release(50);
+  CHECK(budget.in_use() == 0);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file unit-parallel_functions.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ * @copyright Copyright (c) 2016 MIT and Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the parallel utility functions.
+ */
+
+#include "tiledb/sm/misc/parallel_functions.h"
+
+#include <catch.hpp>
+#include <random>
+
+using namespace tiledb::sm;
+
+/**
+ * Checks that `parallel_radix_sort` on random keys of the given width
+ * matches a stable comparison sort.
+ */
+void check_radix_sort(uint64_t n, unsigned key_bits) {
+  // Create random keys with few distinct values, so that stability matters
+  std::mt19937_64 gen(key_bits + n);
+  uint64_t mask =
+      (key_bits == 64) ? ~uint64_t(0) : (uint64_t(1) << key_bits) - 1;
+  std::vector<uint64_t> keys(n), values(n);
+  for (uint64_t i = 0; i < n; ++i) {
+    keys[i] = ((gen() % 100) * (mask / 100 + 1)) & mask;
+    values[i] = i;
+  }
+
+  // Compute the expected result with a stable comparison sort
+  std::vector<std::pair<uint64_t, uint64_t>> expected(n);
+  for (uint64_t i = 0; i < n; ++i)
+    expected[i] = std::make_pair(keys[i], values[i]);
+  std::stable_sort(
+      expected.begin(),
+      expected.end(),
+      [](const std::pair<uint64_t, uint64_t>& a,
+         const std::pair<uint64_t, uint64_t>& b) { return a.first < b.first; });
+
+  parallel_radix_sort(&keys, &values, key_bits);
+  for (uint64_t i = 0; i < n; ++i) {
+    REQUIRE(keys[i] == expected[i].first);
+    REQUIRE(values[i] == expected[i].second);
+  }
+}
+
+TEST_CASE("Parallel functions: Test radix sort", "[parallel-radix-sort]") {
+  for (uint64_t n : {0, 1, 1000, 300000}) {
+    for (unsigned key_bits : {1, 8, 13, 40, 64})
+      check_radix_sort(n, key_bits);
+  }
+}
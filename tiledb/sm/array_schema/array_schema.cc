@@ -34,6 +34,7 @@
 #include "tiledb/sm/array_schema/array_schema.h"
 #include "tiledb/sm/buffer/const_buffer.h"
 #include "tiledb/sm/filter/compression_filter.h"
+#include "tiledb/sm/filter/dictionary_filter.h"
 #include "tiledb/sm/misc/logger.h"
 
 #include <cassert>
@@ -54,6 +55,7 @@ ArraySchema::ArraySchema() {
   capacity_ = constants::capacity;
   cell_order_ = Layout::ROW_MAJOR;
   is_kv_ = false;
+  kv_hash_ = KVHash::KV_HASH_MD5;
   domain_ = nullptr;
   tile_order_ = Layout::ROW_MAJOR;
   version_ = constants::format_version;
@@ -72,6 +74,7 @@ ArraySchema::ArraySchema(ArrayType array_type)
   capacity_ = constants::capacity;
   cell_order_ = Layout::ROW_MAJOR;
   is_kv_ = false;
+  kv_hash_ = KVHash::KV_HASH_MD5;
   domain_ = nullptr;
   tile_order_ = Layout::ROW_MAJOR;
   version_ = constants::format_version;
@@ -88,6 +91,7 @@ ArraySchema::ArraySchema(const ArraySchema* array_schema) {
   array_uri_ = array_schema->array_uri_;
   array_type_ = array_schema->array_type_;
   is_kv_ = array_schema->is_kv_;
+  kv_hash_ = array_schema->kv_hash_;
   domain_ = nullptr;
 
   if (is_kv_) {
@@ -246,6 +250,11 @@ Status ArraySchema::check() const {
         "Array schema check failed; Double delta compression can be used "
         "only with integer values"));
 
+  if (!check_dictionary_filter())
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Array schema check failed; Dictionary encoding can be used only "
+        "with fixed-sized attributes"));
+
   if (!check_attribute_dimension_names())
     return LOG_STATUS(
         Status::ArraySchemaError("Array schema check failed; Attributes "
@@ -345,6 +354,8 @@ void ArraySchema::dump(FILE* out) const {
   fprintf(out, "- Cell order: %s\n", layout_str(cell_order_).c_str());
   fprintf(out, "- Tile order: %s\n", layout_str(tile_order_).c_str());
   fprintf(out, "- Capacity: %" PRIu64 "\n", capacity_);
+  if (is_kv_)
+    fprintf(out, "- Key hash: %s\n", kv_hash_str(kv_hash_).c_str());
   fprintf(
       out,
       "- Coordinates compressor: %s\n",
@@ -367,6 +378,10 @@ bool ArraySchema::is_kv() const {
   return is_kv_;
 }
 
+KVHash ArraySchema::kv_hash() const {
+  return kv_hash_;
+}
+
 // ===== FORMAT =====
 // version (uint32_t)
 // array_type (uint8_t)
@@ -380,6 +395,7 @@ bool ArraySchema::is_kv() const {
 //   attribute #1
 //   attribute #2
 //   ...
+// kv_hash (uint8_t, only for key-value stores, since format version 2)
 Status ArraySchema::serialize(Buffer* buff) const {
   // Write version
   RETURN_NOT_OK(buff->write(&version_, sizeof(uint32_t)));
@@ -412,6 +428,12 @@ Status ArraySchema::serialize(Buffer* buff) const {
   for (auto& attr : attributes_)
     RETURN_NOT_OK(attr->serialize(buff));
 
+  // Write key hash
+  if (is_kv_) {
+    auto kv_hash = (uint8_t)kv_hash_;
+    RETURN_NOT_OK(buff->write(&kv_hash, sizeof(uint8_t)));
+  }
+
   return Status::Ok();
 }
 
@@ -493,11 +515,16 @@ Status ArraySchema::add_attribute(const Attribute* attr, bool check_special) {
 //   attribute #1
 //   attribute #2
 //   ...
+// kv_hash (uint8_t, only for key-value stores, since format version 2)
 Status ArraySchema::deserialize(ConstBuffer* buff, bool is_kv) {
   is_kv_ = is_kv;
 
   // Load version
   RETURN_NOT_OK(buff->read(&version_, sizeof(uint32_t)));
+  if (version_ > constants::format_version)
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Cannot deserialize array schema; Unsupported format version " +
+        std::to_string(version_)));
 
   // Load array type
   uint8_t array_type;
@@ -536,6 +563,18 @@ Status ArraySchema::deserialize(ConstBuffer* buff, bool is_kv) {
     attributes_.emplace_back(attr);
   }
 
+  // Load key hash. Key-value stores created before format version 2 use
+  // MD5.
+  if (is_kv && version_ >= 2) {
+    uint8_t kv_hash;
+    RETURN_NOT_OK(buff->read(&kv_hash, sizeof(uint8_t)));
+    if (!kv_hash_valid((KVHash)kv_hash))
+      return LOG_STATUS(Status::ArraySchemaError(
+          "Cannot deserialize array schema; Invalid key hash " +
+          std::to_string(kv_hash)));
+    kv_hash_ = (KVHash)kv_hash;
+  }
+
   // Initialize the rest of the object members
   RETURN_NOT_OK(init());
 
@@ -594,6 +633,20 @@ Status ArraySchema::set_as_kv() {
   return Status::Ok();
 }
 
+Status ArraySchema::set_kv_hash(KVHash kv_hash) {
+  if (!is_kv_)
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Cannot set key hash; The array is not a key-value store"));
+  if (!kv_hash_valid(kv_hash))
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Cannot set key hash; Invalid key hash " +
+        std::to_string((uint8_t)kv_hash)));
+
+  kv_hash_ = kv_hash;
+
+  return Status::Ok();
+}
+
 void ArraySchema::set_array_uri(const URI& array_uri) {
   array_uri_ = array_uri;
 }
@@ -708,6 +761,16 @@ bool ArraySchema::check_double_delta_compressor() const {
   return true;
 }
 
+bool ArraySchema::check_dictionary_filter() const {
+  for (auto attr : attributes_) {
+    if (attr->var_size() &&
+        attr->filters()->get_filter<DictionaryFilter>() != nullptr)
+      return false;
+  }
+
+  return true;
+}
+
 void ArraySchema::clear() {
   array_uri_ = URI();
   array_type_ = ArrayType::DENSE;
@@ -48,6 +48,7 @@
 #include "tiledb/sm/enums/array_type.h"
 #include "tiledb/sm/enums/compressor.h"
 #include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/kv_hash.h"
 #include "tiledb/sm/enums/layout.h"
 #include "tiledb/sm/filter/filter_pipeline.h"
 #include "tiledb/sm/misc/constants.h"
@@ -209,6 +210,9 @@ class ArraySchema {
   /** Checks if the array is defined as a key-value store. */
   bool is_kv() const;
 
+  /** Returns the hash function of the keys, if this is a key-value store. */
+  KVHash kv_hash() const;
+
   /**
    * Serializes the array schema object into a buffer.
    *
@@ -295,6 +299,12 @@ class ArraySchema {
   /** Sets the cell order. */
   void set_cell_order(Layout cell_order);
 
+  /**
+   * Sets the hash function of the keys. The function returns an error if
+   * the array is not a key-value store.
+   */
+  Status set_kv_hash(KVHash kv_hash);
+
   /**
    * Sets the domain. The function returns an error if the array has been
    * previously set to be a key-value store.
@@ -350,6 +360,9 @@ class ArraySchema {
   /** `true` if the array is a key-value store. */
   bool is_kv_;
 
+  /** The hash function of the keys, if the array is a key-value store. */
+  KVHash kv_hash_;
+
   /**
    * The tile order. It can be one of the following:
    *    - TILEDB_ROW_MAJOR
@@ -376,6 +389,12 @@ class ArraySchema {
    */
   bool check_double_delta_compressor() const;
 
+  /**
+   * Returns false if dictionary encoding is used with var-sized attributes
+   * and true otherwise.
+   */
+  bool check_dictionary_filter() const;
+
   /** Clears all members. Use with caution! */
   void clear();
 
@@ -0,0 +1,101 @@
+/**
+ * @file   arena.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class Arena.
+ */
+
+#include "tiledb/sm/buffer/arena.h"
+#include "tiledb/sm/buffer/buffer_pool.h"
+#include "tiledb/sm/misc/constants.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+Arena::Arena() {
+  size_ = 0;
+}
+
+Arena::~Arena() {
+  auto& pool = BufferPool::buffer_pool();
+  for (auto& block : blocks_)
+    pool.deallocate(block.data_, block.capacity_);
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void* Arena::allocate(uint64_t nbytes) {
+  const uint64_t alignment = alignof(std::max_align_t);
+  nbytes = (nbytes + alignment - 1) / alignment * alignment;
+
+  // Allocate a new block if the current one has no room
+  if (blocks_.empty() ||
+      blocks_.back().offset_ + nbytes > blocks_.back().capacity_) {
+    Block block;
+    block.data_ = static_cast<char*>(BufferPool::buffer_pool().allocate(
+        std::max(nbytes, constants::arena_block_size), &block.capacity_));
+    if (block.data_ == nullptr)
+      return nullptr;
+    block.offset_ = 0;
+    blocks_.push_back(block);
+  }
+
+  auto& block = blocks_.back();
+  void* ret = block.data_ + block.offset_;
+  block.offset_ += nbytes;
+  size_ += nbytes;
+
+  return ret;
+}
+
+void Arena::reset() {
+  auto& pool = BufferPool::buffer_pool();
+  for (size_t i = 1; i < blocks_.size(); ++i)
+    pool.deallocate(blocks_[i].data_, blocks_[i].capacity_);
+  if (!blocks_.empty()) {
+    blocks_.resize(1);
+    blocks_[0].offset_ = 0;
+  }
+  size_ = 0;
+}
+
+uint64_t Arena::size() const {
+  return size_;
+}
+
+}  // namespace sm
+}  // namespace tiledb
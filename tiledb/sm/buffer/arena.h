@@ -0,0 +1,124 @@
+/**
+ * @file   arena.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class Arena.
+ */
+
+#ifndef TILEDB_ARENA_H
+#define TILEDB_ARENA_H
+
+#include <cinttypes>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A bump allocator for short-lived, per-query allocations. Memory is
+ * carved out of blocks drawn from the BufferPool and is released all at
+ * once, either by `reset` or upon destruction. An arena is not thread-safe.
+ */
+class Arena {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  Arena();
+
+  /** Destructor. Returns all blocks to the buffer pool. */
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Allocates `nbytes` bytes, aligned to `alignof(std::max_align_t)`.
+   *
+   * @param nbytes The number of bytes to allocate.
+   * @return The allocated memory, or `nullptr` if the allocation failed.
+   */
+  void* allocate(uint64_t nbytes);
+
+  /**
+   * Allocates an (uninitialized) array of `num` elements of type `T`.
+   *
+   * @tparam T A trivially destructible type.
+   * @param num The number of elements.
+   * @return The allocated array, or `nullptr` if the allocation failed.
+   */
+  template <class T>
+  T* allocate_array(uint64_t num) {
+    return static_cast<T*>(allocate(num * sizeof(T)));
+  }
+
+  /**
+   * Releases all allocations at once. The first block is kept for reuse,
+   * the rest are returned to the buffer pool.
+   */
+  void reset();
+
+  /** Returns the number of bytes currently allocated from the arena. */
+  uint64_t size() const;
+
+ private:
+  /* ********************************* */
+  /*         TYPE DEFINITIONS          */
+  /* ********************************* */
+
+  /** A memory block drawn from the buffer pool. */
+  struct Block {
+    /** The block memory. */
+    char* data_;
+    /** The block capacity. */
+    uint64_t capacity_;
+    /** The next free position in the block. */
+    uint64_t offset_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The blocks. Allocations are served from the last one. */
+  std::vector<Block> blocks_;
+
+  /** The number of bytes allocated. */
+  uint64_t size_;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_ARENA_H
@@ -31,6 +31,7 @@
  */
 
 #include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/buffer_pool.h"
 #include "tiledb/sm/buffer/const_buffer.h"
 #include "tiledb/sm/misc/logger.h"
 
@@ -51,6 +52,7 @@ namespace sm {
 
 Buffer::Buffer() {
   alloced_size_ = 0;
+  capacity_ = 0;
   data_ = nullptr;
   size_ = 0;
   offset_ = 0;
@@ -63,11 +65,13 @@ Buffer::Buffer(void* data, uint64_t size, bool owns_data)
     , size_(size) {
   offset_ = 0;
   alloced_size_ = 0;
+  capacity_ = 0;
   owns_data_ = false;
 }
 
 Buffer::Buffer(const Buffer& buff) {
   alloced_size_ = 0;
+  capacity_ = 0;
   data_ = nullptr;
   size_ = 0;
   offset_ = 0;
@@ -98,12 +102,13 @@ uint64_t Buffer::alloced_size() const {
 
 void Buffer::clear() {
   if (data_ != nullptr && owns_data_)
-    std::free(data_);
+    BufferPool::buffer_pool().deallocate(data_, capacity_);
 
   data_ = nullptr;
   offset_ = 0;
   size_ = 0;
   alloced_size_ = 0;
+  capacity_ = 0;
 }
 
 void* Buffer::cur_data() const {
@@ -155,26 +160,47 @@ Status Buffer::realloc(uint64_t nbytes) {
         "Cannot reallocate buffer; Buffer does not own data"));
   }
 
+  auto& pool = BufferPool::buffer_pool();
   if (data_ == nullptr) {
-    data_ = std::malloc(nbytes);
+    data_ = pool.allocate(nbytes, &capacity_);
     if (data_ == nullptr) {
+      capacity_ = 0;
       return LOG_STATUS(Status::BufferError(
           "Cannot allocate buffer; Memory allocation failed"));
     }
     alloced_size_ = nbytes;
-  } else if (nbytes > alloced_size_) {
-    auto new_data = std::realloc(data_, nbytes);
+  } else if (nbytes > capacity_) {
+    uint64_t new_capacity;
+    auto new_data =
+        pool.reallocate(data_, capacity_, alloced_size_, nbytes, &new_capacity);
     if (new_data == nullptr) {
       return LOG_STATUS(Status::BufferError(
           "Cannot reallocate buffer; Memory allocation failed"));
     }
     data_ = new_data;
+    capacity_ = new_capacity;
+    alloced_size_ = nbytes;
+  } else if (nbytes > alloced_size_) {
+    // The block already has room
     alloced_size_ = nbytes;
   }
 
   return Status::Ok();
 }
 
+Status Buffer::reserve(uint64_t nbytes) {
+  // Sanity check
+  if (!owns_data_)
+    return LOG_STATUS(Status::BufferError(
+        "Cannot reserve buffer space; Buffer does not own the already stored "
+        "data"));
+
+  while (offset_ + nbytes > alloced_size_)
+    RETURN_NOT_OK(realloc(MAX(nbytes, 2 * alloced_size_)));
+
+  return Status::Ok();
+}
+
 void Buffer::reset_offset() {
   offset_ = 0;
 }
@@ -198,6 +224,7 @@ uint64_t Buffer::size() const {
 
 Status Buffer::swap(Buffer& other) {
   std::swap(alloced_size_, other.alloced_size_);
+  std::swap(capacity_, other.capacity_);
   std::swap(data_, other.data_);
   std::swap(offset_, other.offset_);
   std::swap(owns_data_, other.owns_data_);
@@ -281,7 +308,8 @@ Buffer& Buffer::operator=(const Buffer& buff) {
     data_ = buff.data_;
   } else {
     if (buff.data() != nullptr)
-      data_ = std::malloc(buff.alloced_size_);
+      data_ =
+          BufferPool::buffer_pool().allocate(buff.alloced_size_, &capacity_);
     if (data_ != nullptr) {
       std::memcpy(data_, buff.data_, buff.alloced_size_);
       alloced_size_ = buff.alloced_size_;
@@ -289,6 +317,7 @@ Buffer& Buffer::operator=(const Buffer& buff) {
       offset_ = buff.offset_;
     } else {
       alloced_size_ = 0;
+      capacity_ = 0;
       size_ = 0;
       offset_ = 0;
     }
@@ -126,6 +126,17 @@ class Buffer {
    */
   Status realloc(uint64_t nbytes);
 
+  /**
+   * Makes room for writing `nbytes` bytes at the current offset, growing
+   * the buffer the same way `write` does. This allows writing the bytes
+   * directly at `cur_data()`, followed by `advance_offset` and
+   * `set_size`.
+   *
+   * @param nbytes The number of bytes to make room for.
+   * @return Status
+   */
+  Status reserve(uint64_t nbytes);
+
   /** Resets the buffer offset to 0. */
   void reset_offset();
 
@@ -231,6 +242,13 @@ class Buffer {
   /** The allocated buffer size. */
   uint64_t alloced_size_;
 
+  /**
+   * The capacity of the memory block backing `data_`, as returned by the
+   * buffer pool. It may be larger than `alloced_size_`, in which case
+   * growing the buffer up to the capacity does not reallocate.
+   */
+  uint64_t capacity_;
+
   /** The buffer data. */
   void* data_;
 
@@ -0,0 +1,311 @@
+/**
+ * @file   buffer_pool.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class BufferPool.
+ */
+
+#include "tiledb/sm/buffer/buffer_pool.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/stats.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*             HELPERS            */
+/* ****************************** */
+
+/**
+ * There are four size classes per power of two, i.e., block capacities
+ * `4 * 2^k, 5 * 2^k, 6 * 2^k, 7 * 2^k`, which bounds the internal
+ * fragmentation to 25%. Class 0 is `constants::buffer_pool_min_block_size`.
+ */
+static const unsigned CLASSES_PER_POW2 = 4;
+
+/** Returns the floor of the base-2 logarithm of `x > 0`. */
+static unsigned floor_log2(uint64_t x) {
+  unsigned ret = 0;
+  while (x >>= 1)
+    ++ret;
+  return ret;
+}
+
+/** Returns the capacity of size class `c`. */
+static uint64_t class_capacity(int c) {
+  auto min_shift = floor_log2(constants::buffer_pool_min_block_size);
+  return (uint64_t)(CLASSES_PER_POW2 + c % CLASSES_PER_POW2)
+         << (min_shift - 2 + c / CLASSES_PER_POW2);
+}
+
+/** Returns the number of size classes. */
+static int class_num() {
+  return (int)((floor_log2(constants::buffer_pool_max_block_size) -
+                floor_log2(constants::buffer_pool_min_block_size)) *
+                   CLASSES_PER_POW2 +
+               1);
+}
+
+/**
+ * Returns the smallest size class that can fit `nbytes`, or -1 if
+ * `nbytes` is not served by the pool.
+ */
+static int fitting_class(uint64_t nbytes) {
+  if (nbytes < constants::buffer_pool_min_block_size ||
+      nbytes > constants::buffer_pool_max_block_size)
+    return -1;
+
+  auto shift = floor_log2(nbytes);
+  uint64_t step = (uint64_t)1 << (shift - 2);
+  uint64_t m = (nbytes + step - 1) / step;
+  if (m == 2 * CLASSES_PER_POW2) {
+    ++shift;
+    m = CLASSES_PER_POW2;
+  }
+  return (int)((shift - floor_log2(constants::buffer_pool_min_block_size)) *
+                   CLASSES_PER_POW2 +
+               (m - CLASSES_PER_POW2));
+}
+
+/**
+ * Set when the calling thread's cache has been destroyed (at thread exit),
+ * after which the thread uses the shared cache only.
+ */
+static thread_local bool thread_cache_destroyed = false;
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+BufferPool::BufferPool()
+    : shared_cache_size_(constants::buffer_pool_shared_cache_size)
+    , thread_cache_size_(constants::buffer_pool_thread_cache_size)
+    , epoch_(0) {
+  blocks_.resize(class_num());
+  size_ = 0;
+}
+
+BufferPool::~BufferPool() {
+  clear();
+}
+
+BufferPool::ThreadCache::ThreadCache() {
+  blocks_.resize(class_num());
+  size_ = 0;
+  epoch_ = 0;
+}
+
+BufferPool::ThreadCache::~ThreadCache() {
+  thread_cache_destroyed = true;
+  auto& pool = buffer_pool();
+  for (int c = 0; c < (int)blocks_.size(); ++c) {
+    for (auto block : blocks_[c])
+      pool.push(c, block);
+  }
+}
+
+void BufferPool::ThreadCache::clear() {
+  for (auto& blocks : blocks_) {
+    for (auto block : blocks)
+      std::free(block);
+    blocks.clear();
+  }
+  size_ = 0;
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+BufferPool& BufferPool::buffer_pool() {
+  // The pool is intentionally never destroyed, since thread caches may
+  // be handed over to it after static destruction has begun.
+  static BufferPool* pool = new BufferPool();
+  return *pool;
+}
+
+void* BufferPool::allocate(uint64_t nbytes, uint64_t* capacity) {
+  int c = fitting_class(nbytes);
+  if (c == -1) {
+    *capacity = nbytes;
+    return std::malloc(nbytes);
+  }
+
+  *capacity = class_capacity(c);
+
+  // Try the thread cache first, then the shared cache
+  auto cache = thread_cache();
+  if (cache != nullptr && !cache->blocks_[c].empty()) {
+    void* data = cache->blocks_[c].back();
+    cache->blocks_[c].pop_back();
+    cache->size_ -= *capacity;
+    STATS_COUNTER_ADD(buffer_pool_thread_cache_hits, 1);
+    return data;
+  }
+
+  void* data = pop(c);
+  if (data != nullptr) {
+    STATS_COUNTER_ADD(buffer_pool_shared_cache_hits, 1);
+    return data;
+  }
+
+  STATS_COUNTER_ADD(buffer_pool_misses, 1);
+  return std::malloc(*capacity);
+}
+
+void BufferPool::deallocate(void* data, uint64_t capacity) {
+  if (data == nullptr)
+    return;
+
+  int c = size_class(capacity);
+  if (c == -1) {
+    std::free(data);
+    return;
+  }
+
+  auto cache = thread_cache();
+  if (cache != nullptr && cache->size_ + capacity <= thread_cache_size_) {
+    cache->blocks_[c].push_back(data);
+    cache->size_ += capacity;
+    return;
+  }
+
+  push(c, data);
+}
+
+void* BufferPool::reallocate(
+    void* data,
+    uint64_t capacity,
+    uint64_t size,
+    uint64_t nbytes,
+    uint64_t* new_capacity) {
+  if (size_class(capacity) == -1 && fitting_class(nbytes) == -1) {
+    auto new_data = std::realloc(data, nbytes);
+    if (new_data != nullptr)
+      *new_capacity = nbytes;
+    return new_data;
+  }
+
+  auto new_data = allocate(nbytes, new_capacity);
+  if (new_data == nullptr)
+    return nullptr;
+  std::memcpy(new_data, data, size);
+  deallocate(data, capacity);
+  return new_data;
+}
+
+uint64_t BufferPool::cached_size() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+  return size_;
+}
+
+void BufferPool::clear() {
+  std::unique_lock<std::mutex> lck(mtx_);
+  for (auto& blocks : blocks_) {
+    for (auto block : blocks)
+      std::free(block);
+    blocks.clear();
+  }
+  size_ = 0;
+}
+
+void BufferPool::set_cache_sizes(
+    uint64_t shared_cache_size, uint64_t thread_cache_size) {
+  thread_cache_size_ = thread_cache_size;
+
+  std::unique_lock<std::mutex> lck(mtx_);
+  shared_cache_size_ = shared_cache_size;
+  for (int c = (int)blocks_.size() - 1; c >= 0 && size_ > shared_cache_size;
+       --c) {
+    auto& blocks = blocks_[c];
+    while (!blocks.empty() && size_ > shared_cache_size) {
+      std::free(blocks.back());
+      blocks.pop_back();
+      size_ -= class_capacity(c);
+    }
+  }
+}
+
+void BufferPool::trim() {
+  ++epoch_;
+  // Empties the calling thread's cache
+  thread_cache();
+  clear();
+}
+
+/* ****************************** */
+/*          PRIVATE METHODS       */
+/* ****************************** */
+
+int BufferPool::size_class(uint64_t capacity) {
+  int c = fitting_class(capacity);
+  return (c != -1 && class_capacity(c) == capacity) ? c : -1;
+}
+
+BufferPool::ThreadCache* BufferPool::thread_cache() {
+  if (thread_cache_destroyed)
+    return nullptr;
+  static thread_local ThreadCache cache;
+  auto epoch = epoch_.load(std::memory_order_relaxed);
+  if (cache.epoch_ != epoch) {
+    cache.clear();
+    cache.epoch_ = epoch;
+  }
+  return &cache;
+}
+
+void* BufferPool::pop(int c) {
+  std::unique_lock<std::mutex> lck(mtx_);
+  if (blocks_[c].empty())
+    return nullptr;
+
+  void* data = blocks_[c].back();
+  blocks_[c].pop_back();
+  size_ -= class_capacity(c);
+  return data;
+}
+
+void BufferPool::push(int c, void* data) {
+  auto capacity = class_capacity(c);
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (size_ + capacity <= shared_cache_size_) {
+      blocks_[c].push_back(data);
+      size_ += capacity;
+      return;
+    }
+  }
+
+  std::free(data);
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,215 @@
+/**
+ * @file   buffer_pool.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class BufferPool.
+ */
+
+#ifndef TILEDB_BUFFER_POOL_H
+#define TILEDB_BUFFER_POOL_H
+
+#include <atomic>
+#include <cinttypes>
+#include <mutex>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A process-wide, size-classed pool of memory blocks backing Buffer, Tile
+ * and FilterBuffer data.
+ *
+ * Requests between `constants::buffer_pool_min_block_size` and
+ * `constants::buffer_pool_max_block_size` are rounded up to one of four
+ * size classes per power of two. Released blocks of those sizes are kept
+ * in a small per-thread cache first and in a shared cache second (both
+ * bounded in bytes), so that the tile and filter buffers that are
+ * repeatedly allocated and freed during reads and writes are recycled
+ * instead of going through malloc/free. All other requests are served by
+ * malloc directly, and grown with realloc.
+ *
+ * The cache sizes default to `constants::buffer_pool_shared_cache_size`
+ * and `constants::buffer_pool_thread_cache_size` and are set once per
+ * process from `sm.buffer_pool.shared_cache_size` and
+ * `sm.buffer_pool.thread_cache_size`, by the global state initialization of
+ * the first context created.
+ *
+ * Every block handed out by the pool is a regular `std::malloc` block, so
+ * a buffer that disowns its data may still release it with `std::free`.
+ */
+class BufferPool {
+ public:
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Returns the process-wide buffer pool. */
+  static BufferPool& buffer_pool();
+
+  /**
+   * Allocates a block of at least `nbytes` bytes.
+   *
+   * @param nbytes The number of bytes requested.
+   * @param capacity Set to the actual size of the returned block, which
+   *     must be passed back to `deallocate`.
+   * @return The block, or `nullptr` if the allocation failed.
+   */
+  void* allocate(uint64_t nbytes, uint64_t* capacity);
+
+  /**
+   * Returns a block to the pool.
+   *
+   * @param data The block (may be `nullptr`).
+   * @param capacity The block capacity, as returned by `allocate`.
+   */
+  void deallocate(void* data, uint64_t capacity);
+
+  /**
+   * Grows a block to at least `nbytes` bytes, preserving its first `size`
+   * bytes. Blocks outside the size classes are grown with `std::realloc`,
+   * which may extend them in place.
+   *
+   * @param data The block to grow.
+   * @param capacity The block capacity, as returned by `allocate`.
+   * @param size The number of bytes of the block to preserve.
+   * @param nbytes The number of bytes requested.
+   * @param new_capacity Set to the capacity of the returned block.
+   * @return The grown block, or `nullptr` if the allocation failed (in
+   *     which case `data` is left untouched).
+   */
+  void* reallocate(
+      void* data,
+      uint64_t capacity,
+      uint64_t size,
+      uint64_t nbytes,
+      uint64_t* new_capacity);
+
+  /** Returns the number of bytes currently held in the shared cache. */
+  uint64_t cached_size() const;
+
+  /** Frees all blocks held in the shared cache. */
+  void clear();
+
+  /**
+   * Sets the maximum number of bytes held in the shared cache and in each
+   * per-thread cache. Cached blocks beyond the new shared size are freed.
+   */
+  void set_cache_sizes(uint64_t shared_cache_size, uint64_t thread_cache_size);
+
+  /**
+   * Frees the blocks held in the shared cache and in the calling thread's
+   * cache. The caches of other threads are freed the next time these
+   * threads use the pool.
+   */
+  void trim();
+
+ private:
+  /* ********************************* */
+  /*         TYPE DEFINITIONS          */
+  /* ********************************* */
+
+  /** The per-thread block cache. */
+  struct ThreadCache {
+    /** The cached blocks, one list per size class. */
+    std::vector<std::vector<void*>> blocks_;
+    /** The number of bytes cached. */
+    uint64_t size_;
+    /** The pool trim epoch the cached blocks belong to. */
+    uint64_t epoch_;
+
+    /** Constructor. */
+    ThreadCache();
+
+    /** Destructor. Hands the cached blocks over to the shared cache. */
+    ~ThreadCache();
+
+    /** Frees all cached blocks. */
+    void clear();
+  };
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  BufferPool();
+
+  /** Destructor. */
+  ~BufferPool();
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The shared cached blocks, one list per size class. */
+  std::vector<std::vector<void*>> blocks_;
+
+  /** Protects the shared cache. */
+  mutable std::mutex mtx_;
+
+  /** The number of bytes in the shared cache. */
+  uint64_t size_;
+
+  /** The maximum number of bytes in the shared cache. */
+  std::atomic<uint64_t> shared_cache_size_;
+
+  /** The maximum number of bytes in each per-thread cache. */
+  std::atomic<uint64_t> thread_cache_size_;
+
+  /** Incremented by `trim`, to invalidate the per-thread caches. */
+  std::atomic<uint64_t> epoch_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Returns the size class index of a block capacity, or -1 if the
+   * capacity does not correspond to a size class.
+   */
+  static int size_class(uint64_t capacity);
+
+  /**
+   * Returns the calling thread's cache, or `nullptr` if it has already
+   * been destroyed because the thread is exiting. The cache is emptied
+   * first if the pool has been trimmed since it was last used.
+   */
+  ThreadCache* thread_cache();
+
+  /** Pops a cached block of size class `c` from the shared cache. */
+  void* pop(int c);
+
+  /** Pushes a block of size class `c` to the shared cache (or frees it). */
+  void push(int c, void* data);
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_BUFFER_POOL_H
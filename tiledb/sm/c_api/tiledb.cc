@@ -183,6 +183,17 @@ static bool save_error(tiledb_ctx_t* ctx, const tiledb::sm::Status& st) {
   return true;
 }
 
+/**
+ * Returns the return code of the last error saved in the context, which is
+ * `TILEDB_CHECKSUM_ERR` for corrupted data and `TILEDB_ERR` otherwise.
+ */
+static int32_t last_error_code(tiledb_ctx_t* ctx) {
+  return ctx->ctx_->last_error().code() ==
+                 tiledb::sm::StatusCode::ChecksumError ?
+             TILEDB_CHECKSUM_ERR :
+             TILEDB_ERR;
+}
+
 static bool create_error(tiledb_error_t** error, const tiledb::sm::Status& st) {
   if (st.ok())
     return false;
@@ -899,6 +910,39 @@ int32_t tiledb_filter_get_option(
   return TILEDB_OK;
 }
 
+int32_t tiledb_filter_train_zstd_dictionary(
+    tiledb_ctx_t* ctx,
+    tiledb_filter_t* filter,
+    const void* samples,
+    const uint64_t* sample_sizes,
+    uint32_t sample_num,
+    uint64_t dict_capacity) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, filter) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (filter->filter_->type() != tiledb::sm::FilterType::FILTER_ZSTD ||
+      sample_sizes == nullptr) {
+    auto st = tiledb::sm::Status::Error(
+        "Cannot train dictionary; Invalid filter type or samples");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+
+  auto compression_filter =
+      static_cast<tiledb::sm::CompressionFilter*>(filter->filter_);
+  std::vector<uint64_t> sizes(sample_sizes, sample_sizes + sample_num);
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          compression_filter->train_zstd_dictionary(
+              samples, sizes, dict_capacity)))
+    return TILEDB_ERR;
+
+  // Success
+  return TILEDB_OK;
+}
+
 /* ********************************* */
 /*            FILTER LIST            */
 /* ********************************* */
@@ -2273,7 +2317,7 @@ int32_t tiledb_query_submit(tiledb_ctx_t* ctx, tiledb_query_t* query) {
     return TILEDB_ERR;
 
   if (SAVE_ERROR_CATCH(ctx, query->query_->submit()))
-    return TILEDB_ERR;
+    return last_error_code(ctx);
 
   return TILEDB_OK;
 }
@@ -2633,6 +2677,34 @@ int32_t tiledb_array_consolidate_with_key(
   return TILEDB_OK;
 }
 
+int32_t tiledb_array_consolidate_metadata(
+    tiledb_ctx_t* ctx, const char* array_uri) {
+  return tiledb_array_consolidate_metadata_with_key(
+      ctx, array_uri, TILEDB_NO_ENCRYPTION, nullptr, 0);
+}
+
+int32_t tiledb_array_consolidate_metadata_with_key(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    tiledb_encryption_type_t encryption_type,
+    const void* encryption_key,
+    uint32_t key_length) {
+  // Sanity checks
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          ctx->ctx_->storage_manager()->array_consolidate_metadata(
+              array_uri,
+              static_cast<tiledb::sm::EncryptionType>(encryption_type),
+              encryption_key,
+              key_length)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 int32_t tiledb_array_get_non_empty_domain(
     tiledb_ctx_t* ctx, tiledb_array_t* array, void* domain, int32_t* is_empty) {
   if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, array) == TILEDB_ERR)
@@ -2911,6 +2983,19 @@ int32_t tiledb_kv_schema_set_capacity(
   return TILEDB_OK;
 }
 
+int32_t tiledb_kv_schema_set_hash(
+    tiledb_ctx_t* ctx, tiledb_kv_schema_t* kv_schema, tiledb_kv_hash_t hash) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, kv_schema) == TILEDB_ERR)
+    return TILEDB_ERR;
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          kv_schema->array_schema_->set_kv_hash(
+              static_cast<tiledb::sm::KVHash>(hash))))
+    return TILEDB_ERR;
+  return TILEDB_OK;
+}
+
 int32_t tiledb_kv_schema_check(
     tiledb_ctx_t* ctx, tiledb_kv_schema_t* kv_schema) {
   if (sanity_check(ctx) == TILEDB_ERR ||
@@ -2987,6 +3072,17 @@ int32_t tiledb_kv_schema_get_capacity(
   return TILEDB_OK;
 }
 
+int32_t tiledb_kv_schema_get_hash(
+    tiledb_ctx_t* ctx,
+    const tiledb_kv_schema_t* kv_schema,
+    tiledb_kv_hash_t* hash) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, kv_schema) == TILEDB_ERR)
+    return TILEDB_ERR;
+  *hash = static_cast<tiledb_kv_hash_t>(kv_schema->array_schema_->kv_hash());
+  return TILEDB_OK;
+}
+
 int32_t tiledb_kv_schema_get_attribute_num(
     tiledb_ctx_t* ctx,
     const tiledb_kv_schema_t* kv_schema,
@@ -3297,7 +3393,7 @@ int32_t tiledb_kv_get_item(
               static_cast<tiledb::sm::Datatype>(key_type),
               key_size,
               &((*kv_item)->kv_item_))))
-    return TILEDB_ERR;
+    return last_error_code(ctx);
 
   // Handle case where item does not exist
   if ((*kv_item)->kv_item_ == nullptr) {
@@ -3309,6 +3405,57 @@ int32_t tiledb_kv_get_item(
   return TILEDB_OK;
 }
 
+int32_t tiledb_kv_get_items(
+    tiledb_ctx_t* ctx,
+    tiledb_kv_t* kv,
+    const void** keys,
+    const tiledb_datatype_t* key_types,
+    const uint64_t* key_sizes,
+    uint64_t key_num,
+    tiledb_kv_item_t** kv_items) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Get the items from the key-value store
+  std::vector<const void*> key_vec(keys, keys + key_num);
+  std::vector<tiledb::sm::Datatype> key_type_vec(key_num);
+  for (uint64_t i = 0; i < key_num; ++i)
+    key_type_vec[i] = static_cast<tiledb::sm::Datatype>(key_types[i]);
+  std::vector<uint64_t> key_size_vec(key_sizes, key_sizes + key_num);
+  std::vector<tiledb::sm::KVItem*> items;
+  if (SAVE_ERROR_CATCH(
+          ctx, kv->kv_->get_items(key_vec, key_type_vec, key_size_vec, &items)))
+    return last_error_code(ctx);
+
+  // Create the key-value item structs
+  for (uint64_t i = 0; i < key_num; ++i) {
+    kv_items[i] = nullptr;
+    if (items[i] == nullptr)
+      continue;
+    kv_items[i] = new (std::nothrow) tiledb_kv_item_t;
+    if (kv_items[i] == nullptr) {
+      for (uint64_t j = 0; j < i; ++j) {
+        if (kv_items[j] != nullptr) {
+          delete kv_items[j]->kv_item_;
+          delete kv_items[j];
+          kv_items[j] = nullptr;
+        }
+      }
+      for (uint64_t j = i; j < key_num; ++j)
+        delete items[j];
+      tiledb::sm::Status st = tiledb::sm::Status::Error(
+          "Failed to allocate TileDB key-value item object");
+      LOG_STATUS(st);
+      save_error(ctx, st);
+      return TILEDB_OOM;
+    }
+    kv_items[i]->kv_item_ = items[i];
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
 int32_t tiledb_kv_has_key(
     tiledb_ctx_t* ctx,
     tiledb_kv_t* kv,
@@ -3328,7 +3475,7 @@ int32_t tiledb_kv_has_key(
               static_cast<tiledb::sm::Datatype>(key_type),
               key_size,
               &has_key_b)))
-    return TILEDB_ERR;
+    return last_error_code(ctx);
 
   *has_key = (int32_t)has_key_b;
 
@@ -3693,7 +3840,7 @@ int32_t tiledb_kv_iter_alloc(
   if (SAVE_ERROR_CATCH(ctx, (*kv_iter)->kv_iter_->init(kv->kv_))) {
     delete (*kv_iter)->kv_iter_;
     delete (*kv_iter);
-    return TILEDB_ERR;
+    return last_error_code(ctx);
   }
 
   // Success
@@ -3738,7 +3885,7 @@ int32_t tiledb_kv_iter_next(tiledb_ctx_t* ctx, tiledb_kv_iter_t* kv_iter) {
     return TILEDB_ERR;
 
   if (SAVE_ERROR_CATCH(ctx, kv_iter->kv_iter_->next()))
-    return TILEDB_ERR;
+    return last_error_code(ctx);
 
   return TILEDB_OK;
 }
@@ -3760,7 +3907,7 @@ int32_t tiledb_kv_iter_reset(tiledb_ctx_t* ctx, tiledb_kv_iter_t* kv_iter) {
     return TILEDB_ERR;
 
   if (SAVE_ERROR_CATCH(ctx, kv_iter->kv_iter_->reset()))
-    return TILEDB_ERR;
+    return last_error_code(ctx);
 
   return TILEDB_OK;
 }
@@ -134,6 +134,14 @@ typedef enum {
 #undef TILEDB_ENCRYPTION_TYPE_ENUM
 } tiledb_encryption_type_t;
 
+/** Key-value store key hash. */
+typedef enum {
+/** Helper macro for defining key-value hash enums. */
+#define TILEDB_KV_HASH_ENUM(id) TILEDB_##id
+#include "tiledb_enum.h"
+#undef TILEDB_KV_HASH_ENUM
+} tiledb_kv_hash_t;
+
 /** Compression type. */
 typedef enum {
 /** Helper macro for defining compressor enums. */
@@ -172,6 +180,8 @@ typedef enum {
 #define TILEDB_ERR (-1)
 /** Out of memory */
 #define TILEDB_OOM (-2)
+/** Corrupted data, detected by a checksum filter */
+#define TILEDB_CHECKSUM_ERR (-3)
 /**@}*/
 
 /** Returns a special name indicating the coordinates attribute. */
@@ -389,6 +399,71 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  * - `sm.tile_cache_size` <br>
  *    The tile cache size in bytes. Any `uint64_t` value is acceptable. <br>
  *    **Default**: 10,000,000
+ * - `sm.memory_budget` <br>
+ *    The total number of bytes that the queries, the tile cache and the
+ *    filter pipelines of a context may hold in memory at any time.
+ *    Reads split their subarray partitions and writes queue until they
+ *    fit in the budget. Zero means unlimited. <br>
+ *    **Default**: 5,000,000,000
+ * - `sm.buffer_pool.shared_cache_size` <br>
+ *    The maximum number of bytes of released tile and filter buffers that
+ *    the process-wide buffer pool keeps for reuse across threads. The pool
+ *    is shared by all contexts of the process, and is sized by the first
+ *    context created. <br>
+ *    **Default**: 268,435,456
+ * - `sm.buffer_pool.thread_cache_size` <br>
+ *    The maximum number of bytes of released buffers that the buffer pool
+ *    keeps for reuse in each thread. Like the shared cache size, it is set
+ *    by the first context created. <br>
+ *    **Default**: 33,554,432
+ * - `sm.consolidation.step_min_frags` <br>
+ *    The minimum number of fragments that a consolidation step merges.
+ *    If no run of at least this many fragments qualifies, consolidation
+ *    is a no-op. <br>
+ *    **Default**: 2
+ * - `sm.consolidation.step_max_frags` <br>
+ *    The maximum number of fragments that a consolidation step merges
+ *    (i.e., the consolidation fan-in). <br>
+ *    **Default**: 4294967295
+ * - `sm.consolidation.step_size_ratio` <br>
+ *    Two adjacent fragments are merged in the same consolidation step only
+ *    if the size of the smaller one divided by the size of the larger one
+ *    is at least this ratio. A value in `[0.0, 1.0]`, where `0.0` merges
+ *    fragments of any size and values close to `1.0` merge only fragments
+ *    of similar size. <br>
+ *    **Default**: 0.0
+ * - `sm.consolidation.step_max_bytes` <br>
+ *    The maximum total size in bytes of the fragments that a consolidation
+ *    step merges. Zero means unlimited. <br>
+ *    **Default**: 0
+ * - `sm.consolidation.num_threads` <br>
+ *    The maximum number of subarray partitions that consolidation reads
+ *    concurrently. The partitions are slabs of space tiles. The buffers of
+ *    all partitions are bounded by half of `sm.memory_budget`. <br>
+ *    **Default**: number of cores
+ * - `sm.consolidation.background` <br>
+ *    If `true`, a background service consolidates the unencrypted arrays
+ *    opened through the context whenever they cross the
+ *    `sm.consolidation.background_*` thresholds. <br>
+ *    **Default**: false
+ * - `sm.consolidation.background_interval_ms` <br>
+ *    The period in milliseconds at which the background consolidation
+ *    service checks the watched arrays. <br>
+ *    **Default**: 1000
+ * - `sm.consolidation.background_frag_num` <br>
+ *    The background consolidation service consolidates an array once it
+ *    has at least this many fragments. <br>
+ *    **Default**: 8
+ * - `sm.consolidation.background_frag_bytes` <br>
+ *    The background consolidation service consolidates an array once the
+ *    total size in bytes of its fragments, excluding the largest one,
+ *    reaches this value. Zero disables the size threshold. <br>
+ *    **Default**: 0
+ * - `sm.consolidation.background_latency_ms` <br>
+ *    The target latency in milliseconds of the foreground queries. While
+ *    the recent foreground query latency exceeds it, background
+ *    consolidation pauses between its writes. Zero disables throttling. <br>
+ *    **Default**: 0
  * - `sm.array_schema_cache_size` <br>
  *    The array schema cache size in bytes. Any `uint64_t` value is acceptable.
  * <br>
@@ -396,6 +471,39 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  * - `sm.fragment_metadata_cache_size` <br>
  *    The fragment metadata cache size in bytes. Any `uint64_t` value is
  *    acceptable. <br>
+ * - `sm.fragment_manifest` <br>
+ *    If `true`, writers record the fragments they create and consolidation
+ *    removes in the array fragment manifest, and opening or reopening an
+ *    array reads the new manifest entries instead of listing the array
+ *    directory. All the writers of an array must set it consistently.
+ *    Local writers serialize their manifest updates with a lock file. S3
+ *    and HDFS have no file locks, so only one process may write to the
+ *    array at a time there. <br>
+ *    **Default**: false
+ * - `sm.kv.wal` <br>
+ *    If `true`, every item added to a key-value store is first appended to a
+ *    write-ahead log in the key-value directory, so that unflushed items
+ *    survive a process crash. Opening the key-value store for writes flushes
+ *    the items left in each log as a fragment stamped with the time of its last
+ *    item, and opening it for reads serves them from memory before the
+ *    persisted fragments, unless a newer fragment was written since. Each
+ *    writer locks its own log, so that only the logs of crashed writers are
+ *    flushed. The log is only supported on local filesystems, and not for
+ *    encrypted key-value stores. <br>
+ *    **Default**: false
+ * - `sm.kv.wal_sync` <br>
+ *    If `true`, every write-ahead log append is synced to persistent
+ *    storage before the item is added, so that added items also survive
+ *    an operating system crash or power loss. If `false`, the appends are
+ *    left to the operating system to write back, which is faster but only
+ *    protects against process crashes. <br>
+ *    **Default**: true
+ * - `sm.kv.flush_threshold` <br>
+ *    The size in bytes of the buffered key-value items that triggers a
+ *    flush in the background. Writers keep adding items while the flush is
+ *    in progress, and block only if a second flush becomes due before the
+ *    first one completes. If `0`, items are flushed only explicitly. <br>
+ *    **Default**: 0
  * - `sm.enable_signal_handlers` <br>
  *    Determines whether or not TileDB will install signal handlers. <br>
  *    **Default**: true
@@ -989,6 +1097,43 @@ TILEDB_EXPORT int32_t tiledb_filter_get_option(
     tiledb_filter_option_t option,
     void* value);
 
+/**
+ * Trains a dictionary for a zstd filter on the given samples. The dictionary
+ * is stored with the filter, and compresses every tile chunk the filter
+ * processes. This improves the compression of small chunks of repetitive
+ * data, such as strings or JSON documents.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_filter_t* filter;
+ * tiledb_filter_alloc(ctx, TILEDB_FILTER_ZSTD, &filter);
+ * // `samples` holds `sample_num` concatenated samples of typical data
+ * tiledb_filter_train_zstd_dictionary(
+ *     ctx, filter, samples, sample_sizes, sample_num, 16384);
+ * tiledb_filter_free(&filter);
+ * @endcode
+ *
+ * @note The dictionary is prepared for the compression level set on the
+ * filter. Zstd needs a fair amount of samples to train a dictionary, and
+ * returns an error otherwise.
+ *
+ * @param ctx TileDB context.
+ * @param filter The target filter, of type `TILEDB_FILTER_ZSTD`.
+ * @param samples The concatenated samples.
+ * @param sample_sizes The size of each sample.
+ * @param sample_num The number of samples.
+ * @param dict_capacity The maximum dictionary size in bytes.
+ * @return `TILEDB_OK` for success or `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_filter_train_zstd_dictionary(
+    tiledb_ctx_t* ctx,
+    tiledb_filter_t* filter,
+    const void* samples,
+    const uint64_t* sample_sizes,
+    uint32_t sample_num,
+    uint64_t dict_capacity);
+
 /* ********************************* */
 /*            FILTER LIST            */
 /* ********************************* */
@@ -2581,7 +2726,8 @@ TILEDB_EXPORT void tiledb_query_free(tiledb_query_t** query);
  *
  * @param ctx The TileDB context.
  * @param query The query to be submitted.
- * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ * @return `TILEDB_OK` for success, `TILEDB_CHECKSUM_ERR` if a checksum
+ *     filter detected corrupted data, and `TILEDB_ERR` for other errors.
  *
  * @note `tiledb_query_finalize` must be invoked after finish writing in
  *     global layout (via repeated invocations of `tiledb_query_submit`),
@@ -3087,6 +3233,55 @@ TILEDB_EXPORT int32_t tiledb_array_consolidate_with_key(
     const void* encryption_key,
     uint32_t key_length);
 
+/**
+ * Consolidates the metadata of all the fragments of an array into a single
+ * file in the array directory. Subsequent array opens read the metadata of
+ * the covered fragments from this file, instead of one file per fragment.
+ * Fragments written after the consolidation are still loaded individually,
+ * until the metadata are consolidated again.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_array_consolidate_metadata(ctx, "s3://tiledb_bucket/my_array");
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array_uri The name of the TileDB array whose metadata will be
+ *     consolidated.
+ * @return `TILEDB_OK` on success, and `TILEDB_ERR` on error.
+ */
+TILEDB_EXPORT int32_t
+tiledb_array_consolidate_metadata(tiledb_ctx_t* ctx, const char* array_uri);
+
+/**
+ * Consolidates the metadata of all the fragments of an encrypted array into
+ * a single file in the array directory.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * uint8_t key[32] = ...;
+ * tiledb_array_consolidate_metadata_with_key(
+ *     ctx, "s3://tiledb_bucket/my_array", TILEDB_AES_256_GCM, key,
+ *     sizeof(key));
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array_uri The name of the TileDB array whose metadata will be
+ *     consolidated.
+ * @param encryption_type The encryption type to use.
+ * @param encryption_key The encryption key to use.
+ * @param key_length Length in bytes of the encryption key.
+ * @return `TILEDB_OK` on success, and `TILEDB_ERR` on error.
+ */
+TILEDB_EXPORT int32_t tiledb_array_consolidate_metadata_with_key(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    tiledb_encryption_type_t encryption_type,
+    const void* encryption_key,
+    uint32_t key_length);
+
 /**
  * Retrieves the non-empty domain from an array. This is the union of the
  * non-empty domains of the array fragments.
@@ -3374,6 +3569,26 @@ TILEDB_EXPORT int32_t tiledb_kv_schema_add_attribute(
 TILEDB_EXPORT int32_t tiledb_kv_schema_set_capacity(
     tiledb_ctx_t* ctx, tiledb_kv_schema_t* kv_schema, uint64_t capacity);
 
+/**
+ * Sets the hash function of the keys. The default is `TILEDB_KV_HASH_MD5`.
+ * `TILEDB_KV_HASH_MURMUR3_128` is considerably faster, but it is not
+ * cryptographic. The hash function is persisted in the schema, so it
+ * cannot change after the key-value store is created.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_kv_schema_set_hash(ctx, kv_schema, TILEDB_KV_HASH_MURMUR3_128);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param kv_schema The kv schema.
+ * @param hash The hash function to be set.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_kv_schema_set_hash(
+    tiledb_ctx_t* ctx, tiledb_kv_schema_t* kv_schema, tiledb_kv_hash_t hash);
+
 /**
  * Checks the correctness of the key-value schema.
  *
@@ -3461,6 +3676,26 @@ TILEDB_EXPORT int32_t tiledb_kv_schema_load_with_key(
 TILEDB_EXPORT int32_t tiledb_kv_schema_get_capacity(
     tiledb_ctx_t* ctx, const tiledb_kv_schema_t* kv_schema, uint64_t* capacity);
 
+/**
+ * Retrieves the hash function of the keys.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_kv_hash_t hash;
+ * tiledb_kv_schema_get_hash(ctx, kv_schema, &hash);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param kv_schema The kv schema.
+ * @param hash The hash function to be retrieved.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_kv_schema_get_hash(
+    tiledb_ctx_t* ctx,
+    const tiledb_kv_schema_t* kv_schema,
+    tiledb_kv_hash_t* hash);
+
 /**
  * Retrieves the number of array attributes.
  *
@@ -4094,7 +4329,8 @@ TILEDB_EXPORT int32_t tiledb_kv_flush(tiledb_ctx_t* ctx, tiledb_kv_t* kv);
  * @param key_type The key type.
  * @param key_size The key size.
  * @param kv_item The key-value item to be retrieved.
- * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ * @return `TILEDB_OK` for success, `TILEDB_CHECKSUM_ERR` if a checksum
+ *     filter detected corrupted data, and `TILEDB_ERR` for other errors.
  */
 TILEDB_EXPORT int32_t tiledb_kv_get_item(
     tiledb_ctx_t* ctx,
@@ -4104,6 +4340,42 @@ TILEDB_EXPORT int32_t tiledb_kv_get_item(
     uint64_t key_size,
     tiledb_kv_item_t** kv_item);
 
+/**
+ * Retrieves the key-value items of multiple keys in a single batch. The keys
+ * are grouped by the data tiles that may contain them, so that each tile is
+ * read and unfiltered once for all its keys. `kv_items[i]` is set to the item
+ * of `keys[i]`, or to `NULL` if the key does not exist.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * const void* keys[] = {"key_1", "key_2"};
+ * tiledb_datatype_t key_types[] = {TILEDB_CHAR, TILEDB_CHAR};
+ * uint64_t key_sizes[] = {strlen("key_1"), strlen("key_2")};
+ * tiledb_kv_item_t* kv_items[2];
+ * tiledb_kv_get_items(ctx, kv, keys, key_types, key_sizes, 2, kv_items);
+ * // Make sure to delete the non-NULL kv items in the end
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param kv The key-value store.
+ * @param keys The keys.
+ * @param key_types The key types.
+ * @param key_sizes The key sizes.
+ * @param key_num The number of keys.
+ * @param kv_items An array of `key_num` key-value items to be retrieved.
+ * @return `TILEDB_OK` for success, `TILEDB_CHECKSUM_ERR` if a checksum
+ *     filter detected corrupted data, and `TILEDB_ERR` for other errors.
+ */
+TILEDB_EXPORT int32_t tiledb_kv_get_items(
+    tiledb_ctx_t* ctx,
+    tiledb_kv_t* kv,
+    const void** keys,
+    const tiledb_datatype_t* key_types,
+    const uint64_t* key_sizes,
+    uint64_t key_num,
+    tiledb_kv_item_t** kv_items);
+
 /**
  * Checks if a key exists in the key-value store.
  *
@@ -4113,7 +4385,8 @@ TILEDB_EXPORT int32_t tiledb_kv_get_item(
  * @param key_type The key type.
  * @param key_size The key size.
  * @param has_key Set to `1` if the key exists and `0` otherwise.
- * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ * @return `TILEDB_OK` for success, `TILEDB_CHECKSUM_ERR` if a checksum
+ *     filter detected corrupted data, and `TILEDB_ERR` for other errors.
  */
 TILEDB_EXPORT int32_t tiledb_kv_has_key(
     tiledb_ctx_t* ctx,
@@ -4144,7 +4417,9 @@ TILEDB_EXPORT int32_t tiledb_kv_has_key(
  * @param ctx The TileDB context.
  * @param kv The kv the iterator is associated with.
  * @param kv_iter The kv iterator to be created.
- * @return `TILEDB_OK` for success and `TILEDB_OOM` or `TILEDB_ERR` for error.
+ * @return `TILEDB_OK` for success, `TILEDB_CHECKSUM_ERR` if a checksum
+ *     filter detected corrupted data, and `TILEDB_OOM` or `TILEDB_ERR` for
+ *     other errors.
  */
 TILEDB_EXPORT int32_t tiledb_kv_iter_alloc(
     tiledb_ctx_t* ctx, tiledb_kv_t* kv, tiledb_kv_iter_t** kv_iter);
@@ -4193,7 +4468,8 @@ TILEDB_EXPORT int32_t tiledb_kv_iter_here(
  *
  * @param ctx The TileDB context.
  * @param kv_iter The key-value store iterator.
- * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ * @return `TILEDB_OK` for success, `TILEDB_CHECKSUM_ERR` if a checksum
+ *     filter detected corrupted data, and `TILEDB_ERR` for other errors.
  */
 TILEDB_EXPORT int32_t
 tiledb_kv_iter_next(tiledb_ctx_t* ctx, tiledb_kv_iter_t* kv_iter);
@@ -4227,7 +4503,8 @@ TILEDB_EXPORT int32_t tiledb_kv_iter_done(
  *
  * @param ctx The TileDB context.
  * @param kv_iter The key-value store iterator to be reset.
- * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ * @return `TILEDB_OK` for success, `TILEDB_CHECKSUM_ERR` if a checksum
+ *     filter detected corrupted data, and `TILEDB_ERR` for other errors.
  */
 TILEDB_EXPORT int32_t
 tiledb_kv_iter_reset(tiledb_ctx_t* ctx, tiledb_kv_iter_t* kv_iter);
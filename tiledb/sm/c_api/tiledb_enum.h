@@ -177,6 +177,18 @@
     TILEDB_FILTER_TYPE_ENUM(FILTER_BYTESHUFFLE) = 15,
     /** Positive-delta encoding filter. */
     TILEDB_FILTER_TYPE_ENUM(FILTER_POSITIVE_DELTA) = 16,
+    /** Dictionary encoding filter (fixed-sized attributes only). */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_DICTIONARY) = 18,
+    /** XOR floating-point encoding filter. */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_XOR) = 19,
+    /** Frame-of-reference and bit packing filter. */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_BIT_PACKING) = 20,
+    /** Filter choosing the encoding of every tile chunk. */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_AUTO) = 21,
+    /** CRC32C checksum filter. */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_CHECKSUM_CRC32C) = 22,
+    /** xxHash64 checksum filter. */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_CHECKSUM_XXHASH64) = 23,
 #endif
 
 #ifdef TILEDB_FILTER_OPTION_ENUM
@@ -186,6 +198,10 @@
     TILEDB_FILTER_OPTION_ENUM(BIT_WIDTH_MAX_WINDOW) = 1,
     /** Max window length for positive-delta encoding. Type: `uint32_t`. */
     TILEDB_FILTER_OPTION_ENUM(POSITIVE_DELTA_MAX_WINDOW) = 2,
+    /** Split XORed values into byte planes. Type: `uint32_t`. */
+    TILEDB_FILTER_OPTION_ENUM(XOR_BYTE_PLANES) = 3,
+    /** Delta-encode before bit packing. Type: `uint32_t`. */
+    TILEDB_FILTER_OPTION_ENUM(BIT_PACKING_DELTA) = 4,
 #endif
 
 #ifdef TILEDB_ENCRYPTION_TYPE_ENUM
@@ -195,6 +211,13 @@
     TILEDB_ENCRYPTION_TYPE_ENUM(AES_256_GCM) = 1,
 #endif
 
+#ifdef TILEDB_KV_HASH_ENUM
+    /** MD5 */
+    TILEDB_KV_HASH_ENUM(KV_HASH_MD5) = 0,
+    /** 128-bit x64 MurmurHash3 */
+    TILEDB_KV_HASH_ENUM(KV_HASH_MURMUR3_128) = 1,
+#endif
+
 #ifdef TILEDB_QUERY_STATUS_ENUM
     /** Query failed */
     TILEDB_QUERY_STATUS_ENUM(FAILED) = 0,
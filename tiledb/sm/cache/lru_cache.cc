@@ -92,7 +92,17 @@ Status LRUCache::insert(
   bool exists = item_it != item_map_.end();
 
   if (exists && !overwrite) {
-    std::free(object);
+    // Dispose of the rejected object the same way as an evicted one, so
+    // that any bookkeeping in the evict callback stays balanced
+    if (evict_callback_ == nullptr) {
+      std::free(object);
+    } else {
+      LRUCacheItem rejected;
+      rejected.key_ = key;
+      rejected.object_ = object;
+      rejected.size_ = size;
+      (*evict_callback_)(&rejected, evict_callback_data_);
+    }
     return Status::Ok();
   }
 
@@ -109,6 +119,7 @@ Status LRUCache::insert(
       std::free(item.object_);
     else
       (*evict_callback_)(&item, evict_callback_data_);
+    size_ -= item.size_;
     item.object_ = object;
     item.size_ = size;
 
@@ -34,6 +34,8 @@
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/stats.h"
 
+#include <cstring>
+
 /* ****************************** */
 /*             MACROS             */
 /* ****************************** */
@@ -187,21 +189,13 @@ Status DoubleDelta::compress(ConstBuffer* input_buffer, Buffer* output_buffer) {
   if (num == 2)
     return Status::Ok();
 
-  // Write double deltas
-  int64_t prev_delta = int64_t(in[1]) - int64_t(in[0]);
-  int bit_in_chunk = 63;  // Leftmost bit (MSB)
-  uint64_t chunk = 0;
-  for (uint64_t i = 2; i < num; ++i) {
-    int64_t cur_delta = int64_t(in[i]) - int64_t(in[i - 1]);
-    int64_t dd = cur_delta - prev_delta;
-    RETURN_NOT_OK(
-        write_double_delta(output_buffer, dd, bitsize, &chunk, &bit_in_chunk));
-    prev_delta = cur_delta;
-  }
-
-  // Write whatever is left in the chunk
-  if (bit_in_chunk < 63)
-    RETURN_NOT_OK(output_buffer->write(&chunk, sizeof(uint64_t)));
+  // Write double deltas directly to the output, in whole 64-bit chunks
+  uint64_t chunk_num = ((num - 2) * (bitsize + 1) + 63) / 64;
+  RETURN_NOT_OK(output_buffer->reserve(chunk_num * sizeof(uint64_t)));
+  write_double_deltas(
+      in, num, bitsize, static_cast<unsigned char*>(output_buffer->cur_data()));
+  output_buffer->advance_offset(chunk_num * sizeof(uint64_t));
+  output_buffer->set_size(output_buffer->offset());
 
   return Status::Ok();
 }
@@ -250,12 +244,14 @@ Status DoubleDelta::decompress(
   RETURN_NOT_OK(input_buffer->read(&bitsize_c, sizeof(uint8_t)));
   RETURN_NOT_OK(input_buffer->read(&num, sizeof(uint64_t)));
   auto bitsize = static_cast<unsigned int>(bitsize_c);
-  auto out = (T*)output_buffer->cur_data();
 
   // Trivial case - no compression
   if (bitsize >= sizeof(T) * 8 - 1) {
+    uint64_t nbytes = input_buffer->nbytes_left_to_read();
     RETURN_NOT_OK(output_buffer->write(
-        input_buffer, input_buffer->nbytes_left_to_read()));
+        static_cast<const char*>(input_buffer->data()) + input_buffer->offset(),
+        nbytes));
+    input_buffer->advance_offset(nbytes);
     return Status::Ok();
   }
 
@@ -272,117 +268,118 @@ Status DoubleDelta::decompress(
   if (num == 2)
     return Status::Ok();
 
-  // Read first chunk
-  uint64_t chunk;
-  RETURN_NOT_OK(input_buffer->read(&chunk, sizeof(uint64_t)));
-  int bit_in_chunk = 63;  // Leftmost bit (MSB)
+  // Check that the input holds all the chunks and that the values fit in
+  // the output, so that the rest of the values are decoded in place
+  uint64_t chunk_num = ((num - 2) * (bitsize + 1) + 63) / 64;
+  if (input_buffer->nbytes_left_to_read() < chunk_num * sizeof(uint64_t))
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot decompress with DoubleDelta; Input buffer too small"));
+  if (output_buffer->free_space() < (num - 2) * value_size)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot decompress with DoubleDelta; Output buffer too small"));
 
   // Decompress rest of the values
-  int64_t dd;
-  for (uint64_t i = 2; i < num; ++i) {
-    RETURN_NOT_OK(
-        read_double_delta(input_buffer, &dd, bitsize, &chunk, &bit_in_chunk));
-    value = (T)(dd + 2 * (int64_t)out[i - 1] - (int64_t)out[i - 2]);
-    RETURN_NOT_OK(output_buffer->write(&value, value_size));
-  }
+  auto out = static_cast<unsigned char*>(output_buffer->cur_data()) -
+             2 * value_size;
+  read_double_deltas<T>(
+      static_cast<const unsigned char*>(input_buffer->data()) +
+          input_buffer->offset(),
+      num,
+      bitsize,
+      out);
+  input_buffer->advance_offset(chunk_num * sizeof(uint64_t));
+  output_buffer->advance_offset((num - 2) * value_size);
 
   return Status::Ok();
 }
 
-Status DoubleDelta::read_double_delta(
-    ConstBuffer* buff,
-    int64_t* double_delta,
-    int bitsize,
-    uint64_t* chunk,
-    int* bit_in_chunk) {
-  // Read sign
-  uint64_t to_and = 1;
-  to_and <<= (*bit_in_chunk);
-  int sign = (((*chunk) & to_and) == 0) ? 1 : -1;
-  --(*bit_in_chunk);
-
-  // Read chunk and reset
-  if (*bit_in_chunk < 0) {
-    RETURN_NOT_OK(buff->read(chunk, sizeof(uint64_t)));
-    *bit_in_chunk = 63;
-  }
-
-  // Read double delta
-  int bits_left_to_read = bitsize;
-  int bits_to_read_from_chunk = MIN(*bit_in_chunk + 1, bits_left_to_read);
-  uint64_t tmp_chunk;
-  int bit_in_dd = bitsize - 1;
-  *double_delta = 0;
-  while (bits_left_to_read > 0) {
-    // Read from chunk
-    if (bits_to_read_from_chunk > 0) {
-      tmp_chunk = (((*chunk) << (63 - *bit_in_chunk)) >> (63 - bit_in_dd));
-      (*double_delta) |= tmp_chunk;
-      bit_in_dd -= bits_to_read_from_chunk;
-      (*bit_in_chunk) -= bits_to_read_from_chunk;
-      bits_left_to_read -= bits_to_read_from_chunk;
+template <class T>
+void DoubleDelta::read_double_deltas(
+    const unsigned char* in,
+    uint64_t num,
+    unsigned int bitsize,
+    unsigned char* out) {
+  // The values and chunks are accessed with `memcpy`, as the buffers may be
+  // unaligned
+  T prev_prev, prev;
+  std::memcpy(&prev_prev, out, sizeof(T));
+  std::memcpy(&prev, out + sizeof(T), sizeof(T));
+
+  // Each double delta is a sign bit followed by its absolute value, stored
+  // from the most significant bit of the chunks
+  const unsigned int width = bitsize + 1;
+  const uint64_t mask = (uint64_t(1) << bitsize) - 1;
+  uint64_t chunk = 0;
+  unsigned int avail = 0;
+  for (uint64_t i = 2; i < num; ++i) {
+    if (avail == 0) {
+      std::memcpy(&chunk, in, sizeof(uint64_t));
+      in += sizeof(uint64_t);
+      avail = 64;
     }
 
-    // Read chunk and reset
-    if (*bit_in_chunk < 0 && buff->offset() != buff->size()) {
-      RETURN_NOT_OK(buff->read(chunk, sizeof(uint64_t)));
-      *bit_in_chunk = 63;
-      bits_to_read_from_chunk = MIN(*bit_in_chunk + 1, bits_left_to_read);
+    uint64_t field;
+    if (width <= avail) {
+      field = (chunk << (64 - avail)) >> (64 - width);
+      avail -= width;
+    } else {
+      // The double delta spans two chunks
+      unsigned int need = width - avail;
+      field = ((chunk << (64 - avail)) >> (64 - avail)) << need;
+      std::memcpy(&chunk, in, sizeof(uint64_t));
+      in += sizeof(uint64_t);
+      field |= chunk >> (64 - need);
+      avail = 64 - need;
     }
-  }
-
-  // Set sign
-  (*double_delta) *= sign;
 
-  return Status::Ok();
-}
-
-Status DoubleDelta::write_double_delta(
-    Buffer* buff,
-    int64_t double_delta,
-    int bitsize,
-    uint64_t* chunk,
-    int* bit_in_chunk) {
-  // Write sign
-  uint64_t to_or = (double_delta < 0) ? 1 : 0;
-  to_or <<= (*bit_in_chunk);
-  (*chunk) |= to_or;
-  --(*bit_in_chunk);
-
-  // Write chunk and reset
-  if (*bit_in_chunk < 0) {
-    RETURN_NOT_OK(buff->write(chunk, sizeof(uint64_t)));
-    *bit_in_chunk = 63;
-    *chunk = 0;
+    auto abs_dd = (int64_t)(field & mask);
+    int64_t dd = ((field >> bitsize) != 0) ? -abs_dd : abs_dd;
+    // Computed modulo 2^64, like the deltas at compression
+    T value = (T)(uint64_t(dd) + 2 * uint64_t(int64_t(prev)) -
+                  uint64_t(int64_t(prev_prev)));
+    std::memcpy(out + i * sizeof(T), &value, sizeof(T));
+    prev_prev = prev;
+    prev = value;
   }
+}
 
-  // Write rest of bits
-  int bits_left_to_write = bitsize;
-  int bit_in_dd = bitsize - 1;
-  int bits_to_fill_in_chunk = MIN((*bit_in_chunk) + 1, bits_left_to_write);
-  uint64_t abs_dd = ABS(double_delta);
-  uint64_t tmp_abs_dd;
-
-  while (bits_left_to_write > 0) {
-    if (bits_to_fill_in_chunk > 0) {
-      tmp_abs_dd = (abs_dd << (63 - bit_in_dd));
-      tmp_abs_dd >>= (63 - (*bit_in_chunk));
-      (*chunk) |= tmp_abs_dd;
-      (*bit_in_chunk) -= bits_to_fill_in_chunk;
-      bit_in_dd -= bits_to_fill_in_chunk;
-      bits_left_to_write -= bits_to_fill_in_chunk;
-    }
+template <class T>
+void DoubleDelta::write_double_deltas(
+    const T* in, uint64_t num, unsigned int bitsize, unsigned char* out) {
+  // Each double delta is a sign bit followed by its absolute value, stored
+  // from the most significant bit of the chunks
+  const unsigned int width = bitsize + 1;
+  const uint64_t mask = (uint64_t(1) << bitsize) - 1;
+  // The deltas are computed modulo 2^64, so that they wrap around instead
+  // of overflowing
+  uint64_t prev_delta = uint64_t(int64_t(in[1])) - uint64_t(int64_t(in[0]));
+  uint64_t chunk = 0;
+  unsigned int used = 0;
+  for (uint64_t i = 2; i < num; ++i) {
+    uint64_t cur_delta =
+        uint64_t(int64_t(in[i])) - uint64_t(int64_t(in[i - 1]));
+    auto dd = (int64_t)(cur_delta - prev_delta);
+    uint64_t field = (uint64_t(dd < 0) << bitsize) | ((ABS(dd)) & mask);
+    prev_delta = cur_delta;
 
-    // Write chunk and reset
-    if (*bit_in_chunk < 0) {
-      RETURN_NOT_OK(buff->write(chunk, sizeof(uint64_t)));
-      *bit_in_chunk = 63;
-      *chunk = 0;
-      bits_to_fill_in_chunk = MIN((*bit_in_chunk) + 1, bits_left_to_write);
+    unsigned int free = 64 - used;
+    if (width < free) {
+      chunk |= field << (free - width);
+      used += width;
+    } else {
+      // Fill and write the chunk, and start the next one with the rest
+      unsigned int rest = width - free;
+      chunk |= field >> rest;
+      std::memcpy(out, &chunk, sizeof(uint64_t));
+      out += sizeof(uint64_t);
+      chunk = (rest == 0) ? 0 : field << (64 - rest);
+      used = rest;
     }
   }
 
-  return Status::Ok();
+  // Write whatever is left in the chunk
+  if (used > 0)
+    std::memcpy(out, &chunk, sizeof(uint64_t));
 }
 
 // Explicit template instantiations
@@ -152,44 +152,35 @@ class DoubleDelta {
       ConstBuffer* input_buffer, PreallocatedBuffer* output_buffer);
 
   /**
-   * Reads/reconstructs a double delta value from a compressed buffer.
+   * Reads the double deltas from the compressed chunks and reconstructs the
+   * values from the third one on.
    *
-   * @param buff The input buffer.
-   * @param double_delta The double delta value to be retrieved.
+   * @tparam The datatype of the values.
+   * @param in The compressed chunks.
+   * @param num The number of values.
    * @param bitsize The bitsize of the double delta compression.
-   * @param chunk The function reads from the buffer in whole 64-bit chunks.
-   *     This parameters represents some state about the current chunk.
-   * @param bit_in_chunk Part of the chunk state. Stores the current bit
-   *     in the chunk the next read will start from.
-   * @return Status
+   * @param out The values, holding the first two on entry.
    */
-  static Status read_double_delta(
-      ConstBuffer* buff,
-      int64_t* double_delta,
-      int bitsize,
-      uint64_t* chunk,
-      int* bit_in_chunk);
+  template <class T>
+  static void read_double_deltas(
+      const unsigned char* in,
+      uint64_t num,
+      unsigned int bitsize,
+      unsigned char* out);
 
   /**
-   * Writes a double delta value to a buffer, after reducing its bitsize
-   * to match the input one.
+   * Writes the double deltas of the values from the third one on, after
+   * reducing their bitsize to the input one, in whole 64-bit chunks.
    *
-   * @param buff The output buffer.
-   * @param double_delta The double delta value to write.
-   * @param bitsize The bitsize the double delta value will reduce to
-   *     before being written to the buffer.
-   * @param chunk The function writes to the buffer in whole 64-bit chunks.
-   *     This parameters represents some state about the current chunk.
-   * @param bit_in_chunk Part of the chunk state. Stores the current bit
-   *     in the chunk the next write will start from.
-   * @return Status
+   * @tparam The datatype of the values.
+   * @param in The values.
+   * @param num The number of values.
+   * @param bitsize The bitsize the double delta values will reduce to.
+   * @param out The output, with room for all the chunks.
    */
-  static Status write_double_delta(
-      Buffer* buff,
-      int64_t double_delta,
-      int bitsize,
-      uint64_t* chunk,
-      int* bit_in_chunk);
+  template <class T>
+  static void write_double_deltas(
+      const T* in, uint64_t num, unsigned int bitsize, unsigned char* out);
 };
 
 }  // namespace sm
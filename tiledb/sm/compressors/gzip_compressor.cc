@@ -40,6 +40,92 @@
 namespace tiledb {
 namespace sm {
 
+/* ****************************** */
+/*           GZipContext          */
+/* ****************************** */
+
+GZipContext::GZipContext()
+    : deflate_(nullptr)
+    , deflate_level_(0)
+    , inflate_(nullptr) {
+}
+
+GZipContext::~GZipContext() {
+  if (deflate_ != nullptr) {
+    (void)deflateEnd(deflate_);
+    delete deflate_;
+  }
+  if (inflate_ != nullptr) {
+    (void)inflateEnd(inflate_);
+    delete inflate_;
+  }
+}
+
+Status GZipContext::deflate_stream(int level, z_stream_s** strm) {
+  level = level < 0 ? GZip::default_level() : level;
+
+  // Reset the stream if it was initialized with the same level
+  if (deflate_ != nullptr && deflate_level_ == level) {
+    if (deflateReset(deflate_) != Z_OK)
+      return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
+    *strm = deflate_;
+    return Status::Ok();
+  }
+
+  if (deflate_ != nullptr) {
+    (void)deflateEnd(deflate_);
+    delete deflate_;
+    deflate_ = nullptr;
+  }
+
+  // Allocate deflate state
+  auto new_strm = new z_stream();
+  new_strm->zalloc = Z_NULL;
+  new_strm->zfree = Z_NULL;
+  new_strm->opaque = Z_NULL;
+  if (deflateInit(new_strm, level) != Z_OK) {
+    (void)deflateEnd(new_strm);
+    delete new_strm;
+    return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
+  }
+
+  deflate_ = new_strm;
+  deflate_level_ = level;
+  *strm = deflate_;
+
+  return Status::Ok();
+}
+
+Status GZipContext::inflate_stream(z_stream_s** strm) {
+  if (inflate_ != nullptr) {
+    if (inflateReset(inflate_) != Z_OK)
+      return LOG_STATUS(Status::GZipError("Cannot decompress with GZIP"));
+    *strm = inflate_;
+    return Status::Ok();
+  }
+
+  // Allocate inflate state
+  auto new_strm = new z_stream();
+  new_strm->zalloc = Z_NULL;
+  new_strm->zfree = Z_NULL;
+  new_strm->opaque = Z_NULL;
+  new_strm->avail_in = 0;
+  new_strm->next_in = Z_NULL;
+  if (inflateInit(new_strm) != Z_OK) {
+    delete new_strm;
+    return LOG_STATUS(Status::GZipError("Cannot decompress with GZIP"));
+  }
+
+  inflate_ = new_strm;
+  *strm = inflate_;
+
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*              GZip              */
+/* ****************************** */
+
 Status GZip::compress(
     int level, ConstBuffer* input_buffer, Buffer* output_buffer) {
   STATS_FUNC_IN(compressor_gzip_compress);
@@ -87,6 +173,42 @@ Status GZip::compress(
   STATS_FUNC_OUT(compressor_gzip_compress);
 }
 
+Status GZip::compress(
+    GZipContext* ctx,
+    int level,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
+  STATS_FUNC_IN(compressor_gzip_compress);
+
+  // Sanity check
+  if (input_buffer->data() == nullptr || output_buffer->data() == nullptr)
+    return LOG_STATUS(Status::CompressionError(
+        "Failed compressing with GZip; invalid buffer format"));
+
+  z_stream* strm;
+  RETURN_NOT_OK(ctx->deflate_stream(level, &strm));
+
+  // Compress
+  strm->next_in = (unsigned char*)input_buffer->data();
+  strm->next_out = (unsigned char*)output_buffer->cur_data();
+  strm->avail_in = (uInt)input_buffer->size();
+  strm->avail_out = (uInt)output_buffer->free_space();
+  int ret = deflate(strm, Z_FINISH);
+
+  // Return
+  if (ret == Z_STREAM_ERROR || strm->avail_in != 0)
+    return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
+
+  // Set size of compressed data
+  uint64_t compressed_size = output_buffer->free_space() - strm->avail_out;
+  output_buffer->advance_size(compressed_size);
+  output_buffer->advance_offset(compressed_size);
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(compressor_gzip_compress);
+}
+
 Status GZip::decompress(
     ConstBuffer* input_buffer, PreallocatedBuffer* output_buffer) {
   STATS_FUNC_IN(compressor_gzip_decompress);
@@ -136,6 +258,42 @@ Status GZip::decompress(
   STATS_FUNC_OUT(compressor_gzip_decompress);
 }
 
+Status GZip::decompress(
+    GZipContext* ctx,
+    ConstBuffer* input_buffer,
+    PreallocatedBuffer* output_buffer) {
+  STATS_FUNC_IN(compressor_gzip_decompress);
+
+  // Sanity check
+  if (input_buffer->data() == nullptr || output_buffer->data() == nullptr)
+    return LOG_STATUS(Status::CompressionError(
+        "Failed decompressing with GZip; invalid buffer format"));
+
+  z_stream* strm;
+  RETURN_NOT_OK(ctx->inflate_stream(&strm));
+
+  // Decompress
+  strm->next_in = (unsigned char*)input_buffer->data();
+  strm->next_out = (unsigned char*)output_buffer->cur_data();
+  strm->avail_in = (uInt)input_buffer->size();
+  strm->avail_out = (uInt)output_buffer->free_space();
+  int ret = inflate(strm, Z_FINISH);
+
+  if (ret != Z_STREAM_END) {
+    return LOG_STATUS(
+        Status::GZipError("Cannot decompress with GZIP, Stream Error"));
+  }
+
+  // Set size of decompressed data
+  uint64_t compressed_size = output_buffer->free_space() - strm->avail_out;
+  output_buffer->advance_offset(compressed_size);
+
+  // Success
+  return Status::Ok();
+
+  STATS_FUNC_OUT(compressor_gzip_decompress);
+}
+
 uint64_t GZip::overhead(uint64_t buffer_size) {
   return 6 + 5 * uint64_t((ceil(buffer_size / 16834.0)));
 }
@@ -40,9 +40,56 @@
 
 #include <cmath>
 
+struct z_stream_s;
+
 namespace tiledb {
 namespace sm {
 
+/**
+ * Reusable zlib compression and decompression streams. Reusing a stream
+ * across calls resets it instead of allocating and initializing its state
+ * every time. A context must only be used by one thread at a time.
+ */
+class GZipContext {
+ public:
+  /** Constructor. */
+  GZipContext();
+
+  /** Destructor. Frees the streams. */
+  ~GZipContext();
+
+  GZipContext(const GZipContext&) = delete;
+  GZipContext& operator=(const GZipContext&) = delete;
+
+  /**
+   * Returns the compression stream, reset for a new input. The stream is
+   * initialized again if the level differs from that of the previous call.
+   *
+   * @param level Compression level.
+   * @param strm The compression stream.
+   * @return Status
+   */
+  Status deflate_stream(int level, z_stream_s** strm);
+
+  /**
+   * Returns the decompression stream, reset for a new input.
+   *
+   * @param strm The decompression stream.
+   * @return Status
+   */
+  Status inflate_stream(z_stream_s** strm);
+
+ private:
+  /** The compression stream. */
+  z_stream_s* deflate_;
+
+  /** The compression level of the compression stream. */
+  int deflate_level_;
+
+  /** The decompression stream. */
+  z_stream_s* inflate_;
+};
+
 /** Handles compression/decompression with the zlib (gzip) library. */
 class GZip {
  public:
@@ -57,6 +104,21 @@ class GZip {
   static Status compress(
       int level, ConstBuffer* input_buffer, Buffer* output_buffer);
 
+  /**
+   * Compression function using a reusable context.
+   *
+   * @param ctx The context.
+   * @param level Compression level.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write to the compressed data.
+   * @return Status
+   */
+  static Status compress(
+      GZipContext* ctx,
+      int level,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
   /**
    * Decompression function.
    *
@@ -67,6 +129,19 @@ class GZip {
   static Status decompress(
       ConstBuffer* input_buffer, PreallocatedBuffer* output_buffer);
 
+  /**
+   * Decompression function using a reusable context.
+   *
+   * @param ctx The context.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write the decompressed data to.
+   * @return Status
+   */
+  static Status decompress(
+      GZipContext* ctx,
+      ConstBuffer* input_buffer,
+      PreallocatedBuffer* output_buffer);
+
   /** Returns the compression overhead for the given input. */
   static uint64_t overhead(uint64_t buffer_size);
 
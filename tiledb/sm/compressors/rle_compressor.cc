@@ -30,7 +30,9 @@
  * This file implements the rle compressor class.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
 #include "tiledb/sm/compressors/rle_compressor.h"
@@ -40,6 +42,10 @@
 namespace tiledb {
 namespace sm {
 
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
 Status RLE::compress(
     uint64_t value_size, ConstBuffer* input_buffer, Buffer* output_buffer) {
   STATS_FUNC_IN(compressor_rle_compress);
@@ -48,12 +54,7 @@ Status RLE::compress(
   if (input_buffer->data() == nullptr)
     return LOG_STATUS(Status::CompressionError(
         "Failed compressing with RLE; null input buffer"));
-  unsigned int cur_run_len = 1;
-  unsigned int max_run_len = 65535;
-  auto input_cur = (const unsigned char*)input_buffer->data() + value_size;
-  auto input_prev = (const unsigned char*)input_buffer->data();
   uint64_t value_num = input_buffer->size() / value_size;
-  unsigned char byte;
 
   // Trivial case
   if (value_num == 0)
@@ -65,34 +66,31 @@ Status RLE::compress(
         "Failed compressing with RLE; invalid input buffer format"));
   }
 
-  // Make runs
-  for (uint64_t i = 1; i < value_num; ++i) {
-    if (std::memcmp(input_cur, input_prev, value_size) == 0 &&
-        cur_run_len < max_run_len) {  // Expand the run
-      ++cur_run_len;
-    } else {  // Save the run
-      // Copy to output buffer
-      RETURN_NOT_OK(output_buffer->write(input_prev, value_size));
-      byte = (unsigned char)(cur_run_len >> 8);
-      RETURN_NOT_OK(output_buffer->write(&byte, sizeof(char)));
-      byte = (unsigned char)(cur_run_len % 256);
-      RETURN_NOT_OK(output_buffer->write(&byte, sizeof(char)));
-
-      // Reset current run length
-      cur_run_len = 1;
-    }
-
-    // Update run info
-    input_prev = input_cur;
-    input_cur = input_prev + value_size;
+  // Make room for the worst case (one run per value), and write the runs
+  // directly to the output
+  RETURN_NOT_OK(output_buffer->reserve(value_num * (value_size + 2)));
+  auto input = static_cast<const unsigned char*>(input_buffer->data());
+  auto output = static_cast<unsigned char*>(output_buffer->cur_data());
+  uint64_t output_size;
+  switch (value_size) {
+    case sizeof(uint8_t):
+      output_size = compress<uint8_t>(input, value_num, output);
+      break;
+    case sizeof(uint16_t):
+      output_size = compress<uint16_t>(input, value_num, output);
+      break;
+    case sizeof(uint32_t):
+      output_size = compress<uint32_t>(input, value_num, output);
+      break;
+    case sizeof(uint64_t):
+      output_size = compress<uint64_t>(input, value_num, output);
+      break;
+    default:
+      output_size = compress(value_size, input, value_num, output);
+      break;
   }
-
-  // Save final run
-  RETURN_NOT_OK(output_buffer->write(input_prev, value_size));
-  byte = (unsigned char)(cur_run_len >> 8);
-  RETURN_NOT_OK(output_buffer->write(&byte, sizeof(char)));
-  byte = (unsigned char)(cur_run_len % 256);
-  RETURN_NOT_OK(output_buffer->write(&byte, sizeof(char)));
+  output_buffer->advance_offset(output_size);
+  output_buffer->set_size(output_buffer->offset());
 
   return Status::Ok();
 
@@ -110,10 +108,9 @@ Status RLE::decompress(
     return LOG_STATUS(Status::CompressionError(
         "Failed decompressing with RLE; null input buffer"));
 
-  auto input_cur = static_cast<const unsigned char*>(input_buffer->data());
+  auto input = static_cast<const unsigned char*>(input_buffer->data());
   uint64_t run_size = value_size + 2 * sizeof(char);
   uint64_t run_num = input_buffer->size() / run_size;
-  unsigned char byte;
 
   // Trivial case
   if (run_num == 0)
@@ -125,21 +122,35 @@ Status RLE::decompress(
         "Failed decompressing with RLE; invalid input buffer format"));
   }
 
-  // Decompress runs
-  for (uint64_t i = 0; i < run_num; ++i) {
-    // Retrieve the current run length
-    std::memcpy(&byte, input_cur + value_size, sizeof(char));
-    uint64_t run_len = (((uint64_t)byte) << 8);
-    std::memcpy(&byte, input_cur + value_size + sizeof(char), sizeof(char));
-    run_len += (uint64_t)byte;
-
-    // Copy to output buffer
-    for (uint64_t j = 0; j < run_len; ++j)
-      RETURN_NOT_OK(output_buffer->write(input_cur, value_size))
+  // Check that the runs fit in the output, so that they can be written
+  // directly to it
+  uint64_t value_num = 0;
+  for (uint64_t i = 0; i < run_num; ++i)
+    value_num += run_length(input + i * run_size + value_size);
+  if (value_num * value_size > output_buffer->free_space())
+    return LOG_STATUS(Status::CompressionError(
+        "Failed decompressing with RLE; output buffer overflow"));
 
-    // Update input/output tracking info
-    input_cur += run_size;
+  // Decompress runs
+  auto output = static_cast<unsigned char*>(output_buffer->cur_data());
+  switch (value_size) {
+    case sizeof(uint8_t):
+      decompress<uint8_t>(input, run_num, output);
+      break;
+    case sizeof(uint16_t):
+      decompress<uint16_t>(input, run_num, output);
+      break;
+    case sizeof(uint32_t):
+      decompress<uint32_t>(input, run_num, output);
+      break;
+    case sizeof(uint64_t):
+      decompress<uint64_t>(input, run_num, output);
+      break;
+    default:
+      decompress(value_size, input, run_num, output);
+      break;
   }
+  output_buffer->advance_offset(value_num * value_size);
 
   return Status::Ok();
 
@@ -152,5 +163,118 @@ uint64_t RLE::overhead(uint64_t nbytes, uint64_t value_size) {
   return value_num * 2;
 }
 
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+template <class T>
+uint64_t RLE::compress(
+    const unsigned char* input, uint64_t value_num, unsigned char* output) {
+  // The values are loaded with `memcpy`, as the input may be unaligned
+  auto load = [input](uint64_t i) {
+    T value;
+    std::memcpy(&value, input + i * sizeof(T), sizeof(T));
+    return value;
+  };
+
+  auto output_start = output;
+  uint64_t i = 0;
+  while (i < value_num) {
+    // Find the end of the run. Blocks of values are compared without
+    // branching, which lets the compiler vectorize the comparisons.
+    const T value = load(i);
+    uint64_t end = std::min(value_num, i + max_run_len);
+    uint64_t j = i + 1;
+    while (j + run_block <= end) {
+      unsigned diff = 0;
+      for (uint64_t k = 0; k < run_block; ++k)
+        diff |= (unsigned)(load(j + k) != value);
+      if (diff != 0)
+        break;
+      j += run_block;
+    }
+    while (j < end && load(j) == value)
+      ++j;
+
+    std::memcpy(output, &value, sizeof(T));
+    write_run_length(j - i, output + sizeof(T));
+    output += sizeof(T) + 2;
+    i = j;
+  }
+
+  return output - output_start;
+}
+
+uint64_t RLE::compress(
+    uint64_t value_size,
+    const unsigned char* input,
+    uint64_t value_num,
+    unsigned char* output) {
+  auto output_start = output;
+  uint64_t i = 0;
+  while (i < value_num) {
+    const unsigned char* value = input + i * value_size;
+    uint64_t end = std::min(value_num, i + max_run_len);
+    uint64_t j = i + 1;
+    while (j < end &&
+           std::memcmp(input + j * value_size, value, value_size) == 0)
+      ++j;
+
+    std::memcpy(output, value, value_size);
+    write_run_length(j - i, output + value_size);
+    output += value_size + 2;
+    i = j;
+  }
+
+  return output - output_start;
+}
+
+template <class T>
+void RLE::decompress(
+    const unsigned char* input, uint64_t run_num, unsigned char* output) {
+  for (uint64_t i = 0; i < run_num; ++i) {
+    T value;
+    std::memcpy(&value, input, sizeof(T));
+    uint64_t run_len = run_length(input + sizeof(T));
+
+    // The values are stored with `memcpy`, as the output may be unaligned
+    for (uint64_t j = 0; j < run_len; ++j)
+      std::memcpy(output + j * sizeof(T), &value, sizeof(T));
+    output += run_len * sizeof(T);
+    input += sizeof(T) + 2;
+  }
+}
+
+void RLE::decompress(
+    uint64_t value_size,
+    const unsigned char* input,
+    uint64_t run_num,
+    unsigned char* output) {
+  for (uint64_t i = 0; i < run_num; ++i) {
+    uint64_t run_len = run_length(input + value_size);
+    if (run_len > 0) {
+      // Copy the value, then double the copied values until the run is full
+      std::memcpy(output, input, value_size);
+      uint64_t run_bytes = run_len * value_size;
+      for (uint64_t copied = value_size; copied < run_bytes; copied *= 2)
+        std::memcpy(
+            output + copied,
+            output,
+            std::min(copied, run_bytes - copied));
+      output += run_bytes;
+    }
+    input += value_size + 2;
+  }
+}
+
+uint64_t RLE::run_length(const unsigned char* input) {
+  return ((uint64_t)input[0] << 8) + (uint64_t)input[1];
+}
+
+void RLE::write_run_length(uint64_t run_len, unsigned char* output) {
+  output[0] = (unsigned char)(run_len >> 8);
+  output[1] = (unsigned char)(run_len % 256);
+}
+
 }  // namespace sm
 }  // namespace tiledb
@@ -70,6 +70,58 @@ class RLE {
 
   /** Returns the compression overhead for the given input. */
   static uint64_t overhead(uint64_t nbytes, uint64_t value_size);
+
+ private:
+  /** The maximum length of a run. */
+  static const uint64_t max_run_len = 65535;
+
+  /** The number of values compared at once when searching for a run end. */
+  static const uint64_t run_block = 16;
+
+  /**
+   * Compresses values of a fixed-size type into runs.
+   *
+   * @tparam T The type of the values, whose size is the value size.
+   * @param input The values.
+   * @param value_num The number of values.
+   * @param output The output, with room for one run per value.
+   * @return The size of the runs written to the output.
+   */
+  template <class T>
+  static uint64_t compress(
+      const unsigned char* input, uint64_t value_num, unsigned char* output);
+
+  /** Compresses values of any size into runs. */
+  static uint64_t compress(
+      uint64_t value_size,
+      const unsigned char* input,
+      uint64_t value_num,
+      unsigned char* output);
+
+  /**
+   * Decompresses runs of values of a fixed-size type.
+   *
+   * @tparam T The type of the values, whose size is the value size.
+   * @param input The runs.
+   * @param run_num The number of runs.
+   * @param output The output, with room for all the values of the runs.
+   */
+  template <class T>
+  static void decompress(
+      const unsigned char* input, uint64_t run_num, unsigned char* output);
+
+  /** Decompresses runs of values of any size. */
+  static void decompress(
+      uint64_t value_size,
+      const unsigned char* input,
+      uint64_t run_num,
+      unsigned char* output);
+
+  /** Reads a (big-endian, two-byte) run length. */
+  static uint64_t run_length(const unsigned char* input);
+
+  /** Writes a (big-endian, two-byte) run length. */
+  static void write_run_length(uint64_t run_len, unsigned char* output);
 };
 
 }  // namespace sm
@@ -34,12 +34,100 @@
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/stats.h"
 
+#include <zdict.h>
 #include <zstd.h>
 #include <iostream>
 
 namespace tiledb {
 namespace sm {
 
+/* ****************************** */
+/*         ZStdDictionary         */
+/* ****************************** */
+
+ZStdDictionary::ZStdDictionary()
+    : cdict_(nullptr)
+    , ddict_(nullptr) {
+}
+
+ZStdDictionary::~ZStdDictionary() {
+  ZSTD_freeCDict(cdict_);
+  ZSTD_freeDDict(ddict_);
+}
+
+Status ZStdDictionary::init(const void* data, uint64_t size, int level) {
+  if (cdict_ != nullptr || ddict_ != nullptr)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot initialize ZStd dictionary; Dictionary already initialized"));
+  if (data == nullptr || size == 0)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot initialize ZStd dictionary; Dictionary is empty"));
+
+  data_.assign((const uint8_t*)data, (const uint8_t*)data + size);
+  cdict_ = ZSTD_createCDict(
+      data_.data(),
+      data_.size(),
+      level < 0 ? ZStd::default_level() : level);
+  ddict_ = ZSTD_createDDict(data_.data(), data_.size());
+  if (cdict_ == nullptr || ddict_ == nullptr)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot initialize ZStd dictionary; Dictionary creation failed"));
+
+  return Status::Ok();
+}
+
+const ZSTD_CDict_s* ZStdDictionary::cdict() const {
+  return cdict_;
+}
+
+const std::vector<uint8_t>& ZStdDictionary::data() const {
+  return data_;
+}
+
+const ZSTD_DDict_s* ZStdDictionary::ddict() const {
+  return ddict_;
+}
+
+/* ****************************** */
+/*           ZStdContext          */
+/* ****************************** */
+
+ZStdContext::ZStdContext()
+    : cctx_(nullptr)
+    , dctx_(nullptr) {
+}
+
+ZStdContext::~ZStdContext() {
+  ZSTD_freeCCtx(cctx_);
+  ZSTD_freeDCtx(dctx_);
+}
+
+Status ZStdContext::cctx(ZSTD_CCtx_s** cctx) {
+  if (cctx_ == nullptr)
+    cctx_ = ZSTD_createCCtx();
+  if (cctx_ == nullptr)
+    return LOG_STATUS(Status::CompressionError(
+        "ZStd compression failed; Cannot create context"));
+
+  *cctx = cctx_;
+  return Status::Ok();
+}
+
+Status ZStdContext::dctx(ZSTD_DCtx_s** dctx) {
+  if (dctx_ == nullptr)
+    dctx_ = ZSTD_createDCtx();
+  if (dctx_ == nullptr)
+    return LOG_STATUS(Status::CompressionError(
+        "ZStd decompression failed; Cannot create context"));
+
+  *dctx = dctx_;
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*              ZStd              */
+/* ****************************** */
+
 Status ZStd::compress(
     int level, ConstBuffer* input_buffer, Buffer* output_buffer) {
   STATS_FUNC_IN(compressor_zstd_compress);
@@ -73,6 +161,57 @@ Status ZStd::compress(
   STATS_FUNC_OUT(compressor_zstd_compress);
 }
 
+Status ZStd::compress(
+    ZStdContext* ctx,
+    int level,
+    const ZStdDictionary* dict,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
+  STATS_FUNC_IN(compressor_zstd_compress);
+
+  // Sanity check
+  if (input_buffer->data() == nullptr || output_buffer->data() == nullptr ||
+      (dict != nullptr && dict->cdict() == nullptr))
+    return LOG_STATUS(Status::CompressionError(
+        "Failed compressing with ZStd; invalid buffer format"));
+
+  ZSTD_CCtx* cctx;
+  RETURN_NOT_OK(ctx->cctx(&cctx));
+
+  // Compress
+  uint64_t zstd_ret =
+      dict != nullptr ?
+          ZSTD_compress_usingCDict(
+              cctx,
+              output_buffer->cur_data(),
+              output_buffer->free_space(),
+              input_buffer->data(),
+              input_buffer->size(),
+              dict->cdict()) :
+          ZSTD_compressCCtx(
+              cctx,
+              output_buffer->cur_data(),
+              output_buffer->free_space(),
+              input_buffer->data(),
+              input_buffer->size(),
+              level < 0 ? ZStd::default_level() : level);
+
+  // Handle error
+  if (ZSTD_isError(zstd_ret) != 0) {
+    const char* msg = ZSTD_getErrorName(zstd_ret);
+    return LOG_STATUS(Status::CompressionError(
+        std::string("ZStd compression failed: ") + msg));
+  }
+
+  // Set size of compressed data
+  output_buffer->advance_size(zstd_ret);
+  output_buffer->advance_offset(zstd_ret);
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(compressor_zstd_compress);
+}
+
 Status ZStd::decompress(
     ConstBuffer* input_buffer, PreallocatedBuffer* output_buffer) {
   STATS_FUNC_IN(compressor_zstd_decompress);
@@ -104,9 +243,88 @@ Status ZStd::decompress(
   STATS_FUNC_OUT(compressor_zstd_decompress);
 }
 
+Status ZStd::decompress(
+    ZStdContext* ctx,
+    const ZStdDictionary* dict,
+    ConstBuffer* input_buffer,
+    PreallocatedBuffer* output_buffer) {
+  STATS_FUNC_IN(compressor_zstd_decompress);
+
+  // Sanity check
+  if (input_buffer->data() == nullptr || output_buffer->data() == nullptr ||
+      (dict != nullptr && dict->ddict() == nullptr))
+    return LOG_STATUS(Status::CompressionError(
+        "Failed decompressing with ZStd; invalid buffer format"));
+
+  ZSTD_DCtx* dctx;
+  RETURN_NOT_OK(ctx->dctx(&dctx));
+
+  // Decompress
+  uint64_t zstd_ret =
+      dict != nullptr ?
+          ZSTD_decompress_usingDDict(
+              dctx,
+              output_buffer->cur_data(),
+              output_buffer->free_space(),
+              input_buffer->data(),
+              input_buffer->size(),
+              dict->ddict()) :
+          ZSTD_decompressDCtx(
+              dctx,
+              output_buffer->cur_data(),
+              output_buffer->free_space(),
+              input_buffer->data(),
+              input_buffer->size());
+
+  // Check error
+  if (ZSTD_isError(zstd_ret) != 0) {
+    const char* msg = ZSTD_getErrorName(zstd_ret);
+    return LOG_STATUS(Status::CompressionError(
+        std::string("ZStd decompression failed: ") + msg));
+  }
+
+  // Set size decompressed data
+  output_buffer->advance_offset(zstd_ret);
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(compressor_zstd_decompress);
+}
+
 uint64_t ZStd::overhead(uint64_t nbytes) {
   return ZSTD_compressBound(nbytes) - nbytes;
 }
 
+Status ZStd::train_dictionary(
+    const void* samples,
+    const std::vector<uint64_t>& sample_sizes,
+    uint64_t capacity,
+    std::vector<uint8_t>* dict) {
+  if (samples == nullptr || sample_sizes.empty() || capacity == 0)
+    return LOG_STATUS(Status::CompressionError(
+        "Cannot train ZStd dictionary; No samples given"));
+
+  std::vector<size_t> sizes(sample_sizes.begin(), sample_sizes.end());
+  dict->resize(capacity);
+  size_t zstd_ret = ZDICT_trainFromBuffer(
+      dict->data(),
+      dict->size(),
+      samples,
+      sizes.data(),
+      (unsigned)sizes.size());
+
+  // Handle error
+  if (ZDICT_isError(zstd_ret) != 0) {
+    dict->clear();
+    const char* msg = ZDICT_getErrorName(zstd_ret);
+    return LOG_STATUS(Status::CompressionError(
+        std::string("Cannot train ZStd dictionary: ") + msg));
+  }
+
+  dict->resize(zstd_ret);
+
+  return Status::Ok();
+}
+
 }  // namespace sm
 }  // namespace tiledb
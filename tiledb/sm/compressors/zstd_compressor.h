@@ -38,9 +38,102 @@
 #include "tiledb/sm/buffer/preallocated_buffer.h"
 #include "tiledb/sm/misc/status.h"
 
+#include <vector>
+
+struct ZSTD_CCtx_s;
+struct ZSTD_CDict_s;
+struct ZSTD_DCtx_s;
+struct ZSTD_DDict_s;
+
 namespace tiledb {
 namespace sm {
 
+/**
+ * A zstd dictionary, prepared once for compression at a fixed level and for
+ * decompression. The prepared dictionaries are read-only, so an instance can
+ * be shared by concurrent (de)compressions.
+ */
+class ZStdDictionary {
+ public:
+  /** Constructor. */
+  ZStdDictionary();
+
+  /** Destructor. Frees the prepared dictionaries. */
+  ~ZStdDictionary();
+
+  ZStdDictionary(const ZStdDictionary&) = delete;
+  ZStdDictionary& operator=(const ZStdDictionary&) = delete;
+
+  /**
+   * Initializes the dictionary.
+   *
+   * @param data The dictionary bytes.
+   * @param size The dictionary size.
+   * @param level The compression level the dictionary is prepared for.
+   * @return Status
+   */
+  Status init(const void* data, uint64_t size, int level);
+
+  /** Returns the prepared compression dictionary. */
+  const ZSTD_CDict_s* cdict() const;
+
+  /** Returns the dictionary bytes. */
+  const std::vector<uint8_t>& data() const;
+
+  /** Returns the prepared decompression dictionary. */
+  const ZSTD_DDict_s* ddict() const;
+
+ private:
+  /** The prepared compression dictionary. */
+  ZSTD_CDict_s* cdict_;
+
+  /** The dictionary bytes. */
+  std::vector<uint8_t> data_;
+
+  /** The prepared decompression dictionary. */
+  ZSTD_DDict_s* ddict_;
+};
+
+/**
+ * Reusable zstd compression and decompression contexts. Reusing a context
+ * across calls avoids allocating and initializing its state every time. A
+ * context must only be used by one thread at a time.
+ */
+class ZStdContext {
+ public:
+  /** Constructor. */
+  ZStdContext();
+
+  /** Destructor. Frees the contexts. */
+  ~ZStdContext();
+
+  ZStdContext(const ZStdContext&) = delete;
+  ZStdContext& operator=(const ZStdContext&) = delete;
+
+  /**
+   * Returns the compression context, creating it on first use.
+   *
+   * @param cctx The compression context.
+   * @return Status
+   */
+  Status cctx(ZSTD_CCtx_s** cctx);
+
+  /**
+   * Returns the decompression context, creating it on first use.
+   *
+   * @param dctx The decompression context.
+   * @return Status
+   */
+  Status dctx(ZSTD_DCtx_s** dctx);
+
+ private:
+  /** The compression context. */
+  ZSTD_CCtx_s* cctx_;
+
+  /** The decompression context. */
+  ZSTD_DCtx_s* dctx_;
+};
+
 /** Handles compression/decompression with the zstd library. */
 class ZStd {
  public:
@@ -55,6 +148,24 @@ class ZStd {
   static Status compress(
       int level, ConstBuffer* input_buffer, Buffer* output_buffer);
 
+  /**
+   * Compression function using a reusable context.
+   *
+   * @param ctx The context.
+   * @param level Compression level, ignored if a dictionary is given (the
+   *     level is the one the dictionary was prepared for).
+   * @param dict The dictionary, or `nullptr` to compress without one.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write to the compressed data.
+   * @return Status
+   */
+  static Status compress(
+      ZStdContext* ctx,
+      int level,
+      const ZStdDictionary* dict,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
   /**
    * Decompression function.
    *
@@ -65,6 +176,22 @@ class ZStd {
   static Status decompress(
       ConstBuffer* input_buffer, PreallocatedBuffer* output_buffer);
 
+  /**
+   * Decompression function using a reusable context.
+   *
+   * @param ctx The context.
+   * @param dict The dictionary the input was compressed with, or `nullptr`
+   *     if it was compressed without one.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write the decompressed data to.
+   * @return Status
+   */
+  static Status decompress(
+      ZStdContext* ctx,
+      const ZStdDictionary* dict,
+      ConstBuffer* input_buffer,
+      PreallocatedBuffer* output_buffer);
+
   /** Returns the default compression level. */
   static int default_level() {
     return 5;
@@ -72,6 +199,21 @@ class ZStd {
 
   /** Returns the compression overhead for the given input. */
   static uint64_t overhead(uint64_t nbytes);
+
+  /**
+   * Trains a dictionary on the given samples.
+   *
+   * @param samples The concatenated samples.
+   * @param sample_sizes The size of each sample.
+   * @param capacity The maximum dictionary size.
+   * @param dict The trained dictionary bytes.
+   * @return Status
+   */
+  static Status train_dictionary(
+      const void* samples,
+      const std::vector<uint64_t>& sample_sizes,
+      uint64_t capacity,
+      std::vector<uint8_t>* dict);
 };
 
 }  // namespace sm
@@ -527,6 +527,53 @@ class Array {
         ctx, uri.c_str(), encryption_type, encryption_key, key_length));
   }
 
+  /**
+   * Consolidates the metadata of all the fragments of an array into a single
+   * file, so that opening the array reads one object instead of one per
+   * fragment.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * tiledb::Array::consolidate_metadata(ctx, "s3://bucket-name/array-name");
+   * @endcode
+   *
+   * @param ctx TileDB context
+   * @param array_uri The URI of the TileDB array whose metadata will be
+   *     consolidated.
+   */
+  static void consolidate_metadata(const Context& ctx, const std::string& uri) {
+    consolidate_metadata(ctx, uri, TILEDB_NO_ENCRYPTION, nullptr, 0);
+  }
+
+  /**
+   * Consolidates the metadata of all the fragments of an encrypted array
+   * into a single file.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * // Load AES-256 key from disk, environment variable, etc.
+   * uint8_t key[32] = ...;
+   * tiledb::Array::consolidate_metadata(ctx, "s3://bucket-name/array-name",
+   *    TILEDB_AES_256_GCM, key, sizeof(key));
+   * @endcode
+   *
+   * @param ctx TileDB context
+   * @param array_uri The URI of the TileDB array whose metadata will be
+   *     consolidated.
+   * @param encryption_type The encryption type to use.
+   * @param encryption_key The encryption key to use.
+   * @param key_length Length in bytes of the encryption key.
+   */
+  static void consolidate_metadata(
+      const Context& ctx,
+      const std::string& uri,
+      tiledb_encryption_type_t encryption_type,
+      const void* encryption_key,
+      uint32_t key_length) {
+    ctx.handle_error(tiledb_array_consolidate_metadata_with_key(
+        ctx, uri.c_str(), encryption_type, encryption_key, key_length));
+  }
+
   /**
    * Creates a new TileDB array given an input schema.
    *
@@ -242,6 +242,71 @@ class Config {
    * - `sm.tile_cache_size` <br>
    *    The tile cache size in bytes. Any `uint64_t` value is acceptable. <br>
    *    **Default**: 10,000,000
+   * - `sm.memory_budget` <br>
+   *    The total number of bytes that the queries, the tile cache and the
+   *    filter pipelines of a context may hold in memory at any time.
+   *    Reads split their subarray partitions and writes queue until they
+   *    fit in the budget. Zero means unlimited. <br>
+   *    **Default**: 5,000,000,000
+   * - `sm.buffer_pool.shared_cache_size` <br>
+   *    The maximum number of bytes of released tile and filter buffers that
+   *    the process-wide buffer pool keeps for reuse across threads. The pool
+   *    is shared by all contexts of the process, and is sized by the first
+   *    context created. <br>
+   *    **Default**: 268,435,456
+   * - `sm.buffer_pool.thread_cache_size` <br>
+   *    The maximum number of bytes of released buffers that the buffer pool
+   *    keeps for reuse in each thread. Like the shared cache size, it is set
+   *    by the first context created. <br>
+   *    **Default**: 33,554,432
+   * - `sm.consolidation.step_min_frags` <br>
+   *    The minimum number of fragments that a consolidation step merges.
+   *    If no run of at least this many fragments qualifies, consolidation
+   *    is a no-op. <br>
+   *    **Default**: 2
+   * - `sm.consolidation.step_max_frags` <br>
+   *    The maximum number of fragments that a consolidation step merges
+   *    (i.e., the consolidation fan-in). <br>
+   *    **Default**: 4294967295
+   * - `sm.consolidation.step_size_ratio` <br>
+   *    Two adjacent fragments are merged in the same consolidation step only
+   *    if the size of the smaller one divided by the size of the larger one
+   *    is at least this ratio. A value in `[0.0, 1.0]`, where `0.0` merges
+   *    fragments of any size and values close to `1.0` merge only fragments
+   *    of similar size. <br>
+   *    **Default**: 0.0
+   * - `sm.consolidation.step_max_bytes` <br>
+   *    The maximum total size in bytes of the fragments that a consolidation
+   *    step merges. Zero means unlimited. <br>
+   *    **Default**: 0
+   * - `sm.consolidation.num_threads` <br>
+   *    The maximum number of subarray partitions that consolidation reads
+   *    concurrently. The partitions are slabs of space tiles. The buffers of
+   *    all partitions are bounded by half of `sm.memory_budget`. <br>
+   *    **Default**: number of cores
+   * - `sm.consolidation.background` <br>
+   *    If `true`, a background service consolidates the unencrypted arrays
+   *    opened through the context whenever they cross the
+   *    `sm.consolidation.background_*` thresholds. <br>
+   *    **Default**: false
+   * - `sm.consolidation.background_interval_ms` <br>
+   *    The period in milliseconds at which the background consolidation
+   *    service checks the watched arrays. <br>
+   *    **Default**: 1000
+   * - `sm.consolidation.background_frag_num` <br>
+   *    The background consolidation service consolidates an array once it
+   *    has at least this many fragments. <br>
+   *    **Default**: 8
+   * - `sm.consolidation.background_frag_bytes` <br>
+   *    The background consolidation service consolidates an array once the
+   *    total size in bytes of its fragments, excluding the largest one,
+   *    reaches this value. Zero disables the size threshold. <br>
+   *    **Default**: 0
+   * - `sm.consolidation.background_latency_ms` <br>
+   *    The target latency in milliseconds of the foreground queries. While
+   *    the recent foreground query latency exceeds it, background
+   *    consolidation pauses between its writes. Zero disables throttling. <br>
+   *    **Default**: 0
    * - `sm.array_schema_cache_size` <br>
    *    The array schema cache size in bytes. Any `uint64_t` value is
    *    acceptable. <br>
@@ -250,6 +315,39 @@ class Config {
    *    The fragment metadata cache size in bytes. Any `uint64_t` value is
    *    acceptable. <br>
    *    **Default**: 10,000,000
+   * - `sm.fragment_manifest` <br>
+   *    If `true`, writers record the fragments they create and consolidation
+   *    removes in the array fragment manifest, and opening or reopening an
+   *    array reads the new manifest entries instead of listing the array
+   *    directory. All the writers of an array must set it consistently.
+   *    Local writers serialize their manifest updates with a lock file. S3
+   *    and HDFS have no file locks, so only one process may write to the
+   *    array at a time there. <br>
+   *    **Default**: false
+   * - `sm.kv.wal` <br>
+   *    If `true`, every item added to a key-value store is first appended to a
+   *    write-ahead log in the key-value directory, so that unflushed items
+   *    survive a process crash. Opening the key-value store for writes flushes
+   *    the items left in each log as a fragment stamped with the time of its
+   *    last item, and opening it for reads serves them from memory before the
+   *    persisted fragments, unless a newer fragment was written since. Each
+   *    writer locks its own log, so that only the logs of crashed writers are
+   *    flushed. The log is only supported on local filesystems, and not for
+   *    encrypted key-value stores. <br>
+   *    **Default**: false
+   * - `sm.kv.wal_sync` <br>
+   *    If `true`, every write-ahead log append is synced to persistent
+   *    storage before the item is added, so that added items also survive
+   *    an operating system crash or power loss. If `false`, the appends are
+   *    left to the operating system to write back, which is faster but only
+   *    protects against process crashes. <br>
+   *    **Default**: true
+   * - `sm.kv.flush_threshold` <br>
+   *    The size in bytes of the buffered key-value items that triggers a
+   *    flush in the background. Writers keep adding items while the flush is
+   *    in progress, and block only if a second flush becomes due before the
+   *    first one completes. If `0`, items are flushed only explicitly. <br>
+   *    **Default**: 0
    * - `sm.enable_signal_handlers` <br>
    *    Whether or not TileDB will install signal handlers. <br>
    *    **Default**: true
@@ -108,11 +108,14 @@ class Context {
    * in case of error.
    *
    * @param rc If != TILEDB_OK, calls error handler
+   * @throws ChecksumError if `rc` is TILEDB_CHECKSUM_ERR, regardless of the
+   *     error handler
    */
   void handle_error(int rc) const {
     // Do nothing if there is not error
     if (rc == TILEDB_OK)
       return;
+    bool checksum_error = rc == TILEDB_CHECKSUM_ERR;
 
     // Get error
     const auto& ctx = ctx_.get();
@@ -136,6 +139,8 @@ class Context {
     tiledb_error_free(&err);
 
     // Throw exception
+    if (checksum_error)
+      throw ChecksumError(msg_str);
     error_handler_(msg_str);
   }
 
@@ -70,6 +70,13 @@ struct AttributeError : public TileDBError {
   }
 };
 
+/** Exception indicating corrupted data, detected by a checksum filter **/
+struct ChecksumError : public TileDBError {
+  ChecksumError(const std::string& msg)
+      : TileDBError(msg) {
+  }
+};
+
 namespace impl {
 
 /** Checks if the input type complies with the template type. */
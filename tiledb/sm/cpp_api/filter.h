@@ -37,6 +37,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace tiledb {
 
@@ -159,6 +160,45 @@ class Filter {
         tiledb_filter_get_option(ctx, filter_.get(), option, value));
   }
 
+  /**
+   * Trains a dictionary for a zstd filter on the given samples. The
+   * dictionary is stored with the filter and used to compress every tile
+   * chunk, which improves the compression of small chunks of repetitive data.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * tiledb::Filter f(ctx, TILEDB_FILTER_ZSTD);
+   * std::vector<std::string> samples = ...;
+   * f.train_zstd_dictionary(samples, 16384);
+   * @endcode
+   *
+   * @param samples The samples, representative of the data to compress.
+   * @param dict_capacity The maximum dictionary size in bytes.
+   * @return Reference to this Filter
+   *
+   * @throws TileDBError if the filter is not a zstd filter, or if the
+   *    training fails.
+   */
+  Filter& train_zstd_dictionary(
+      const std::vector<std::string>& samples, uint64_t dict_capacity) {
+    auto& ctx = ctx_.get();
+    std::string data;
+    std::vector<uint64_t> sizes;
+    for (const auto& sample : samples) {
+      data += sample;
+      sizes.push_back(sample.size());
+    }
+    ctx.handle_error(tiledb_filter_train_zstd_dictionary(
+        ctx,
+        filter_.get(),
+        data.data(),
+        sizes.data(),
+        (uint32_t)sizes.size(),
+        dict_capacity));
+    return *this;
+  }
+
   /** Gets the filter type of this filter. */
   tiledb_filter_type_t filter_type() const {
     auto& ctx = ctx_.get();
@@ -208,6 +248,18 @@ class Filter {
         return "BYTESHUFFLE";
       case TILEDB_FILTER_POSITIVE_DELTA:
         return "POSITIVE_DELTA";
+      case TILEDB_FILTER_DICTIONARY:
+        return "DICTIONARY";
+      case TILEDB_FILTER_XOR:
+        return "XOR";
+      case TILEDB_FILTER_BIT_PACKING:
+        return "BIT_PACKING";
+      case TILEDB_FILTER_AUTO:
+        return "AUTO";
+      case TILEDB_FILTER_CHECKSUM_CRC32C:
+        return "CHECKSUM_CRC32C";
+      case TILEDB_FILTER_CHECKSUM_XXHASH64:
+        return "CHECKSUM_XXHASH64";
     }
     return "";
   }
@@ -42,6 +42,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace tiledb {
 
@@ -879,6 +880,54 @@ class Map {
     return MapItem(schema_.context(), &item, this);
   }
 
+  /**
+   * Returns the MapItems from the map corresponding to the given keys,
+   * retrieved in a single batch. The item of a key that does not exist
+   * is not good.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * // Load a map
+   * tiledb::Map map(...);
+   * std::vector<std::string> keys = {"key1", "key2"};
+   * auto items = map.get_items(keys);
+   * @endcode
+   *
+   * @tparam T Key type
+   * @param keys Keys of the items to retrieve
+   * @return The items, in the order of the keys
+   */
+  template <typename T>
+  std::vector<MapItem> get_items(const std::vector<T>& keys) {
+    using DataT = typename impl::TypeHandler<T>;
+
+    auto& ctx = context();
+    auto key_num = keys.size();
+    std::vector<const void*> key_data(key_num);
+    std::vector<tiledb_datatype_t> key_types(key_num, DataT::tiledb_type);
+    std::vector<uint64_t> key_sizes(key_num);
+    for (size_t i = 0; i < key_num; ++i) {
+      key_data[i] = DataT::data(keys[i]);
+      key_sizes[i] = DataT::size(keys[i]) * sizeof(typename DataT::value_type);
+    }
+
+    std::vector<tiledb_kv_item_t*> items(key_num, nullptr);
+    ctx.handle_error(tiledb_kv_get_items(
+        ctx,
+        kv_.get(),
+        key_data.data(),
+        key_types.data(),
+        key_sizes.data(),
+        key_num,
+        items.data()));
+
+    std::vector<MapItem> ret;
+    ret.reserve(key_num);
+    for (auto& item : items)
+      ret.emplace_back(schema_.context(), &item, this);
+    return ret;
+  }
+
   /**
    * Get an item with a given key. If the item doesn't exist, it is created.
    *
@@ -283,6 +283,26 @@ class MapSchema : public Schema {
     return capacity;
   }
 
+  /**
+   * Sets the hash function of the keys.
+   *
+   * @param hash The hash function to set.
+   * @return Reference to this MapSchema.
+   */
+  MapSchema& set_hash(tiledb_kv_hash_t hash) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_kv_schema_set_hash(ctx, schema_.get(), hash));
+    return *this;
+  }
+
+  /** Returns the hash function of the keys. */
+  tiledb_kv_hash_t hash() const {
+    auto& ctx = ctx_.get();
+    tiledb_kv_hash_t hash;
+    ctx.handle_error(tiledb_kv_schema_get_hash(ctx, schema_.get(), &hash));
+    return hash;
+  }
+
  private:
   /* ********************************* */
   /*         PRIVATE ATTRIBUTES        */
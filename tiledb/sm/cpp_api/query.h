@@ -250,6 +250,7 @@ class Query {
    * with `set_buffer()`, and resubmit the query.
    *
    * @return Query status
+   * @throws ChecksumError if a checksum filter detected corrupted data
    */
   Status submit() {
     auto& ctx = ctx_.get();
@@ -667,6 +668,11 @@ class Query {
     return set_buffer(attr, buf.first, buf.second);
   }
 
+  /** Returns a shared pointer to the C TileDB query object. */
+  std::shared_ptr<tiledb_query_t> ptr() const {
+    return query_;
+  }
+
   /* ********************************* */
   /*         STATIC FUNCTIONS          */
   /* ********************************* */
@@ -0,0 +1,90 @@
+/**
+ * @file kv_hash.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This defines the TileDB KVHash enum that maps to
+ * tiledb_kv_hash_t C-API enum.
+ */
+
+#ifndef TILEDB_KV_HASH_H
+#define TILEDB_KV_HASH_H
+
+#include <cassert>
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+/** Defines the hash function of the keys of a key-value store. */
+enum class KVHash : uint8_t {
+#define TILEDB_KV_HASH_ENUM(id) id
+#include "tiledb/sm/c_api/tiledb_enum.h"
+#undef TILEDB_KV_HASH_ENUM
+};
+
+/** Returns the string representation of the input key-value hash. */
+inline const std::string& kv_hash_str(KVHash kv_hash) {
+  switch (kv_hash) {
+    case KVHash::KV_HASH_MD5:
+      return constants::kv_hash_md5_str;
+    case KVHash::KV_HASH_MURMUR3_128:
+      return constants::kv_hash_murmur3_128_str;
+    default:
+      assert(0);
+      return constants::empty_str;
+  }
+}
+
+/** Returns `true` if the input is a valid key-value hash. */
+inline bool kv_hash_valid(KVHash kv_hash) {
+  switch (kv_hash) {
+    case KVHash::KV_HASH_MD5:
+    case KVHash::KV_HASH_MURMUR3_128:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** Returns the key-value hash given a string representation. */
+inline Status kv_hash_enum(const std::string& kv_hash_str, KVHash* kv_hash) {
+  if (kv_hash_str == constants::kv_hash_md5_str)
+    *kv_hash = KVHash::KV_HASH_MD5;
+  else if (kv_hash_str == constants::kv_hash_murmur3_128_str)
+    *kv_hash = KVHash::KV_HASH_MURMUR3_128;
+  else {
+    return Status::Error("Invalid KVHash " + kv_hash_str);
+  }
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_KV_HASH_H
@@ -43,6 +43,7 @@
 #include <limits.h>
 
 #include <ftw.h>
+#include <sys/file.h>
 
 #include <fstream>
 #include <iostream>
@@ -256,6 +257,61 @@ Status Posix::filelock_unlock(filelock_t fd) const {
   return Status::Ok();
 }
 
+Status Posix::open_locked(const std::string& filename, filelock_t* fd) const {
+  *fd = ::open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT, S_IRWXU);
+  if (*fd == -1) {
+    return LOG_STATUS(Status::IOError(
+        "Cannot open file '" + filename + "'; " + strerror(errno)));
+  }
+
+  // Unlike fcntl locks, flock locks belong to the open file description,
+  // so they also conflict between the handles of a single process
+  if (flock(*fd, LOCK_EX | LOCK_NB) != 0) {
+    auto err = errno;
+    ::close(*fd);
+    *fd = INVALID_FILELOCK;
+    if (err == EWOULDBLOCK)
+      return Status::Ok();
+    return LOG_STATUS(Status::IOError(
+        "Cannot lock file '" + filename + "'; " + strerror(err)));
+  }
+
+  return Status::Ok();
+}
+
+Status Posix::append_locked(
+    filelock_t fd, const void* buffer, uint64_t buffer_size, bool sync) const {
+  auto bytes = static_cast<const char*>(buffer);
+  uint64_t nwritten = 0;
+  while (nwritten < buffer_size) {
+    auto nbytes = std::min<uint64_t>(
+        buffer_size - nwritten, constants::max_write_bytes);
+    auto ret = ::write(fd, bytes + nwritten, nbytes);
+    if (ret == -1) {
+      if (errno == EINTR)
+        continue;
+      return LOG_STATUS(Status::IOError(
+          std::string("Cannot append to file; ") + strerror(errno)));
+    }
+    nwritten += ret;
+  }
+
+  if (sync && fsync(fd) != 0) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot sync file; ") + strerror(errno)));
+  }
+
+  return Status::Ok();
+}
+
+Status Posix::close_locked(filelock_t fd) const {
+  if (::close(fd) != 0) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot close file; ") + strerror(errno)));
+  }
+  return Status::Ok();
+}
+
 Status Posix::init(
     const Config::VFSParams& vfs_params, ThreadPool* vfs_thread_pool) {
   if (vfs_thread_pool == nullptr) {
@@ -134,6 +134,42 @@ class Posix {
    */
   Status filelock_unlock(int fd) const;
 
+  /**
+   * Opens a file for appending, creating it if it does not exist, and tries
+   * to lock it exclusively without blocking. The lock is held by the
+   * returned handle, so it conflicts with the locks held by any other
+   * handle, including the handles of this process. It does not prevent
+   * other handles from reading the file.
+   *
+   * @param filename The file to open.
+   * @param fd Set to the handle of the locked file, or to
+   *     `INVALID_FILELOCK` if the file is locked by another handle.
+   * @return Status
+   */
+  Status open_locked(const std::string& filename, filelock_t* fd) const;
+
+  /**
+   * Appends data to a file opened with `open_locked`.
+   *
+   * @param fd The handle of the file.
+   * @param buffer The data to append.
+   * @param buffer_size The size of the data.
+   * @param sync If `true`, the file is synced to persistent storage before
+   *     returning.
+   * @return Status
+   */
+  Status append_locked(
+      filelock_t fd, const void* buffer, uint64_t buffer_size, bool sync)
+      const;
+
+  /**
+   * Closes a file opened with `open_locked`, releasing its lock.
+   *
+   * @param fd The handle of the file.
+   * @return Status
+   */
+  Status close_locked(filelock_t fd) const;
+
   /**
    * Initialize this instance with the given parameters.
    *
@@ -394,6 +394,36 @@ Status VFS::filelock_unlock(const URI& uri, filelock_t fd) const {
   STATS_FUNC_OUT(vfs_filelock_unlock);
 }
 
+Status VFS::open_locked(const URI& uri, filelock_t* fd) const {
+  if (uri.is_file())
+#ifdef _WIN32
+    return win_.open_locked(uri.to_path(), fd);
+#else
+    return posix_.open_locked(uri.to_path(), fd);
+#endif
+
+  return LOG_STATUS(Status::VFSError(
+      "Cannot open locked file '" + uri.to_string() +
+      "'; Only local files can be locked"));
+}
+
+Status VFS::append_locked(
+    filelock_t fd, const void* buffer, uint64_t nbytes, bool sync) const {
+#ifdef _WIN32
+  return win_.append_locked(fd, buffer, nbytes, sync);
+#else
+  return posix_.append_locked(fd, buffer, nbytes, sync);
+#endif
+}
+
+Status VFS::close_locked(filelock_t fd) const {
+#ifdef _WIN32
+  return win_.close_locked(fd);
+#else
+  return posix_.close_locked(fd);
+#endif
+}
+
 bool VFS::incr_lock_count(const URI& uri) const {
   auto it = filelock_counts_.find(uri.to_string());
   if (it == filelock_counts_.end()) {
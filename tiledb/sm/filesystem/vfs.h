@@ -180,6 +180,41 @@ class VFS {
    */
   Status filelock_unlock(const URI& uri, filelock_t fd) const;
 
+  /**
+   * Opens a local file for appending, creating it if it does not exist,
+   * and tries to lock it exclusively without blocking. Unlike filelocks,
+   * the lock is held by the returned handle and conflicts with any other
+   * handle, including the handles of this process. Reads of the file are
+   * not blocked.
+   *
+   * @param uri The URI of the file.
+   * @param fd Set to the handle of the locked file, or to
+   *     `INVALID_FILELOCK` if the file is locked by another handle.
+   * @return Status
+   */
+  Status open_locked(const URI& uri, filelock_t* fd) const;
+
+  /**
+   * Appends data to a file opened with `open_locked`.
+   *
+   * @param fd The handle of the file.
+   * @param buffer The data to append.
+   * @param nbytes The size of the data.
+   * @param sync If `true`, the file is synced to persistent storage before
+   *     returning.
+   * @return Status
+   */
+  Status append_locked(
+      filelock_t fd, const void* buffer, uint64_t nbytes, bool sync) const;
+
+  /**
+   * Closes a file opened with `open_locked`, releasing its lock.
+   *
+   * @param fd The handle of the file.
+   * @return Status
+   */
+  Status close_locked(filelock_t fd) const;
+
   /**
    * Retrieves the size of a file.
    *
@@ -211,7 +211,7 @@ Status Win::file_size(const std::string& path, uint64_t* size) const {
   HANDLE file_h = CreateFile(
       path.c_str(),
       GENERIC_READ,
-      FILE_SHARE_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
       NULL,
       OPEN_EXISTING,
       FILE_ATTRIBUTE_NORMAL,
@@ -273,6 +273,73 @@ Status Win::filelock_unlock(filelock_t fd) const {
   return Status::Ok();
 }
 
+Status Win::open_locked(const std::string& filename, filelock_t* fd) const {
+  HANDLE file_h = CreateFile(
+      filename.c_str(),
+      FILE_APPEND_DATA,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      NULL,
+      OPEN_ALWAYS,
+      FILE_ATTRIBUTE_NORMAL,
+      NULL);
+  if (file_h == INVALID_HANDLE_VALUE) {
+    return LOG_STATUS(Status::IOError(
+        "Cannot open file '" + filename + "'; CreateFile error"));
+  }
+
+  // Lock a byte far past the end of the file, since Windows locks would
+  // otherwise prevent other handles from reading the locked range
+  OVERLAPPED overlapped = {0};
+  overlapped.OffsetHigh = MAXDWORD;
+  if (LockFileEx(
+          file_h,
+          LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY,
+          0,
+          1,
+          0,
+          &overlapped) == 0) {
+    auto err = GetLastError();
+    CloseHandle(file_h);
+    *fd = INVALID_FILELOCK;
+    if (err == ERROR_LOCK_VIOLATION)
+      return Status::Ok();
+    return LOG_STATUS(Status::IOError(
+        "Cannot lock file '" + filename + "'; LockFileEx error"));
+  }
+
+  *fd = file_h;
+  return Status::Ok();
+}
+
+Status Win::append_locked(
+    filelock_t fd, const void* buffer, uint64_t buffer_size, bool sync) const {
+  auto bytes = static_cast<const char*>(buffer);
+  uint64_t nwritten = 0;
+  while (nwritten < buffer_size) {
+    auto nbytes = (DWORD)std::min<uint64_t>(
+        buffer_size - nwritten, constants::max_write_bytes);
+    DWORD ret = 0;
+    if (WriteFile(fd, bytes + nwritten, nbytes, &ret, NULL) == 0) {
+      return LOG_STATUS(
+          Status::IOError("Cannot append to file; WriteFile error"));
+    }
+    nwritten += ret;
+  }
+
+  if (sync && FlushFileBuffers(fd) == 0) {
+    return LOG_STATUS(
+        Status::IOError("Cannot sync file; FlushFileBuffers error"));
+  }
+
+  return Status::Ok();
+}
+
+Status Win::close_locked(filelock_t fd) const {
+  if (CloseHandle(fd) == 0)
+    return LOG_STATUS(Status::IOError("Cannot close file; CloseHandle error"));
+  return Status::Ok();
+}
+
 Status Win::init(
     const Config::VFSParams& vfs_params, ThreadPool* vfs_thread_pool) {
   if (vfs_thread_pool == nullptr) {
@@ -356,7 +423,7 @@ Status Win::read(
   HANDLE file_h = CreateFile(
       path.c_str(),
       GENERIC_READ,
-      FILE_SHARE_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
       NULL,
       OPEN_EXISTING,
       FILE_ATTRIBUTE_NORMAL,
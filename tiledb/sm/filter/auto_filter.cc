@@ -0,0 +1,233 @@
+/**
+ * @file   auto_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class AutoFilter.
+ */
+
+#include "tiledb/sm/filter/auto_filter.h"
+#include "tiledb/sm/filter/bit_packing_filter.h"
+#include "tiledb/sm/filter/compression_filter.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/filter/filter_storage.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/tile/tile.h"
+
+namespace tiledb {
+namespace sm {
+
+AutoFilter::AutoFilter()
+    : AutoFilter(-1) {
+}
+
+AutoFilter::AutoFilter(int zstd_level)
+    : Filter(FilterType::FILTER_AUTO) {
+  zstd_level_ = zstd_level;
+  create_candidates();
+}
+
+Status AutoFilter::run_forward(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  Codec codec;
+  RETURN_NOT_OK(choose_codec(input, &codec));
+
+  auto candidate = candidates_[(uint8_t)codec].get();
+  if (candidate == nullptr) {
+    RETURN_NOT_OK(output->append_view(input));
+    RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+  } else {
+    RETURN_NOT_OK(candidate->run_forward(
+        input_metadata, input, output_metadata, output));
+  }
+
+  // Record the codec in front of the codec metadata
+  RETURN_NOT_OK(output_metadata->prepend_buffer(sizeof(uint8_t)));
+  RETURN_NOT_OK(output_metadata->write(&codec, sizeof(uint8_t)));
+
+  return Status::Ok();
+}
+
+Status AutoFilter::run_reverse(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  uint8_t codec;
+  RETURN_NOT_OK(input_metadata->read(&codec, sizeof(uint8_t)));
+  if (codec >= candidates_.size())
+    return LOG_STATUS(
+        Status::FilterError("Auto filter error; unknown codec"));
+
+  auto candidate = candidates_[codec].get();
+  if (candidate != nullptr)
+    return candidate->run_reverse(
+        input_metadata, input, output_metadata, output);
+
+  RETURN_NOT_OK(output->append_view(input));
+  auto md_offset = input_metadata->offset();
+  RETURN_NOT_OK(output_metadata->append_view(
+      input_metadata, md_offset, input_metadata->size() - md_offset));
+
+  return Status::Ok();
+}
+
+void AutoFilter::set_pipeline(const FilterPipeline* pipeline) {
+  Filter::set_pipeline(pipeline);
+  for (auto& candidate : candidates_) {
+    if (candidate != nullptr)
+      candidate->set_pipeline(pipeline);
+  }
+}
+
+int AutoFilter::zstd_level() const {
+  return zstd_level_;
+}
+
+Status AutoFilter::choose_codec(FilterBuffer* input, Codec* codec) const {
+  *codec = Codec::NONE;
+  auto input_size = input->size();
+  if (input_size == 0)
+    return Status::Ok();
+
+  // Run-length encoding works on whole cells only
+  auto cell_size = pipeline_->current_tile()->cell_size();
+  bool whole_cells = cell_size > 0;
+  for (const auto& part : input->buffers())
+    whole_cells = whole_cells && part.size() % cell_size == 0;
+
+  // Sample evenly spaced slices of the input, aligned to the cells
+  uint64_t align = whole_cells ? cell_size : 1;
+  std::vector<char> sample;
+  if (input_size <= constants::auto_filter_sample_size) {
+    sample.resize(input_size);
+    RETURN_NOT_OK(input->read(sample.data(), input_size));
+  } else {
+    uint64_t slice_num = constants::auto_filter_sample_slice_num;
+    uint64_t slice_size =
+        constants::auto_filter_sample_size / slice_num / align * align;
+    slice_size = std::min(std::max(slice_size, align), input_size);
+    uint64_t stride = slice_num > 1 ?
+                          (input_size - slice_size) / (slice_num - 1) /
+                              align * align :
+                          0;
+    sample.resize(slice_num * slice_size);
+    for (uint64_t i = 0; i < slice_num; i++) {
+      input->set_offset(i * stride);
+      RETURN_NOT_OK(input->read(&sample[i * slice_size], slice_size));
+    }
+  }
+  input->reset_offset();
+
+  // Run the candidates on the sample
+  auto& storage = FilterStorage::thread_storage();
+  uint64_t best_size = sample.size();
+  for (size_t i = 0; i < candidates_.size(); i++) {
+    auto candidate = candidates_[i].get();
+    if (candidate == nullptr || ((Codec)i == Codec::RLE && !whole_cells))
+      continue;
+
+    FilterBuffer sample_input(&storage), sample_metadata(&storage);
+    FilterBuffer output(&storage), output_metadata(&storage);
+    RETURN_NOT_OK(sample_input.init(sample.data(), sample.size()));
+    RETURN_NOT_OK(candidate->run_forward(
+        &sample_metadata, &sample_input, &output_metadata, &output));
+
+    uint64_t size = output.size() + output_metadata.size();
+    if (size < best_size) {
+      best_size = size;
+      *codec = (Codec)i;
+    }
+  }
+
+  return Status::Ok();
+}
+
+AutoFilter* AutoFilter::clone_impl() const {
+  return new AutoFilter(zstd_level_);
+}
+
+void AutoFilter::create_candidates() {
+  auto bit_packing = new BitPackingFilter;
+  bit_packing->set_delta(true);
+
+  candidates_.clear();
+  candidates_.emplace_back(nullptr);
+  candidates_.emplace_back(bit_packing);
+  candidates_.emplace_back(new CompressionFilter(Compressor::RLE, -1));
+  candidates_.emplace_back(
+      new CompressionFilter(Compressor::ZSTD, zstd_level_));
+  for (auto& candidate : candidates_) {
+    if (candidate != nullptr)
+      candidate->set_pipeline(pipeline_);
+  }
+}
+
+Status AutoFilter::deserialize_impl(ConstBuffer* buff) {
+  RETURN_NOT_OK(buff->read(&zstd_level_, sizeof(int32_t)));
+  create_candidates();
+  return Status::Ok();
+}
+
+Status AutoFilter::get_option_impl(FilterOption option, void* value) const {
+  switch (option) {
+    case FilterOption::COMPRESSION_LEVEL:
+      *(int32_t*)value = zstd_level_;
+      return Status::Ok();
+    default:
+      return LOG_STATUS(
+          Status::FilterError("Auto filter error; unknown option"));
+  }
+}
+
+Status AutoFilter::set_option_impl(FilterOption option, const void* value) {
+  if (value == nullptr)
+    return LOG_STATUS(
+        Status::FilterError("Auto filter error; invalid option value"));
+
+  switch (option) {
+    case FilterOption::COMPRESSION_LEVEL:
+      zstd_level_ = *(int32_t*)value;
+      create_candidates();
+      return Status::Ok();
+    default:
+      return LOG_STATUS(
+          Status::FilterError("Auto filter error; unknown option"));
+  }
+}
+
+Status AutoFilter::serialize_impl(Buffer* buff) const {
+  RETURN_NOT_OK(buff->write(&zstd_level_, sizeof(int32_t)));
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,154 @@
+/**
+ * @file   auto_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class AutoFilter.
+ */
+
+#ifndef TILEDB_AUTO_FILTER_H
+#define TILEDB_AUTO_FILTER_H
+
+#include "tiledb/sm/filter/filter.h"
+#include "tiledb/sm/misc/status.h"
+
+#include <memory>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A filter that chooses the encoding of every tile chunk separately among a
+ * small set of candidates:
+ *
+ * - No encoding.
+ * - Delta encoding and bit packing (see `BitPackingFilter`).
+ * - Run-length encoding.
+ * - Zstandard compression, at the level given by the `COMPRESSION_LEVEL`
+ *   option.
+ *
+ * To bound the CPU cost, every candidate is tried on a sample of the chunk,
+ * made of `constants::auto_filter_sample_slice_num` evenly spaced slices
+ * that take `constants::auto_filter_sample_size` bytes in total. The
+ * candidate with the smallest output on the sample (the first one among
+ * equals) is then run on the whole chunk.
+ *
+ * The forward output metadata has the format:
+ *   uint8_t - The chosen codec (see `AutoFilter::Codec`)
+ *   uint8_t[] - The output metadata of the chosen codec
+ *
+ * The forward output data is the output data of the chosen codec.
+ */
+class AutoFilter : public Filter {
+ public:
+  /** The candidate codecs, in order of preference. */
+  enum class Codec : uint8_t {
+    /** No encoding. */
+    NONE = 0,
+    /** Delta encoding and bit packing. */
+    BIT_PACKING = 1,
+    /** Run-length encoding. */
+    RLE = 2,
+    /** Zstandard compression. */
+    ZSTD = 3
+  };
+
+  /** Constructor. */
+  AutoFilter();
+
+  /**
+   * Constructor.
+   *
+   * @param zstd_level Compression level of the Zstandard candidate.
+   */
+  explicit AutoFilter(int zstd_level);
+
+  /**
+   * Encodes the given input with the codec chosen for it.
+   */
+  Status run_forward(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /**
+   * Decodes the given input with the codec it was encoded with.
+   */
+  Status run_reverse(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /** Sets the pipeline instance that executes this filter. */
+  void set_pipeline(const FilterPipeline* pipeline) override;
+
+  /** Returns the compression level of the Zstandard candidate. */
+  int zstd_level() const;
+
+ private:
+  /** The candidate filters, indexed by codec (`nullptr` for no encoding). */
+  std::vector<std::unique_ptr<Filter>> candidates_;
+
+  /** The compression level of the Zstandard candidate. */
+  int zstd_level_;
+
+  /**
+   * Chooses the codec for the given input by running every candidate on a
+   * sample of it.
+   *
+   * @param input The filter input.
+   * @param codec Set to the chosen codec.
+   * @return Status
+   */
+  Status choose_codec(FilterBuffer* input, Codec* codec) const;
+
+  /** Returns a new clone of this filter. */
+  AutoFilter* clone_impl() const override;
+
+  /** Creates the candidate filters. */
+  void create_candidates();
+
+  /** Deserializes this filter's metadata from the given buffer. */
+  Status deserialize_impl(ConstBuffer* buff) override;
+
+  /** Gets an option from this filter. */
+  Status get_option_impl(FilterOption option, void* value) const override;
+
+  /** Sets an option on this filter. */
+  Status set_option_impl(FilterOption option, const void* value) override;
+
+  /** Serializes this filter's metadata to the given buffer. */
+  Status serialize_impl(Buffer* buff) const override;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_AUTO_FILTER_H
@@ -0,0 +1,534 @@
+/**
+ * @file   bit_packing_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class BitPackingFilter.
+ */
+
+#include "tiledb/sm/filter/bit_packing_filter.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/tile/tile.h"
+
+#include <cstring>
+
+namespace tiledb {
+namespace sm {
+
+const unsigned BitPackingFilter::block_size;
+
+/** Returns the number of bits required to represent the given value. */
+static inline unsigned bit_width(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return value == 0 ? 0 : 64 - (unsigned)__builtin_clzll(value);
+#else
+  unsigned bits = 0;
+  for (; value > 0; value >>= 1)
+    bits++;
+  return bits;
+#endif
+}
+
+/**
+ * Packs the `bits` low bits of `num` values (at most a block) into `out`,
+ * returning the number of bytes written.
+ *
+ * The values are ORed into 64-bit words independently of each other, so
+ * that the loop can be vectorized by the compiler.
+ */
+template <typename U>
+static inline uint64_t pack(
+    const U* values, uint64_t num, unsigned bits, uint8_t* out) {
+  if (bits == 0 || num == 0)
+    return 0;
+
+  uint64_t words[BitPackingFilter::block_size + 1] = {0};
+  const uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+  for (uint64_t i = 0; i < num; i++) {
+    uint64_t value = (uint64_t)values[i] & mask;
+    uint64_t bit = i * bits;
+    unsigned shift = bit & 63;
+    words[bit >> 6] |= value << shift;
+    if (shift + bits > 64)
+      words[(bit >> 6) + 1] |= value >> (64 - shift);
+  }
+
+  uint64_t nbytes = (num * bits + 7) / 8;
+  std::memcpy(out, words, nbytes);
+  return nbytes;
+}
+
+/** Unpacks `num` values (at most a block) of `bits` bits from `in`. */
+template <typename U>
+static inline void unpack(
+    const uint8_t* in, uint64_t num, unsigned bits, U* values) {
+  if (bits == 0) {
+    for (uint64_t i = 0; i < num; i++)
+      values[i] = 0;
+    return;
+  }
+
+  uint64_t words[BitPackingFilter::block_size + 1] = {0};
+  std::memcpy(words, in, (num * bits + 7) / 8);
+  const uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+  for (uint64_t i = 0; i < num; i++) {
+    uint64_t bit = i * bits;
+    unsigned shift = bit & 63;
+    uint64_t value = words[bit >> 6] >> shift;
+    if (shift + bits > 64)
+      value |= words[(bit >> 6) + 1] << (64 - shift);
+    values[i] = (U)(value & mask);
+  }
+}
+
+BitPackingFilter::BitPackingFilter()
+    : Filter(FilterType::FILTER_BIT_PACKING) {
+  delta_ = false;
+}
+
+bool BitPackingFilter::delta() const {
+  return delta_;
+}
+
+Status BitPackingFilter::run_forward(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  auto tile_type = pipeline_->current_tile()->type();
+
+  // If bit packing can't work, just return the input unmodified.
+  if (!datatype_is_integer(tile_type)) {
+    RETURN_NOT_OK(output->append_view(input));
+    RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+    return Status::Ok();
+  }
+
+  switch (tile_type) {
+    case Datatype::INT8:
+      return run_forward<int8_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT8:
+      return run_forward<uint8_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT16:
+      return run_forward<int16_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT16:
+      return run_forward<uint16_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT32:
+      return run_forward<int>(input_metadata, input, output_metadata, output);
+    case Datatype::UINT32:
+      return run_forward<unsigned>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT64:
+      return run_forward<int64_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT64:
+      return run_forward<uint64_t>(
+          input_metadata, input, output_metadata, output);
+    default:
+      return LOG_STATUS(
+          Status::FilterError("Cannot filter; Unsupported input type"));
+  }
+}
+
+template <typename T>
+Status BitPackingFilter::run_forward(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  // Compute the upper bound on the size of the output.
+  auto parts = input->buffers();
+  auto num_parts = (uint32_t)parts.size();
+  uint64_t output_size_ub = 0;
+  for (const auto& part : parts)
+    output_size_ub += max_encoded_size<T>(part.size());
+
+  RETURN_NOT_OK(output->prepend_buffer(output_size_ub));
+  Buffer* output_buf = output->buffer_ptr(0);
+  assert(output_buf != nullptr);
+
+  // Forward the existing metadata and write the header.
+  auto input_size = (uint32_t)input->size();
+  uint32_t metadata_size = 2 * sizeof(uint32_t) +
+                           num_parts * (2 * sizeof(uint32_t) + sizeof(uint8_t));
+  RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+  RETURN_NOT_OK(output_metadata->prepend_buffer(metadata_size));
+  RETURN_NOT_OK(output_metadata->write(&input_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&num_parts, sizeof(uint32_t)));
+
+  // Encode all parts
+  for (const auto& part : parts) {
+    auto part_size = (uint32_t)part.size();
+    uint32_t encoded_size;
+    bool encoded;
+    RETURN_NOT_OK(encode_part<T>(&part, output_buf, &encoded_size, &encoded));
+    auto encoded_flag = (uint8_t)(encoded ? 1 : 0);
+    RETURN_NOT_OK(output_metadata->write(&part_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(output_metadata->write(&encoded_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(output_metadata->write(&encoded_flag, sizeof(uint8_t)));
+  }
+
+  return Status::Ok();
+}
+
+template <typename T>
+Status BitPackingFilter::encode_part(
+    const ConstBuffer* part,
+    Buffer* output,
+    uint32_t* encoded_size,
+    bool* encoded) const {
+  typedef typename std::make_unsigned<T>::type U;
+  typedef typename std::make_signed<T>::type S;
+  const unsigned width = 8 * sizeof(T);
+  const bool is_signed = delta_ || std::is_signed<T>::value;
+
+  auto part_size = part->size();
+  auto data = static_cast<const char*>(part->data());
+  auto out = static_cast<uint8_t*>(output->cur_data());
+  uint64_t num = part_size / sizeof(T);
+  uint64_t tail_size = part_size - num * sizeof(T);
+
+  U values[block_size], highs[block_size];
+  uint8_t positions[block_size];
+  uint64_t size = 0;
+  U prev = 0;
+  for (uint64_t start = 0; start < num; start += block_size) {
+    auto n = (unsigned)std::min<uint64_t>(block_size, num - start);
+
+    // Load the block, applying delta encoding
+    for (unsigned i = 0; i < n; i++) {
+      U value;
+      std::memcpy(&value, data + (start + i) * sizeof(T), sizeof(T));
+      values[i] = delta_ ? (U)(value - prev) : value;
+      prev = value;
+    }
+
+    // Compute the reference value
+    U ref = values[0];
+    for (unsigned i = 1; i < n; i++) {
+      bool less = is_signed ? (S)values[i] < (S)ref : values[i] < ref;
+      if (less)
+        ref = values[i];
+    }
+
+    // Compute the histogram of the bit widths relative to the reference
+    unsigned counts[65] = {0};
+    for (unsigned i = 0; i < n; i++) {
+      values[i] = (U)(values[i] - ref);
+      counts[bit_width(values[i])]++;
+    }
+    unsigned max_bits = width;
+    while (max_bits > 0 && counts[max_bits] == 0)
+      max_bits--;
+
+    // Choose the bit width minimizing the block size, where every exception
+    // costs its position and its high bits.
+    unsigned bits = max_bits;
+    uint64_t best_cost = (uint64_t)n * max_bits, num_exceptions = 0;
+    for (unsigned b = max_bits; b-- > 0;) {
+      num_exceptions += counts[b + 1];
+      uint64_t cost = (uint64_t)n * b + num_exceptions * (8 + max_bits - b);
+      if (cost < best_cost) {
+        best_cost = cost;
+        bits = b;
+      }
+    }
+    unsigned high_bits = max_bits - bits;
+
+    // Collect the exceptions
+    unsigned e = 0;
+    if (high_bits > 0) {
+      for (unsigned i = 0; i < n; i++) {
+        U high = (U)(values[i] >> bits);
+        if (high != 0) {
+          positions[e] = (uint8_t)i;
+          highs[e] = high;
+          e++;
+        }
+      }
+    }
+
+    // Write the block
+    std::memcpy(out + size, &ref, sizeof(T));
+    size += sizeof(T);
+    out[size++] = (uint8_t)bits;
+    out[size++] = (uint8_t)(e > 0 ? high_bits : 0);
+    out[size++] = (uint8_t)e;
+    size += pack(values, n, bits, out + size);
+    std::memcpy(out + size, positions, e);
+    size += e;
+    size += pack(highs, e, high_bits, out + size);
+  }
+
+  // Copy the trailing bytes
+  std::memcpy(out + size, data + num * sizeof(T), tail_size);
+  size += tail_size;
+
+  // Store the part unmodified if encoding did not pay off
+  *encoded = num > 0 && size < part_size;
+  if (!*encoded) {
+    std::memcpy(out, data, part_size);
+    size = part_size;
+  }
+
+  if (output->owns_data())
+    output->advance_size(size);
+  output->advance_offset(size);
+  *encoded_size = (uint32_t)size;
+
+  return Status::Ok();
+}
+
+Status BitPackingFilter::run_reverse(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  auto tile_type = pipeline_->current_tile()->type();
+
+  // If bit packing wasn't applied, just return the input unmodified.
+  if (!datatype_is_integer(tile_type)) {
+    RETURN_NOT_OK(output->append_view(input));
+    RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+    return Status::Ok();
+  }
+
+  switch (tile_type) {
+    case Datatype::INT8:
+      return run_reverse<int8_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT8:
+      return run_reverse<uint8_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT16:
+      return run_reverse<int16_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT16:
+      return run_reverse<uint16_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT32:
+      return run_reverse<int>(input_metadata, input, output_metadata, output);
+    case Datatype::UINT32:
+      return run_reverse<unsigned>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT64:
+      return run_reverse<int64_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT64:
+      return run_reverse<uint64_t>(
+          input_metadata, input, output_metadata, output);
+    default:
+      return LOG_STATUS(
+          Status::FilterError("Cannot filter; Unsupported input type"));
+  }
+}
+
+template <typename T>
+Status BitPackingFilter::run_reverse(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  uint32_t orig_size, num_parts;
+  RETURN_NOT_OK(input_metadata->read(&orig_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(input_metadata->read(&num_parts, sizeof(uint32_t)));
+
+  RETURN_NOT_OK(output->prepend_buffer(orig_size));
+  Buffer* output_buf = output->buffer_ptr(0);
+  assert(output_buf != nullptr);
+
+  for (uint32_t i = 0; i < num_parts; i++) {
+    uint32_t part_size, encoded_size;
+    uint8_t encoded;
+    RETURN_NOT_OK(input_metadata->read(&part_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(input_metadata->read(&encoded_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(input_metadata->read(&encoded, sizeof(uint8_t)));
+    ConstBuffer part(nullptr, 0);
+    RETURN_NOT_OK(input->get_const_buffer(encoded_size, &part));
+
+    if (encoded) {
+      RETURN_NOT_OK(decode_part<T>(&part, part_size, output_buf));
+    } else if (encoded_size == part_size) {
+      std::memcpy(output_buf->cur_data(), part.data(), part_size);
+    } else {
+      return LOG_STATUS(Status::FilterError(
+          "Cannot decode bit-packed data; Invalid part size"));
+    }
+
+    if (output_buf->owns_data())
+      output_buf->advance_size(part_size);
+    output_buf->advance_offset(part_size);
+    input->advance_offset(encoded_size);
+  }
+
+  // Output metadata is a view on the input metadata, skipping what was used
+  // by this filter.
+  auto md_offset = input_metadata->offset();
+  RETURN_NOT_OK(output_metadata->append_view(
+      input_metadata, md_offset, input_metadata->size() - md_offset));
+
+  return Status::Ok();
+}
+
+template <typename T>
+Status BitPackingFilter::decode_part(
+    const ConstBuffer* part, uint32_t orig_size, Buffer* output) const {
+  typedef typename std::make_unsigned<T>::type U;
+  const unsigned width = 8 * sizeof(T);
+
+  auto in = static_cast<const uint8_t*>(part->data());
+  auto out = static_cast<char*>(output->cur_data());
+  uint64_t num = orig_size / sizeof(T);
+  uint64_t tail_size = orig_size - num * sizeof(T);
+  if (part->size() < tail_size)
+    return LOG_STATUS(Status::FilterError(
+        "Cannot decode bit-packed data; Invalid part size"));
+  uint64_t blocks_size = part->size() - tail_size;
+
+  U values[block_size], highs[block_size];
+  uint64_t pos = 0;
+  U prev = 0;
+  for (uint64_t start = 0; start < num; start += block_size) {
+    auto n = (unsigned)std::min<uint64_t>(block_size, num - start);
+
+    // Read the block header
+    if (blocks_size - pos < sizeof(T) + 3)
+      return LOG_STATUS(Status::FilterError(
+          "Cannot decode bit-packed data; Truncated input"));
+    U ref;
+    std::memcpy(&ref, in + pos, sizeof(T));
+    pos += sizeof(T);
+    unsigned bits = in[pos++], high_bits = in[pos++], e = in[pos++];
+    if (bits > width || bits + high_bits > width || e > n ||
+        (e > 0 && high_bits == 0))
+      return LOG_STATUS(Status::FilterError(
+          "Cannot decode bit-packed data; Invalid block header"));
+
+    uint64_t packed_size = ((uint64_t)n * bits + 7) / 8;
+    uint64_t highs_size = ((uint64_t)e * high_bits + 7) / 8;
+    if (blocks_size - pos < packed_size + e + highs_size)
+      return LOG_STATUS(Status::FilterError(
+          "Cannot decode bit-packed data; Truncated input"));
+
+    // Unpack the elements and patch the exceptions
+    unpack(in + pos, n, bits, values);
+    pos += packed_size;
+    const uint8_t* positions = in + pos;
+    pos += e;
+    unpack(in + pos, e, high_bits, highs);
+    pos += highs_size;
+    for (unsigned j = 0; j < e; j++) {
+      if (positions[j] >= n)
+        return LOG_STATUS(Status::FilterError(
+            "Cannot decode bit-packed data; Invalid exception position"));
+      values[positions[j]] |= (U)(highs[j] << bits);
+    }
+
+    // Restore the elements
+    for (unsigned i = 0; i < n; i++) {
+      U value = (U)(values[i] + ref);
+      if (delta_)
+        value = (U)(value + prev);
+      prev = value;
+      std::memcpy(out + (start + i) * sizeof(T), &value, sizeof(T));
+    }
+  }
+
+  if (pos != blocks_size)
+    return LOG_STATUS(Status::FilterError(
+        "Cannot decode bit-packed data; Invalid part size"));
+
+  std::memcpy(out + num * sizeof(T), in + blocks_size, tail_size);
+
+  return Status::Ok();
+}
+
+template <typename T>
+uint64_t BitPackingFilter::max_encoded_size(uint64_t part_size) {
+  // A block takes at most its header, its elements and two rounding bytes.
+  uint64_t num_blocks = part_size / sizeof(T) / block_size + 1;
+  return part_size + num_blocks * (sizeof(T) + 5);
+}
+
+void BitPackingFilter::set_delta(bool delta) {
+  delta_ = delta;
+}
+
+Status BitPackingFilter::set_option_impl(
+    FilterOption option, const void* value) {
+  if (value == nullptr)
+    return LOG_STATUS(
+        Status::FilterError("Bit packing filter error; invalid option value"));
+
+  switch (option) {
+    case FilterOption::BIT_PACKING_DELTA:
+      delta_ = *(uint32_t*)value != 0;
+      return Status::Ok();
+    default:
+      return LOG_STATUS(
+          Status::FilterError("Bit packing filter error; unknown option"));
+  }
+}
+
+Status BitPackingFilter::get_option_impl(
+    FilterOption option, void* value) const {
+  switch (option) {
+    case FilterOption::BIT_PACKING_DELTA:
+      *(uint32_t*)value = delta_ ? 1 : 0;
+      return Status::Ok();
+    default:
+      return LOG_STATUS(
+          Status::FilterError("Bit packing filter error; unknown option"));
+  }
+}
+
+BitPackingFilter* BitPackingFilter::clone_impl() const {
+  auto clone = new BitPackingFilter;
+  clone->delta_ = delta_;
+  return clone;
+}
+
+Status BitPackingFilter::deserialize_impl(ConstBuffer* buff) {
+  uint8_t delta;
+  RETURN_NOT_OK(buff->read(&delta, sizeof(uint8_t)));
+  delta_ = delta != 0;
+  return Status::Ok();
+}
+
+Status BitPackingFilter::serialize_impl(Buffer* buff) const {
+  auto delta = (uint8_t)(delta_ ? 1 : 0);
+  RETURN_NOT_OK(buff->write(&delta, sizeof(uint8_t)));
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,205 @@
+/**
+ * @file   bit_packing_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class BitPackingFilter.
+ */
+
+#ifndef TILEDB_BIT_PACKING_FILTER_H
+#define TILEDB_BIT_PACKING_FILTER_H
+
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/filter/filter.h"
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A filter that compresses an array of integers with frame-of-reference
+ * encoding and bit packing at arbitrary bit widths, with patched exceptions
+ * for outliers (PFor).
+ *
+ * The input elements are processed in blocks of `block_size` elements (the
+ * last block may be shorter). Within a block, every element is stored
+ * relative to the block minimum (the reference) and packed with the bit
+ * width `b` that minimizes the block size. Elements that need more than `b`
+ * bits are exceptions: their low `b` bits are packed with the rest, and
+ * their high bits are packed separately along with their positions in the
+ * block.
+ *
+ * If the `BIT_PACKING_DELTA` option is set, the elements are first replaced
+ * by their differences to the previous element, which suits sorted or slowly
+ * changing data.
+ *
+ * Non-integer input is written to the output unmodified. If the input comes
+ * in multiple FilterBuffer parts, each part is encoded separately; parts that
+ * would grow are written unmodified. Trailing bytes of a part that do not
+ * form a full element are copied unmodified.
+ *
+ * Input metadata is not modified.
+ *
+ * The forward output metadata has the format:
+ *   uint32_t - Original input number of bytes
+ *   uint32_t - Number of parts
+ *   part0_md
+ *   ...
+ *   partN_md
+ * Where each part*_md has the fixed format:
+ *   uint32_t - Original number of bytes of the part
+ *   uint32_t - Number of encoded bytes of the part
+ *   uint8_t - 1 if the part is encoded, 0 if it is stored unmodified
+ *
+ * The forward output data format of an encoded part is:
+ *   block0
+ *   ...
+ *   blockN
+ *   uint8_t[] - Trailing bytes of the part
+ * Where each block has the format:
+ *   T - Reference value
+ *   uint8_t - Bit width b of the packed elements
+ *   uint8_t - Bit width h of the exception high bits
+ *   uint8_t - Number of exceptions e
+ *   uint8_t[] - Packed elements (ceil(n * b / 8) bytes)
+ *   uint8_t[] - Exception positions (e bytes)
+ *   uint8_t[] - Packed exception high bits (ceil(e * h / 8) bytes)
+ *
+ * The reverse output format is simply:
+ *   T[] - Array of original elements
+ */
+class BitPackingFilter : public Filter {
+ public:
+  /** The number of elements in a block. */
+  static const unsigned block_size = 128;
+
+  /** Constructor. */
+  BitPackingFilter();
+
+  /** Returns `true` if the elements are delta-encoded before packing. */
+  bool delta() const;
+
+  /**
+   * Bit-pack the given input into the given output.
+   */
+  Status run_forward(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /**
+   * Unpack the given input into the given output.
+   */
+  Status run_reverse(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /** Sets whether the elements are delta-encoded before packing. */
+  void set_delta(bool delta);
+
+ private:
+  /** `true` if the elements are delta-encoded before packing. */
+  bool delta_;
+
+  /** Returns a new clone of this filter. */
+  BitPackingFilter* clone_impl() const override;
+
+  /**
+   * Decodes a part of the filter input.
+   *
+   * @tparam T Tile cell datatype
+   * @param part Buffer to decode.
+   * @param orig_size The original number of bytes of the part.
+   * @param output Buffer to write the decoded part to.
+   * @return Status
+   */
+  template <typename T>
+  Status decode_part(
+      const ConstBuffer* part, uint32_t orig_size, Buffer* output) const;
+
+  /** Deserializes this filter's metadata from the given buffer. */
+  Status deserialize_impl(ConstBuffer* buff) override;
+
+  /**
+   * Encodes a part of the filter input, writing it unmodified if encoding
+   * does not make it smaller.
+   *
+   * @tparam T Tile cell datatype
+   * @param part Buffer to encode.
+   * @param output Buffer to write the encoded part to. It must have room for
+   *     at least `max_encoded_size<T>(part->size())` bytes.
+   * @param encoded_size Set to the number of bytes written.
+   * @param encoded Set to `true` if the part was encoded.
+   * @return Status
+   */
+  template <typename T>
+  Status encode_part(
+      const ConstBuffer* part,
+      Buffer* output,
+      uint32_t* encoded_size,
+      bool* encoded) const;
+
+  /** Gets an option from this filter. */
+  Status get_option_impl(FilterOption option, void* value) const override;
+
+  /**
+   * Returns the maximum number of bytes written by `encode_part` for a part
+   * of the given size.
+   */
+  template <typename T>
+  static uint64_t max_encoded_size(uint64_t part_size);
+
+  /** Run_forward method templated on the tile cell datatype. */
+  template <typename T>
+  Status run_forward(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const;
+
+  /** Run_reverse method templated on the tile cell datatype. */
+  template <typename T>
+  Status run_reverse(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const;
+
+  /** Sets an option on this filter. */
+  Status set_option_impl(FilterOption option, const void* value) override;
+
+  /** Serializes this filter's metadata to the given buffer. */
+  Status serialize_impl(Buffer* buff) const override;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_BIT_PACKING_FILTER_H
@@ -0,0 +1,161 @@
+/**
+ * @file   checksum_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class ChecksumFilter.
+ */
+
+#include "tiledb/sm/filter/checksum_filter.h"
+#include "tiledb/sm/misc/checksum.h"
+#include "tiledb/sm/misc/logger.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace tiledb {
+namespace sm {
+
+ChecksumFilter::ChecksumFilter(FilterType type)
+    : Filter(type) {
+}
+
+ChecksumFilter* ChecksumFilter::clone_impl() const {
+  return new ChecksumFilter(type_);
+}
+
+Status ChecksumFilter::run_forward(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  auto metadata_size = input_metadata->size();
+  auto data_size = input->size();
+  if (metadata_size > std::numeric_limits<uint32_t>::max() ||
+      data_size > std::numeric_limits<uint32_t>::max())
+    return LOG_STATUS(Status::FilterError("Checksum error; input too large"));
+
+  uint64_t metadata_checksum, data_checksum;
+  RETURN_NOT_OK(compute(input_metadata, 0, metadata_size, &metadata_checksum));
+  RETURN_NOT_OK(compute(input, 0, data_size, &data_checksum));
+
+  RETURN_NOT_OK(output->append_view(input));
+  RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+  RETURN_NOT_OK(output_metadata->prepend_buffer(
+      2 * (sizeof(uint32_t) + sizeof(uint64_t))));
+
+  auto metadata_size32 = (uint32_t)metadata_size;
+  auto data_size32 = (uint32_t)data_size;
+  RETURN_NOT_OK(output_metadata->write(&metadata_size32, sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&metadata_checksum, sizeof(uint64_t)));
+  RETURN_NOT_OK(output_metadata->write(&data_size32, sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&data_checksum, sizeof(uint64_t)));
+
+  return Status::Ok();
+}
+
+Status ChecksumFilter::run_reverse(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  uint32_t metadata_size, data_size;
+  uint64_t metadata_checksum, data_checksum;
+  RETURN_NOT_OK(input_metadata->read(&metadata_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(input_metadata->read(&metadata_checksum, sizeof(uint64_t)));
+  RETURN_NOT_OK(input_metadata->read(&data_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(input_metadata->read(&data_checksum, sizeof(uint64_t)));
+
+  auto md_offset = input_metadata->offset();
+  if (input_metadata->size() - md_offset != metadata_size ||
+      input->size() != data_size)
+    return LOG_STATUS(Status::ChecksumError(
+        "Checksum mismatch; unexpected tile chunk size"));
+
+  uint64_t computed;
+  RETURN_NOT_OK(compute(input_metadata, md_offset, metadata_size, &computed));
+  if (computed != metadata_checksum)
+    return LOG_STATUS(Status::ChecksumError(
+        "Checksum mismatch; tile chunk metadata is corrupted"));
+  RETURN_NOT_OK(compute(input, 0, data_size, &computed));
+  if (computed != data_checksum)
+    return LOG_STATUS(Status::ChecksumError(
+        "Checksum mismatch; tile chunk data is corrupted"));
+
+  RETURN_NOT_OK(output->append_view(input));
+  RETURN_NOT_OK(
+      output_metadata->append_view(input_metadata, md_offset, metadata_size));
+
+  return Status::Ok();
+}
+
+Status ChecksumFilter::compute(
+    const FilterBuffer* buffer,
+    uint64_t offset,
+    uint64_t nbytes,
+    uint64_t* value) const {
+  uint32_t crc = 0;
+  checksum::XXHash64 xxhash;
+
+  for (const auto& part : buffer->buffers()) {
+    if (nbytes == 0)
+      break;
+    if (offset >= part.size()) {
+      offset -= part.size();
+      continue;
+    }
+    auto data = static_cast<const char*>(part.data()) + offset;
+    auto n = std::min(part.size() - offset, nbytes);
+    if (type_ == FilterType::FILTER_CHECKSUM_CRC32C)
+      crc = checksum::crc32c(crc, data, n);
+    else
+      xxhash.update(data, n);
+    offset = 0;
+    nbytes -= n;
+  }
+
+  if (nbytes != 0)
+    return LOG_STATUS(
+        Status::FilterError("Checksum error; range exceeds buffer"));
+
+  switch (type_) {
+    case FilterType::FILTER_CHECKSUM_CRC32C:
+      *value = crc;
+      break;
+    case FilterType::FILTER_CHECKSUM_XXHASH64:
+      *value = xxhash.digest();
+      break;
+    default:
+      return LOG_STATUS(
+          Status::FilterError("Checksum error; unknown checksum type"));
+  }
+
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,119 @@
+/**
+ * @file   checksum_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class ChecksumFilter.
+ */
+
+#ifndef TILEDB_CHECKSUM_FILTER_H
+#define TILEDB_CHECKSUM_FILTER_H
+
+#include "tiledb/sm/filter/filter.h"
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A filter that stores a checksum of every tile chunk, so that corrupted
+ * tiles are detected when they are read. The filter type selects the
+ * checksum algorithm:
+ *
+ * - `FILTER_CHECKSUM_CRC32C`: CRC32C (Castagnoli), computed with the SSE4.2
+ *   CRC32 instruction when the processor supports it.
+ * - `FILTER_CHECKSUM_XXHASH64`: 64-bit xxHash.
+ *
+ * To cover the bytes stored on disk, add this filter last in the pipeline.
+ * The data and metadata are not modified. On reverse, a checksum mismatch
+ * returns a status with code `StatusCode::ChecksumError`, which lets
+ * callers tell corrupted tiles apart from other errors (e.g. to retry the
+ * read).
+ *
+ * The forward output metadata has the format:
+ *   uint32_t - Number of bytes of the input metadata
+ *   uint64_t - Checksum of the input metadata
+ *   uint32_t - Number of bytes of the input data
+ *   uint64_t - Checksum of the input data
+ *   uint8_t[] - Input metadata
+ *
+ * 32-bit checksums are stored zero-extended to 64 bits.
+ *
+ * The forward output data format is the input data, unmodified.
+ */
+class ChecksumFilter : public Filter {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param type The checksum filter type.
+   */
+  explicit ChecksumFilter(FilterType type);
+
+  /**
+   * Computes the checksums of the input and passes it to the output.
+   */
+  Status run_forward(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /**
+   * Verifies the checksums of the input and passes it to the output.
+   */
+  Status run_reverse(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+ private:
+  /** Returns a new clone of this filter. */
+  ChecksumFilter* clone_impl() const override;
+
+  /**
+   * Computes the checksum of a byte range of a FilterBuffer, which may span
+   * several underlying buffers.
+   *
+   * @param buffer The buffer.
+   * @param offset The offset of the first byte to checksum.
+   * @param nbytes The number of bytes to checksum.
+   * @param value Set to the computed checksum.
+   * @return Status
+   */
+  Status compute(
+      const FilterBuffer* buffer,
+      uint64_t offset,
+      uint64_t nbytes,
+      uint64_t* value) const;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_CHECKSUM_FILTER_H
@@ -43,9 +43,29 @@
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/tile/tile.h"
 
+#include <unordered_map>
+
 namespace tiledb {
 namespace sm {
 
+namespace {
+
+/**
+ * Returns the compressor context of type `T` of the calling thread for the
+ * given compression level. The contexts are kept per thread, compressor and
+ * level, so that they are reused across chunks and tiles.
+ */
+template <class T>
+T* thread_context(int level) {
+  static thread_local std::unordered_map<int, std::unique_ptr<T>> contexts;
+  auto& ctx = contexts[level];
+  if (ctx == nullptr)
+    ctx.reset(new T());
+  return ctx.get();
+}
+
+}  // namespace
+
 CompressionFilter::CompressionFilter(FilterType compressor, int level)
     : Filter(compressor) {
   compressor_ = filter_to_compressor(compressor);
@@ -68,16 +88,63 @@ int CompressionFilter::compression_level() const {
 }
 
 CompressionFilter* CompressionFilter::clone_impl() const {
-  return new CompressionFilter(compressor_, level_);
+  auto clone = new CompressionFilter(compressor_, level_);
+  clone->zstd_dict_ = zstd_dict_;
+  return clone;
 }
 
 void CompressionFilter::set_compressor(Compressor compressor) {
   compressor_ = compressor;
   type_ = compressor_to_filter(compressor);
+  if (compressor_ != Compressor::ZSTD)
+    zstd_dict_.reset();
 }
 
 void CompressionFilter::set_compression_level(int compressor_level) {
   level_ = compressor_level;
+  reset_zstd_dictionary();
+}
+
+Status CompressionFilter::set_zstd_dictionary(const void* data, uint64_t size) {
+  if (compressor_ != Compressor::ZSTD)
+    return LOG_STATUS(Status::FilterError(
+        "Compression filter error; dictionaries require the zstd compressor"));
+  if (size > std::numeric_limits<uint32_t>::max())
+    return LOG_STATUS(Status::FilterError(
+        "Compression filter error; dictionary is too large"));
+
+  std::shared_ptr<ZStdDictionary> dict(new ZStdDictionary());
+  RETURN_NOT_OK(dict->init(data, size, level_));
+  zstd_dict_ = dict;
+
+  return Status::Ok();
+}
+
+Status CompressionFilter::train_zstd_dictionary(
+    const void* samples,
+    const std::vector<uint64_t>& sample_sizes,
+    uint64_t capacity) {
+  if (compressor_ != Compressor::ZSTD)
+    return LOG_STATUS(Status::FilterError(
+        "Compression filter error; dictionaries require the zstd compressor"));
+
+  std::vector<uint8_t> dict;
+  RETURN_NOT_OK(
+      ZStd::train_dictionary(samples, sample_sizes, capacity, &dict));
+  return set_zstd_dictionary(dict.data(), dict.size());
+}
+
+uint64_t CompressionFilter::zstd_dictionary_size() const {
+  return zstd_dict_ == nullptr ? 0 : zstd_dict_->data().size();
+}
+
+Status CompressionFilter::reset_zstd_dictionary() {
+  if (zstd_dict_ == nullptr)
+    return Status::Ok();
+
+  // Copy the bytes, since `set_zstd_dictionary` replaces the dictionary
+  auto data = zstd_dict_->data();
+  return set_zstd_dictionary(data.data(), data.size());
 }
 
 FilterType CompressionFilter::compressor_to_filter(Compressor compressor) {
@@ -157,7 +224,7 @@ Status CompressionFilter::set_option_impl(
   switch (option) {
     case FilterOption::COMPRESSION_LEVEL:
       level_ = *(int*)value;
-      return Status::Ok();
+      return reset_zstd_dictionary();
     default:
       return LOG_STATUS(
           Status::FilterError("Compression filter error; unknown option"));
@@ -273,10 +340,16 @@ Status CompressionFilter::compress_part(
   uint32_t orig_size = (uint32_t)output->size();
   switch (compressor_) {
     case Compressor::GZIP:
-      RETURN_NOT_OK(GZip::compress(level_, &input_buffer, output));
+      RETURN_NOT_OK(GZip::compress(
+          thread_context<GZipContext>(level_), level_, &input_buffer, output));
       break;
     case Compressor::ZSTD:
-      RETURN_NOT_OK(ZStd::compress(level_, &input_buffer, output));
+      RETURN_NOT_OK(ZStd::compress(
+          thread_context<ZStdContext>(level_),
+          level_,
+          zstd_dict_.get(),
+          &input_buffer,
+          output));
       break;
     case Compressor::LZ4:
       RETURN_NOT_OK(LZ4::compress(level_, &input_buffer, output));
@@ -367,10 +440,15 @@ Status CompressionFilter::decompress_part(
       assert(0);
       break;
     case Compressor::GZIP:
-      st = GZip::decompress(&input_buffer, &output_buffer);
+      st = GZip::decompress(
+          thread_context<GZipContext>(level_), &input_buffer, &output_buffer);
       break;
     case Compressor::ZSTD:
-      st = ZStd::decompress(&input_buffer, &output_buffer);
+      st = ZStd::decompress(
+          thread_context<ZStdContext>(level_),
+          zstd_dict_.get(),
+          &input_buffer,
+          &output_buffer);
       break;
     case Compressor::LZ4:
       st = LZ4::decompress(&input_buffer, &output_buffer);
@@ -447,6 +525,14 @@ Status CompressionFilter::serialize_impl(Buffer* buff) const {
   RETURN_NOT_OK(buff->write(&compressor_char, sizeof(uint8_t)));
   RETURN_NOT_OK(buff->write(&level_, sizeof(int32_t)));
 
+  // The dictionary is optional, and only written if set
+  if (zstd_dict_ != nullptr) {
+    const auto& dict = zstd_dict_->data();
+    auto dict_size = (uint32_t)dict.size();
+    RETURN_NOT_OK(buff->write(&dict_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(buff->write(dict.data(), dict_size));
+  }
+
   return Status::Ok();
 }
 
@@ -456,6 +542,18 @@ Status CompressionFilter::deserialize_impl(ConstBuffer* buff) {
   compressor_ = static_cast<Compressor>(compressor_char);
   RETURN_NOT_OK(buff->read(&level_, sizeof(int32_t)));
 
+  // Read the dictionary, if one was written
+  if (buff->nbytes_left_to_read() > 0) {
+    uint32_t dict_size;
+    RETURN_NOT_OK(buff->read(&dict_size, sizeof(uint32_t)));
+    if (buff->nbytes_left_to_read() < dict_size)
+      return LOG_STATUS(Status::FilterError(
+          "Compression filter error; invalid dictionary size"));
+    RETURN_NOT_OK(set_zstd_dictionary(
+        (const char*)buff->data() + buff->offset(), dict_size));
+    buff->advance_offset(dict_size);
+  }
+
   return Status::Ok();
 }
 
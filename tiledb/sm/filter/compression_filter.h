@@ -38,9 +38,14 @@
 #include "tiledb/sm/filter/filter.h"
 #include "tiledb/sm/misc/status.h"
 
+#include <memory>
+#include <vector>
+
 namespace tiledb {
 namespace sm {
 
+class ZStdDictionary;
+
 /**
  * A filter that compresses/decompresses its input data. The FilterBuffer input
  * to a filter may contain multiple buffers. Each input buffer is termed a
@@ -70,6 +75,14 @@ namespace sm {
  *
  * The reverse (decompress) output format is simply:
  *   uint8_t[] - Array of uncompressed bytes
+ *
+ * The gzip and zstd library contexts are cached per thread, compressor and
+ * level, and reused across parts, chunks and tiles.
+ *
+ * A zstd compression filter may carry a trained dictionary, which is stored
+ * once in the filter's serialized metadata and used to compress every part.
+ * This benefits small parts of repetitive data, which otherwise share no
+ * compression context.
  */
 class CompressionFilter : public Filter {
  public:
@@ -119,6 +132,33 @@ class CompressionFilter : public Filter {
   /** Set the compression level used by this filter instance. */
   void set_compression_level(int compressor_level);
 
+  /**
+   * Sets the zstd dictionary used by this filter instance.
+   *
+   * @param data The dictionary bytes.
+   * @param size The dictionary size.
+   * @return Status
+   */
+  Status set_zstd_dictionary(const void* data, uint64_t size);
+
+  /**
+   * Trains a zstd dictionary on the given samples and sets it on this filter
+   * instance. The samples should be representative of the tile chunks the
+   * filter will compress.
+   *
+   * @param samples The concatenated samples.
+   * @param sample_sizes The size of each sample.
+   * @param capacity The maximum dictionary size.
+   * @return Status
+   */
+  Status train_zstd_dictionary(
+      const void* samples,
+      const std::vector<uint64_t>& sample_sizes,
+      uint64_t capacity);
+
+  /** Returns the zstd dictionary size (zero if none is set). */
+  uint64_t zstd_dictionary_size() const;
+
  private:
   /** The compressor. */
   Compressor compressor_;
@@ -126,6 +166,12 @@ class CompressionFilter : public Filter {
   /** The compression level. */
   int level_;
 
+  /**
+   * The zstd dictionary, prepared for `level_`. This is shared by clones,
+   * and replaced rather than modified.
+   */
+  std::shared_ptr<ZStdDictionary> zstd_dict_;
+
   /** Returns a new clone of this filter. */
   CompressionFilter* clone_impl() const override;
 
@@ -155,6 +201,9 @@ class CompressionFilter : public Filter {
   /** Computes the compression overhead on nbytes of the input data. */
   uint64_t overhead(uint64_t nbytes) const;
 
+  /** Prepares the zstd dictionary again for the current compression level. */
+  Status reset_zstd_dictionary();
+
   /** Sets an option on this filter. */
   Status set_option_impl(FilterOption option, const void* value) override;
 
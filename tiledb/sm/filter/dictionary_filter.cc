@@ -0,0 +1,297 @@
+/**
+ * @file   dictionary_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class DictionaryFilter.
+ */
+
+#include "tiledb/sm/filter/dictionary_filter.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/tile/tile.h"
+
+#include <cstring>
+#include <unordered_map>
+
+namespace tiledb {
+namespace sm {
+
+/** Hashes a cell, given its index in an array of fixed-size cells. */
+struct DictionaryCellHash {
+  const char* data_;
+  uint64_t cell_size_;
+
+  size_t operator()(uint64_t cell_idx) const {
+    // FNV-1a
+    auto cell = data_ + cell_idx * cell_size_;
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint64_t i = 0; i < cell_size_; i++) {
+      hash ^= (uint8_t)cell[i];
+      hash *= 1099511628211ULL;
+    }
+    return (size_t)hash;
+  }
+};
+
+/** Compares two cells, given their indices in an array of fixed-size cells. */
+struct DictionaryCellEqual {
+  const char* data_;
+  uint64_t cell_size_;
+
+  bool operator()(uint64_t a, uint64_t b) const {
+    return std::memcmp(
+               data_ + a * cell_size_, data_ + b * cell_size_, cell_size_) ==
+           0;
+  }
+};
+
+/** Returns the number of bits required to represent the given value. */
+static inline uint8_t bits_required(uint32_t value) {
+  uint8_t bits = 0;
+  while (value > 0) {
+    bits++;
+    value >>= 1;
+  }
+  return bits;
+}
+
+/**
+ * Sets `data` to a contiguous view of the given filter buffer, copying the
+ * buffer into `scratch` if it consists of multiple parts.
+ */
+static Status contiguous_data(
+    FilterBuffer* buffer, std::vector<char>* scratch, const char** data) {
+  auto parts = buffer->buffers();
+  if (parts.size() == 1) {
+    *data = static_cast<const char*>(parts[0].data());
+    return Status::Ok();
+  }
+
+  scratch->resize(buffer->size());
+  RETURN_NOT_OK(buffer->copy_to(scratch->data()));
+  *data = scratch->data();
+  return Status::Ok();
+}
+
+const uint32_t DictionaryFilter::max_dict_size;
+
+DictionaryFilter::DictionaryFilter()
+    : Filter(FilterType::FILTER_DICTIONARY) {
+}
+
+DictionaryFilter* DictionaryFilter::clone_impl() const {
+  return new DictionaryFilter;
+}
+
+Status DictionaryFilter::run_forward(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  auto input_size = input->size();
+  auto cell_size = pipeline_->current_tile()->cell_size();
+  uint64_t cell_num =
+      (cell_size == 0 || cell_size > input_size) ? 0 : input_size / cell_size;
+
+  std::vector<char> scratch;
+  const char* data = nullptr;
+  if (cell_num > 0)
+    RETURN_NOT_OK(contiguous_data(input, &scratch, &data));
+
+  // Encode only if there are few distinct cells and the encoding pays off
+  std::vector<uint64_t> dict;
+  std::vector<uint32_t> codes;
+  uint32_t dict_size = 0;
+  uint8_t bits = 0;
+  uint64_t tail_size = input_size - cell_num * cell_size;
+  uint64_t encoded_size = input_size;
+  if (cell_num > 0 &&
+      build_dictionary(data, cell_num, cell_size, &dict, &codes)) {
+    bits = bits_required((uint32_t)dict.size() - 1);
+    uint64_t size =
+        dict.size() * cell_size + (cell_num * bits + 7) / 8 + tail_size;
+    if (size < input_size) {
+      dict_size = (uint32_t)dict.size();
+      encoded_size = size;
+    }
+  }
+
+  // Write the metadata
+  auto orig_size = (uint32_t)input_size;
+  auto cell_size_u32 = (uint32_t)cell_size;
+  uint32_t metadata_size = 3 * sizeof(uint32_t) + sizeof(uint8_t);
+  RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+  RETURN_NOT_OK(output_metadata->prepend_buffer(metadata_size));
+  RETURN_NOT_OK(output_metadata->write(&orig_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&cell_size_u32, sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&dict_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&bits, sizeof(uint8_t)));
+
+  if (dict_size == 0) {
+    RETURN_NOT_OK(output->append_view(input));
+    return Status::Ok();
+  }
+
+  RETURN_NOT_OK(output->prepend_buffer(encoded_size));
+  output->reset_offset();
+
+  // Write the dictionary
+  for (auto cell_idx : dict)
+    RETURN_NOT_OK(output->write(data + cell_idx * cell_size, cell_size));
+
+  // Bit-pack the codes
+  std::vector<uint8_t> packed((cell_num * bits + 7) / 8);
+  uint64_t acc = 0, byte_idx = 0;
+  unsigned acc_bits = 0;
+  for (auto code : codes) {
+    acc |= (uint64_t)code << acc_bits;
+    acc_bits += bits;
+    while (acc_bits >= 8) {
+      packed[byte_idx++] = (uint8_t)acc;
+      acc >>= 8;
+      acc_bits -= 8;
+    }
+  }
+  if (acc_bits > 0)
+    packed[byte_idx] = (uint8_t)acc;
+  RETURN_NOT_OK(output->write(packed.data(), packed.size()));
+
+  // Copy the trailing bytes
+  if (tail_size > 0)
+    RETURN_NOT_OK(output->write(data + cell_num * cell_size, tail_size));
+
+  return Status::Ok();
+}
+
+Status DictionaryFilter::run_reverse(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  uint32_t orig_size, cell_size, dict_size;
+  uint8_t bits;
+  RETURN_NOT_OK(input_metadata->read(&orig_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(input_metadata->read(&cell_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(input_metadata->read(&dict_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(input_metadata->read(&bits, sizeof(uint8_t)));
+
+  if (dict_size == 0) {
+    RETURN_NOT_OK(output->append_view(input));
+  } else {
+    if (cell_size == 0)
+      return LOG_STATUS(Status::FilterError(
+          "Cannot decode dictionary-encoded data; Invalid cell size"));
+
+    uint64_t cell_num = orig_size / cell_size;
+    uint64_t dict_bytes = (uint64_t)dict_size * cell_size;
+    uint64_t codes_bytes = (cell_num * bits + 7) / 8;
+    uint64_t tail_size = orig_size - cell_num * cell_size;
+    if (bits > 32 || dict_bytes + codes_bytes + tail_size != input->size())
+      return LOG_STATUS(Status::FilterError(
+          "Cannot decode dictionary-encoded data; Invalid input size"));
+
+    std::vector<char> scratch;
+    const char* data = nullptr;
+    RETURN_NOT_OK(contiguous_data(input, &scratch, &data));
+    auto dict = data;
+    auto packed = reinterpret_cast<const uint8_t*>(data + dict_bytes);
+
+    RETURN_NOT_OK(output->prepend_buffer(orig_size));
+    output->reset_offset();
+
+    // Decode the codes
+    uint64_t mask = (1ULL << bits) - 1;
+    uint64_t acc = 0, byte_idx = 0;
+    unsigned acc_bits = 0;
+    for (uint64_t i = 0; i < cell_num; i++) {
+      while (acc_bits < bits) {
+        acc |= (uint64_t)packed[byte_idx++] << acc_bits;
+        acc_bits += 8;
+      }
+      auto code = acc & mask;
+      acc >>= bits;
+      acc_bits -= bits;
+      if (code >= dict_size)
+        return LOG_STATUS(Status::FilterError(
+            "Cannot decode dictionary-encoded data; Invalid code"));
+      RETURN_NOT_OK(output->write(dict + code * cell_size, cell_size));
+    }
+
+    // Copy the trailing bytes
+    if (tail_size > 0)
+      RETURN_NOT_OK(
+          output->write(data + dict_bytes + codes_bytes, tail_size));
+  }
+
+  // Output metadata is a view on the input metadata, skipping what was used
+  // by this filter.
+  auto md_offset = input_metadata->offset();
+  RETURN_NOT_OK(output_metadata->append_view(
+      input_metadata, md_offset, input_metadata->size() - md_offset));
+
+  return Status::Ok();
+}
+
+bool DictionaryFilter::build_dictionary(
+    const char* data,
+    uint64_t cell_num,
+    uint64_t cell_size,
+    std::vector<uint64_t>* dict,
+    std::vector<uint32_t>* codes) const {
+  std::unordered_map<
+      uint64_t,
+      uint32_t,
+      DictionaryCellHash,
+      DictionaryCellEqual>
+      cell_codes(
+          0,
+          DictionaryCellHash{data, cell_size},
+          DictionaryCellEqual{data, cell_size});
+
+  dict->clear();
+  codes->resize(cell_num);
+  for (uint64_t i = 0; i < cell_num; i++) {
+    auto it = cell_codes.find(i);
+    if (it != cell_codes.end()) {
+      (*codes)[i] = it->second;
+      continue;
+    }
+
+    if (dict->size() == max_dict_size)
+      return false;
+    auto code = (uint32_t)dict->size();
+    cell_codes.emplace(i, code);
+    dict->push_back(i);
+    (*codes)[i] = code;
+  }
+
+  return true;
+}
+
+}  // namespace sm
+}  // namespace tiledb
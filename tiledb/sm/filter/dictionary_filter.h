@@ -0,0 +1,130 @@
+/**
+ * @file   dictionary_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class DictionaryFilter.
+ */
+
+#ifndef TILEDB_DICTIONARY_FILTER_H
+#define TILEDB_DICTIONARY_FILTER_H
+
+#include "tiledb/sm/filter/filter.h"
+#include "tiledb/sm/misc/status.h"
+
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A filter that dictionary-encodes the cells of its input. The distinct cell
+ * values of the input are stored once in a dictionary, and every cell is
+ * replaced by the bit-packed index (code) of its value in the dictionary,
+ * using the minimal number of bits for the dictionary size. This suits
+ * low-cardinality attributes, e.g. categorical integers or short fixed-length
+ * strings.
+ *
+ * Cells are the tile cells (e.g. `char[2]` for a fixed-length string
+ * attribute with two values per cell). The filter only applies to
+ * fixed-sized attributes, since the cell boundaries of the values tile of a
+ * var-sized attribute are not visible to it; the array schema check rejects
+ * it on var-sized attributes.
+ *
+ * If the input has more than `max_dict_size` distinct cells, or if encoding
+ * would not make it smaller, the input is written to the output unmodified.
+ * Trailing bytes that do not form a full cell are copied unmodified.
+ *
+ * Input metadata is not modified.
+ *
+ * The forward output metadata has the format:
+ *   uint32_t - Original input number of bytes
+ *   uint32_t - Cell size in bytes
+ *   uint32_t - Number of dictionary entries (0 if the input is not encoded)
+ *   uint8_t - Bit width of the codes
+ *
+ * The forward output data format for encoded input is:
+ *   uint8_t[] - Dictionary (concatenated distinct cell values)
+ *   uint8_t[] - Bit-packed codes, one per cell
+ *   uint8_t[] - Trailing bytes of the input
+ *
+ * The reverse output data format is simply:
+ *   uint8_t[] - Original input data
+ */
+class DictionaryFilter : public Filter {
+ public:
+  /** The maximum number of dictionary entries of an encoded input. */
+  static const uint32_t max_dict_size = 1 << 16;
+
+  /** Constructor. */
+  DictionaryFilter();
+
+  /**
+   * Dictionary-encode the cells of the given input into the given output.
+   */
+  Status run_forward(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /**
+   * Decode the dictionary-encoded input into the given output.
+   */
+  Status run_reverse(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+ private:
+  /** Returns a new clone of this filter. */
+  DictionaryFilter* clone_impl() const override;
+
+  /**
+   * Builds the dictionary of the given cells.
+   *
+   * @param data The cells to encode.
+   * @param cell_num The number of cells.
+   * @param cell_size The cell size in bytes.
+   * @param dict Set to the indices of the first cell holding each distinct
+   *     value, in the order of appearance.
+   * @param codes Set to the dictionary code of each cell.
+   * @return `false` if there are more than `max_dict_size` distinct cells.
+   */
+  bool build_dictionary(
+      const char* data,
+      uint64_t cell_num,
+      uint64_t cell_size,
+      std::vector<uint64_t>* dict,
+      std::vector<uint32_t>* codes) const;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_DICTIONARY_FILTER_H
@@ -31,13 +31,18 @@
  */
 
 #include "tiledb/sm/filter/filter.h"
+#include "tiledb/sm/filter/auto_filter.h"
+#include "tiledb/sm/filter/bit_packing_filter.h"
 #include "tiledb/sm/filter/bit_width_reduction_filter.h"
 #include "tiledb/sm/filter/bitshuffle_filter.h"
 #include "tiledb/sm/filter/byteshuffle_filter.h"
+#include "tiledb/sm/filter/checksum_filter.h"
 #include "tiledb/sm/filter/compression_filter.h"
+#include "tiledb/sm/filter/dictionary_filter.h"
 #include "tiledb/sm/filter/encryption_aes256gcm_filter.h"
 #include "tiledb/sm/filter/noop_filter.h"
 #include "tiledb/sm/filter/positive_delta_filter.h"
+#include "tiledb/sm/filter/xor_filter.h"
 #include "tiledb/sm/misc/logger.h"
 
 namespace tiledb {
@@ -81,6 +86,17 @@ Filter* Filter::create(FilterType type) {
       return new (std::nothrow) ByteshuffleFilter();
     case FilterType::FILTER_POSITIVE_DELTA:
       return new (std::nothrow) PositiveDeltaFilter();
+    case FilterType::FILTER_DICTIONARY:
+      return new (std::nothrow) DictionaryFilter();
+    case FilterType::FILTER_XOR:
+      return new (std::nothrow) XORFilter();
+    case FilterType::FILTER_BIT_PACKING:
+      return new (std::nothrow) BitPackingFilter();
+    case FilterType::FILTER_AUTO:
+      return new (std::nothrow) AutoFilter();
+    case FilterType::FILTER_CHECKSUM_CRC32C:
+    case FilterType::FILTER_CHECKSUM_XXHASH64:
+      return new (std::nothrow) ChecksumFilter(type);
     case FilterType::INTERNAL_FILTER_AES_256_GCM:
       return new (std::nothrow) EncryptionAES256GCMFilter();
     default:
@@ -111,14 +127,23 @@ Status Filter::deserialize(ConstBuffer* buff, Filter** filter) {
   if (f == nullptr)
     return LOG_STATUS(Status::FilterError("Deserialization error."));
 
-  auto offset = buff->offset();
-  RETURN_NOT_OK_ELSE(f->deserialize_impl(buff), delete f);
+  if (buff->nbytes_left_to_read() < filter_metadata_len) {
+    delete f;
+    return LOG_STATUS(Status::FilterError(
+        "Deserialization error; unexpected metadata length"));
+  }
+
+  // Bound the filter metadata, so that filters can read optional fields
+  ConstBuffer metadata(
+      (const char*)buff->data() + buff->offset(), filter_metadata_len);
+  RETURN_NOT_OK_ELSE(f->deserialize_impl(&metadata), delete f);
 
-  if (buff->offset() - offset != filter_metadata_len) {
+  if (metadata.offset() != filter_metadata_len) {
     delete f;
     return LOG_STATUS(Status::FilterError(
         "Deserialization error; unexpected metadata length"));
   }
+  buff->advance_offset(filter_metadata_len);
 
   *filter = f;
 
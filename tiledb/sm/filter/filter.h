@@ -150,7 +150,7 @@ class Filter {
   Status serialize(Buffer* buff) const;
 
   /** Sets the pipeline instance that executes this filter. */
-  void set_pipeline(const FilterPipeline* pipeline);
+  virtual void set_pipeline(const FilterPipeline* pipeline);
 
   /** Returns the filter type. */
   FilterType type() const;
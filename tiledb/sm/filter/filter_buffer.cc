@@ -95,6 +95,13 @@ FilterBuffer::FilterBuffer(FilterStorage* storage) {
   storage_ = storage;
 }
 
+FilterBuffer::~FilterBuffer() {
+  if (storage_ != nullptr) {
+    read_only_ = false;
+    clear();
+  }
+}
+
 Status FilterBuffer::swap(FilterBuffer& other) {
   if (read_only_ || other.read_only_)
     return LOG_STATUS(Status::FilterError(
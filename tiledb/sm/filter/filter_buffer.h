@@ -60,6 +60,12 @@ class FilterBuffer {
    */
   explicit FilterBuffer(FilterStorage* storage);
 
+  /**
+   * Destructor. Returns the underlying buffers to the storage, so that they
+   * can be reused.
+   */
+  ~FilterBuffer();
+
   /**
    * Advance the offset (global across buffers) by the given number of bytes.
    */
@@ -128,16 +128,18 @@ const Tile* FilterPipeline::current_tile() const {
 Status FilterPipeline::filter_chunks_forward(
     const std::vector<std::pair<void*, uint32_t>>& chunks,
     Buffer* output) const {
-  // Vector storing the input and output of the final pipeline stage for each
-  // chunk.
-  std::vector<std::pair<FilterBufferPair, FilterBufferPair>> final_stage_io(
-      chunks.size());
+  // The metadata and data of the filtered chunks.
+  std::vector<Buffer> filtered_metadata(chunks.size());
+  std::vector<Buffer> filtered_data(chunks.size());
 
   // Run each chunk through the entire pipeline.
   auto statuses = parallel_for(0, chunks.size(), [&](uint64_t i) {
-    // TODO(ttd): can we instead allocate one FilterStorage per thread?
-    // or make it threadsafe?
-    FilterStorage storage;
+    // The buffers come from the storage of the calling thread, which is
+    // reused across chunks. They are returned to the storage when the
+    // FilterBuffers go out of scope.
+    auto& storage = FilterStorage::thread_storage();
+    RETURN_NOT_OK(storage.reserve(
+        constants::filter_storage_scratch_buffer_num, max_chunk_size_));
     FilterBuffer input_data(&storage), output_data(&storage);
     FilterBuffer input_metadata(&storage), output_metadata(&storage);
 
@@ -168,18 +170,12 @@ Status FilterPipeline::filter_chunks_forward(
       // Next input (input_buffers) now stores this output (output_buffers).
     }
 
-    // Save the finished chunk (last stage's output). This is safe to do because
-    // when the local FilterStorage goes out of scope, it will not free the
-    // buffers saved here as their shared_ptr counters will not be zero.
-    // However, as the output may have been a view on the input, we do need to
-    // save both here to prevent the input buffer from being freed.
-    auto& io = final_stage_io[i];
-    auto& io_input = io.first;
-    auto& io_output = io.second;
-    io_input.first.swap(input_metadata);
-    io_input.second.swap(input_data);
-    io_output.first.swap(output_metadata);
-    io_output.second.swap(output_data);
+    // Save a copy of the finished chunk (last stage's output), since the
+    // storage buffers holding it are reused by the next chunk. The output
+    // sizes are only known once all chunks are filtered, so the chunks cannot
+    // be written to the output buffer yet.
+    RETURN_NOT_OK(input_metadata.copy_to(&filtered_metadata[i]));
+    RETURN_NOT_OK(input_data.copy_to(&filtered_data[i]));
 
     return Status::Ok();
   });
@@ -192,22 +188,19 @@ Status FilterPipeline::filter_chunks_forward(
   // buffer.
   uint64_t offset = output->offset();
   uint64_t total_processed_size = 0;
-  std::vector<uint64_t> offsets(final_stage_io.size());
-  for (uint64_t i = 0; i < final_stage_io.size(); i++) {
-    auto& final_stage_output_metadata = final_stage_io[i].first.first;
-    auto& final_stage_output_data = final_stage_io[i].first.second;
+  std::vector<uint64_t> offsets(chunks.size());
+  for (uint64_t i = 0; i < chunks.size(); i++) {
+    auto metadata_size = filtered_metadata[i].size();
+    auto data_size = filtered_data[i].size();
 
     // Check the size doesn't exceed the limit (should never happen).
-    if (final_stage_output_data.size() > std::numeric_limits<uint32_t>::max() ||
-        final_stage_output_metadata.size() >
-            std::numeric_limits<uint32_t>::max())
+    if (data_size > std::numeric_limits<uint32_t>::max() ||
+        metadata_size > std::numeric_limits<uint32_t>::max())
       return LOG_STATUS(Status::FilterError(
           "Filter error; filtered chunk size exceeds uint32_t"));
 
     // Leave space for the chunk sizes and the data itself.
-    auto space_required = 3 * sizeof(uint32_t) +
-                          final_stage_output_data.size() +
-                          final_stage_output_metadata.size();
+    auto space_required = 3 * sizeof(uint32_t) + metadata_size + data_size;
     offsets[i] = offset;
     offset += space_required;
     total_processed_size += space_required;
@@ -215,12 +208,10 @@ Status FilterPipeline::filter_chunks_forward(
 
   // Concatenate all processed chunks into the final output buffer.
   RETURN_NOT_OK(output->realloc(output->size() + total_processed_size));
-  statuses = parallel_for(0, final_stage_io.size(), [&](uint64_t i) {
-    auto& final_stage_output_metadata = final_stage_io[i].first.first;
-    auto& final_stage_output_data = final_stage_io[i].first.second;
-    auto filtered_size = (uint32_t)final_stage_output_data.size();
+  statuses = parallel_for(0, chunks.size(), [&](uint64_t i) {
+    auto metadata_size = (uint32_t)filtered_metadata[i].size();
+    auto filtered_size = (uint32_t)filtered_data[i].size();
     auto orig_chunk_size = chunks[i].second;
-    auto metadata_size = (uint32_t)final_stage_output_metadata.size();
     void* dest = output->data(offsets[i]);
     uint64_t dest_offset = 0;
 
@@ -234,11 +225,16 @@ Status FilterPipeline::filter_chunks_forward(
     std::memcpy((char*)dest + dest_offset, &metadata_size, sizeof(uint32_t));
     dest_offset += sizeof(uint32_t);
     // Write the chunk metadata
-    RETURN_NOT_OK(
-        final_stage_output_metadata.copy_to((char*)dest + dest_offset));
+    if (metadata_size > 0)
+      std::memcpy(
+          (char*)dest + dest_offset,
+          filtered_metadata[i].data(),
+          metadata_size);
     dest_offset += metadata_size;
     // Write the chunk data
-    RETURN_NOT_OK(final_stage_output_data.copy_to((char*)dest + dest_offset));
+    if (filtered_size > 0)
+      std::memcpy(
+          (char*)dest + dest_offset, filtered_data[i].data(), filtered_size);
     return Status::Ok();
   });
 
@@ -255,6 +251,7 @@ Status FilterPipeline::filter_chunks_forward(
 
 Status FilterPipeline::filter_chunks_reverse(
     const std::vector<std::tuple<void*, uint32_t, uint32_t, uint32_t>>& chunks,
+    const std::vector<uint64_t>& chunk_idxs,
     Buffer* output) const {
   // Precompute the offsets for the final chunks in the shared output buffer.
   std::vector<uint64_t> chunk_dest_offsets(chunks.size());
@@ -264,8 +261,15 @@ Status FilterPipeline::filter_chunks_reverse(
     chunk_dest_offset += std::get<2>(chunks[i]);
   }
 
-  // Run each chunk through the entire pipeline.
-  auto statuses = parallel_for(0, chunks.size(), [&](uint64_t i) {
+  // Ensure the final size is set to the sum of unfiltered chunk sizes.
+  output->set_offset(chunk_dest_offset);
+  output->set_size(chunk_dest_offset);
+  if (chunk_idxs.empty())
+    return Status::Ok();
+
+  // Run each requested chunk through the entire pipeline.
+  auto statuses = parallel_for(0, chunk_idxs.size(), [&](uint64_t idx) {
+    auto i = chunk_idxs[idx];
     const auto& chunk_input = chunks[i];
     uint32_t filtered_chunk_len = std::get<1>(chunk_input);
     uint32_t orig_chunk_len = std::get<2>(chunk_input);
@@ -273,9 +277,12 @@ Status FilterPipeline::filter_chunks_reverse(
     void* metadata = std::get<0>(chunk_input);
     void* chunk_data = (char*)metadata + metadata_len;
 
-    // TODO(ttd): can we instead allocate one FilterStorage per thread?
-    // or make it threadsafe?
-    FilterStorage storage;
+    // The buffers come from the storage of the calling thread, which is
+    // reused across chunks. They are returned to the storage when the
+    // FilterBuffers go out of scope.
+    auto& storage = FilterStorage::thread_storage();
+    RETURN_NOT_OK(storage.reserve(
+        constants::filter_storage_scratch_buffer_num, max_chunk_size_));
     FilterBuffer input_data(&storage), output_data(&storage);
     FilterBuffer input_metadata(&storage), output_metadata(&storage);
 
@@ -330,10 +337,6 @@ Status FilterPipeline::filter_chunks_reverse(
   for (auto st : statuses)
     RETURN_NOT_OK(st);
 
-  // Ensure the final size is set to the sum of unfiltered chunk sizes.
-  output->set_offset(chunk_dest_offset);
-  output->set_size(chunk_dest_offset);
-
   return Status::Ok();
 }
 
@@ -383,6 +386,20 @@ Status FilterPipeline::run_forward(Tile* tile) const {
 }
 
 Status FilterPipeline::run_reverse(Tile* tile) const {
+  return run_reverse_internal(tile, nullptr, nullptr);
+}
+
+Status FilterPipeline::run_reverse(
+    Tile* tile,
+    const std::vector<std::pair<uint64_t, uint64_t>>& byte_ranges,
+    uint64_t* skipped_chunk_num) const {
+  return run_reverse_internal(tile, &byte_ranges, skipped_chunk_num);
+}
+
+Status FilterPipeline::run_reverse_internal(
+    Tile* tile,
+    const std::vector<std::pair<uint64_t, uint64_t>>* byte_ranges,
+    uint64_t* skipped_chunk_num) const {
   STATS_FUNC_IN(filter_pipeline_run_reverse);
 
   auto tile_buff = tile->buffer();
@@ -414,14 +431,37 @@ Status FilterPipeline::run_reverse(Tile* tile) const {
   }
   assert(tile_buff->offset() == tile_buff->size());
 
+  // Select the chunks to unfilter. Coordinate chunks may hold a single
+  // dimension of the split coordinates, so they are always all unfiltered.
+  std::vector<uint64_t> chunk_idxs;
+  if (byte_ranges == nullptr || tile->stores_coords()) {
+    chunk_idxs.resize(num_chunks);
+    for (uint64_t i = 0; i < num_chunks; i++)
+      chunk_idxs[i] = i;
+  } else {
+    uint64_t chunk_start = 0;
+    for (uint64_t i = 0; i < num_chunks; i++) {
+      uint64_t chunk_end = chunk_start + std::get<2>(chunks[i]);
+      for (const auto& range : *byte_ranges) {
+        if (range.first < chunk_end && range.second > chunk_start) {
+          chunk_idxs.push_back(i);
+          break;
+        }
+      }
+      chunk_start = chunk_end;
+    }
+  }
+  if (skipped_chunk_num != nullptr)
+    *skipped_chunk_num = num_chunks - chunk_idxs.size();
+
   // Allocate a buffer to hold the end result (the assembled, unfiltered
   // chunks).
   Buffer unfiltered_tile;
   RETURN_NOT_OK(unfiltered_tile.realloc(total_orig_size));
 
-  // Run the filters in reverse over all the chunks into the unfiltered_tile
-  // buffer.
-  RETURN_NOT_OK(filter_chunks_reverse(chunks, &unfiltered_tile));
+  // Run the filters in reverse over the selected chunks into the
+  // unfiltered_tile buffer.
+  RETURN_NOT_OK(filter_chunks_reverse(chunks, chunk_idxs, &unfiltered_tile));
 
   // Replace the tile's buffer with the unfiltered buffer.
   RETURN_NOT_OK(tile->buffer()->swap(unfiltered_tile));
@@ -205,6 +205,31 @@ class FilterPipeline {
    */
   Status run_reverse(Tile* tile) const;
 
+  /**
+   * Runs the pipeline in reverse on the given filtered tile, unfiltering only
+   * the chunks that overlap the given byte ranges of the unfiltered tile.
+   * This is used during reads that need only some of the cells of a tile.
+   *
+   * The Tile's buffer is modified to contain the unfiltered byte array, with
+   * the same size as in `run_reverse(Tile*)`. The contents of the chunks that
+   * do not overlap any of the ranges are left unspecified.
+   *
+   * Coordinate tiles are always unfiltered entirely, since their chunks may
+   * hold the split coordinates of a single dimension.
+   *
+   * @param tile Tile to filter
+   * @param byte_ranges The needed byte ranges `[start, end)` of the
+   *    unfiltered tile. The ranges may overlap and may extend past the end of
+   *    the tile.
+   * @param skipped_chunk_num Set to the number of chunks that were not
+   *    unfiltered.
+   * @return Status
+   */
+  Status run_reverse(
+      Tile* tile,
+      const std::vector<std::pair<uint64_t, uint64_t>>& byte_ranges,
+      uint64_t* skipped_chunk_num) const;
+
   /**
    * Serializes the pipeline metadata into a binary buffer.
    *
@@ -233,9 +258,6 @@ class FilterPipeline {
       FilterPipeline* pipeline, const EncryptionKey& encryption_key);
 
  private:
-  /** A pair of FilterBuffers. */
-  typedef std::pair<FilterBuffer, FilterBuffer> FilterBufferPair;
-
   /** The ordered list of filters comprising the pipeline. */
   std::vector<std::unique_ptr<Filter>> filters_;
 
@@ -270,17 +292,36 @@ class FilterPipeline {
       Buffer* output) const;
 
   /**
-   * Run the given list of chunks in reverse through the pipeline.
+   * Run a subset of the given list of chunks in reverse through the pipeline.
+   * The output buffer is sized to hold all the unfiltered chunks, and each
+   * processed chunk is written at its position in the unfiltered tile.
    *
-   * @param chunks Chunks to process. Format is
+   * @param chunks Chunks of the tile. Format is
    *    (data ptr, filtered size, original size, metadata size).
+   * @param chunk_idxs The indices of the chunks to process.
    * @param output Buffer where output of last stage will be written.
    * @return Status
    */
   Status filter_chunks_reverse(
       const std::vector<std::tuple<void*, uint32_t, uint32_t, uint32_t>>&
           chunks,
+      const std::vector<uint64_t>& chunk_idxs,
       Buffer* output) const;
+
+  /**
+   * Runs the pipeline in reverse on the given filtered tile.
+   *
+   * @param tile Tile to filter
+   * @param byte_ranges The needed byte ranges of the unfiltered tile, or
+   *    `nullptr` to unfilter all the chunks.
+   * @param skipped_chunk_num If not `nullptr`, set to the number of chunks
+   *    that were not unfiltered.
+   * @return Status
+   */
+  Status run_reverse_internal(
+      Tile* tile,
+      const std::vector<std::pair<uint64_t, uint64_t>>* byte_ranges,
+      uint64_t* skipped_chunk_num) const;
 };
 
 }  // namespace sm
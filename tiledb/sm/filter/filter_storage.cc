@@ -31,6 +31,7 @@
  */
 
 #include "tiledb/sm/filter/filter_storage.h"
+#include "tiledb/sm/misc/constants.h"
 
 namespace tiledb {
 namespace sm {
@@ -39,12 +40,7 @@ std::shared_ptr<Buffer> FilterStorage::get_buffer() {
   if (available_.empty())
     available_.emplace_back(new Buffer());
 
-  std::shared_ptr<Buffer> buf = std::move(available_.front());
-  Buffer* buf_ptr = buf.get();
-  available_.pop_front();
-  in_use_.push_back(std::move(buf));
-  in_use_list_map_[buf_ptr] = --(in_use_.end());
-
+  in_use_.splice(in_use_.end(), available_, available_.begin());
   return in_use_.back();
 }
 
@@ -57,27 +53,64 @@ uint64_t FilterStorage::num_in_use() const {
 }
 
 Status FilterStorage::reclaim(Buffer* buffer) {
-  auto it = in_use_list_map_.find(buffer);
+  auto it = in_use_.begin();
+  while (it != in_use_.end() && it->get() != buffer)
+    ++it;
 
   // If the buffer is not managed by this class, do nothing.
-  if (it == in_use_list_map_.end())
+  if (it == in_use_.end())
     return Status::Ok();
 
   // An "unused" buffer will have exactly one reference, which is the held by
   // the in_use_ list.
-  if (it->second->use_count() == 1) {
-    buffer->reset_offset();
-    buffer->reset_size();
-
-    auto list_node = it->second;
-    std::shared_ptr<Buffer> ptr = std::move(*list_node);
-    in_use_.erase(list_node);
-    in_use_list_map_.erase(it);
-    available_.push_front(std::move(ptr));
+  if (it->use_count() == 1) {
+    if (available_.size() >= max_available_ || oversized(*buffer)) {
+      in_use_.erase(it);
+    } else {
+      buffer->reset_offset();
+      buffer->reset_size();
+      available_.splice(available_.begin(), in_use_, it);
+    }
   }
 
   return Status::Ok();
 }
 
+Status FilterStorage::reserve(uint64_t num_buffers, uint64_t nbytes) {
+  max_available_ = num_buffers;
+  max_alloced_size_ =
+      nbytes > std::numeric_limits<uint64_t>::max() /
+                   constants::filter_storage_max_buffer_growth ?
+          std::numeric_limits<uint64_t>::max() :
+          nbytes * constants::filter_storage_max_buffer_growth;
+
+  while (available_.size() > num_buffers)
+    available_.pop_back();
+  while (available_.size() < num_buffers)
+    available_.emplace_back(new Buffer());
+
+  // Replace the buffers that are too large, and grow the ones that are too
+  // small.
+  for (auto& buffer : available_) {
+    if (oversized(*buffer))
+      buffer.reset(new Buffer());
+    if (buffer->alloced_size() < nbytes) {
+      RETURN_NOT_OK(buffer->realloc(nbytes));
+      buffer->reset_size();
+    }
+  }
+
+  return Status::Ok();
+}
+
+bool FilterStorage::oversized(const Buffer& buffer) const {
+  return buffer.alloced_size() > max_alloced_size_;
+}
+
+FilterStorage& FilterStorage::thread_storage() {
+  static thread_local FilterStorage storage;
+  return storage;
+}
+
 }  // namespace sm
 }  // namespace tiledb
\ No newline at end of file
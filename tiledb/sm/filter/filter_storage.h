@@ -36,15 +36,24 @@
 #include "tiledb/sm/buffer/buffer.h"
 #include "tiledb/sm/misc/status.h"
 
+#include <limits>
 #include <list>
 #include <memory>
-#include <unordered_map>
 
 namespace tiledb {
 namespace sm {
 
 /**
  * Manages a ref-counted pool of buffers, used for filter I/O.
+ *
+ * The filter pipeline runs every chunk with the storage of the calling
+ * thread (see `thread_storage()`), so that the buffers and their
+ * allocations are reused across chunks and tiles instead of being
+ * allocated anew for every chunk. Once `reserve()` is called, the storage
+ * only retains the reserved number of buffers, and frees the reclaimed
+ * buffers whose allocation outgrew the reserved size by more than
+ * `constants::filter_storage_max_buffer_growth`, so that a single large chunk
+ * does not pin its memory to the thread.
  */
 class FilterStorage {
  public:
@@ -65,7 +74,8 @@ class FilterStorage {
 
   /**
    * Reclaims the given buffer, marking it as available to return with a
-   * subsequent call to get_buffer().
+   * subsequent call to get_buffer(). The buffer is freed instead if keeping
+   * it would exceed the limits set by the last `reserve()`.
    *
    * If the given buffer is not managed by this instance, reclaiming it is a
    * no-op.
@@ -75,19 +85,44 @@ class FilterStorage {
    */
   Status reclaim(Buffer* buffer);
 
+  /**
+   * Ensures that exactly `num_buffers` buffers are available, each with an
+   * allocation of at least `nbytes` bytes, and limits the buffers retained
+   * by later reclaims accordingly.
+   *
+   * @param num_buffers The number of available buffers to ensure.
+   * @param nbytes The minimum allocation size of the buffers.
+   * @return Status
+   */
+  Status reserve(uint64_t num_buffers, uint64_t nbytes);
+
+  /**
+   * Returns the storage of the calling thread. The storage must only be
+   * used by the calling thread, and all the buffers taken from it must be
+   * reclaimed before the thread starts processing another chunk.
+   */
+  static FilterStorage& thread_storage();
+
  private:
   /** List of buffers that are available to be used (may be empty). */
   std::list<std::shared_ptr<Buffer>> available_;
 
-  /** List of buffers that are currently in use (may be empty). */
-  std::list<std::shared_ptr<Buffer>> in_use_;
-
   /**
-   * Mapping of underlying Buffer pointer to linked list node in the in_use_
-   * list.
+   * List of buffers that are currently in use (may be empty). Buffers are
+   * spliced between the two lists, so that reusing a buffer allocates
+   * nothing. Only a handful of buffers are in use at a time, which keeps
+   * the linear lookups in `reclaim()` cheap.
    */
-  std::unordered_map<Buffer*, std::list<std::shared_ptr<Buffer>>::iterator>
-      in_use_list_map_;
+  std::list<std::shared_ptr<Buffer>> in_use_;
+
+  /** The maximum number of available buffers retained by `reclaim()`. */
+  uint64_t max_available_ = std::numeric_limits<uint64_t>::max();
+
+  /** The maximum allocation size of a buffer retained by `reclaim()`. */
+  uint64_t max_alloced_size_ = std::numeric_limits<uint64_t>::max();
+
+  /** Returns true if the given buffer is too large to be retained. */
+  bool oversized(const Buffer& buffer) const;
 };
 
 }  // namespace sm
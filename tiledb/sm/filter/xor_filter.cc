@@ -0,0 +1,524 @@
+/**
+ * @file   xor_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class XORFilter.
+ */
+
+#include "blosc/shuffle.h"
+
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/filter/xor_filter.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/tile/tile.h"
+
+#include <cstring>
+
+namespace tiledb {
+namespace sm {
+
+/** Writes bits to a byte array, least significant bit first. */
+class XORBitWriter {
+ public:
+  explicit XORBitWriter(uint8_t* data)
+      : data_(data)
+      , acc_(0)
+      , acc_bits_(0)
+      , size_(0) {
+  }
+
+  /** Writes the `nbits` (at most 32) low bits of `value`. */
+  inline void write(uint64_t value, unsigned nbits) {
+    acc_ |= (value & ((1ULL << nbits) - 1)) << acc_bits_;
+    acc_bits_ += nbits;
+    while (acc_bits_ >= 8) {
+      data_[size_++] = (uint8_t)acc_;
+      acc_ >>= 8;
+      acc_bits_ -= 8;
+    }
+  }
+
+  /** Writes the `nbits` (at most 64) low bits of `value`. */
+  inline void write_wide(uint64_t value, unsigned nbits) {
+    if (nbits > 32) {
+      write(value, 32);
+      write(value >> 32, nbits - 32);
+    } else {
+      write(value, nbits);
+    }
+  }
+
+  /** Flushes the pending bits and returns the number of bytes written. */
+  uint64_t flush() {
+    if (acc_bits_ > 0) {
+      data_[size_++] = (uint8_t)acc_;
+      acc_ = 0;
+      acc_bits_ = 0;
+    }
+    return size_;
+  }
+
+ private:
+  uint8_t* data_;
+  uint64_t acc_;
+  unsigned acc_bits_;
+  uint64_t size_;
+};
+
+/** Reads bits from a byte array, least significant bit first. */
+class XORBitReader {
+ public:
+  XORBitReader(const uint8_t* data, uint64_t size)
+      : data_(data)
+      , size_(size)
+      , pos_(0)
+      , acc_(0)
+      , acc_bits_(0) {
+  }
+
+  /** Reads `nbits` (at most 32) bits. */
+  inline uint64_t read(unsigned nbits) {
+    while (acc_bits_ < nbits) {
+      uint64_t byte = pos_ < size_ ? data_[pos_] : 0;
+      pos_++;
+      acc_ |= byte << acc_bits_;
+      acc_bits_ += 8;
+    }
+    uint64_t value = acc_ & ((1ULL << nbits) - 1);
+    acc_ >>= nbits;
+    acc_bits_ -= nbits;
+    return value;
+  }
+
+  /** Reads `nbits` (at most 64) bits. */
+  inline uint64_t read_wide(unsigned nbits) {
+    if (nbits > 32) {
+      uint64_t low = read(32);
+      return low | (read(nbits - 32) << 32);
+    }
+    return read(nbits);
+  }
+
+  /** Returns `true` if more bytes were read than available. */
+  bool overrun() const {
+    return pos_ > size_;
+  }
+
+ private:
+  const uint8_t* data_;
+  uint64_t size_;
+  uint64_t pos_;
+  uint64_t acc_;
+  unsigned acc_bits_;
+};
+
+/** Returns the number of leading zero bits of a non-zero value. */
+template <typename T>
+static inline unsigned leading_zeros(T value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned)__builtin_clzll((unsigned long long)value) -
+         (64 - 8 * sizeof(T));
+#else
+  unsigned n = 0;
+  for (T mask = T(1) << (8 * sizeof(T) - 1); !(value & mask); mask >>= 1)
+    n++;
+  return n;
+#endif
+}
+
+/** Returns the number of trailing zero bits of a non-zero value. */
+template <typename T>
+static inline unsigned trailing_zeros(T value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned)__builtin_ctzll((unsigned long long)value);
+#else
+  unsigned n = 0;
+  for (; !(value & 1); value >>= 1)
+    n++;
+  return n;
+#endif
+}
+
+/**
+ * Encodes `num` values of type T (at least one) into a Gorilla bit stream,
+ * returning the number of bytes written.
+ */
+template <typename T>
+static uint64_t gorilla_encode(const char* data, uint64_t num, uint8_t* out) {
+  const unsigned width = 8 * sizeof(T);
+  const unsigned header_bits = sizeof(T) == 8 ? 6 : 5;
+  XORBitWriter writer(out);
+
+  T prev;
+  std::memcpy(&prev, data, sizeof(T));
+  writer.write_wide(prev, width);
+
+  bool has_window = false;
+  unsigned prev_lz = 0, prev_tz = 0;
+  for (uint64_t i = 1; i < num; i++) {
+    T value;
+    std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+    T x = value ^ prev;
+    prev = value;
+
+    // Control bit '0': same value as the previous one
+    if (x == 0) {
+      writer.write(0, 1);
+      continue;
+    }
+
+    auto lz = leading_zeros(x), tz = trailing_zeros(x);
+    if (has_window && lz >= prev_lz && tz >= prev_tz) {
+      // Control bits '10': the meaningful bits fit in the previous window
+      writer.write(1, 2);
+      writer.write_wide(x >> prev_tz, width - prev_lz - prev_tz);
+    } else {
+      // Control bits '11': new window
+      auto len = width - lz - tz;
+      writer.write(3, 2);
+      writer.write(lz, header_bits);
+      writer.write(len - 1, header_bits);
+      writer.write_wide(x >> tz, len);
+      has_window = true;
+      prev_lz = lz;
+      prev_tz = tz;
+    }
+  }
+
+  return writer.flush();
+}
+
+/** Decodes `num` values of type T (at least one) from a Gorilla bit stream. */
+template <typename T>
+static Status gorilla_decode(
+    const uint8_t* in, uint64_t in_size, uint64_t num, char* out) {
+  const unsigned width = 8 * sizeof(T);
+  const unsigned header_bits = sizeof(T) == 8 ? 6 : 5;
+  XORBitReader reader(in, in_size);
+
+  auto value = (T)reader.read_wide(width);
+  std::memcpy(out, &value, sizeof(T));
+
+  bool has_window = false;
+  unsigned prev_lz = 0, prev_tz = 0;
+  for (uint64_t i = 1; i < num; i++) {
+    if (reader.read(1) != 0) {
+      T x;
+      if (reader.read(1) == 0) {
+        if (!has_window)
+          return LOG_STATUS(Status::FilterError(
+              "Cannot decode XOR-encoded data; Invalid bit stream"));
+        x = (T)reader.read_wide(width - prev_lz - prev_tz) << prev_tz;
+      } else {
+        auto lz = (unsigned)reader.read(header_bits);
+        auto len = (unsigned)reader.read(header_bits) + 1;
+        if (lz + len > width)
+          return LOG_STATUS(Status::FilterError(
+              "Cannot decode XOR-encoded data; Invalid bit stream"));
+        auto tz = width - lz - len;
+        x = (T)reader.read_wide(len) << tz;
+        has_window = true;
+        prev_lz = lz;
+        prev_tz = tz;
+      }
+      value ^= x;
+    }
+    std::memcpy(out + i * sizeof(T), &value, sizeof(T));
+  }
+
+  if (reader.overrun())
+    return LOG_STATUS(Status::FilterError(
+        "Cannot decode XOR-encoded data; Truncated bit stream"));
+
+  return Status::Ok();
+}
+
+/** XORs the `num` values of type T in place with their predecessors. */
+template <typename T>
+static void prefix_xor(char* data, uint64_t num) {
+  if (num == 0)
+    return;
+
+  T prev;
+  std::memcpy(&prev, data, sizeof(T));
+  for (uint64_t i = 1; i < num; i++) {
+    T value;
+    std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+    prev ^= value;
+    std::memcpy(data + i * sizeof(T), &prev, sizeof(T));
+  }
+}
+
+XORFilter::XORFilter()
+    : Filter(FilterType::FILTER_XOR) {
+  byte_planes_ = false;
+}
+
+bool XORFilter::byte_planes() const {
+  return byte_planes_;
+}
+
+Status XORFilter::run_forward(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  auto value_size = datatype_size(pipeline_->current_tile()->type());
+  if (value_size != sizeof(uint32_t) && value_size != sizeof(uint64_t))
+    value_size = 0;
+
+  // Compute the upper bound on the size of the output.
+  auto parts = input->buffers();
+  auto num_parts = (uint32_t)parts.size();
+  uint64_t output_size_ub = 0;
+  for (const auto& part : parts)
+    output_size_ub += max_encoded_size(part.size());
+
+  RETURN_NOT_OK(output->prepend_buffer(output_size_ub));
+  Buffer* output_buf = output->buffer_ptr(0);
+  assert(output_buf != nullptr);
+
+  // Forward the existing metadata and write the header.
+  auto input_size = (uint32_t)input->size();
+  uint32_t metadata_size = 2 * sizeof(uint32_t) +
+                           num_parts * (2 * sizeof(uint32_t) + sizeof(uint8_t));
+  RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+  RETURN_NOT_OK(output_metadata->prepend_buffer(metadata_size));
+  RETURN_NOT_OK(output_metadata->write(&input_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&num_parts, sizeof(uint32_t)));
+
+  // Encode all parts
+  for (const auto& part : parts) {
+    auto part_size = (uint32_t)part.size();
+    uint32_t encoded_size;
+    Encoding encoding;
+    RETURN_NOT_OK(
+        encode_part(&part, value_size, output_buf, &encoded_size, &encoding));
+    RETURN_NOT_OK(output_metadata->write(&part_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(output_metadata->write(&encoded_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(output_metadata->write(&encoding, sizeof(uint8_t)));
+  }
+
+  return Status::Ok();
+}
+
+Status XORFilter::encode_part(
+    const ConstBuffer* part,
+    uint64_t value_size,
+    Buffer* output,
+    uint32_t* encoded_size,
+    Encoding* encoding) const {
+  auto part_size = part->size();
+  auto data = static_cast<const char*>(part->data());
+  auto out = static_cast<uint8_t*>(output->cur_data());
+  uint64_t num = value_size == 0 ? 0 : part_size / value_size;
+  uint64_t tail_size = part_size - num * value_size;
+
+  *encoding = Encoding::NONE;
+  uint64_t size = part_size;
+  if (num > 1 && byte_planes_) {
+    // Transposing commutes with XOR, so XOR the planes after shuffling.
+    blosc::shuffle(value_size, part_size, (uint8_t*)data, out);
+    for (uint64_t b = 0; b < value_size; b++) {
+      uint8_t* plane = out + b * num;
+      for (uint64_t i = num - 1; i > 0; i--)
+        plane[i] ^= plane[i - 1];
+    }
+    *encoding = Encoding::BYTE_PLANES;
+  } else if (num > 1) {
+    uint64_t stream_size = value_size == sizeof(uint64_t) ?
+                               gorilla_encode<uint64_t>(data, num, out) :
+                               gorilla_encode<uint32_t>(data, num, out);
+    if (stream_size + tail_size < part_size) {
+      std::memcpy(out + stream_size, data + num * value_size, tail_size);
+      size = stream_size + tail_size;
+      *encoding = Encoding::GORILLA;
+    }
+  }
+
+  if (*encoding == Encoding::NONE)
+    std::memcpy(out, data, part_size);
+
+  if (output->owns_data())
+    output->advance_size(size);
+  output->advance_offset(size);
+  *encoded_size = (uint32_t)size;
+
+  return Status::Ok();
+}
+
+Status XORFilter::run_reverse(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  auto value_size = datatype_size(pipeline_->current_tile()->type());
+
+  uint32_t orig_size, num_parts;
+  RETURN_NOT_OK(input_metadata->read(&orig_size, sizeof(uint32_t)));
+  RETURN_NOT_OK(input_metadata->read(&num_parts, sizeof(uint32_t)));
+
+  RETURN_NOT_OK(output->prepend_buffer(orig_size));
+  Buffer* output_buf = output->buffer_ptr(0);
+  assert(output_buf != nullptr);
+
+  for (uint32_t i = 0; i < num_parts; i++) {
+    uint32_t part_size, encoded_size;
+    Encoding encoding;
+    RETURN_NOT_OK(input_metadata->read(&part_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(input_metadata->read(&encoded_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(input_metadata->read(&encoding, sizeof(uint8_t)));
+    ConstBuffer part(nullptr, 0);
+    RETURN_NOT_OK(input->get_const_buffer(encoded_size, &part));
+
+    RETURN_NOT_OK(
+        decode_part(&part, value_size, encoding, part_size, output_buf));
+
+    if (output_buf->owns_data())
+      output_buf->advance_size(part_size);
+    output_buf->advance_offset(part_size);
+    input->advance_offset(encoded_size);
+  }
+
+  // Output metadata is a view on the input metadata, skipping what was used
+  // by this filter.
+  auto md_offset = input_metadata->offset();
+  RETURN_NOT_OK(output_metadata->append_view(
+      input_metadata, md_offset, input_metadata->size() - md_offset));
+
+  return Status::Ok();
+}
+
+Status XORFilter::decode_part(
+    const ConstBuffer* part,
+    uint64_t value_size,
+    Encoding encoding,
+    uint32_t orig_size,
+    Buffer* output) const {
+  auto data = static_cast<const uint8_t*>(part->data());
+  auto out = static_cast<char*>(output->cur_data());
+
+  if (encoding == Encoding::NONE) {
+    if (part->size() != orig_size)
+      return LOG_STATUS(Status::FilterError(
+          "Cannot decode XOR-encoded data; Invalid part size"));
+    std::memcpy(out, data, orig_size);
+    return Status::Ok();
+  }
+
+  if (value_size != sizeof(uint32_t) && value_size != sizeof(uint64_t))
+    return LOG_STATUS(Status::FilterError(
+        "Cannot decode XOR-encoded data; Unsupported input type"));
+
+  uint64_t num = orig_size / value_size;
+  uint64_t tail_size = orig_size - num * value_size;
+  switch (encoding) {
+    case Encoding::BYTE_PLANES:
+      if (part->size() != orig_size)
+        return LOG_STATUS(Status::FilterError(
+            "Cannot decode XOR-encoded data; Invalid part size"));
+      blosc::unshuffle(value_size, orig_size, (uint8_t*)data, (uint8_t*)out);
+      if (value_size == sizeof(uint64_t))
+        prefix_xor<uint64_t>(out, num);
+      else
+        prefix_xor<uint32_t>(out, num);
+      return Status::Ok();
+    case Encoding::GORILLA: {
+      if (num == 0 || part->size() < tail_size)
+        return LOG_STATUS(Status::FilterError(
+            "Cannot decode XOR-encoded data; Invalid part size"));
+      auto stream_size = part->size() - tail_size;
+      auto st = value_size == sizeof(uint64_t) ?
+                    gorilla_decode<uint64_t>(data, stream_size, num, out) :
+                    gorilla_decode<uint32_t>(data, stream_size, num, out);
+      RETURN_NOT_OK(st);
+      std::memcpy(out + num * value_size, data + stream_size, tail_size);
+      return Status::Ok();
+    }
+    default:
+      return LOG_STATUS(Status::FilterError(
+          "Cannot decode XOR-encoded data; Unknown encoding"));
+  }
+}
+
+uint64_t XORFilter::max_encoded_size(uint64_t part_size) const {
+  // A Gorilla-encoded value takes at most 14 bits more than its width.
+  return byte_planes_ ? part_size : part_size + part_size / 2 + 16;
+}
+
+void XORFilter::set_byte_planes(bool byte_planes) {
+  byte_planes_ = byte_planes;
+}
+
+Status XORFilter::set_option_impl(FilterOption option, const void* value) {
+  if (value == nullptr)
+    return LOG_STATUS(
+        Status::FilterError("XOR filter error; invalid option value"));
+
+  switch (option) {
+    case FilterOption::XOR_BYTE_PLANES:
+      byte_planes_ = *(uint32_t*)value != 0;
+      return Status::Ok();
+    default:
+      return LOG_STATUS(
+          Status::FilterError("XOR filter error; unknown option"));
+  }
+}
+
+Status XORFilter::get_option_impl(FilterOption option, void* value) const {
+  switch (option) {
+    case FilterOption::XOR_BYTE_PLANES:
+      *(uint32_t*)value = byte_planes_ ? 1 : 0;
+      return Status::Ok();
+    default:
+      return LOG_STATUS(
+          Status::FilterError("XOR filter error; unknown option"));
+  }
+}
+
+XORFilter* XORFilter::clone_impl() const {
+  auto clone = new XORFilter;
+  clone->byte_planes_ = byte_planes_;
+  return clone;
+}
+
+Status XORFilter::deserialize_impl(ConstBuffer* buff) {
+  uint8_t byte_planes;
+  RETURN_NOT_OK(buff->read(&byte_planes, sizeof(uint8_t)));
+  byte_planes_ = byte_planes != 0;
+  return Status::Ok();
+}
+
+Status XORFilter::serialize_impl(Buffer* buff) const {
+  auto byte_planes = (uint8_t)(byte_planes_ ? 1 : 0);
+  RETURN_NOT_OK(buff->write(&byte_planes, sizeof(uint8_t)));
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,188 @@
+/**
+ * @file   xor_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class XORFilter.
+ */
+
+#ifndef TILEDB_XOR_FILTER_H
+#define TILEDB_XOR_FILTER_H
+
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/filter/filter.h"
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A filter that encodes 4- or 8-byte values (typically `float32`/`float64`
+ * time series) by XORing every value with the previous one. Consecutive
+ * values of slowly changing series share their sign, exponent and leading
+ * mantissa bits, so the XORed values have long runs of zero bits.
+ *
+ * The filter has two encodings:
+ *
+ * - Gorilla (default): the XORed values are written to a bit stream as in
+ *   Facebook's Gorilla time series database. A zero XOR takes one bit; a
+ *   non-zero XOR stores only its meaningful bits, either within the window of
+ *   leading/trailing zeros of the previous value, or preceded by its own
+ *   number of leading zeros and meaningful bits. Parts that would grow are
+ *   written unmodified.
+ * - Byte planes (option `XOR_BYTE_PLANES`): the XORed values are split into
+ *   byte planes (all first bytes, then all second bytes, etc.), leaving the
+ *   mostly-zero high bytes contiguous for a subsequent compression filter.
+ *   This encoding does not change the data size and decodes much faster.
+ *
+ * Values of any other size are written to the output unmodified. If the
+ * input comes in multiple FilterBuffer parts, each part is encoded
+ * separately. Trailing bytes of a part that do not form a full value are
+ * copied unmodified.
+ *
+ * Input metadata is not modified.
+ *
+ * The forward output metadata has the format:
+ *   uint32_t - Original input number of bytes
+ *   uint32_t - Number of parts
+ *   part0_md
+ *   ...
+ *   partN_md
+ * Where each part*_md has the fixed format:
+ *   uint32_t - Original number of bytes of the part
+ *   uint32_t - Number of encoded bytes of the part
+ *   uint8_t - Encoding of the part (see `XORFilter::Encoding`)
+ *
+ * The forward output data format is the concatenated encoded parts.
+ *
+ * The reverse output data format is simply:
+ *   uint8_t[] - Original input data
+ */
+class XORFilter : public Filter {
+ public:
+  /** The encoding of a part of the input. */
+  enum class Encoding : uint8_t {
+    /** The part is not encoded. */
+    NONE = 0,
+    /** Gorilla bit stream. */
+    GORILLA = 1,
+    /** Byte planes of the XORed values. */
+    BYTE_PLANES = 2
+  };
+
+  /** Constructor. */
+  XORFilter();
+
+  /** Returns `true` if the filter splits the XORed values into byte planes. */
+  bool byte_planes() const;
+
+  /**
+   * XOR-encode the given input into the given output.
+   */
+  Status run_forward(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /**
+   * Decode the XOR-encoded input into the given output.
+   */
+  Status run_reverse(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /** Sets whether to split the XORed values into byte planes. */
+  void set_byte_planes(bool byte_planes);
+
+ private:
+  /** `true` if the XORed values are split into byte planes. */
+  bool byte_planes_;
+
+  /** Returns a new clone of this filter. */
+  XORFilter* clone_impl() const override;
+
+  /** Deserializes this filter's metadata from the given buffer. */
+  Status deserialize_impl(ConstBuffer* buff) override;
+
+  /**
+   * Encodes a part of the filter input.
+   *
+   * @param part Buffer to encode.
+   * @param value_size The value size in bytes (0 if not supported).
+   * @param output Buffer to write the encoded part to. It must have room for
+   *     at least `max_encoded_size(part->size())` bytes.
+   * @param encoded_size Set to the number of encoded bytes.
+   * @param encoding Set to the encoding that was applied.
+   * @return Status
+   */
+  Status encode_part(
+      const ConstBuffer* part,
+      uint64_t value_size,
+      Buffer* output,
+      uint32_t* encoded_size,
+      Encoding* encoding) const;
+
+  /**
+   * Decodes a part of the filter input.
+   *
+   * @param part Buffer to decode.
+   * @param value_size The value size in bytes.
+   * @param encoding The encoding of the part.
+   * @param orig_size The original number of bytes of the part.
+   * @param output Buffer to write the decoded part to.
+   * @return Status
+   */
+  Status decode_part(
+      const ConstBuffer* part,
+      uint64_t value_size,
+      Encoding encoding,
+      uint32_t orig_size,
+      Buffer* output) const;
+
+  /** Gets an option from this filter. */
+  Status get_option_impl(FilterOption option, void* value) const override;
+
+  /**
+   * Returns the maximum number of bytes written by `encode_part` for a part
+   * of the given size.
+   */
+  uint64_t max_encoded_size(uint64_t part_size) const;
+
+  /** Sets an option on this filter. */
+  Status set_option_impl(FilterOption option, const void* value) override;
+
+  /** Serializes this filter's metadata to the given buffer. */
+  Status serialize_impl(Buffer* buff) const override;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_XOR_FILTER_H
@@ -0,0 +1,110 @@
+/**
+ * @file   bloom_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class BloomFilter.
+ */
+
+#include "tiledb/sm/fragment/bloom_filter.h"
+#include "tiledb/sm/misc/constants.h"
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+BloomFilter::BloomFilter()
+    : hash_num_(0) {
+}
+
+BloomFilter::BloomFilter(
+    uint64_t key_num, uint64_t bits_per_key, uint32_t hash_num)
+    : hash_num_(hash_num) {
+  const uint64_t block_bits = constants::bloom_filter_block_words * 64;
+  uint64_t block_num = (key_num * bits_per_key + block_bits - 1) / block_bits;
+  if (block_num == 0)
+    block_num = 1;
+  words_.resize(block_num * constants::bloom_filter_block_words, 0);
+}
+
+BloomFilter::BloomFilter(std::vector<uint64_t>&& words, uint32_t hash_num)
+    : hash_num_(hash_num)
+    , words_(std::move(words)) {
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void BloomFilter::add(uint64_t h1, uint64_t h2) {
+  if (words_.empty())
+    return;
+
+  auto block_num = words_.size() / constants::bloom_filter_block_words;
+  auto block = &words_[(h1 % block_num) * constants::bloom_filter_block_words];
+  auto bit = (uint32_t)h2;
+  auto delta = (uint32_t)(h2 >> 32) | 1;
+  for (uint32_t i = 0; i < hash_num_; ++i, bit += delta) {
+    auto pos = bit % (constants::bloom_filter_block_words * 64);
+    block[pos / 64] |= uint64_t(1) << (pos % 64);
+  }
+}
+
+bool BloomFilter::may_contain(uint64_t h1, uint64_t h2) const {
+  if (words_.empty())
+    return true;
+
+  auto block_num = words_.size() / constants::bloom_filter_block_words;
+  auto block = &words_[(h1 % block_num) * constants::bloom_filter_block_words];
+  auto bit = (uint32_t)h2;
+  auto delta = (uint32_t)(h2 >> 32) | 1;
+  for (uint32_t i = 0; i < hash_num_; ++i, bit += delta) {
+    auto pos = bit % (constants::bloom_filter_block_words * 64);
+    if ((block[pos / 64] & (uint64_t(1) << (pos % 64))) == 0)
+      return false;
+  }
+
+  return true;
+}
+
+bool BloomFilter::empty() const {
+  return words_.empty();
+}
+
+uint32_t BloomFilter::hash_num() const {
+  return hash_num_;
+}
+
+const std::vector<uint64_t>& BloomFilter::words() const {
+  return words_;
+}
+
+}  // namespace sm
+}  // namespace tiledb
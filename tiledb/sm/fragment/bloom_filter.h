@@ -0,0 +1,126 @@
+/**
+ * @file   bloom_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class BloomFilter.
+ */
+
+#ifndef TILEDB_BLOOM_FILTER_H
+#define TILEDB_BLOOM_FILTER_H
+
+#include <cinttypes>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A blocked Bloom filter over 128-bit key hashes, used to rule out the
+ * fragments of a key-value store that cannot contain a key.
+ *
+ * The filter is split into 512-bit blocks. The first half of a hash selects
+ * the block and the second half derives the bits set within it, so that a
+ * lookup touches a single cache line. Since the key-value hashes are already
+ * uniformly distributed, no further hashing is performed.
+ */
+class BloomFilter {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. Creates an empty filter, which contains every key. */
+  BloomFilter();
+
+  /**
+   * Constructor. Creates a filter sized for `key_num` keys.
+   *
+   * @param key_num The number of keys that will be added.
+   * @param bits_per_key The number of filter bits per key.
+   * @param hash_num The number of bits set per key.
+   */
+  BloomFilter(uint64_t key_num, uint64_t bits_per_key, uint32_t hash_num);
+
+  /**
+   * Constructor. Creates a filter from its serialized words.
+   *
+   * @param words The filter words.
+   * @param hash_num The number of bits set per key.
+   */
+  BloomFilter(std::vector<uint64_t>&& words, uint32_t hash_num);
+
+  /** Destructor. */
+  ~BloomFilter() = default;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Adds a key hash to the filter.
+   *
+   * @param h1 The first half of the hash.
+   * @param h2 The second half of the hash.
+   */
+  void add(uint64_t h1, uint64_t h2);
+
+  /**
+   * Checks if the filter may contain a key hash. An empty filter is
+   * considered to contain every key.
+   *
+   * @param h1 The first half of the hash.
+   * @param h2 The second half of the hash.
+   * @return `false` if the key is certainly not in the filter.
+   */
+  bool may_contain(uint64_t h1, uint64_t h2) const;
+
+  /** Returns `true` if the filter has no bits. */
+  bool empty() const;
+
+  /** Returns the number of bits set per key. */
+  uint32_t hash_num() const;
+
+  /** Returns the filter words. */
+  const std::vector<uint64_t>& words() const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The number of bits set per key. */
+  uint32_t hash_num_;
+
+  /** The filter bits, in blocks of `constants::bloom_filter_block_words`. */
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_BLOOM_FILTER_H
@@ -101,10 +101,21 @@ FragmentMetadata::~FragmentMetadata() {
 /*                API             */
 /* ****************************** */
 
+void FragmentMetadata::add_bloom_filter_keys(
+    const uint64_t* coords, uint64_t coords_num) {
+  bloom_filter_keys_.reserve(bloom_filter_keys_.size() + coords_num);
+  for (uint64_t i = 0; i < coords_num; ++i)
+    bloom_filter_keys_.emplace_back(coords[2 * i], coords[2 * i + 1]);
+}
+
 const URI& FragmentMetadata::array_uri() const {
   return array_schema_->array_uri();
 }
 
+bool FragmentMetadata::bloom_filter_may_contain(const uint64_t* coords) const {
+  return bloom_filter_.may_contain(coords[0], coords[1]);
+}
+
 void FragmentMetadata::set_bounding_coords(
     uint64_t tile, const void* bounding_coords) {
   // For easy reference
@@ -191,6 +202,10 @@ void FragmentMetadata::set_tile_var_size(
   tile_var_sizes_[attribute_id][tile] = size;
 }
 
+const std::vector<void*>& FragmentMetadata::bounding_coords() const {
+  return bounding_coords_;
+}
+
 uint64_t FragmentMetadata::cell_num(uint64_t tile_pos) const {
   if (dense_)
     return array_schema_->domain()->cell_num_per_tile();
@@ -342,6 +357,7 @@ Status FragmentMetadata::deserialize(ConstBuffer* buf) {
   RETURN_NOT_OK(load_last_tile_cell_num(buf));
   RETURN_NOT_OK(load_file_sizes(buf));
   RETURN_NOT_OK(load_file_var_sizes(buf));
+  RETURN_NOT_OK(load_bloom_filter(buf));
 
   return Status::Ok();
 }
@@ -362,6 +378,19 @@ uint64_t FragmentMetadata::file_var_sizes(const std::string& attribute) const {
   return file_var_sizes_[attribute_id];
 }
 
+uint32_t FragmentMetadata::format_version() const {
+  return version_;
+}
+
+uint64_t FragmentMetadata::fragment_size() const {
+  uint64_t size = 0;
+  for (auto s : file_sizes_)
+    size += s;
+  for (auto s : file_var_sizes_)
+    size += s;
+  return size;
+}
+
 const URI& FragmentMetadata::fragment_uri() const {
   return fragment_uri_;
 }
@@ -455,6 +484,7 @@ Status FragmentMetadata::serialize(Buffer* buf) {
   RETURN_NOT_OK(write_last_tile_cell_num(buf));
   RETURN_NOT_OK(write_file_sizes(buf));
   RETURN_NOT_OK(write_file_var_sizes(buf));
+  RETURN_NOT_OK(write_bloom_filter(buf));
 
   return Status::Ok();
 }
@@ -736,6 +766,37 @@ Status FragmentMetadata::load_bounding_coords(ConstBuffer* buff) {
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// hash_num (uint32_t)
+// word_num (uint64_t)
+// word_#1 (uint64_t) word_#2 (uint64_t) ...
+Status FragmentMetadata::load_bloom_filter(ConstBuffer* buff) {
+  // Only key-value fragments written with a Bloom filter have one
+  if (!array_schema_->is_kv() || buff->end())
+    return Status::Ok();
+
+  uint32_t hash_num = 0;
+  uint64_t word_num = 0;
+  Status st = buff->read(&hash_num, sizeof(uint32_t));
+  if (st.ok())
+    st = buff->read(&word_num, sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading Bloom filter size failed"));
+  }
+
+  std::vector<uint64_t> words(word_num);
+  if (word_num > 0)
+    st = buff->read(words.data(), word_num * sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading Bloom filter failed"));
+  }
+  bloom_filter_ = BloomFilter(std::move(words), hash_num);
+
+  return Status::Ok();
+}
+
 // ===== FORMAT =====
 // file_sizes_attr#0 (uint64_t)
 // ...
@@ -1006,6 +1067,41 @@ Status FragmentMetadata::write_bounding_coords(Buffer* buff) {
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// hash_num (uint32_t)
+// word_num (uint64_t)
+// word_#1 (uint64_t) word_#2 (uint64_t) ...
+Status FragmentMetadata::write_bloom_filter(Buffer* buff) {
+  if (!array_schema_->is_kv())
+    return Status::Ok();
+
+  // Build the filter from the keys added since it was last built
+  if (!bloom_filter_keys_.empty()) {
+    bloom_filter_ = BloomFilter(
+        bloom_filter_keys_.size(),
+        constants::bloom_filter_bits_per_key,
+        constants::bloom_filter_hash_num);
+    for (const auto& key : bloom_filter_keys_)
+      bloom_filter_.add(key.first, key.second);
+    bloom_filter_keys_.clear();
+  }
+
+  auto hash_num = bloom_filter_.hash_num();
+  const auto& words = bloom_filter_.words();
+  auto word_num = (uint64_t)words.size();
+  Status st = buff->write(&hash_num, sizeof(uint32_t));
+  if (st.ok())
+    st = buff->write(&word_num, sizeof(uint64_t));
+  if (st.ok() && word_num > 0)
+    st = buff->write(words.data(), word_num * sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing Bloom filter failed"));
+  }
+
+  return Status::Ok();
+}
+
 // ===== FORMAT =====
 // file_sizes_attr#0 (uint64_t)
 // ...
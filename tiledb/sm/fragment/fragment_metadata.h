@@ -37,6 +37,7 @@
 #include "tiledb/sm/array_schema/array_schema.h"
 #include "tiledb/sm/buffer/buffer.h"
 #include "tiledb/sm/enums/query_type.h"
+#include "tiledb/sm/fragment/bloom_filter.h"
 #include "tiledb/sm/misc/status.h"
 
 #include <vector>
@@ -73,9 +74,35 @@ class FragmentMetadata {
   /*                API                */
   /* ********************************* */
 
+  /**
+   * Adds the coordinates of key-value cells written to the fragment, i.e.,
+   * their key hashes, to the keys of the fragment Bloom filter. The filter
+   * is built when the metadata are serialized.
+   *
+   * @param coords The coordinates (pairs of `uint64_t` hash halves).
+   * @param coords_num The number of coordinates.
+   */
+  void add_bloom_filter_keys(const uint64_t* coords, uint64_t coords_num);
+
   /** Returns the array URI. */
   const URI& array_uri() const;
 
+  /**
+   * Checks if the fragment may contain the input key-value coordinates,
+   * based on its Bloom filter. This is always `true` for fragments without
+   * a Bloom filter.
+   *
+   * @param coords The coordinates (a pair of `uint64_t` hash halves).
+   * @return `false` if the fragment certainly does not contain the key.
+   */
+  bool bloom_filter_may_contain(const uint64_t* coords) const;
+
+  /**
+   * Returns the bounding coordinates of the tiles, i.e., the coordinates of
+   * the first and last cell of each tile.
+   */
+  const std::vector<void*>& bounding_coords() const;
+
   /** Returns the number of cells in the tile at the input position. */
   uint64_t cell_num(uint64_t tile_pos) const;
 
@@ -220,6 +247,15 @@ class FragmentMetadata {
   /** Returns the size of the input variable attribute. */
   uint64_t file_var_sizes(const std::string& attribute) const;
 
+  /** Returns the format version of the fragment. */
+  uint32_t format_version() const;
+
+  /**
+   * Returns the total size in bytes of the fragment files, i.e., the sum of
+   * the fixed and var-sized file sizes of all attributes and coordinates.
+   */
+  uint64_t fragment_size() const;
+
   /** Returns the fragment URI. */
   const URI& fragment_uri() const;
 
@@ -451,6 +487,12 @@ class FragmentMetadata {
   /** The array schema */
   const ArraySchema* array_schema_;
 
+  /** The Bloom filter of the key hashes (key-value fragments only). */
+  BloomFilter bloom_filter_;
+
+  /** The key hashes added since the Bloom filter was last built. */
+  std::vector<std::pair<uint64_t, uint64_t>> bloom_filter_keys_;
+
   /** Maps an attribute to an index used in the various vector class members. */
   std::unordered_map<std::string, unsigned> attribute_idx_map_;
 
@@ -577,6 +619,12 @@ class FragmentMetadata {
    */
   Status load_bounding_coords(ConstBuffer* buff);
 
+  /**
+   * Loads the Bloom filter of a key-value fragment from the buffer. Older
+   * fragments have no filter, in which case the filter is left empty.
+   */
+  Status load_bloom_filter(ConstBuffer* buff);
+
   /** Loads the sizes of each attribute file from the buffer. */
   Status load_file_sizes(ConstBuffer* buff);
 
@@ -642,6 +690,12 @@ class FragmentMetadata {
    */
   Status write_bounding_coords(Buffer* buff);
 
+  /**
+   * Builds the Bloom filter from the added keys and writes it to the
+   * buffer. Applicable only to key-value fragments.
+   */
+  Status write_bloom_filter(Buffer* buff);
+
   /** Writes the sizes of each attribute file in the buffer. */
   Status write_file_sizes(Buffer* buff);
 
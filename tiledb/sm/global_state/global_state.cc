@@ -31,6 +31,7 @@
  */
 
 #include "tiledb/sm/global_state/global_state.h"
+#include "tiledb/sm/buffer/buffer_pool.h"
 #include "tiledb/sm/global_state/openssl_state.h"
 #include "tiledb/sm/global_state/signal_handlers.h"
 #include "tiledb/sm/global_state/tbb_state.h"
@@ -67,6 +68,11 @@ Status GlobalState::initialize(Config* config) {
     }
     RETURN_NOT_OK(Watchdog::GetWatchdog().initialize());
     RETURN_NOT_OK(init_openssl());
+    // The buffer pool is shared by the process, so only the first context
+    // sizes it
+    BufferPool::buffer_pool().set_cache_sizes(
+        config_.sm_params().buffer_pool_shared_cache_size_,
+        config_.sm_params().buffer_pool_thread_cache_size_);
     initialized_ = true;
   }
 
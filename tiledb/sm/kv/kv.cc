@@ -32,9 +32,16 @@
 
 #include "tiledb/sm/kv/kv.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/misc/uuid.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <sstream>
 
 namespace tiledb {
 namespace sm {
@@ -45,11 +52,21 @@ namespace sm {
 
 KV::KV(const URI& kv_uri, StorageManager* storage_manager)
     : kv_uri_(kv_uri)
-    , storage_manager_(storage_manager) {
+    , storage_manager_(storage_manager)
+    , flush_threshold_(0)
+    , flushing_(false)
+    , flushing_wal_fd_(INVALID_FILELOCK)
+    , items_size_(0)
+    , wal_(false)
+    , wal_fd_(INVALID_FILELOCK)
+    , wal_seq_(0)
+    , wal_sync_(false) {
   array_ = new Array(kv_uri, storage_manager);
 }
 
 KV::~KV() {
+  if (flush_thread_.joinable())
+    flush_thread_.join();
   clear();
   delete array_;
 }
@@ -72,7 +89,8 @@ Status KV::is_dirty(bool* dirty) const {
     return LOG_STATUS(Status::KVError(
         "Cannot check if dirty; Key-value store was not opened in write mode"));
 
-  *dirty = !items_.empty();
+  std::unique_lock<std::mutex> lck(mtx_);
+  *dirty = !items_.empty() || flushing_ || !flushing_items_.empty();
 
   return Status::Ok();
 }
@@ -86,11 +104,26 @@ Status KV::open(
     return LOG_STATUS(Status::KVError(
         "Cannot open key-value store; Key-value store already open"));
 
+  // The items left in the write-ahead log are read before opening the array
+  wal_ = storage_manager_->config().sm_params().kv_wal_;
+  std::vector<URI> wal_uris;
+  std::vector<std::unique_ptr<Buffer>> wal_buffers;
+  if (wal_ && query_type == QueryType::READ)
+    RETURN_NOT_OK(read_wal(&wal_uris, &wal_buffers, nullptr));
+
   RETURN_NOT_OK(
       array_->open(query_type, encryption_type, encryption_key, key_length));
 
   prepare_attributes_and_read_buffer_sizes();
 
+  auto st = (query_type == QueryType::WRITE) ? prepare_writes(encryption_type) :
+                                               replay_wal(wal_buffers);
+  if (!st.ok()) {
+    array_->close();
+    clear();
+    return st;
+  }
+
   return Status::Ok();
 }
 
@@ -123,10 +156,14 @@ Status KV::close() {
     return Status::Ok();
 
   std::unique_lock<std::mutex> lck(mtx_);
+  wait_flush(&lck);
+  auto st = flush_status_;
   RETURN_NOT_OK(array_->close());
   clear();
 
-  return Status::Ok();
+  // Report the failure of the last background flush. Its items are
+  // preserved in the write-ahead log, if enabled.
+  return st;
 }
 
 bool KV::is_open() const {
@@ -147,7 +184,25 @@ Status KV::add_item(const KVItem* kv_item) {
 
   auto new_item = new KVItem();
   *new_item = *kv_item;
-  items_[new_item->key()->hash_] = new_item;
+  auto key = new_item->key();
+  new_item->set_hash(KVItem::compute_hash(
+      key->key_, key->key_type_, key->key_size_, kv_hash()));
+
+  // Log the item before buffering it
+  if (wal_)
+    RETURN_NOT_OK_ELSE(wal_append(*new_item), delete new_item);
+
+  auto& item = items_[key->hash_];
+  if (item != nullptr) {
+    items_size_ -= item_size(*item);
+    delete item;
+  }
+  item = new_item;
+  items_size_ += item_size(*new_item);
+
+  // Flush in the background once the buffered items are large enough
+  if (flush_threshold_ != 0 && items_size_ >= flush_threshold_)
+    RETURN_NOT_OK(schedule_flush(&lck));
 
   return Status::Ok();
 }
@@ -170,7 +225,11 @@ Status KV::get_item(
         Status::KVError("Cannot get item; Memory allocation failed"));
 
   // Set key
-  auto st = (*kv_item)->set_key(key, key_type, key_size);
+  auto st = (*kv_item)->set_key(
+      key,
+      key_type,
+      key_size,
+      KVItem::compute_hash(key, key_type, key_size, kv_hash()));
   if (!st.ok()) {
     delete *kv_item;
     *kv_item = nullptr;
@@ -282,6 +341,110 @@ Status KV::get_item(const KVItem::Hash& hash, KVItem** kv_item) {
   return Status::Ok();
 }
 
+Status KV::get_items(
+    const std::vector<const void*>& keys,
+    const std::vector<Datatype>& key_types,
+    const std::vector<uint64_t>& key_sizes,
+    std::vector<KVItem*>* kv_items) {
+  // Take the lock.
+  std::unique_lock<std::mutex> lck(mtx_);
+
+  QueryType query_type;
+  RETURN_NOT_OK(array_->get_query_type(&query_type));
+  if (query_type != QueryType::READ)
+    return LOG_STATUS(Status::KVError(
+        "Cannot get items; Key-value store was not opened in read mode"));
+
+  auto key_num = keys.size();
+  if (key_types.size() != key_num || key_sizes.size() != key_num)
+    return LOG_STATUS(Status::KVError(
+        "Cannot get items; The numbers of keys, key types and key sizes "
+        "differ"));
+  for (uint64_t i = 0; i < key_num; ++i) {
+    if (keys[i] == nullptr || key_sizes[i] == 0)
+      return LOG_STATUS(
+          Status::KVError("Cannot get items; Key cannot be empty"));
+  }
+
+  // Hash all the keys
+  auto hash_fn = kv_hash();
+  std::vector<KVItem::Hash> hashes(key_num);
+  for (uint64_t i = 0; i < key_num; ++i)
+    hashes[i] =
+        KVItem::compute_hash(keys[i], key_types[i], key_sizes[i], hash_fn);
+
+  // Copy the buffered items, and sort the rest of the keys on their hashes
+  kv_items->assign(key_num, nullptr);
+  std::vector<uint64_t> pending;
+  for (uint64_t i = 0; i < key_num; ++i) {
+    auto it = items_.find(hashes[i]);
+    if (it == items_.end()) {
+      pending.push_back(i);
+      continue;
+    }
+    auto kv_item = new (std::nothrow) KVItem();
+    if (kv_item == nullptr) {
+      clear_items(kv_items);
+      return LOG_STATUS(
+          Status::KVError("Cannot get items; Memory allocation failed"));
+    }
+    *kv_item = *(it->second);
+    (*kv_items)[i] = kv_item;
+  }
+  std::sort(pending.begin(), pending.end(), [&](uint64_t a, uint64_t b) {
+    return hashes[a] < hashes[b];
+  });
+
+  // Assign each key to the first tile whose MBR contains its hash, skipping
+  // the fragments whose Bloom filter rules the key out. Keys that fall in
+  // no MBR do not exist.
+  std::vector<const uint64_t*> group_mbrs;
+  std::vector<std::vector<uint64_t>> groups;
+  std::vector<bool> assigned(key_num, false);
+  for (auto meta : array_->fragment_metadata()) {
+    for (auto mbr_ptr : meta->mbrs()) {
+      auto mbr = static_cast<const uint64_t*>(mbr_ptr);
+      auto it = std::lower_bound(
+          pending.begin(),
+          pending.end(),
+          mbr[0],
+          [&](uint64_t i, uint64_t value) { return hashes[i].first < value; });
+      std::vector<uint64_t> group;
+      for (; it != pending.end() && hashes[*it].first <= mbr[1]; ++it) {
+        uint64_t coords[] = {hashes[*it].first, hashes[*it].second};
+        if (!assigned[*it] && hashes[*it].second >= mbr[2] &&
+            hashes[*it].second <= mbr[3] &&
+            meta->bloom_filter_may_contain(coords)) {
+          group.push_back(*it);
+          assigned[*it] = true;
+        }
+      }
+      if (!group.empty()) {
+        group_mbrs.push_back(mbr);
+        groups.emplace_back(std::move(group));
+      }
+    }
+  }
+
+  // Read each tile once for all its keys
+  for (size_t g = 0; g < groups.size(); ++g) {
+    auto st = read_items(
+        group_mbrs[g],
+        groups[g],
+        keys,
+        key_types,
+        key_sizes,
+        hashes,
+        kv_items);
+    if (!st.ok()) {
+      clear_items(kv_items);
+      return st;
+    }
+  }
+
+  return Status::Ok();
+}
+
 Status KV::has_key(
     const void* key, Datatype key_type, uint64_t key_size, bool* has_key) {
   // Take the lock.
@@ -297,7 +460,11 @@ Status KV::has_key(
   KVItem kv_item;
 
   // Set key
-  RETURN_NOT_OK(kv_item.set_key(key, key_type, key_size));
+  RETURN_NOT_OK(kv_item.set_key(
+      key,
+      key_type,
+      key_size,
+      KVItem::compute_hash(key, key_type, key_size, kv_hash())));
 
   // If the item is buffered, copy and return
   auto it = items_.find(kv_item.key()->hash_);
@@ -323,15 +490,20 @@ Status KV::flush() {
         Status::KVError("Cannot flush key-value store; Key-value store was not "
                         "opened in write mode"));
 
+  // Flush the items of a failed background flush first
+  wait_flush(&lck);
+  RETURN_NOT_OK(
+      flush_items(&flushing_items_, flushing_wal_uri_, &flushing_wal_fd_));
+  flush_status_ = Status::Ok();
+
   // No items to flush
   if (items_.empty())
     return Status::Ok();
 
-  clear_write_buffers();
-  RETURN_NOT_OK(populate_write_buffers());
-  RETURN_NOT_OK(submit_write_query());
-
-  clear_items();
+  RETURN_NOT_OK(flush_items(&items_, wal_uri_, &wal_fd_));
+  items_size_ = 0;
+  if (wal_)
+    wal_uri_ = wal_new_uri();
 
   return Status::Ok();
 }
@@ -349,9 +521,21 @@ Status KV::get_query_type(QueryType* query_type) const {
 }
 
 void KV::clear_items() {
-  for (auto& i : items_)
+  clear_items(&items_);
+  items_size_ = 0;
+}
+
+void KV::clear_items(std::map<KVItem::Hash, KVItem*>* items) {
+  for (auto& i : *items)
     delete i.second;
-  items_.clear();
+  items->clear();
+}
+
+void KV::clear_items(std::vector<KVItem*>* kv_items) {
+  for (auto& kv_item : *kv_items) {
+    delete kv_item;
+    kv_item = nullptr;
+  }
 }
 
 void KV::clear_read_buffers() {
@@ -390,7 +574,15 @@ Status KV::reopen() {
     return LOG_STATUS(Status::KVError(
         "Cannot reopen key-value store; Key-value store is not open"));
 
-  return array_->reopen();
+  // Refresh the items left in the write-ahead log
+  std::vector<URI> wal_uris;
+  std::vector<std::unique_ptr<Buffer>> wal_buffers;
+  if (wal_)
+    RETURN_NOT_OK(read_wal(&wal_uris, &wal_buffers, nullptr));
+  RETURN_NOT_OK(array_->reopen());
+  clear_items();
+
+  return replay_wal(wal_buffers);
 }
 
 /* ********************************* */
@@ -435,16 +627,171 @@ Status KV::add_value(const std::string& attribute, const KVItem::Value& value) {
   return Status::Ok();
 }
 
+void KV::background_flush() {
+  auto st = flush_items(&flushing_items_, flushing_wal_uri_, &flushing_wal_fd_);
+
+  std::unique_lock<std::mutex> lck(mtx_);
+  flush_status_ = st;
+  flushing_ = false;
+  flush_cv_.notify_all();
+}
+
 void KV::clear() {
   attributes_.clear();
   attribute_types_.clear();
 
   clear_items();
+  clear_items(&flushing_items_);
   clear_read_buffers();
   clear_write_buffers();
+
+  // The logs of unflushed items are closed but kept, so that they are
+  // flushed by the next writer
+  auto vfs = storage_manager_->vfs();
+  if (flushing_wal_fd_ != INVALID_FILELOCK)
+    vfs->close_locked(flushing_wal_fd_);
+  if (wal_fd_ != INVALID_FILELOCK)
+    vfs->close_locked(wal_fd_);
+
+  flush_status_ = Status::Ok();
+  flush_threshold_ = 0;
+  flushing_wal_fd_ = INVALID_FILELOCK;
+  flushing_wal_uri_ = URI();
+  wal_ = false;
+  wal_fd_ = INVALID_FILELOCK;
+  wal_id_.clear();
+  wal_sync_ = false;
+  wal_uri_ = URI();
+}
+
+Status KV::flush_items(
+    std::map<KVItem::Hash, KVItem*>* items,
+    const URI& wal_uri,
+    filelock_t* wal_fd,
+    uint64_t timestamp) {
+  if (!items->empty()) {
+    URI fragment_uri;
+    if (timestamp != 0) {
+      std::string uuid;
+      RETURN_NOT_OK(uuid::generate_uuid(&uuid, false));
+      std::stringstream ss;
+      ss << "__" << uuid << "_" << timestamp;
+      fragment_uri = kv_uri_.join_path(ss.str());
+    }
+    clear_write_buffers();
+    RETURN_NOT_OK(populate_write_buffers(*items));
+    RETURN_NOT_OK(submit_write_query(fragment_uri));
+    clear_items(items);
+  }
+
+  // The log is no longer needed once its items are persisted. It is removed
+  // before being unlocked, so that no other writer flushes it again.
+  if (*wal_fd != INVALID_FILELOCK) {
+    auto vfs = storage_manager_->vfs();
+    RETURN_NOT_OK(vfs->remove_file(wal_uri));
+    auto fd = *wal_fd;
+    *wal_fd = INVALID_FILELOCK;
+    RETURN_NOT_OK(vfs->close_locked(fd));
+  }
+
+  return Status::Ok();
+}
+
+uint64_t KV::item_size(const KVItem& kv_item) const {
+  uint64_t size = kv_item.key()->key_size_;
+  for (const auto& attr : attributes_) {
+    auto value = kv_item.value(attr);
+    if (value != nullptr)
+      size += value->value_size_;
+  }
+  return size;
+}
+
+KVHash KV::kv_hash() const {
+  return array_->array_schema()->kv_hash();
+}
+
+bool KV::may_contain(const KVItem::Hash& hash) const {
+  uint64_t coords[] = {hash.first, hash.second};
+  for (auto meta : array_->fragment_metadata()) {
+    if (meta->bloom_filter_may_contain(coords))
+      return true;
+  }
+  return false;
+}
+
+// ===== FORMAT =====
+// record_size (uint64_t)
+// timestamp (uint64_t)
+// key_type (uint8_t)
+// key_size (uint64_t)
+// key (void*)
+// value_size#1 (uint64_t) value#1 (void*) ...
+Status KV::parse_wal(
+    const Buffer& wal_buffer,
+    std::map<KVItem::Hash, KVItem*>* items,
+    uint64_t* timestamp) {
+  auto schema = array_->array_schema();
+  auto hash_fn = kv_hash();
+  ConstBuffer cbuff(wal_buffer.data(), wal_buffer.size());
+  while (cbuff.nbytes_left_to_read() >= sizeof(uint64_t)) {
+    // A record that was not fully written is ignored
+    uint64_t record_size;
+    RETURN_NOT_OK(cbuff.read(&record_size, sizeof(uint64_t)));
+    if (record_size > cbuff.nbytes_left_to_read())
+      break;
+    ConstBuffer record((const char*)cbuff.data() + cbuff.offset(), record_size);
+    cbuff.advance_offset(record_size);
+
+    // Timestamp
+    uint64_t record_timestamp;
+    RETURN_NOT_OK(record.read(&record_timestamp, sizeof(uint64_t)));
+
+    // Key
+    uint8_t key_type_c;
+    uint64_t key_size;
+    RETURN_NOT_OK(record.read(&key_type_c, sizeof(uint8_t)));
+    RETURN_NOT_OK(record.read(&key_size, sizeof(uint64_t)));
+    if (key_size > record.nbytes_left_to_read())
+      return LOG_STATUS(
+          Status::KVError("Cannot replay write-ahead log; Invalid key size"));
+    auto key = (const char*)record.data() + record.offset();
+    auto key_type = static_cast<Datatype>(key_type_c);
+    record.advance_offset(key_size);
+    std::unique_ptr<KVItem> kv_item(new KVItem());
+    RETURN_NOT_OK(kv_item->set_key(
+        key,
+        key_type,
+        key_size,
+        KVItem::compute_hash(key, key_type, key_size, hash_fn)));
+
+    // Values
+    for (const auto& attr : attributes_) {
+      if (attr == constants::coords || attr == constants::key_attr_name)
+        continue;
+      uint64_t value_size;
+      RETURN_NOT_OK(record.read(&value_size, sizeof(uint64_t)));
+      if (value_size > record.nbytes_left_to_read())
+        return LOG_STATUS(Status::KVError(
+            "Cannot replay write-ahead log; Invalid value size"));
+      auto value = (const char*)record.data() + record.offset();
+      record.advance_offset(value_size);
+      RETURN_NOT_OK(
+          kv_item->set_value(attr, value, schema->type(attr), value_size));
+    }
+
+    // Later records override earlier ones
+    auto& item = (*items)[kv_item->hash()];
+    delete item;
+    item = kv_item.release();
+    *timestamp = std::max(*timestamp, record_timestamp);
+  }
+
+  return Status::Ok();
 }
 
-Status KV::populate_write_buffers() {
+Status KV::populate_write_buffers(
+    const std::map<KVItem::Hash, KVItem*>& items) {
   assert(array_->is_open());
   auto schema = array_->array_schema();
 
@@ -465,7 +812,7 @@ Status KV::populate_write_buffers() {
     }
   }
 
-  for (const auto& item : items_) {
+  for (const auto& item : items) {
     auto key = (item.second)->key();
     assert(key != nullptr);
     RETURN_NOT_OK(add_key(*key));
@@ -497,7 +844,58 @@ void KV::prepare_attributes_and_read_buffer_sizes() {
   }
 }
 
+Status KV::prepare_writes(EncryptionType encryption_type) {
+  flush_threshold_ = storage_manager_->config().sm_params().kv_flush_threshold_;
+  if (!wal_)
+    return Status::Ok();
+
+  if (!kv_uri_.is_file())
+    return LOG_STATUS(
+        Status::KVError("Cannot open key-value store; The write-ahead log is "
+                        "only supported on local filesystems"));
+  if (encryption_type != EncryptionType::NO_ENCRYPTION)
+    return LOG_STATUS(
+        Status::KVError("Cannot open key-value store; The write-ahead log is "
+                        "not supported for encrypted key-value stores"));
+
+  // Flush the items left in the logs of crashed writers, oldest first. The
+  // logs of live writers are locked, and are left to them. Each log becomes
+  // a fragment stamped with the time of its last record, so that it does
+  // not override the fragments written after the crash.
+  std::vector<URI> wal_uris;
+  std::vector<std::unique_ptr<Buffer>> wal_buffers;
+  std::vector<filelock_t> wal_fds;
+  auto st = read_wal(&wal_uris, &wal_buffers, &wal_fds);
+  for (size_t i = 0; st.ok() && i < wal_fds.size(); ++i) {
+    std::map<KVItem::Hash, KVItem*> items;
+    uint64_t timestamp = 0;
+    st = parse_wal(*wal_buffers[i], &items, &timestamp);
+    if (st.ok())
+      st = flush_items(&items, wal_uris[i], &wal_fds[i], timestamp);
+    clear_items(&items);
+  }
+  auto vfs = storage_manager_->vfs();
+  for (auto fd : wal_fds) {
+    if (fd != INVALID_FILELOCK)
+      vfs->close_locked(fd);
+  }
+  RETURN_NOT_OK(st);
+
+  RETURN_NOT_OK(vfs->create_dir(kv_uri_.join_path(constants::kv_wal_dir_name)));
+  RETURN_NOT_OK(uuid::generate_uuid(&wal_id_, false));
+  wal_sync_ = storage_manager_->config().sm_params().kv_wal_sync_;
+  wal_uri_ = wal_new_uri();
+
+  return Status::Ok();
+}
+
 Status KV::read_item(const KVItem::Hash& hash, bool* found) {
+  // Avoid any I/O if the key is certainly not stored
+  if (!may_contain(hash)) {
+    *found = false;
+    return Status::Ok();
+  }
+
   // Prepare subarray
   uint64_t subarray[4];
   subarray[0] = hash.first;
@@ -533,6 +931,135 @@ Status KV::read_item(const KVItem::Hash& hash, bool* found) {
   return Status::Ok();
 }
 
+Status KV::read_items(
+    const uint64_t* subarray,
+    const std::vector<uint64_t>& group,
+    const std::vector<const void*>& keys,
+    const std::vector<Datatype>& key_types,
+    const std::vector<uint64_t>& key_sizes,
+    const std::vector<KVItem::Hash>& hashes,
+    std::vector<KVItem*>* kv_items) {
+  // Read all the items in the subarray
+  RETURN_NOT_OK(array_->compute_max_buffer_sizes(
+      subarray, attributes_, &read_buffer_sizes_));
+  if (read_buffer_sizes_[constants::coords].first == 0)
+    return Status::Ok();
+  RETURN_NOT_OK(realloc_read_buffers());
+  RETURN_NOT_OK(submit_read_query(subarray));
+
+  // The results are in row-major order, i.e., sorted on the hashes
+  auto schema = array_->array_schema();
+  auto coords =
+      static_cast<const uint64_t*>(read_buffers_[constants::coords].first);
+  auto cell_num =
+      read_buffer_sizes_[constants::coords].first / (2 * sizeof(uint64_t));
+  uint64_t cell = 0;
+  for (auto i : group) {
+    // Find the cell of the key
+    const auto& hash = hashes[i];
+    while (cell < cell_num &&
+           KVItem::Hash(coords[2 * cell], coords[2 * cell + 1]) < hash)
+      ++cell;
+    if (cell == cell_num ||
+        KVItem::Hash(coords[2 * cell], coords[2 * cell + 1]) != hash)
+      continue;
+
+    // Create the item
+    std::unique_ptr<KVItem> kv_item(new (std::nothrow) KVItem());
+    if (kv_item == nullptr)
+      return LOG_STATUS(
+          Status::KVError("Cannot get items; Memory allocation failed"));
+    RETURN_NOT_OK(kv_item->set_key(keys[i], key_types[i], key_sizes[i], hash));
+    for (const auto& attr : attributes_) {
+      const void* value;
+      uint64_t value_size;
+      if (!schema->var_size(attr)) {
+        value_size = schema->cell_size(attr);
+        value = (const char*)read_buffers_[attr].first + cell * value_size;
+      } else {
+        auto offsets = static_cast<const uint64_t*>(read_buffers_[attr].first);
+        auto end = (cell + 1 < cell_num) ? offsets[cell + 1] :
+                                           read_buffer_sizes_[attr].second;
+        value = (const char*)read_buffers_[attr].second + offsets[cell];
+        value_size = end - offsets[cell];
+      }
+      RETURN_NOT_OK(
+          kv_item->set_value(attr, value, schema->type(attr), value_size));
+    }
+    (*kv_items)[i] = kv_item.release();
+  }
+
+  return Status::Ok();
+}
+
+Status KV::read_wal(
+    std::vector<URI>* wal_uris,
+    std::vector<std::unique_ptr<Buffer>>* wal_buffers,
+    std::vector<filelock_t>* wal_fds) {
+  auto vfs = storage_manager_->vfs();
+  auto wal_dir = kv_uri_.join_path(constants::kv_wal_dir_name);
+  bool is_dir;
+  RETURN_NOT_OK(vfs->is_dir(wal_dir, &is_dir));
+  if (!is_dir)
+    return Status::Ok();
+
+  // Sort the log files on their creation timestamp and sequence number
+  std::vector<URI> uris;
+  RETURN_NOT_OK(vfs->ls(wal_dir, &uris));
+  std::vector<std::pair<std::pair<uint64_t, uint64_t>, URI>> sorted_uris;
+  for (const auto& uri : uris) {
+    uint64_t timestamp, seq;
+    if (std::sscanf(
+            uri.last_path_part().c_str(),
+            "%" SCNu64 "_%" SCNu64,
+            &timestamp,
+            &seq) == 2)
+      sorted_uris.emplace_back(std::make_pair(timestamp, seq), uri);
+  }
+  std::sort(
+      sorted_uris.begin(),
+      sorted_uris.end(),
+      [](const std::pair<std::pair<uint64_t, uint64_t>, URI>& a,
+         const std::pair<std::pair<uint64_t, uint64_t>, URI>& b) {
+        return a.first < b.first;
+      });
+
+  // Read the log files. A log that is locked belongs to a live writer.
+  for (const auto& uri : sorted_uris) {
+    if (wal_fds != nullptr) {
+      filelock_t fd;
+      RETURN_NOT_OK(vfs->open_locked(uri.second, &fd));
+      if (fd == INVALID_FILELOCK)
+        continue;
+      wal_fds->push_back(fd);
+      wal_uris->push_back(uri.second);
+    }
+
+    // A log removed since the listing was flushed by its writer, so its
+    // items are in the fragments
+    uint64_t size;
+    auto st = vfs->file_size(uri.second, &size);
+    if (!st.ok()) {
+      bool is_file;
+      RETURN_NOT_OK(vfs->is_file(uri.second, &is_file));
+      if (is_file)
+        return st;
+      if (wal_fds != nullptr)
+        wal_buffers->emplace_back(new Buffer());
+      continue;
+    }
+    std::unique_ptr<Buffer> buff(new Buffer());
+    RETURN_NOT_OK(buff->realloc(size));
+    RETURN_NOT_OK(vfs->read(uri.second, 0, buff->data(), size));
+    buff->set_size(size);
+    if (wal_fds == nullptr)
+      wal_uris->push_back(uri.second);
+    wal_buffers->push_back(std::move(buff));
+  }
+
+  return Status::Ok();
+}
+
 Status KV::realloc_read_buffers() {
   assert(array_->is_open());
   auto schema = array_->array_schema();
@@ -588,6 +1115,65 @@ Status KV::realloc_read_buffers() {
   return Status::Ok();
 }
 
+Status KV::replay_wal(
+    const std::vector<std::unique_ptr<Buffer>>& wal_buffers) {
+  // A log older than the newest fragment may hold items that were since
+  // overwritten, so it is left to be flushed by the next writer
+  uint64_t newest_timestamp = 0;
+  for (auto meta : array_->fragment_metadata())
+    newest_timestamp = std::max(newest_timestamp, meta->timestamp());
+
+  for (const auto& buff : wal_buffers) {
+    std::map<KVItem::Hash, KVItem*> items;
+    uint64_t timestamp = 0;
+    auto st = parse_wal(*buff, &items, &timestamp);
+    if (!st.ok() || timestamp < newest_timestamp) {
+      clear_items(&items);
+      RETURN_NOT_OK(st);
+      continue;
+    }
+
+    // Later logs override earlier ones
+    for (auto& it : items) {
+      auto& item = items_[it.first];
+      delete item;
+      item = it.second;
+    }
+  }
+
+  return Status::Ok();
+}
+
+Status KV::schedule_flush(std::unique_lock<std::mutex>* lck) {
+  wait_flush(lck);
+  auto st = flush_status_;
+
+  // The items of a failed flush are flushed again before new ones
+  if (flushing_items_.empty()) {
+    std::swap(flushing_items_, items_);
+    flushing_wal_uri_ = wal_uri_;
+    flushing_wal_fd_ = wal_fd_;
+    wal_fd_ = INVALID_FILELOCK;
+    items_size_ = 0;
+    if (wal_)
+      wal_uri_ = wal_new_uri();
+  }
+
+  flushing_ = true;
+  try {
+    flush_thread_ = std::thread(&KV::background_flush, this);
+  } catch (const std::exception& e) {
+    flushing_ = false;
+    return LOG_STATUS(Status::KVError(
+        std::string("Cannot flush key-value store in the background; ") +
+        e.what()));
+  }
+
+  // Report the failure of the previous flush, whose items are being
+  // flushed again
+  return st;
+}
+
 Status KV::set_read_query_buffers(Query* query) {
   assert(array_->is_open());
   auto schema = array_->array_schema();
@@ -649,8 +1235,8 @@ Status KV::submit_read_query(const uint64_t* subarray) {
   return Status::Ok();
 }
 
-Status KV::submit_write_query() {
-  auto query = new Query(storage_manager_, array_);
+Status KV::submit_write_query(const URI& fragment_uri) {
+  auto query = new Query(storage_manager_, array_, fragment_uri);
   RETURN_NOT_OK_ELSE(set_write_query_buffers(query), delete query);
   RETURN_NOT_OK_ELSE(query->submit(), delete query);
   delete query;
@@ -658,5 +1244,75 @@ Status KV::submit_write_query() {
   return Status::Ok();
 }
 
+void KV::wait_flush(std::unique_lock<std::mutex>* lck) {
+  flush_cv_.wait(*lck, [this]() { return !flushing_; });
+  if (flush_thread_.joinable())
+    flush_thread_.join();
+}
+
+// ===== FORMAT =====
+// record_size (uint64_t)
+// timestamp (uint64_t)
+// key_type (uint8_t)
+// key_size (uint64_t)
+// key (void*)
+// value_size#1 (uint64_t) value#1 (void*) ...
+Status KV::wal_append(const KVItem& kv_item) {
+  Buffer buff;
+  uint64_t record_size = 0;
+  auto timestamp = utils::time::timestamp_now_ms();
+  auto key = kv_item.key();
+  auto key_type_c = static_cast<uint8_t>(key->key_type_);
+  RETURN_NOT_OK(buff.write(&record_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff.write(&timestamp, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff.write(&key_type_c, sizeof(uint8_t)));
+  RETURN_NOT_OK(buff.write(&key->key_size_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff.write(key->key_, key->key_size_));
+  for (const auto& attr : attributes_) {
+    if (attr == constants::coords || attr == constants::key_attr_name)
+      continue;
+    auto value = kv_item.value(attr);
+    assert(value != nullptr);
+    RETURN_NOT_OK(buff.write(&value->value_size_, sizeof(uint64_t)));
+    RETURN_NOT_OK(buff.write(value->value_, value->value_size_));
+  }
+  record_size = buff.size() - sizeof(uint64_t);
+  std::memcpy(buff.data(), &record_size, sizeof(uint64_t));
+
+  // A single append, so that a crash leaves at most one partial record
+  if (wal_fd_ == INVALID_FILELOCK)
+    RETURN_NOT_OK(wal_open());
+  return storage_manager_->vfs()->append_locked(
+      wal_fd_, buff.data(), buff.size(), wal_sync_);
+}
+
+URI KV::wal_new_uri() {
+  std::stringstream ss;
+  ss << utils::time::timestamp_now_ms() << "_" << wal_seq_++ << "_" << wal_id_
+     << constants::file_suffix;
+  return kv_uri_.join_path(constants::kv_wal_dir_name).join_path(ss.str());
+}
+
+Status KV::wal_open() {
+  auto vfs = storage_manager_->vfs();
+  auto tmp_uri = kv_uri_.join_path(constants::kv_wal_dir_name)
+                     .join_path("." + wal_uri_.last_path_part());
+  filelock_t fd;
+  RETURN_NOT_OK(vfs->open_locked(tmp_uri, &fd));
+  if (fd == INVALID_FILELOCK)
+    return LOG_STATUS(Status::KVError(
+        "Cannot create write-ahead log; The log file is already locked"));
+
+  auto st = vfs->move_file(tmp_uri, wal_uri_);
+  if (!st.ok()) {
+    vfs->close_locked(fd);
+    vfs->remove_file(tmp_uri);
+    return st;
+  }
+  wal_fd_ = fd;
+
+  return Status::Ok();
+}
+
 }  // namespace sm
 }  // namespace tiledb
@@ -37,13 +37,17 @@
 #include "tiledb/sm/enums/array_type.h"
 #include "tiledb/sm/enums/datatype.h"
 #include "tiledb/sm/enums/query_type.h"
+#include "tiledb/sm/filesystem/filelock.h"
 #include "tiledb/sm/kv/kv_item.h"
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
 
+#include <condition_variable>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace tiledb {
@@ -52,10 +56,20 @@ namespace sm {
 /**
  * This is a key-value store. It enables both reading/writing with
  * thread- and process-safety. Upon writes, the written items are
- * available for reading. Written items are buffered and periodically
- * flushed into the disk. The user can call `flush` to force-write
- * the buffered items to the disk at any point. All items are
- * flushed upon `close` or destroying a `KV` object.
+ * available for reading. Written items are buffered in memory (the
+ * memtable) and flushed into the disk as a new fragment, either when
+ * the user calls `flush`, or in the background once the buffered items
+ * exceed `sm.kv.flush_threshold` bytes. Writers keep adding items to a
+ * fresh memtable while a background flush is in progress.
+ *
+ * If `sm.kv.wal` is set, every added item is first appended to a
+ * write-ahead log, one log file per memtable, which is deleted once the
+ * memtable is flushed. A writer keeps its log open and locked until then.
+ * The logs that are no longer locked, because their writer crashed, are
+ * flushed when the key-value store is next opened for writes, each into a
+ * fragment stamped with the time of its last record. When the key-value
+ * store is opened for reads, the logs that are not older than the newest
+ * fragment are served from memory before the persisted fragments.
  */
 class KV {
  public:
@@ -73,7 +87,11 @@ class KV {
   /*                API                */
   /* ********************************* */
 
-  /** Adds a key-value item to the store. */
+  /**
+   * Adds a key-value item to the store. If this starts a background flush
+   * while the previous one had failed, the error of the previous flush is
+   * returned, although the item is added.
+   */
   Status add_item(const KVItem* kv_item);
 
   /** The tile capacity of the KV schema. */
@@ -120,6 +138,25 @@ class KV {
    */
   Status get_item(const KVItem::Hash& hash, KVItem** kv_item);
 
+  /**
+   * Gets several key-value items from the key-value store. This function
+   * first searches in the buffered items. The remaining keys are grouped by
+   * the persisted tile whose MBR contains them, and a single read query is
+   * submitted per tile, answering all the keys of the group.
+   *
+   * @param keys The keys to query on.
+   * @param key_types The key types.
+   * @param key_sizes The key sizes.
+   * @param kv_items Set to one key-value item per key, or `nullptr` if the
+   *     key does not exist. The caller is responsible for deleting them.
+   * @return Status
+   */
+  Status get_items(
+      const std::vector<const void*>& keys,
+      const std::vector<Datatype>& key_types,
+      const std::vector<uint64_t>& key_sizes,
+      std::vector<KVItem*>* kv_items);
+
   /**
    * Checks if the key-value store contains a particular key.
    *
@@ -252,7 +289,55 @@ class KV {
   StorageManager* storage_manager_;
 
   /** Mutex for thread-safety. */
-  std::mutex mtx_;
+  mutable std::mutex mtx_;
+
+  /** The buffered items size that triggers a background flush. */
+  uint64_t flush_threshold_;
+
+  /** Notified when a background flush completes. */
+  std::condition_variable flush_cv_;
+
+  /** The status of the last background flush. */
+  Status flush_status_;
+
+  /** The background flush thread. */
+  std::thread flush_thread_;
+
+  /** `true` while a background flush is in progress. */
+  bool flushing_;
+
+  /**
+   * The items being flushed in the background, indexed on their hash.
+   * They remain here if the flush fails, until the next flush succeeds.
+   */
+  std::map<KVItem::Hash, KVItem*> flushing_items_;
+
+  /** The write-ahead log of `flushing_items_`. */
+  URI flushing_wal_uri_;
+
+  /** The locked handle of `flushing_wal_uri_`, if it was created. */
+  filelock_t flushing_wal_fd_;
+
+  /** The total size of the keys and values of `items_`. */
+  uint64_t items_size_;
+
+  /** `true` if the write-ahead log is enabled. */
+  bool wal_;
+
+  /** The locked handle of `wal_uri_`, if it was created. */
+  filelock_t wal_fd_;
+
+  /** A unique identifier of this writer, part of its log file names. */
+  std::string wal_id_;
+
+  /** The sequence number of the next write-ahead log file. */
+  uint64_t wal_seq_;
+
+  /** `true` if every write-ahead log append is synced. */
+  bool wal_sync_;
+
+  /** The write-ahead log of `items_`. */
+  URI wal_uri_;
 
   /* ********************************* */
   /*          PRIVATE METHODS          */
@@ -276,18 +361,181 @@ class KV {
   /** Frees memory of items. */
   void clear_items();
 
+  /** Frees the memory of the input items. */
+  static void clear_items(std::map<KVItem::Hash, KVItem*>* items);
+
+  /** Deletes the input key-value items and resets them to `nullptr`. */
+  static void clear_items(std::vector<KVItem*>* kv_items);
+
   /** Clears the read buffers.*/
   void clear_read_buffers();
 
   /** Clears the write buffers.*/
   void clear_write_buffers();
 
-  /** Populates the write buffers with the buffered key-value items. */
-  Status populate_write_buffers();
+  /** Returns the key hash function of the open key-value store. */
+  KVHash kv_hash() const;
+
+  /**
+   * Checks the fragment Bloom filters for a key hash.
+   *
+   * @param hash The key hash.
+   * @return `false` if no fragment can contain the key.
+   */
+  bool may_contain(const KVItem::Hash& hash) const;
+
+  /**
+   * The body of the background flush thread. It writes `flushing_items_`
+   * and records the outcome in `flush_status_`.
+   */
+  void background_flush();
+
+  /**
+   * Writes the input items to persistent storage as a new fragment, and
+   * deletes their write-ahead log on success. The items are then freed.
+   *
+   * @param items The items to write.
+   * @param wal_uri The write-ahead log of the items.
+   * @param wal_fd The locked handle of the log, which is closed once the
+   *     log is deleted. If it is `INVALID_FILELOCK`, the log was never
+   *     created.
+   * @param timestamp The timestamp of the new fragment, in ms since the
+   *     epoch. If it is 0, the current time is used.
+   * @return Status
+   */
+  Status flush_items(
+      std::map<KVItem::Hash, KVItem*>* items,
+      const URI& wal_uri,
+      filelock_t* wal_fd,
+      uint64_t timestamp = 0);
+
+  /** Returns the total size of the key and values of an item. */
+  uint64_t item_size(const KVItem& kv_item) const;
+
+  /**
+   * Reads the existing write-ahead log files. This must take place before
+   * opening the array, so that items that are concurrently flushed into a
+   * new fragment are found either in the logs or in the fragments.
+   *
+   * @param wal_uris The URIs of the log files, in the order they were
+   *     created.
+   * @param wal_buffers The contents of the log files.
+   * @param wal_fds If not null, only the logs that are not locked by a live
+   *     writer are read. They are locked, and their handles are returned
+   *     here, even if reading fails, so that the caller can close them.
+   * @return Status
+   */
+  Status read_wal(
+      std::vector<URI>* wal_uris,
+      std::vector<std::unique_ptr<Buffer>>* wal_buffers,
+      std::vector<filelock_t>* wal_fds);
+
+  /**
+   * Adds the items recorded in write-ahead log contents to `items_`. The
+   * logs whose last record is older than the newest fragment are skipped,
+   * since their items may have been overwritten since.
+   *
+   * @param wal_buffers The contents of the log files, oldest first.
+   * @return Status
+   */
+  Status replay_wal(const std::vector<std::unique_ptr<Buffer>>& wal_buffers);
+
+  /**
+   * Starts flushing `items_` in the background, after waiting for the
+   * previous background flush to complete. If the previous flush failed,
+   * its items are flushed again instead and its error is returned, once
+   * the new flush has started.
+   *
+   * @param lck The lock on `mtx_`, released while waiting.
+   * @return Status
+   */
+  Status schedule_flush(std::unique_lock<std::mutex>* lck);
+
+  /**
+   * Waits for the background flush in progress, if any, to complete.
+   *
+   * @param lck The lock on `mtx_`, released while waiting.
+   */
+  void wait_flush(std::unique_lock<std::mutex>* lck);
+
+  /**
+   * Appends an item to the write-ahead log, creating the log first if
+   * needed. The append is synced if `sm.kv.wal_sync` is set.
+   *
+   * @param kv_item The item to log.
+   * @return Status
+   */
+  Status wal_append(const KVItem& kv_item);
+
+  /** Returns the URI of a new write-ahead log file. */
+  URI wal_new_uri();
+
+  /**
+   * Creates the write-ahead log file `wal_uri_` and locks it. The file is
+   * created under a hidden name and renamed once locked, so that writers
+   * recovering the logs of crashed writers never see it unlocked.
+   *
+   * @return Status
+   */
+  Status wal_open();
+
+  /**
+   * Parses the items recorded in the contents of a write-ahead log file.
+   * A trailing record that was only partially written is ignored.
+   *
+   * @param wal_buffer The contents of the log file.
+   * @param items The parsed items, indexed on their hash. A later record of
+   *     a key overrides the earlier ones.
+   * @param timestamp Set to the timestamp of the latest record, if any.
+   * @return Status
+   */
+  Status parse_wal(
+      const Buffer& wal_buffer,
+      std::map<KVItem::Hash, KVItem*>* items,
+      uint64_t* timestamp);
+
+  /**
+   * Populates the write buffers with key-value items.
+   *
+   * @param items The items to write.
+   * @return Status
+   */
+  Status populate_write_buffers(const std::map<KVItem::Hash, KVItem*>& items);
+
+  /**
+   * Reads the items of a group of keys from persistent storage. All the
+   * key hashes must fall in the input subarray.
+   *
+   * @param subarray The subarray to read, typically the MBR of a tile.
+   * @param group The indices of the keys in `keys`, sorted on their hashes.
+   * @param keys The keys.
+   * @param key_types The key types.
+   * @param key_sizes The key sizes.
+   * @param hashes The key hashes.
+   * @param kv_items The items of the keys that are found are set.
+   * @return Status
+   */
+  Status read_items(
+      const uint64_t* subarray,
+      const std::vector<uint64_t>& group,
+      const std::vector<const void*>& keys,
+      const std::vector<Datatype>& key_types,
+      const std::vector<uint64_t>& key_sizes,
+      const std::vector<KVItem::Hash>& hashes,
+      std::vector<KVItem*>* kv_items);
 
   /** Initializations when opening the KV. */
   void prepare_attributes_and_read_buffer_sizes();
 
+  /**
+   * Prepares the memtable and the write-ahead log for writes, flushing the
+   * items left in the log by a crashed writer.
+   *
+   * @param encryption_type The key-value store encryption type.
+   * @return Status
+   */
+  Status prepare_writes(EncryptionType encryption_type);
+
   /**
    * Reads a key-value item from persistent storage and into the local
    * read buffers, given the input key information.
@@ -313,8 +561,14 @@ class KV {
   /** Submits a read query. */
   Status submit_read_query(const uint64_t* subarray);
 
-  /** Submits a write query. */
-  Status submit_write_query();
+  /**
+   * Submits a write query.
+   *
+   * @param fragment_uri The URI of the new fragment. If it is empty, a new
+   *     fragment name with the current timestamp is used.
+   * @return Status
+   */
+  Status submit_write_query(const URI& fragment_uri = URI());
 };
 
 }  // namespace sm
@@ -32,6 +32,7 @@
 
 #include "tiledb/sm/kv/kv_item.h"
 #include "md5/md5.h"
+#include "murmur3/murmur3.h"
 #include "tiledb/sm/misc/logger.h"
 
 #include <iostream>
@@ -131,8 +132,7 @@ const KVItem::Value* KVItem::value(const std::string& attribute) const {
 }
 
 Status KVItem::set_key(const void* key, Datatype key_type, uint64_t key_size) {
-  auto hash = compute_hash(key, key_type, key_size);
-  return set_key(key, key_type, key_size, hash);
+  return set_key(key, key_type, key_size, Hash());
 }
 
 Status KVItem::set_key(
@@ -155,6 +155,10 @@ Status KVItem::set_key(
   return Status::Ok();
 }
 
+void KVItem::set_hash(const Hash& hash) {
+  copy_hash(hash);
+}
+
 Status KVItem::set_value(
     const std::string& attribute,
     const void* value,
@@ -201,12 +205,23 @@ Status KVItem::set_value(
 /* ********************************* */
 
 KVItem::Hash KVItem::compute_hash(
-    const void* key, Datatype key_type, uint64_t key_size) {
+    const void* key, Datatype key_type, uint64_t key_size, KVHash kv_hash) {
   // Case of empty key
   if (key == nullptr)
     return Hash();
 
   Hash hash;
+  if (kv_hash == KVHash::KV_HASH_MURMUR3_128) {
+    // The key type is mixed in as the seed and the key size by the hash
+    // finalization, so the key is hashed in place
+    uint64_t digest[2];
+    murmur3::MurmurHash3_x64_128(
+        key, key_size, (uint32_t)key_type, digest);
+    hash.first = digest[0];
+    hash.second = digest[1];
+    return hash;
+  }
+
   md5::MD5_CTX md5_ctx;
   uint64_t coord_size = sizeof(md5_ctx.digest) / 2;
   assert(coord_size == sizeof(uint64_t));
@@ -34,6 +34,7 @@
 #define TILEDB_KV_ITEM_H
 
 #include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/kv_hash.h"
 #include "tiledb/sm/misc/status.h"
 
 #include <map>
@@ -121,8 +122,8 @@ class KVItem {
   const Value* value(const std::string& attribute) const;
 
   /**
-   * Sets the key of the key-value item. This function also computes and
-   * sets the hash of the key.
+   * Sets the key of the key-value item. The hash of the key is left unset,
+   * since it depends on the key-value store the item is added to.
    *
    * @param key The key to be set.
    * @param key_type The key type to be set.
@@ -143,6 +144,9 @@ class KVItem {
   Status set_key(
       const void* key, Datatype key_type, uint64_t key_size, const Hash& hash);
 
+  /** Sets the hash of the key of the key-value item. */
+  void set_hash(const Hash& hash);
+
   /**
    * Sets the value for a particular attribute of the key-value item.
    *
@@ -164,9 +168,18 @@ class KVItem {
   /**
    * Computes and returns a hash on a key, key type and key size tuple as a
    * pair of `uint64_t` values.
+   *
+   * @param key The key.
+   * @param key_type The key type.
+   * @param key_size The key size (in bytes).
+   * @param kv_hash The hash function to use.
+   * @return The hash.
    */
   static Hash compute_hash(
-      const void* key, Datatype key_type, uint64_t key_size);
+      const void* key,
+      Datatype key_type,
+      uint64_t key_size,
+      KVHash kv_hash = KVHash::KV_HASH_MD5);
 
  private:
   /* ********************************* */
@@ -0,0 +1,325 @@
+/**
+ * @file   checksum.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines the checksum functions used to verify data integrity.
+ */
+
+#include "tiledb/sm/misc/checksum.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#include <nmmintrin.h>
+#define TILEDB_CRC32C_HW
+#define TILEDB_TARGET_SSE42
+#elif defined(__GNUC__) || defined(__clang__)
+#include <cpuid.h>
+#include <nmmintrin.h>
+#define TILEDB_CRC32C_HW
+#define TILEDB_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#endif
+
+namespace tiledb {
+namespace sm {
+
+namespace checksum {
+
+namespace {
+
+/* ****************************** */
+/*             CRC32C             */
+/* ****************************** */
+
+/** The reflected CRC32C (Castagnoli) polynomial. */
+const uint32_t crc32c_poly = 0x82F63B78;
+
+/** Lookup tables of the slicing-by-8 software implementation. */
+struct CRC32CTables {
+  uint32_t t[8][256];
+
+  CRC32CTables() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (int j = 0; j < 8; ++j)
+        crc = (crc >> 1) ^ (crc32c_poly & (0 - (crc & 1)));
+      t[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i)
+      for (int k = 1; k < 8; ++k)
+        t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+  }
+};
+
+/** Returns the (lazily built) software lookup tables. */
+const CRC32CTables& crc32c_tables() {
+  static const CRC32CTables tables;
+  return tables;
+}
+
+/** Software CRC32C over the given bytes, on the inverted checksum. */
+uint32_t crc32c_sw(uint32_t crc, const unsigned char* p, uint64_t nbytes) {
+  const auto& t = crc32c_tables().t;
+  for (; nbytes >= 8; nbytes -= 8, p += 8) {
+    uint32_t lo, hi;
+    std::memcpy(&lo, p, sizeof(uint32_t));
+    std::memcpy(&hi, p + 4, sizeof(uint32_t));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    lo = __builtin_bswap32(lo);
+    hi = __builtin_bswap32(hi);
+#endif
+    lo ^= crc;
+    crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^
+          t[4][lo >> 24] ^ t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^
+          t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+  }
+  for (; nbytes > 0; --nbytes, ++p)
+    crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xff];
+  return crc;
+}
+
+#ifdef TILEDB_CRC32C_HW
+/** Hardware CRC32C over the given bytes, on the inverted checksum. */
+TILEDB_TARGET_SSE42 uint32_t
+crc32c_hw(uint32_t crc, const unsigned char* p, uint64_t nbytes) {
+  uint64_t crc64 = crc;
+  for (; nbytes >= 32; nbytes -= 32, p += 32) {
+    uint64_t v[4];
+    std::memcpy(v, p, sizeof(v));
+    crc64 = _mm_crc32_u64(crc64, v[0]);
+    crc64 = _mm_crc32_u64(crc64, v[1]);
+    crc64 = _mm_crc32_u64(crc64, v[2]);
+    crc64 = _mm_crc32_u64(crc64, v[3]);
+  }
+  for (; nbytes >= 8; nbytes -= 8, p += 8) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    crc64 = _mm_crc32_u64(crc64, v);
+  }
+  crc = (uint32_t)crc64;
+  for (; nbytes > 0; --nbytes, ++p)
+    crc = _mm_crc32_u8(crc, *p);
+  return crc;
+}
+
+/** Returns `true` if the processor supports SSE4.2. */
+bool cpu_has_sse42() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int cpu_info[4];
+  __cpuid(cpu_info, 1);
+  return (cpu_info[2] & (1 << 20)) != 0;
+#else
+  unsigned eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+  return (ecx & bit_SSE4_2) != 0;
+#endif
+}
+#endif
+
+/** The CRC32C implementation selected for this processor. */
+typedef uint32_t (*CRC32CFunc)(uint32_t, const unsigned char*, uint64_t);
+
+/** Selects the CRC32C implementation for this processor. */
+CRC32CFunc select_crc32c() {
+#ifdef TILEDB_CRC32C_HW
+  if (cpu_has_sse42())
+    return crc32c_hw;
+#endif
+  return crc32c_sw;
+}
+
+/** Returns the CRC32C implementation selected for this processor. */
+CRC32CFunc crc32c_func() {
+  static const CRC32CFunc func = select_crc32c();
+  return func;
+}
+
+/* ****************************** */
+/*            XXHASH64            */
+/* ****************************** */
+
+const uint64_t xxh_prime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t xxh_prime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t xxh_prime3 = 0x165667B19E3779F9ULL;
+const uint64_t xxh_prime4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t xxh_prime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl64(uint64_t x, unsigned r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const unsigned char* p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
+
+inline uint32_t read32(const unsigned char* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap32(v);
+#endif
+  return v;
+}
+
+inline uint64_t xxh_round(uint64_t acc, uint64_t input) {
+  acc += input * xxh_prime2;
+  acc = rotl64(acc, 31);
+  return acc * xxh_prime1;
+}
+
+inline uint64_t xxh_merge_round(uint64_t acc, uint64_t val) {
+  acc ^= xxh_round(0, val);
+  return acc * xxh_prime1 + xxh_prime4;
+}
+
+/** Consumes the full 32-byte stripes of the input; returns the bytes read. */
+uint64_t xxh_stripes(uint64_t* acc, const unsigned char* p, uint64_t nbytes) {
+  uint64_t a0 = acc[0], a1 = acc[1], a2 = acc[2], a3 = acc[3];
+  const unsigned char* start = p;
+  for (; nbytes >= 32; nbytes -= 32, p += 32) {
+    a0 = xxh_round(a0, read64(p));
+    a1 = xxh_round(a1, read64(p + 8));
+    a2 = xxh_round(a2, read64(p + 16));
+    a3 = xxh_round(a3, read64(p + 24));
+  }
+  acc[0] = a0;
+  acc[1] = a1;
+  acc[2] = a2;
+  acc[3] = a3;
+  return (uint64_t)(p - start);
+}
+
+}  // namespace
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+uint32_t crc32c(uint32_t crc, const void* data, uint64_t nbytes) {
+  auto p = static_cast<const unsigned char*>(data);
+  return ~crc32c_func()(~crc, p, nbytes);
+}
+
+bool crc32c_hardware() {
+#ifdef TILEDB_CRC32C_HW
+  return crc32c_func() == crc32c_hw;
+#else
+  return false;
+#endif
+}
+
+XXHash64::XXHash64(uint64_t seed)
+    : seed_(seed)
+    , pending_size_(0)
+    , total_size_(0) {
+  acc_[0] = seed + xxh_prime1 + xxh_prime2;
+  acc_[1] = seed + xxh_prime2;
+  acc_[2] = seed;
+  acc_[3] = seed - xxh_prime1;
+}
+
+void XXHash64::update(const void* data, uint64_t nbytes) {
+  auto p = static_cast<const unsigned char*>(data);
+  total_size_ += nbytes;
+
+  // Complete a pending stripe first
+  if (pending_size_ > 0) {
+    uint64_t n = 32 - pending_size_;
+    if (n > nbytes)
+      n = nbytes;
+    std::memcpy(pending_ + pending_size_, p, n);
+    pending_size_ += (unsigned)n;
+    p += n;
+    nbytes -= n;
+    if (pending_size_ < 32)
+      return;
+    xxh_stripes(acc_, pending_, 32);
+    pending_size_ = 0;
+  }
+
+  uint64_t nread = xxh_stripes(acc_, p, nbytes);
+  std::memcpy(pending_, p + nread, nbytes - nread);
+  pending_size_ = (unsigned)(nbytes - nread);
+}
+
+uint64_t XXHash64::digest() const {
+  uint64_t h;
+  if (total_size_ >= 32) {
+    h = rotl64(acc_[0], 1) + rotl64(acc_[1], 7) + rotl64(acc_[2], 12) +
+        rotl64(acc_[3], 18);
+    for (int i = 0; i < 4; ++i)
+      h = xxh_merge_round(h, acc_[i]);
+  } else {
+    h = seed_ + xxh_prime5;
+  }
+  h += total_size_;
+
+  const unsigned char* p = pending_;
+  unsigned n = pending_size_;
+  for (; n >= 8; n -= 8, p += 8) {
+    h ^= xxh_round(0, read64(p));
+    h = rotl64(h, 27) * xxh_prime1 + xxh_prime4;
+  }
+  if (n >= 4) {
+    h ^= (uint64_t)read32(p) * xxh_prime1;
+    h = rotl64(h, 23) * xxh_prime2 + xxh_prime3;
+    n -= 4;
+    p += 4;
+  }
+  for (; n > 0; --n, ++p) {
+    h ^= (*p) * xxh_prime5;
+    h = rotl64(h, 11) * xxh_prime1;
+  }
+
+  h ^= h >> 33;
+  h *= xxh_prime2;
+  h ^= h >> 29;
+  h *= xxh_prime3;
+  h ^= h >> 32;
+  return h;
+}
+
+uint64_t xxhash64(const void* data, uint64_t nbytes, uint64_t seed) {
+  XXHash64 hash(seed);
+  hash.update(data, nbytes);
+  return hash.digest();
+}
+
+}  // namespace checksum
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,98 @@
+/**
+ * @file   checksum.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares the checksum functions used to verify data integrity.
+ */
+
+#ifndef TILEDB_CHECKSUM_H
+#define TILEDB_CHECKSUM_H
+
+#include <cstdint>
+
+namespace tiledb {
+namespace sm {
+
+namespace checksum {
+
+/**
+ * Updates a CRC32C (Castagnoli) checksum with the given bytes. Start with
+ * `crc = 0`; feeding the data in several calls gives the same result as a
+ * single call over the concatenated data.
+ *
+ * On x86-64 processors with SSE4.2 the hardware CRC32 instruction is used,
+ * otherwise a table-driven (slicing-by-8) implementation.
+ *
+ * @param crc The checksum of the preceding bytes.
+ * @param data The bytes to add to the checksum.
+ * @param nbytes The number of bytes.
+ * @return The updated checksum.
+ */
+uint32_t crc32c(uint32_t crc, const void* data, uint64_t nbytes);
+
+/** Returns `true` if `crc32c` uses the hardware CRC32 instruction. */
+bool crc32c_hardware();
+
+/** Incremental computation of the 64-bit xxHash (XXH64) of a byte stream. */
+class XXHash64 {
+ public:
+  /** Constructor. */
+  explicit XXHash64(uint64_t seed = 0);
+
+  /** Returns the hash of all bytes added so far. */
+  uint64_t digest() const;
+
+  /** Adds the given bytes to the hashed stream. */
+  void update(const void* data, uint64_t nbytes);
+
+ private:
+  /** The hash seed. */
+  uint64_t seed_;
+
+  /** The four accumulators of the 32-byte stripes. */
+  uint64_t acc_[4];
+
+  /** Bytes that do not yet form a full stripe. */
+  unsigned char pending_[32];
+
+  /** Number of valid bytes in `pending_`. */
+  unsigned pending_size_;
+
+  /** Total number of bytes added. */
+  uint64_t total_size_;
+};
+
+/** Returns the 64-bit xxHash (XXH64) of the given bytes. */
+uint64_t xxhash64(const void* data, uint64_t nbytes, uint64_t seed = 0);
+
+}  // namespace checksum
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_CHECKSUM_H
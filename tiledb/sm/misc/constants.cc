@@ -81,6 +81,29 @@ const std::string kv_schema_filename = "__kv_schema.tdb";
 /** The fragment metadata file name. */
 const std::string fragment_metadata_filename = "__fragment_metadata.tdb";
 
+/** The consolidated fragment metadata file name. */
+const std::string consolidated_fragment_metadata_filename =
+    "__fragment_metadata_consolidated.tdb";
+
+/** The fragment manifest file name. */
+const std::string fragment_manifest_filename = "__fragment_manifest.tdb";
+
+/** The name of the lock file serializing the fragment manifest updates. */
+const std::string fragment_manifest_lock_filename =
+    "__fragment_manifest_lock.tdb";
+
+/** The key-value write-ahead log directory name. */
+const std::string kv_wal_dir_name = "__kv_wal";
+
+/** The number of 64-bit words in a key-value Bloom filter block. */
+const uint64_t bloom_filter_block_words = 8;
+
+/** The number of key-value Bloom filter bits per key. */
+const uint64_t bloom_filter_bits_per_key = 10;
+
+/** The number of key-value Bloom filter bits set per key. */
+const uint32_t bloom_filter_hash_num = 6;
+
 /** The default tile capacity. */
 const uint64_t capacity = 10000;
 
@@ -189,6 +212,12 @@ const std::string group_filename = "__tiledb_group.tdb";
 /** The buffer size for each attribute used in consolidation. */
 const uint64_t consolidation_buffer_size = 50000000;
 
+/**
+ * The minimum buffer size for each attribute used in consolidation, when
+ * the buffers are shrunk to fit in the memory budget.
+ */
+const uint64_t consolidation_min_buffer_size = 1024 * 1024;
+
 /** The maximum number of bytes written in a single I/O. */
 const uint64_t max_write_bytes = std::numeric_limits<int>::max();
 
@@ -221,6 +250,18 @@ const uint64_t array_schema_cache_size = 10000000;
 /** The fragment metadata cache size. */
 const uint64_t fragment_metadata_cache_size = 10000000;
 
+/** Whether fragment commits are recorded in the array fragment manifest. */
+const bool fragment_manifest = false;
+
+/** Whether key-value writes are recorded in a write-ahead log. */
+const bool kv_wal = false;
+
+/** Whether every key-value write-ahead log append is synced. */
+const bool kv_wal_sync = true;
+
+/** The buffered key-value bytes that trigger a background flush. */
+const uint64_t kv_flush_threshold = 0;
+
 /** Whether or not the signal handlers are installed. */
 const bool enable_signal_handlers = true;
 
@@ -243,6 +284,55 @@ const int num_tbb_threads = -1;
 /** The tile cache size. */
 const uint64_t tile_cache_size = 10000000;
 
+/** The global memory budget of a storage manager, in bytes. */
+const uint64_t memory_budget = 5000000000;
+
+/** The minimum number of fragments merged in a consolidation step. */
+const uint64_t consolidation_step_min_frags = 2;
+
+/** The maximum number of fragments merged in a consolidation step. */
+const uint64_t consolidation_step_max_frags =
+    std::numeric_limits<uint32_t>::max();
+
+/** The size ratio two adjacent fragments must satisfy to be consolidated. */
+const float consolidation_step_size_ratio = 0.0f;
+
+/** The maximum total size of the fragments of a consolidation step. */
+const uint64_t consolidation_step_max_bytes = 0;
+
+/** The number of subarray partitions read concurrently in consolidation. */
+const uint64_t consolidation_num_threads = std::thread::hardware_concurrency();
+
+/** Whether the background consolidation service is enabled. */
+const bool consolidation_background = false;
+
+/** The period in ms at which the consolidation service checks the arrays. */
+const uint64_t consolidation_background_interval_ms = 1000;
+
+/** The fragment number that triggers background consolidation. */
+const uint64_t consolidation_background_frag_num = 8;
+
+/** The unconsolidated bytes that trigger background consolidation. */
+const uint64_t consolidation_background_frag_bytes = 0;
+
+/** The target foreground query latency of background consolidation. */
+const uint64_t consolidation_background_latency_ms = 0;
+
+/** The smallest block size served by the buffer pool. */
+const uint64_t buffer_pool_min_block_size = 4 * 1024;
+
+/** The largest block size served by the buffer pool. */
+const uint64_t buffer_pool_max_block_size = 64 * 1024 * 1024;
+
+/** The maximum number of bytes cached by the buffer pool per thread. */
+const uint64_t buffer_pool_thread_cache_size = 32 * 1024 * 1024;
+
+/** The maximum number of bytes cached by the buffer pool across threads. */
+const uint64_t buffer_pool_shared_cache_size = 256 * 1024 * 1024;
+
+/** The size of the blocks a query arena requests from the buffer pool. */
+const uint64_t arena_block_size = 1024 * 1024;
+
 /** Empty String **/
 const std::string empty_str = "";
 
@@ -275,6 +365,12 @@ const std::string no_encryption_str = "NO_ENCRYPTION";
 /** String describing AES_256_GCM. */
 const std::string aes_256_gcm_str = "AES_256_GCM";
 
+/** String describing the MD5 key-value hash. */
+const std::string kv_hash_md5_str = "KV_HASH_MD5";
+
+/** String describing the MurmurHash3 key-value hash. */
+const std::string kv_hash_murmur3_128_str = "KV_HASH_MURMUR3_128";
+
 /** String describing GZIP. */
 const std::string gzip_str = "GZIP";
 
@@ -390,12 +486,33 @@ const std::string null_str = "null";
 const int32_t library_version[3] = {
     TILEDB_VERSION_MAJOR, TILEDB_VERSION_MINOR, TILEDB_VERSION_PATCH};
 
-/** The TileDB serialization format version number. */
-const uint32_t format_version = 1;
+/**
+ * The TileDB serialization format version number. Version 2 adds the key
+ * hash to the key-value store schema.
+ */
+const uint32_t format_version = 2;
 
 /** The maximum size of a tile chunk (unit of compression) in bytes. */
 const uint64_t max_tile_chunk_size = 64 * 1024;
 
+/**
+ * The number of scratch buffers that the filter storage of a thread keeps
+ * allocated to the maximum chunk size.
+ */
+const uint64_t filter_storage_scratch_buffer_num = 4;
+
+/**
+ * The factor by which a filter storage buffer may outgrow its reserved size
+ * and still be kept for reuse.
+ */
+const uint64_t filter_storage_max_buffer_growth = 2;
+
+/** The number of bytes of a tile chunk sampled by the auto filter. */
+const uint64_t auto_filter_sample_size = 4096;
+
+/** The number of evenly spaced slices the auto filter sample consists of. */
+const uint64_t auto_filter_sample_slice_num = 4;
+
 /** The default attribute name prefix. */
 const std::string default_attr_name = "__attr";
 
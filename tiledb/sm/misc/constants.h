@@ -158,6 +158,27 @@ extern const std::string file_suffix;
 /** The fragment metadata file name. */
 extern const std::string fragment_metadata_filename;
 
+/** The consolidated fragment metadata file name. */
+extern const std::string consolidated_fragment_metadata_filename;
+
+/** The fragment manifest file name. */
+extern const std::string fragment_manifest_filename;
+
+/** The name of the lock file serializing the fragment manifest updates. */
+extern const std::string fragment_manifest_lock_filename;
+
+/** The key-value write-ahead log directory name. */
+extern const std::string kv_wal_dir_name;
+
+/** The number of 64-bit words in a key-value Bloom filter block. */
+extern const uint64_t bloom_filter_block_words;
+
+/** The number of key-value Bloom filter bits per key. */
+extern const uint64_t bloom_filter_bits_per_key;
+
+/** The number of key-value Bloom filter bits set per key. */
+extern const uint32_t bloom_filter_hash_num;
+
 /** Default datatype for a generic tile. */
 extern const Datatype generic_tile_datatype;
 
@@ -176,6 +197,12 @@ extern const std::string group_filename;
 /** The buffer size for each attribute used in consolidation. */
 extern const uint64_t consolidation_buffer_size;
 
+/**
+ * The minimum buffer size for each attribute used in consolidation, when
+ * the buffers are shrunk to fit in the memory budget.
+ */
+extern const uint64_t consolidation_min_buffer_size;
+
 /** The maximum number of bytes written in a single I/O. */
 extern const uint64_t max_write_bytes;
 
@@ -206,6 +233,18 @@ extern const uint64_t array_schema_cache_size;
 /** The fragment metadata cache size. */
 extern const uint64_t fragment_metadata_cache_size;
 
+/** Whether fragment commits are recorded in the array fragment manifest. */
+extern const bool fragment_manifest;
+
+/** Whether key-value writes are recorded in a write-ahead log. */
+extern const bool kv_wal;
+
+/** Whether every key-value write-ahead log append is synced. */
+extern const bool kv_wal_sync;
+
+/** The buffered key-value bytes that trigger a background flush. */
+extern const uint64_t kv_flush_threshold;
+
 /** Whether or not the signal handlers are installed. */
 extern const bool enable_signal_handlers;
 
@@ -224,6 +263,54 @@ extern const int num_tbb_threads;
 /** The tile cache size. */
 extern const uint64_t tile_cache_size;
 
+/** The global memory budget of a storage manager, in bytes. */
+extern const uint64_t memory_budget;
+
+/** The minimum number of fragments merged in a consolidation step. */
+extern const uint64_t consolidation_step_min_frags;
+
+/** The maximum number of fragments merged in a consolidation step. */
+extern const uint64_t consolidation_step_max_frags;
+
+/** The size ratio two adjacent fragments must satisfy to be consolidated. */
+extern const float consolidation_step_size_ratio;
+
+/** The maximum total size of the fragments of a consolidation step. */
+extern const uint64_t consolidation_step_max_bytes;
+
+/** The number of subarray partitions read concurrently in consolidation. */
+extern const uint64_t consolidation_num_threads;
+
+/** Whether the background consolidation service is enabled. */
+extern const bool consolidation_background;
+
+/** The period in ms at which the consolidation service checks the arrays. */
+extern const uint64_t consolidation_background_interval_ms;
+
+/** The fragment number that triggers background consolidation. */
+extern const uint64_t consolidation_background_frag_num;
+
+/** The unconsolidated bytes that trigger background consolidation. */
+extern const uint64_t consolidation_background_frag_bytes;
+
+/** The target foreground query latency of background consolidation. */
+extern const uint64_t consolidation_background_latency_ms;
+
+/** The smallest block size served by the buffer pool. */
+extern const uint64_t buffer_pool_min_block_size;
+
+/** The largest block size served by the buffer pool. */
+extern const uint64_t buffer_pool_max_block_size;
+
+/** The maximum number of bytes cached by the buffer pool per thread. */
+extern const uint64_t buffer_pool_thread_cache_size;
+
+/** The maximum number of bytes cached by the buffer pool across threads. */
+extern const uint64_t buffer_pool_shared_cache_size;
+
+/** The size of the blocks a query arena requests from the buffer pool. */
+extern const uint64_t arena_block_size;
+
 /** Empty String reference **/
 extern const std::string empty_str;
 
@@ -257,6 +344,12 @@ extern const std::string no_encryption_str;
 /** String describing AES_256_GCM. */
 extern const std::string aes_256_gcm_str;
 
+/** String describing the MD5 key-value hash. */
+extern const std::string kv_hash_md5_str;
+
+/** String describing the MurmurHash3 key-value hash. */
+extern const std::string kv_hash_murmur3_128_str;
+
 /** String describing GZIP. */
 extern const std::string gzip_str;
 
@@ -377,6 +470,24 @@ extern const uint32_t format_version;
 /** The maximum size of a tile chunk (unit of compression) in bytes. */
 extern const uint64_t max_tile_chunk_size;
 
+/**
+ * The number of scratch buffers that the filter storage of a thread keeps
+ * allocated to the maximum chunk size.
+ */
+extern const uint64_t filter_storage_scratch_buffer_num;
+
+/**
+ * The factor by which a filter storage buffer may outgrow its reserved size
+ * and still be kept for reuse.
+ */
+extern const uint64_t filter_storage_max_buffer_growth;
+
+/** The number of bytes of a tile chunk sampled by the auto filter. */
+extern const uint64_t auto_filter_sample_size;
+
+/** The number of evenly spaced slices the auto filter sample consists of. */
+extern const uint64_t auto_filter_sample_slice_num;
+
 /** The default attribute name prefix. */
 extern const std::string default_attr_name;
 
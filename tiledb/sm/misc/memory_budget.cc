@@ -0,0 +1,174 @@
+/**
+ * @file   memory_budget.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines the MemoryBudget and MemoryReservation classes.
+ */
+
+#include "tiledb/sm/misc/memory_budget.h"
+#include "tiledb/sm/misc/stats.h"
+
+#include <cassert>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+MemoryBudget::MemoryBudget() {
+  budget_ = 0;
+  in_use_ = 0;
+  num_holders_ = 0;
+}
+
+MemoryBudget::~MemoryBudget() {
+  assert(num_holders_ == 0);
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status MemoryBudget::init(uint64_t budget) {
+  std::unique_lock<std::mutex> lck(mtx_);
+  budget_ = budget;
+  return Status::Ok();
+}
+
+uint64_t MemoryBudget::budget() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+  return budget_;
+}
+
+uint64_t MemoryBudget::in_use() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+  return in_use_;
+}
+
+bool MemoryBudget::try_reserve(uint64_t nbytes) {
+  std::unique_lock<std::mutex> lck(mtx_);
+  if (budget_ != 0 && in_use_ + nbytes > budget_)
+    return false;
+  in_use_ += nbytes;
+  return true;
+}
+
+void MemoryBudget::reserve(uint64_t nbytes) {
+  std::unique_lock<std::mutex> lck(mtx_);
+  if (budget_ != 0 && num_holders_ > 0 && in_use_ + nbytes > budget_) {
+    STATS_COUNTER_ADD(sm_memory_budget_waits, 1);
+    cv_.wait(lck, [this, nbytes]() {
+      return num_holders_ == 0 || in_use_ + nbytes <= budget_;
+    });
+  }
+  in_use_ += nbytes;
+}
+
+void MemoryBudget::release(uint64_t nbytes) {
+  std::unique_lock<std::mutex> lck(mtx_);
+  assert(in_use_ >= nbytes);
+  in_use_ -= nbytes;
+  cv_.notify_all();
+}
+
+/* ****************************** */
+/*          PRIVATE METHODS       */
+/* ****************************** */
+
+void MemoryBudget::acquire(uint64_t nbytes) {
+  std::unique_lock<std::mutex> lck(mtx_);
+  if (budget_ != 0 && num_holders_ > 0 && in_use_ + nbytes > budget_) {
+    STATS_COUNTER_ADD(sm_memory_budget_waits, 1);
+    cv_.wait(lck, [this, nbytes]() {
+      return num_holders_ == 0 || in_use_ + nbytes <= budget_;
+    });
+  }
+  in_use_ += nbytes;
+  ++num_holders_;
+}
+
+void MemoryBudget::grow(uint64_t nbytes) {
+  std::unique_lock<std::mutex> lck(mtx_);
+  in_use_ += nbytes;
+}
+
+void MemoryBudget::release_holder(uint64_t nbytes) {
+  std::unique_lock<std::mutex> lck(mtx_);
+  assert(in_use_ >= nbytes);
+  assert(num_holders_ > 0);
+  in_use_ -= nbytes;
+  --num_holders_;
+  cv_.notify_all();
+}
+
+/* ****************************** */
+/*        MemoryReservation       */
+/* ****************************** */
+
+MemoryReservation::MemoryReservation(MemoryBudget* budget)
+    : budget_(budget)
+    , admitted_(false)
+    , size_(0) {
+}
+
+MemoryReservation::~MemoryReservation() {
+  release();
+}
+
+Status MemoryReservation::reserve(uint64_t nbytes) {
+  if (budget_ == nullptr)
+    return Status::Ok();
+
+  if (!admitted_) {
+    budget_->acquire(nbytes);
+    admitted_ = true;
+  } else {
+    budget_->grow(nbytes);
+  }
+  size_ += nbytes;
+
+  return Status::Ok();
+}
+
+void MemoryReservation::release() {
+  if (budget_ == nullptr || !admitted_)
+    return;
+
+  budget_->release_holder(size_);
+  admitted_ = false;
+  size_ = 0;
+}
+
+uint64_t MemoryReservation::size() const {
+  return size_;
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,211 @@
+/**
+ * @file   memory_budget.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares the MemoryBudget and MemoryReservation classes.
+ */
+
+#ifndef TILEDB_MEMORY_BUDGET_H
+#define TILEDB_MEMORY_BUDGET_H
+
+#include <condition_variable>
+#include <mutex>
+
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * Tracks the memory used by the queries and caches of a single storage
+ * manager against a global budget (`sm.memory_budget`).
+ *
+ * Queries acquire memory through a MemoryReservation. The first reservation
+ * of a query blocks until the requested amount fits in the budget, which
+ * queues concurrent queries instead of letting them allocate past it. A query
+ * is always admitted when no other query holds a reservation, so a single
+ * oversized query still makes progress. Caches use `try_reserve`, which never
+ * blocks and fails if the memory is not available.
+ *
+ * A budget of zero disables all accounting.
+ */
+class MemoryBudget {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  MemoryBudget();
+
+  /** Destructor. */
+  ~MemoryBudget();
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Initializes the budget.
+   *
+   * @param budget The total number of bytes that may be reserved. Zero
+   *     means unlimited.
+   * @return Status
+   */
+  Status init(uint64_t budget);
+
+  /** Returns the total budget in bytes (zero means unlimited). */
+  uint64_t budget() const;
+
+  /** Returns the number of bytes currently reserved. */
+  uint64_t in_use() const;
+
+  /**
+   * Reserves `nbytes` if they fit in the budget, without blocking.
+   *
+   * @param nbytes The number of bytes to reserve.
+   * @return `true` if the bytes were reserved, `false` otherwise.
+   */
+  bool try_reserve(uint64_t nbytes);
+
+  /**
+   * Reserves `nbytes`, blocking until they fit in the budget or no query
+   * holds a reservation. Unlike with a MemoryReservation, the caller does
+   * not become a holder, so the queries it issues itself are admitted as
+   * usual instead of waiting for it.
+   *
+   * @param nbytes The number of bytes to reserve.
+   */
+  void reserve(uint64_t nbytes);
+
+  /**
+   * Releases `nbytes` previously reserved with `try_reserve` or `reserve`.
+   *
+   * @param nbytes The number of bytes to release.
+   */
+  void release(uint64_t nbytes);
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The total budget in bytes. */
+  uint64_t budget_;
+
+  /** Notified every time memory is released. */
+  std::condition_variable cv_;
+
+  /** The number of bytes currently reserved. */
+  uint64_t in_use_;
+
+  /** Protects the budget state. */
+  mutable std::mutex mtx_;
+
+  /** The number of MemoryReservation objects currently holding memory. */
+  uint64_t num_holders_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Admits a new reservation holder with `nbytes`, blocking until
+   * the bytes fit in the budget or there are no other holders.
+   */
+  void acquire(uint64_t nbytes);
+
+  /** Adds `nbytes` to an existing holder without blocking. */
+  void grow(uint64_t nbytes);
+
+  /** Releases `nbytes` held by a holder and drops the holder. */
+  void release_holder(uint64_t nbytes);
+
+  friend class MemoryReservation;
+};
+
+/**
+ * The memory held by a single query (or query step) against a MemoryBudget.
+ * The memory is released upon destruction.
+ */
+class MemoryReservation {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param budget The budget to reserve from. If `nullptr`, all
+   *     reservations trivially succeed.
+   */
+  explicit MemoryReservation(MemoryBudget* budget);
+
+  /** Destructor. Releases any reserved memory. */
+  ~MemoryReservation();
+
+  MemoryReservation(const MemoryReservation&) = delete;
+  MemoryReservation& operator=(const MemoryReservation&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Reserves `nbytes` more bytes. The first reservation blocks until
+   * the budget can accommodate it; subsequent ones are granted immediately
+   * (possibly exceeding the budget), so that a query that has been admitted
+   * can never deadlock on itself.
+   *
+   * @param nbytes The number of bytes to reserve.
+   * @return Status
+   */
+  Status reserve(uint64_t nbytes);
+
+  /** Releases all the memory held by this reservation. */
+  void release();
+
+  /** Returns the number of bytes held by this reservation. */
+  uint64_t size() const;
+
+ private:
+  /** The budget the memory is reserved from. */
+  MemoryBudget* budget_;
+
+  /** `true` if this reservation has been admitted by the budget. */
+  bool admitted_;
+
+  /** The number of bytes held. */
+  uint64_t size_;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_MEMORY_BUDGET_H
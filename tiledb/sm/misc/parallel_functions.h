@@ -33,8 +33,12 @@
 #ifndef TILEDB_PARALLEL_FUNCTIONS_H
 #define TILEDB_PARALLEL_FUNCTIONS_H
 
+#include "tiledb/sm/misc/status.h"
+
 #include <algorithm>
 #include <cassert>
+#include <cinttypes>
+#include <vector>
 
 #ifdef HAVE_TBB
 #include <tbb/parallel_for.h>
@@ -124,6 +128,82 @@ std::vector<Status> parallel_for(uint64_t begin, uint64_t end, const FuncT& F) {
   return result;
 }
 
+/**
+ * Sorts the given keys in ascending order with a stable LSD radix sort,
+ * possibly in parallel, permuting the given values along with the keys.
+ * The input is split into chunks; each pass counts the key digits of
+ * every chunk in parallel and then scatters every chunk in parallel into
+ * its precomputed output ranges. Passes over digits that are the same for
+ * all keys are skipped.
+ *
+ * @param keys The keys to sort.
+ * @param values The values to permute (same size as `keys`).
+ * @param key_bits The number of low-order bits that may be set in the keys.
+ */
+inline void parallel_radix_sort(
+    std::vector<uint64_t>* keys,
+    std::vector<uint64_t>* values,
+    unsigned key_bits) {
+  assert(keys->size() == values->size());
+  const unsigned radix_bits = 8;
+  const uint64_t radix = uint64_t(1) << radix_bits;
+  const uint64_t max_chunk_num = 1024;
+  const uint64_t min_chunk_size = 65536;
+  const uint64_t n = keys->size();
+  if (n < 2)
+    return;
+
+  const uint64_t chunk_size =
+      std::max(min_chunk_size, (n + max_chunk_num - 1) / max_chunk_num);
+  const uint64_t chunk_num = (n + chunk_size - 1) / chunk_size;
+  std::vector<uint64_t> tmp_keys(n), tmp_values(n);
+  std::vector<uint64_t> offsets(chunk_num * radix);
+
+  for (unsigned shift = 0; shift < key_bits; shift += radix_bits) {
+    // Count the digits per chunk
+    std::fill(offsets.begin(), offsets.end(), 0);
+    parallel_for(0, chunk_num, [&](uint64_t c) {
+      auto hist = &offsets[c * radix];
+      auto end = std::min(n, (c + 1) * chunk_size);
+      for (uint64_t i = c * chunk_size; i < end; ++i)
+        ++hist[((*keys)[i] >> shift) & (radix - 1)];
+      return Status::Ok();
+    });
+
+    // Compute the output offsets, skipping the pass if all keys share
+    // the same digit
+    uint64_t sum = 0;
+    bool trivial = false;
+    for (uint64_t b = 0; b < radix && !trivial; ++b) {
+      uint64_t bucket_sum = 0;
+      for (uint64_t c = 0; c < chunk_num; ++c) {
+        auto count = offsets[c * radix + b];
+        offsets[c * radix + b] = sum;
+        sum += count;
+        bucket_sum += count;
+      }
+      trivial = (bucket_sum == n);
+    }
+    if (trivial)
+      continue;
+
+    // Scatter
+    parallel_for(0, chunk_num, [&](uint64_t c) {
+      auto offs = &offsets[c * radix];
+      auto end = std::min(n, (c + 1) * chunk_size);
+      for (uint64_t i = c * chunk_size; i < end; ++i) {
+        auto pos = offs[((*keys)[i] >> shift) & (radix - 1)]++;
+        tmp_keys[pos] = (*keys)[i];
+        tmp_values[pos] = (*values)[i];
+      }
+      return Status::Ok();
+    });
+
+    keys->swap(tmp_keys);
+    values->swap(tmp_values);
+  }
+}
+
 }  // namespace sm
 }  // namespace tiledb
 
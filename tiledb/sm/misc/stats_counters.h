@@ -80,6 +80,7 @@ STATS_DEFINE_FUNC_STAT(writer_check_coord_dups_global)
 STATS_DEFINE_FUNC_STAT(writer_compute_coord_dups)
 STATS_DEFINE_FUNC_STAT(writer_compute_coord_dups_global)
 STATS_DEFINE_FUNC_STAT(writer_compute_coords_metadata)
+STATS_DEFINE_FUNC_STAT(writer_compute_sort_keys)
 STATS_DEFINE_FUNC_STAT(writer_compute_write_cell_ranges)
 STATS_DEFINE_FUNC_STAT(writer_create_fragment)
 STATS_DEFINE_FUNC_STAT(writer_filter_tiles)
@@ -102,6 +103,7 @@ STATS_DEFINE_FUNC_STAT(sm_array_open)
 STATS_DEFINE_FUNC_STAT(sm_read_from_cache)
 STATS_DEFINE_FUNC_STAT(sm_write_to_cache)
 STATS_DEFINE_FUNC_STAT(sm_query_submit)
+STATS_DEFINE_FUNC_STAT(sm_consolidation_service_consolidate)
 // TileIO
 STATS_DEFINE_FUNC_STAT(tileio_read)
 STATS_DEFINE_FUNC_STAT(tileio_write)
@@ -191,6 +193,7 @@ STATS_INIT_FUNC_STAT(writer_check_coord_dups_global)
 STATS_INIT_FUNC_STAT(writer_compute_coord_dups)
 STATS_INIT_FUNC_STAT(writer_compute_coord_dups_global)
 STATS_INIT_FUNC_STAT(writer_compute_coords_metadata)
+STATS_INIT_FUNC_STAT(writer_compute_sort_keys)
 STATS_INIT_FUNC_STAT(writer_compute_write_cell_ranges)
 STATS_INIT_FUNC_STAT(writer_create_fragment)
 STATS_INIT_FUNC_STAT(writer_filter_tiles)
@@ -213,6 +216,7 @@ STATS_INIT_FUNC_STAT(sm_array_open)
 STATS_INIT_FUNC_STAT(sm_read_from_cache)
 STATS_INIT_FUNC_STAT(sm_write_to_cache)
 STATS_INIT_FUNC_STAT(sm_query_submit)
+STATS_INIT_FUNC_STAT(sm_consolidation_service_consolidate)
 // TileIO
 STATS_INIT_FUNC_STAT(tileio_read)
 STATS_INIT_FUNC_STAT(tileio_write)
@@ -303,6 +307,7 @@ STATS_REPORT_FUNC_STAT(writer_check_coord_dups_global)
 STATS_REPORT_FUNC_STAT(writer_compute_coord_dups)
 STATS_REPORT_FUNC_STAT(writer_compute_coord_dups_global)
 STATS_REPORT_FUNC_STAT(writer_compute_coords_metadata)
+STATS_REPORT_FUNC_STAT(writer_compute_sort_keys)
 STATS_REPORT_FUNC_STAT(writer_compute_write_cell_ranges)
 STATS_REPORT_FUNC_STAT(writer_create_fragment)
 STATS_REPORT_FUNC_STAT(writer_filter_tiles)
@@ -325,6 +330,7 @@ STATS_REPORT_FUNC_STAT(sm_array_open)
 STATS_REPORT_FUNC_STAT(sm_read_from_cache)
 STATS_REPORT_FUNC_STAT(sm_write_to_cache)
 STATS_REPORT_FUNC_STAT(sm_query_submit)
+STATS_REPORT_FUNC_STAT(sm_consolidation_service_consolidate)
 // TileIO
 STATS_REPORT_FUNC_STAT(tileio_read)
 STATS_REPORT_FUNC_STAT(tileio_write)
@@ -365,6 +371,10 @@ STATS_REPORT_FUNC_STAT(vfs_s3_write_multipart)
 #endif
 
 #ifdef STATS_DEFINE_COUNTER_STAT
+// Buffer pool
+STATS_DEFINE_COUNTER_STAT(buffer_pool_misses)
+STATS_DEFINE_COUNTER_STAT(buffer_pool_shared_cache_hits)
+STATS_DEFINE_COUNTER_STAT(buffer_pool_thread_cache_hits)
 // Cache
 STATS_DEFINE_COUNTER_STAT(cache_lru_inserts)
 STATS_DEFINE_COUNTER_STAT(cache_lru_read_hits)
@@ -372,9 +382,12 @@ STATS_DEFINE_COUNTER_STAT(cache_lru_read_misses)
 // Reader
 STATS_DEFINE_COUNTER_STAT(reader_attr_tile_cache_hits)
 STATS_DEFINE_COUNTER_STAT(reader_num_attr_tiles_touched)
+STATS_DEFINE_COUNTER_STAT(reader_num_bloom_filter_skips)
 STATS_DEFINE_COUNTER_STAT(reader_num_fixed_cell_bytes_copied)
 STATS_DEFINE_COUNTER_STAT(reader_num_fixed_cell_bytes_read)
+STATS_DEFINE_COUNTER_STAT(reader_num_memory_budget_splits)
 STATS_DEFINE_COUNTER_STAT(reader_num_tile_bytes_read)
+STATS_DEFINE_COUNTER_STAT(reader_num_tile_chunks_skipped)
 STATS_DEFINE_COUNTER_STAT(reader_num_var_cell_bytes_copied)
 STATS_DEFINE_COUNTER_STAT(reader_num_var_cell_bytes_read)
 // Writer
@@ -383,6 +396,14 @@ STATS_DEFINE_COUNTER_STAT(writer_num_bytes_written)
 STATS_DEFINE_COUNTER_STAT(writer_num_input_bytes)
 // StorageManager
 STATS_DEFINE_COUNTER_STAT(sm_contexts_created)
+STATS_DEFINE_COUNTER_STAT(sm_memory_budget_waits)
+STATS_DEFINE_COUNTER_STAT(sm_consolidation_service_arrays_watched)
+STATS_DEFINE_COUNTER_STAT(sm_consolidation_service_checks)
+STATS_DEFINE_COUNTER_STAT(sm_consolidation_service_runs)
+STATS_DEFINE_COUNTER_STAT(sm_consolidation_service_failures)
+STATS_DEFINE_COUNTER_STAT(sm_consolidation_service_fragments_removed)
+STATS_DEFINE_COUNTER_STAT(sm_consolidation_service_skips)
+STATS_DEFINE_COUNTER_STAT(sm_consolidation_service_throttle_waits)
 STATS_DEFINE_COUNTER_STAT(sm_query_submit_layout_col_major)
 STATS_DEFINE_COUNTER_STAT(sm_query_submit_layout_row_major)
 STATS_DEFINE_COUNTER_STAT(sm_query_submit_layout_global_order)
@@ -405,6 +426,10 @@ STATS_DEFINE_COUNTER_STAT(vfs_s3_write_num_parallelized)
 #endif
 
 #ifdef STATS_INIT_COUNTER_STAT
+// Buffer pool
+STATS_INIT_COUNTER_STAT(buffer_pool_misses)
+STATS_INIT_COUNTER_STAT(buffer_pool_shared_cache_hits)
+STATS_INIT_COUNTER_STAT(buffer_pool_thread_cache_hits)
 // Cache
 STATS_INIT_COUNTER_STAT(cache_lru_inserts)
 STATS_INIT_COUNTER_STAT(cache_lru_read_hits)
@@ -412,9 +437,12 @@ STATS_INIT_COUNTER_STAT(cache_lru_read_misses)
 // Reader
 STATS_INIT_COUNTER_STAT(reader_attr_tile_cache_hits)
 STATS_INIT_COUNTER_STAT(reader_num_attr_tiles_touched)
+STATS_INIT_COUNTER_STAT(reader_num_bloom_filter_skips)
 STATS_INIT_COUNTER_STAT(reader_num_fixed_cell_bytes_copied)
 STATS_INIT_COUNTER_STAT(reader_num_fixed_cell_bytes_read)
+STATS_INIT_COUNTER_STAT(reader_num_memory_budget_splits)
 STATS_INIT_COUNTER_STAT(reader_num_tile_bytes_read)
+STATS_INIT_COUNTER_STAT(reader_num_tile_chunks_skipped)
 STATS_INIT_COUNTER_STAT(reader_num_var_cell_bytes_copied)
 STATS_INIT_COUNTER_STAT(reader_num_var_cell_bytes_read)
 // Writer
@@ -423,6 +451,14 @@ STATS_INIT_COUNTER_STAT(writer_num_bytes_written)
 STATS_INIT_COUNTER_STAT(writer_num_input_bytes)
 // StorageManager
 STATS_INIT_COUNTER_STAT(sm_contexts_created)
+STATS_INIT_COUNTER_STAT(sm_memory_budget_waits)
+STATS_INIT_COUNTER_STAT(sm_consolidation_service_arrays_watched)
+STATS_INIT_COUNTER_STAT(sm_consolidation_service_checks)
+STATS_INIT_COUNTER_STAT(sm_consolidation_service_runs)
+STATS_INIT_COUNTER_STAT(sm_consolidation_service_failures)
+STATS_INIT_COUNTER_STAT(sm_consolidation_service_fragments_removed)
+STATS_INIT_COUNTER_STAT(sm_consolidation_service_skips)
+STATS_INIT_COUNTER_STAT(sm_consolidation_service_throttle_waits)
 STATS_INIT_COUNTER_STAT(sm_query_submit_layout_col_major)
 STATS_INIT_COUNTER_STAT(sm_query_submit_layout_row_major)
 STATS_INIT_COUNTER_STAT(sm_query_submit_layout_global_order)
@@ -445,6 +481,10 @@ STATS_INIT_COUNTER_STAT(vfs_s3_write_num_parallelized)
 #endif
 
 #ifdef STATS_REPORT_COUNTER_STAT
+// Buffer pool
+STATS_REPORT_COUNTER_STAT(buffer_pool_misses)
+STATS_REPORT_COUNTER_STAT(buffer_pool_shared_cache_hits)
+STATS_REPORT_COUNTER_STAT(buffer_pool_thread_cache_hits)
 // Cache
 STATS_REPORT_COUNTER_STAT(cache_lru_inserts)
 STATS_REPORT_COUNTER_STAT(cache_lru_read_hits)
@@ -452,9 +492,12 @@ STATS_REPORT_COUNTER_STAT(cache_lru_read_misses)
 // Reader
 STATS_REPORT_COUNTER_STAT(reader_attr_tile_cache_hits)
 STATS_REPORT_COUNTER_STAT(reader_num_attr_tiles_touched)
+STATS_REPORT_COUNTER_STAT(reader_num_bloom_filter_skips)
 STATS_REPORT_COUNTER_STAT(reader_num_fixed_cell_bytes_copied)
 STATS_REPORT_COUNTER_STAT(reader_num_fixed_cell_bytes_read)
+STATS_REPORT_COUNTER_STAT(reader_num_memory_budget_splits)
 STATS_REPORT_COUNTER_STAT(reader_num_tile_bytes_read)
+STATS_REPORT_COUNTER_STAT(reader_num_tile_chunks_skipped)
 STATS_REPORT_COUNTER_STAT(reader_num_var_cell_bytes_copied)
 STATS_REPORT_COUNTER_STAT(reader_num_var_cell_bytes_read)
 // Writer
@@ -463,6 +506,14 @@ STATS_REPORT_COUNTER_STAT(writer_num_bytes_written)
 STATS_REPORT_COUNTER_STAT(writer_num_input_bytes)
 // StorageManager
 STATS_REPORT_COUNTER_STAT(sm_contexts_created)
+STATS_REPORT_COUNTER_STAT(sm_memory_budget_waits)
+STATS_REPORT_COUNTER_STAT(sm_consolidation_service_arrays_watched)
+STATS_REPORT_COUNTER_STAT(sm_consolidation_service_checks)
+STATS_REPORT_COUNTER_STAT(sm_consolidation_service_runs)
+STATS_REPORT_COUNTER_STAT(sm_consolidation_service_failures)
+STATS_REPORT_COUNTER_STAT(sm_consolidation_service_fragments_removed)
+STATS_REPORT_COUNTER_STAT(sm_consolidation_service_skips)
+STATS_REPORT_COUNTER_STAT(sm_consolidation_service_throttle_waits)
 STATS_REPORT_COUNTER_STAT(sm_query_submit_layout_col_major)
 STATS_REPORT_COUNTER_STAT(sm_query_submit_layout_row_major)
 STATS_REPORT_COUNTER_STAT(sm_query_submit_layout_global_order)
@@ -201,6 +201,9 @@ std::string Status::code_to_string() const {
     case StatusCode::ContextError:
       type = "[TileDB::Context] Error";
       break;
+    case StatusCode::ChecksumError:
+      type = "[TileDB::Checksum] Error";
+      break;
     default:
       type = "[TileDB::?] Error:";
   }
@@ -112,7 +112,8 @@ enum class StatusCode : char {
   Encryption,
   Array,
   VFSFileHandleError,
-  ContextError
+  ContextError,
+  ChecksumError
 };
 
 class Status {
@@ -329,6 +330,11 @@ class Status {
     return Status(StatusCode::ContextError, msg, -1);
   }
 
+  /** Return a ChecksumError error class Status with a given message **/
+  static Status ChecksumError(const std::string& msg) {
+    return Status(StatusCode::ChecksumError, msg, -1);
+  }
+
   /** Returns true iff the status indicates success **/
   bool ok() const {
     return (state_ == nullptr);
@@ -168,6 +168,12 @@ URI URI::parent() const {
   return URI(uri_.substr(0, pos));
 }
 
+URI URI::remove_trailing_slash() const {
+  if (!uri_.empty() && uri_.back() == '/')
+    return URI(uri_.substr(0, uri_.size() - 1));
+  return URI(uri_);
+}
+
 std::string URI::to_path(const std::string& uri) {
   if (is_file(uri)) {
 #ifdef _WIN32
@@ -152,6 +152,12 @@ class URI {
   /** Returns the parent of the URI. */
   URI parent() const;
 
+  /**
+   * Return a copy of this URI with the trailing '/' removed (if it had
+   * one).
+   */
+  URI remove_trailing_slash() const;
+
   /**
    * Returns the URI path for the current platform, stripping the resource. For
    * example, if "file:///my/path/" is the URI, this function will return
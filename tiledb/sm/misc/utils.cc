@@ -117,6 +117,24 @@ Status convert(const std::string& str, uint64_t* value) {
   return Status::Ok();
 }
 
+Status convert(const std::string& str, float* value) {
+  try {
+    size_t pos;
+    *value = std::stof(str, &pos);
+    if (pos != str.size())
+      return LOG_STATUS(Status::UtilsError(
+          "Failed to convert string to float; Invalid argument"));
+  } catch (std::invalid_argument& e) {
+    return LOG_STATUS(Status::UtilsError(
+        "Failed to convert string to float; Invalid argument"));
+  } catch (std::out_of_range& e) {
+    return LOG_STATUS(Status::UtilsError(
+        "Failed to convert string to float; Value out of range"));
+  }
+
+  return Status::Ok();
+}
+
 bool is_int(const std::string& str) {
   // Check if empty
   if (str.empty())
@@ -540,6 +558,13 @@ uint64_t ceil(uint64_t x, uint64_t y) {
   return x / y + (x % y != 0);
 }
 
+unsigned popcount(uint64_t x) {
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return (unsigned)((x * 0x0101010101010101ULL) >> 56);
+}
+
 }  // namespace math
 
 // Explicit template instantiations
@@ -52,6 +52,7 @@ Query::Query(StorageManager* storage_manager, Array* array, URI fragment_uri)
 
   callback_ = nullptr;
   callback_data_ = nullptr;
+  internal_ = false;
   layout_ = Layout::ROW_MAJOR;
   status_ = QueryStatus::UNINITIALIZED;
   auto st = array->get_query_type(&type_);
@@ -209,6 +210,10 @@ Status Query::init() {
   return Status::Ok();
 }
 
+bool Query::internal() const {
+  return internal_;
+}
+
 URI Query::last_fragment_uri() const {
   if (type_ == QueryType::WRITE)
     return URI();
@@ -313,6 +318,24 @@ Status Query::set_buffer(
       attribute, buffer_off, buffer_off_size, buffer_val, buffer_val_size);
 }
 
+Status Query::set_fragment_metadata(
+    const std::vector<FragmentMetadata*>& fragment_metadata) {
+  if (type_ == QueryType::WRITE)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set fragment metadata; Applicable only to read queries"));
+  if (status_ != QueryStatus::UNINITIALIZED)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set fragment metadata; The query is already initialized"));
+
+  reader_.set_fragment_metadata(fragment_metadata);
+
+  return Status::Ok();
+}
+
+void Query::set_internal(bool internal) {
+  internal_ = internal;
+}
+
 Status Query::set_layout(Layout layout) {
   layout_ = layout;
   if (type_ == QueryType::WRITE)
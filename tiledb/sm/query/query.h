@@ -232,6 +232,12 @@ class Query {
   /** Initializes the query. */
   Status init();
 
+  /**
+   * Returns `true` if the query is issued internally by TileDB (e.g., by
+   * consolidation) rather than by the user.
+   */
+  bool internal() const;
+
   /** Returns the last fragment uri. */
   URI last_fragment_uri() const;
 
@@ -285,6 +291,24 @@ class Query {
       void* buffer_val,
       uint64_t* buffer_val_size);
 
+  /**
+   * Restricts a read query to the input fragments, which must be a subset
+   * of the fragments of the opened array sorted in ascending timestamp order.
+   * It must be called before the query is submitted. It returns an error for
+   * write queries.
+   *
+   * @param fragment_metadata The metadata of the fragments to read from.
+   * @return Status
+   */
+  Status set_fragment_metadata(
+      const std::vector<FragmentMetadata*>& fragment_metadata);
+
+  /**
+   * Marks the query as issued internally by TileDB. Internal queries are not
+   * accounted for as foreground queries by the consolidation service.
+   */
+  void set_internal(bool internal);
+
   /**
    * Sets the cell layout of the query. The function will return an error
    * if the queried array is a key-value store (because it has its default
@@ -376,6 +400,9 @@ class Query {
   /** The data input to the callback function. */
   void* callback_data_;
 
+  /** `true` if the query is issued internally by TileDB. */
+  bool internal_;
+
   /** The layout of the cells in the result of the subarray. */
   Layout layout_;
 
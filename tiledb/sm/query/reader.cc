@@ -333,6 +333,7 @@ Status Reader::read() {
 
   do {
     reset_buffer_sizes();
+    arena_.reset();
 
     // Perform dense or sparse read if there are fragments
     if (array_schema_->dense()) {
@@ -903,6 +904,16 @@ Status Reader::compute_overlapping_tiles(OverlappingTileVec* tiles) const {
   auto fragment_num = fragment_metadata_.size();
   bool full_overlap;
 
+  // A key lookup in a key-value store is a single-cell subarray
+  bool kv_lookup = array_schema_->is_kv();
+  for (unsigned d = 0; kv_lookup && d < dim_num; ++d)
+    kv_lookup = subarray[2 * d] == subarray[2 * d + 1];
+  uint64_t kv_coords[2];
+  if (kv_lookup) {
+    kv_coords[0] = (uint64_t)subarray[0];
+    kv_coords[1] = (uint64_t)subarray[2];
+  }
+
   // Find overlapping tile indexes for each fragment
   tiles->clear();
   for (unsigned i = 0; i < fragment_num; ++i) {
@@ -910,6 +921,13 @@ Status Reader::compute_overlapping_tiles(OverlappingTileVec* tiles) const {
     if (fragment_metadata_[i]->dense())
       continue;
 
+    // Skip the fragments that certainly do not contain the key
+    if (kv_lookup &&
+        !fragment_metadata_[i]->bloom_filter_may_contain(kv_coords)) {
+      STATS_COUNTER_ADD(reader_num_bloom_filter_skips, 1);
+      continue;
+    }
+
     auto mbrs = fragment_metadata_[i]->mbrs();
     auto mbr_num = (uint64_t)mbrs.size();
     for (uint64_t j = 0; j < mbr_num; ++j) {
@@ -927,10 +945,54 @@ Status Reader::compute_overlapping_tiles(OverlappingTileVec* tiles) const {
   STATS_FUNC_OUT(reader_compute_overlapping_tiles);
 }
 
+template <class T>
+Status Reader::compute_overlapping_tiles_in_budget(
+    OverlappingTileVec* tiles, MemoryReservation* reservation) {
+  auto budget = storage_manager_->memory_budget()->budget();
+  uint64_t tiles_memory = 0;
+
+  for (;;) {
+    RETURN_NOT_OK(compute_overlapping_tiles<T>(tiles));
+    tiles_memory = compute_tiles_memory(*tiles);
+    if (budget == 0 || tiles_memory <= budget)
+      break;
+
+    // The tiles do not fit in the budget; process the partition in halves
+    bool split;
+    RETURN_NOT_OK(split_cur_subarray_partition(&split));
+    if (!split)
+      break;
+    STATS_COUNTER_ADD(reader_num_memory_budget_splits, 1);
+  }
+
+  return reservation->reserve(tiles_memory);
+}
+
+uint64_t Reader::compute_tiles_memory(
+    const OverlappingTileVec& tiles, bool ensure_coords) const {
+  uint64_t memory = 0;
+  for (const auto& tile : tiles) {
+    const auto& fragment = fragment_metadata_[tile->fragment_idx_];
+    for (const auto& attr_it : tile->attr_tiles_) {
+      const auto& attr = attr_it.first;
+      if (attr == constants::coords && !ensure_coords &&
+          (array_schema_->dense() || !has_coords()))
+        continue;  // Same attribute selection as in `read_all_tiles`
+
+      memory += fragment->tile_size(attr, tile->tile_idx_) +
+                fragment->persisted_tile_size(attr, tile->tile_idx_);
+      if (array_schema_->var_size(attr))
+        memory += fragment->tile_var_size(attr, tile->tile_idx_) +
+                  fragment->persisted_tile_var_size(attr, tile->tile_idx_);
+    }
+  }
+
+  return memory;
+}
+
 template <class T>
 Status Reader::compute_tile_coords(
-    std::unique_ptr<T[]>* all_tile_coords,
-    OverlappingCoordsList<T>* coords) const {
+    T** all_tile_coords, OverlappingCoordsList<T>* coords) {
   STATS_FUNC_IN(reader_compute_tile_coords);
 
   if (coords->empty() || array_schema_->domain()->tile_extents() == nullptr)
@@ -943,8 +1005,8 @@ Status Reader::compute_tile_coords(
   const auto num_coords = (uint64_t)coords->size();
 
   // Allocate space for all OverlappingCoords' tile coordinate tuples.
-  all_tile_coords->reset(new (std::nothrow) T[num_coords * dim_num]);
-  if (all_tile_coords == nullptr) {
+  *all_tile_coords = arena_.allocate_array<T>(num_coords * dim_num);
+  if (*all_tile_coords == nullptr) {
     return LOG_STATUS(
         Status::ReaderError("Could not allocate tile coords array."));
   }
@@ -952,7 +1014,7 @@ Status Reader::compute_tile_coords(
   // Compute the tile coordinates for each OverlappingCoords.
   for (uint64_t i = 0; i < num_coords; i++) {
     auto& c = (*coords)[i];
-    T* tile_coords = all_tile_coords->get() + i * dim_num;
+    T* tile_coords = *all_tile_coords + i * dim_num;
     for (unsigned j = 0; j < dim_num; j++) {
       tile_coords[j] = (c.coords_[j] - domain[2 * j]) / tile_extents[j];
     }
@@ -1061,14 +1123,14 @@ Status Reader::copy_var_cells(
   assert(fill_value != nullptr);
 
   // Compute the destinations of offsets and var-len data in the buffers.
-  std::vector<std::vector<uint64_t>> offset_offsets_per_cr;
-  std::vector<std::vector<uint64_t>> var_offsets_per_cr;
+  uint64_t* cr_first_cell = nullptr;
+  uint64_t* var_offsets = nullptr;
   uint64_t total_offset_size, total_var_size;
   RETURN_NOT_OK(compute_var_cell_destinations(
       attribute,
       cell_ranges,
-      &offset_offsets_per_cr,
-      &var_offsets_per_cr,
+      &cr_first_cell,
+      &var_offsets,
       &total_offset_size,
       &total_var_size));
 
@@ -1082,8 +1144,7 @@ Status Reader::copy_var_cells(
   const auto num_cr = cell_ranges.size();
   auto statuses = parallel_for(0, num_cr, [&](uint64_t cr_idx) {
     const auto& cr = cell_ranges[cr_idx];
-    const auto& offset_offsets = offset_offsets_per_cr[cr_idx];
-    const auto& var_offsets = var_offsets_per_cr[cr_idx];
+    const auto first_cell = cr_first_cell[cr_idx];
 
     // Get tile information, if the range is nonempty.
     uint64_t* tile_offsets = nullptr;
@@ -1100,29 +1161,28 @@ Status Reader::copy_var_cells(
       tile_var_size = tile_var.size();
     }
 
-    // Copy each cell in the range
-    for (auto cell_idx = cr.start_; cell_idx <= cr.end_; cell_idx++) {
-      uint64_t dest_vec_idx = cell_idx - cr.start_;
-      auto offset_dest = buffer + offset_offsets[dest_vec_idx];
-      auto var_offset = var_offsets[dest_vec_idx];
-      auto var_dest = buffer_var + var_offset;
-
-      // Copy offset
-      std::memcpy(offset_dest, &var_offset, offset_size);
-
-      // Copy variable-sized value
-      if (cr.tile_ == nullptr) {
-        std::memcpy(var_dest, &fill_value, fill_size);
-      } else {
-        uint64_t cell_var_size =
-            (cell_idx != tile_cell_num - 1) ?
-                tile_offsets[cell_idx + 1] - tile_offsets[cell_idx] :
-                tile_var_size - (tile_offsets[cell_idx] - tile_offsets[0]);
+    // Copy all the offsets of the range at once
+    auto cell_num = cr.end_ - cr.start_ + 1;
+    std::memcpy(
+        buffer + first_cell * offset_size,
+        &var_offsets[first_cell],
+        cell_num * offset_size);
+
+    // Copy the variable-sized values. The values of a nonempty range are
+    // contiguous both in the tile and in the result buffer.
+    if (cr.tile_ == nullptr) {
+      for (uint64_t i = 0; i < cell_num; ++i)
         std::memcpy(
-            var_dest,
-            &tile_var_data[tile_offsets[cell_idx] - tile_offsets[0]],
-            cell_var_size);
-      }
+            buffer_var + var_offsets[first_cell + i], &fill_value, fill_size);
+    } else {
+      auto var_start = tile_offsets[cr.start_] - tile_offsets[0];
+      auto var_end = (cr.end_ != tile_cell_num - 1) ?
+                         tile_offsets[cr.end_ + 1] - tile_offsets[0] :
+                         tile_var_size;
+      std::memcpy(
+          buffer_var + var_offsets[first_cell],
+          &tile_var_data[var_start],
+          var_end - var_start);
     }
 
     return Status::Ok();
@@ -1146,28 +1206,34 @@ Status Reader::copy_var_cells(
 Status Reader::compute_var_cell_destinations(
     const std::string& attribute,
     const OverlappingCellRangeList& cell_ranges,
-    std::vector<std::vector<uint64_t>>* offset_offsets_per_cr,
-    std::vector<std::vector<uint64_t>>* var_offsets_per_cr,
+    uint64_t** cr_first_cell,
+    uint64_t** var_offsets,
     uint64_t* total_offset_size,
-    uint64_t* total_var_size) const {
+    uint64_t* total_var_size) {
   // For easy reference
   auto num_cr = cell_ranges.size();
   auto offset_size = constants::cell_var_offset_size;
   auto type = array_schema_->type(attribute);
   auto fill_size = datatype_size(type);
 
-  // Resize the output vectors
-  offset_offsets_per_cr->resize(num_cr);
-  var_offsets_per_cr->resize(num_cr);
+  // Allocate the output arrays
+  uint64_t cell_num = 0;
+  for (const auto& cr : cell_ranges)
+    cell_num += cr.end_ - cr.start_ + 1;
+  *cr_first_cell = arena_.allocate_array<uint64_t>(num_cr);
+  *var_offsets = arena_.allocate_array<uint64_t>(cell_num);
+  if ((num_cr > 0 && *cr_first_cell == nullptr) ||
+      (cell_num > 0 && *var_offsets == nullptr))
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot compute var cell destinations; Memory allocation failed"));
 
   // Compute the destinations for all cell ranges.
   *total_offset_size = 0;
   *total_var_size = 0;
+  uint64_t dest_idx = 0;
   for (uint64_t cr_idx = 0; cr_idx < num_cr; cr_idx++) {
     const auto& cr = cell_ranges[cr_idx];
-    auto cell_num_in_range = cr.end_ - cr.start_ + 1;
-    (*offset_offsets_per_cr)[cr_idx].resize(cell_num_in_range);
-    (*var_offsets_per_cr)[cr_idx].resize(cell_num_in_range);
+    (*cr_first_cell)[cr_idx] = dest_idx;
 
     // Get tile information, if the range is nonempty.
     uint64_t* tile_offsets = nullptr;
@@ -1182,26 +1248,25 @@ Status Reader::compute_var_cell_destinations(
       tile_var_size = tile_var.size();
     }
 
-    // Compute the destinations for each cell in the range.
-    for (auto cell_idx = cr.start_; cell_idx <= cr.end_; cell_idx++) {
-      uint64_t dest_vec_idx = cell_idx - cr.start_;
-      // Get size of variable-sized cell
-      uint64_t cell_var_size = 0;
-      if (cr.tile_ == nullptr) {
-        cell_var_size = fill_size;
-      } else {
-        cell_var_size =
-            (cell_idx != tile_cell_num - 1) ?
-                tile_offsets[cell_idx + 1] - tile_offsets[cell_idx] :
-                tile_var_size - (tile_offsets[cell_idx] - tile_offsets[0]);
-      }
-
-      // Record destination offsets.
-      (*offset_offsets_per_cr)[cr_idx][dest_vec_idx] = *total_offset_size;
-      (*var_offsets_per_cr)[cr_idx][dest_vec_idx] = *total_var_size;
-      *total_offset_size += offset_size;
-      *total_var_size += cell_var_size;
+    // Compute the destinations for each cell in the range, as the prefix
+    // sums of the cell sizes. For nonempty ranges, these are the tile
+    // offsets rebased to the current total size.
+    auto cell_num = cr.end_ - cr.start_ + 1;
+    if (cr.tile_ == nullptr) {
+      for (uint64_t i = 0; i < cell_num; ++i)
+        (*var_offsets)[dest_idx++] = *total_var_size + i * fill_size;
+      *total_var_size += cell_num * fill_size;
+    } else {
+      auto range_start = tile_offsets[cr.start_];
+      for (auto cell_idx = cr.start_; cell_idx <= cr.end_; cell_idx++)
+        (*var_offsets)[dest_idx++] =
+            *total_var_size + (tile_offsets[cell_idx] - range_start);
+      auto range_end = (cr.end_ != tile_cell_num - 1) ?
+                           tile_offsets[cr.end_ + 1] :
+                           tile_var_size + tile_offsets[0];
+      *total_var_size += range_end - range_start;
     }
+    *total_offset_size += cell_num * offset_size;
   }
 
   return Status::Ok();
@@ -1264,6 +1329,13 @@ template <class T>
 Status Reader::dense_read() {
   STATS_FUNC_IN(reader_dense_read);
 
+  // Get overlapping sparse tile indexes, within the memory budget. This
+  // may shrink the current subarray partition.
+  OverlappingTileVec sparse_tiles;
+  MemoryReservation reservation(storage_manager_->memory_budget());
+  RETURN_CANCEL_OR_ERROR(
+      compute_overlapping_tiles_in_budget<T>(&sparse_tiles, &reservation));
+
   // For easy reference
   auto domain = array_schema_->domain();
   auto subarray_len = 2 * array_schema_->dim_num();
@@ -1272,22 +1344,19 @@ Status Reader::dense_read() {
   for (size_t i = 0; i < subarray_len; ++i)
     subarray[i] = ((T*)read_state_.cur_subarray_partition_)[i];
 
-  // Get overlapping sparse tile indexes
-  OverlappingTileVec sparse_tiles;
-  RETURN_CANCEL_OR_ERROR(compute_overlapping_tiles<T>(&sparse_tiles));
-
   // Read sparse tiles
   RETURN_CANCEL_OR_ERROR(read_all_tiles(&sparse_tiles));
 
-  // Filter sparse tiles
-  RETURN_CANCEL_OR_ERROR(filter_all_tiles(&sparse_tiles));
+  // Filter sparse coordinate tiles. The attribute tiles are filtered once
+  // the cell ranges are known.
+  RETURN_CANCEL_OR_ERROR(filter_tiles(constants::coords, &sparse_tiles));
 
   // Compute the read coordinates for all sparse fragments
   OverlappingCoordsList<T> coords;
   RETURN_CANCEL_OR_ERROR(compute_overlapping_coords<T>(sparse_tiles, &coords));
 
   // Compute the tile coordinates for all overlapping coordinates (for sorting).
-  std::unique_ptr<T[]> tile_coords(nullptr);
+  T* tile_coords = nullptr;
   RETURN_CANCEL_OR_ERROR(compute_tile_coords<T>(&tile_coords, &coords));
 
   // Sort and dedup the coordinates (not applicable to the global order
@@ -1296,8 +1365,6 @@ Status Reader::dense_read() {
     RETURN_CANCEL_OR_ERROR(sort_coords<T>(&coords));
     RETURN_CANCEL_OR_ERROR(dedup_coords<T>(&coords));
   }
-  tile_coords.reset(nullptr);
-
   // For each tile, initialize a dense cell range iterator per
   // (dense) fragment
   std::vector<std::vector<DenseCellRangeIter<T>>> dense_frag_its;
@@ -1332,10 +1399,16 @@ Status Reader::dense_read() {
   overlapping_tile_idx_coords.clear();
 
   // Read dense tiles
+  RETURN_CANCEL_OR_ERROR(
+      reservation.reserve(compute_tiles_memory(dense_tiles, false)));
   RETURN_CANCEL_OR_ERROR(read_all_tiles(&dense_tiles, false));
 
-  // Filter dense tiles
-  RETURN_CANCEL_OR_ERROR(filter_all_tiles(&dense_tiles, false));
+  // Filter the sparse and dense tiles, unfiltering only the chunks that
+  // hold cells of the cell ranges
+  RETURN_CANCEL_OR_ERROR(
+      filter_all_tiles(&sparse_tiles, true, &overlapping_cell_ranges));
+  RETURN_CANCEL_OR_ERROR(
+      filter_all_tiles(&dense_tiles, false, &overlapping_cell_ranges));
 
   // Copy cells
   for (const auto& attr : attributes_) {
@@ -1453,10 +1526,24 @@ void Reader::fill_coords_col_slab(
 }
 
 Status Reader::filter_all_tiles(
-    OverlappingTileVec* tiles, bool ensure_coords) const {
+    OverlappingTileVec* tiles,
+    bool ensure_coords,
+    const OverlappingCellRangeList* cell_ranges) const {
   if (tiles->empty())
     return Status::Ok();
 
+  // Group the cell ranges by tile. Tiles without any cell range are mapped
+  // to no ranges, so none of their chunks are unfiltered.
+  TileCellRangeMap tile_cell_ranges;
+  if (cell_ranges != nullptr) {
+    for (const auto& tile : *tiles)
+      tile_cell_ranges[tile.get()];
+    for (const auto& cr : *cell_ranges) {
+      if (cr.tile_ != nullptr)
+        tile_cell_ranges[cr.tile_].emplace_back(cr.start_, cr.end_);
+    }
+  }
+
   // Prepare attributes
   std::set<std::string> all_attributes;
   for (const auto& attr : attributes_) {
@@ -1473,8 +1560,11 @@ Status Reader::filter_all_tiles(
   auto statuses = parallel_for_each(
       all_attributes.begin(),
       all_attributes.end(),
-      [this, &tiles](const std::string& attr) {
-        RETURN_CANCEL_OR_ERROR(filter_tiles(attr, tiles));
+      [this, &tiles, &tile_cell_ranges, cell_ranges](const std::string& attr) {
+        RETURN_CANCEL_OR_ERROR(filter_tiles(
+            attr,
+            tiles,
+            cell_ranges == nullptr ? nullptr : &tile_cell_ranges));
         return Status::Ok();
       });
 
@@ -1485,10 +1575,14 @@ Status Reader::filter_all_tiles(
 }
 
 Status Reader::filter_tiles(
-    const std::string& attribute, OverlappingTileVec* tiles) const {
+    const std::string& attribute,
+    OverlappingTileVec* tiles,
+    const TileCellRangeMap* tile_cell_ranges) const {
   STATS_FUNC_IN(reader_filter_tiles);
 
   auto var_size = array_schema_->var_size(attribute);
+  auto cell_size = var_size ? constants::cell_var_offset_size :
+                              array_schema_->cell_size(attribute);
   auto num_tiles = static_cast<uint64_t>(tiles->size());
   auto statuses = parallel_for(0, num_tiles, [&, this](uint64_t i) {
     auto& tile = (*tiles)[i];
@@ -1506,11 +1600,39 @@ Status Reader::filter_tiles(
     auto& t = tile_pair.first;
     auto& t_var = tile_pair.second;
 
+    // Get the cell ranges of the tile that must be unfiltered, if known
+    const std::vector<std::pair<uint64_t, uint64_t>>* cell_ranges = nullptr;
+    if (tile_cell_ranges != nullptr) {
+      auto cr_it = tile_cell_ranges->find(tile.get());
+      assert(cr_it != tile_cell_ranges->end());
+      cell_ranges = &cr_it->second;
+    }
+
     if (!t.filtered()) {
+      // Compute the needed byte ranges of the tile. The values of a
+      // var-sized cell are delimited by the offset of the next cell, and
+      // all offsets are relative to the first one.
+      std::vector<std::pair<uint64_t, uint64_t>> byte_ranges;
+      if (cell_ranges != nullptr) {
+        if (var_size && !cell_ranges->empty())
+          byte_ranges.emplace_back(0, cell_size);
+        for (const auto& cr : *cell_ranges) {
+          auto end_cell = var_size ? cr.second + 2 : cr.second + 1;
+          byte_ranges.emplace_back(cr.first * cell_size, end_cell * cell_size);
+        }
+      }
+
       // Decompress, etc.
-      RETURN_NOT_OK(filter_tile(attribute, &t, var_size));
-      RETURN_NOT_OK(storage_manager_->write_to_cache(
-          tile_attr_uri, tile_attr_offset, t.buffer()));
+      bool partial;
+      RETURN_NOT_OK(filter_tile(
+          attribute,
+          &t,
+          var_size,
+          cell_ranges == nullptr ? nullptr : &byte_ranges,
+          &partial));
+      if (!partial)
+        RETURN_NOT_OK(storage_manager_->write_to_cache(
+            tile_attr_uri, tile_attr_offset, t.buffer()));
     }
 
     if (var_size && !t_var.filtered()) {
@@ -1518,10 +1640,31 @@ Status Reader::filter_tiles(
       auto tile_attr_var_offset =
           fragment->file_var_offset(attribute, tile->tile_idx_);
 
+      // Compute the needed byte ranges of the values from the offsets
+      std::vector<std::pair<uint64_t, uint64_t>> byte_ranges;
+      if (cell_ranges != nullptr) {
+        auto offsets = (const uint64_t*)t.data();
+        auto cell_num = t.cell_num();
+        for (const auto& cr : *cell_ranges) {
+          auto start = offsets[cr.first] - offsets[0];
+          auto end = (cr.second + 1 < cell_num) ?
+                         offsets[cr.second + 1] - offsets[0] :
+                         std::numeric_limits<uint64_t>::max();
+          byte_ranges.emplace_back(start, end);
+        }
+      }
+
       // Decompress, etc.
-      RETURN_NOT_OK(filter_tile(attribute, &t_var, false));
-      RETURN_NOT_OK(storage_manager_->write_to_cache(
-          tile_attr_var_uri, tile_attr_var_offset, t_var.buffer()));
+      bool partial;
+      RETURN_NOT_OK(filter_tile(
+          attribute,
+          &t_var,
+          false,
+          cell_ranges == nullptr ? nullptr : &byte_ranges,
+          &partial));
+      if (!partial)
+        RETURN_NOT_OK(storage_manager_->write_to_cache(
+            tile_attr_var_uri, tile_attr_var_offset, t_var.buffer()));
     }
 
     return Status::Ok();
@@ -1536,7 +1679,11 @@ Status Reader::filter_tiles(
 }
 
 Status Reader::filter_tile(
-    const std::string& attribute, Tile* tile, bool offsets) const {
+    const std::string& attribute,
+    Tile* tile,
+    bool offsets,
+    const std::vector<std::pair<uint64_t, uint64_t>>* byte_ranges,
+    bool* partial) const {
   uint64_t orig_size = tile->buffer()->size();
 
   // Get a copy of the appropriate filter pipeline.
@@ -1553,7 +1700,16 @@ Status Reader::filter_tile(
   RETURN_NOT_OK(FilterPipeline::append_encryption_filter(
       &filters, array_->get_encryption_key()));
 
-  RETURN_NOT_OK(filters.run_reverse(tile));
+  if (byte_ranges == nullptr) {
+    RETURN_NOT_OK(filters.run_reverse(tile));
+    *partial = false;
+  } else {
+    uint64_t skipped_chunk_num;
+    RETURN_NOT_OK(
+        filters.run_reverse(tile, *byte_ranges, &skipped_chunk_num));
+    *partial = skipped_chunk_num > 0;
+    STATS_COUNTER_ADD(reader_num_tile_chunks_skipped, skipped_chunk_num);
+  }
 
   tile->set_filtered(true);
   tile->set_pre_filtered_size(orig_size);
@@ -2004,22 +2160,25 @@ template <class T>
 Status Reader::sparse_read() {
   STATS_FUNC_IN(reader_sparse_read);
 
-  // Get overlapping tile indexes
+  // Get overlapping tile indexes, within the memory budget
   OverlappingTileVec tiles;
-  RETURN_CANCEL_OR_ERROR(compute_overlapping_tiles<T>(&tiles));
+  MemoryReservation reservation(storage_manager_->memory_budget());
+  RETURN_CANCEL_OR_ERROR(
+      compute_overlapping_tiles_in_budget<T>(&tiles, &reservation));
 
   // Read tiles
   RETURN_CANCEL_OR_ERROR(read_all_tiles(&tiles));
 
-  // Filter tiles
-  RETURN_CANCEL_OR_ERROR(filter_all_tiles(&tiles));
+  // Filter coordinate tiles. The attribute tiles are filtered once the
+  // cell ranges are known.
+  RETURN_CANCEL_OR_ERROR(filter_tiles(constants::coords, &tiles));
 
   // Compute the read coordinates for all fragments
   OverlappingCoordsList<T> coords;
   RETURN_CANCEL_OR_ERROR(compute_overlapping_coords<T>(tiles, &coords));
 
   // Compute the tile coordinates for all overlapping coordinates (for sorting).
-  std::unique_ptr<T[]> tile_coords(nullptr);
+  T* tile_coords = nullptr;
   RETURN_CANCEL_OR_ERROR(compute_tile_coords<T>(&tile_coords, &coords));
 
   // Sort and dedup the coordinates (not applicable to the global order
@@ -2028,13 +2187,15 @@ Status Reader::sparse_read() {
     RETURN_CANCEL_OR_ERROR(sort_coords<T>(&coords));
     RETURN_CANCEL_OR_ERROR(dedup_coords<T>(&coords));
   }
-  tile_coords.reset(nullptr);
-
   // Compute the maximal cell ranges
   OverlappingCellRangeList cell_ranges;
   RETURN_CANCEL_OR_ERROR(compute_cell_ranges(coords, &cell_ranges));
   coords.clear();
 
+  // Filter attribute tiles, unfiltering only the chunks that hold cells of
+  // the cell ranges
+  RETURN_CANCEL_OR_ERROR(filter_all_tiles(&tiles, true, &cell_ranges));
+
   // Copy cells
   for (const auto& attr : attributes_) {
     if (read_state_.overflowed_)
@@ -2047,6 +2208,35 @@ Status Reader::sparse_read() {
   STATS_FUNC_OUT(reader_sparse_read);
 }
 
+Status Reader::split_cur_subarray_partition(bool* split) {
+  *split = false;
+
+  // Unordered reads are not partitioned
+  if (layout_ == Layout::UNORDERED)
+    return Status::Ok();
+
+  void *subarray_1 = nullptr, *subarray_2 = nullptr;
+  RETURN_NOT_OK(array_schema_->domain()->split_subarray(
+      read_state_.cur_subarray_partition_, layout_, &subarray_1, &subarray_2));
+
+  // Not splittable
+  if (subarray_1 == nullptr || subarray_2 == nullptr) {
+    std::free(subarray_1);
+    std::free(subarray_2);
+    return Status::Ok();
+  }
+
+  std::memcpy(
+      read_state_.cur_subarray_partition_,
+      subarray_1,
+      2 * array_schema_->coords_size());
+  std::free(subarray_1);
+  read_state_.subarray_partitions_.push_front(subarray_2);
+  *split = true;
+
+  return Status::Ok();
+}
+
 void Reader::zero_out_buffer_sizes() {
   for (auto& attr_buffer : attr_buffers_) {
     if (attr_buffer.second.buffer_size_ != nullptr)
@@ -34,8 +34,10 @@
 #define TILEDB_READER_H
 
 #include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/buffer/arena.h"
 #include "tiledb/sm/filter/filter_pipeline.h"
 #include "tiledb/sm/fragment/fragment_metadata.h"
+#include "tiledb/sm/misc/memory_budget.h"
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/query/dense_cell_range_iter.h"
 #include "tiledb/sm/query/types.h"
@@ -161,6 +163,15 @@ class Reader {
   /** A list of cell ranges. */
   typedef std::vector<OverlappingCellRange> OverlappingCellRangeList;
 
+  /**
+   * Maps overlapping tiles to the (inclusive) ranges of their cells that
+   * must be unfiltered.
+   */
+  typedef std::unordered_map<
+      const OverlappingTile*,
+      std::vector<std::pair<uint64_t, uint64_t>>>
+      TileCellRangeMap;
+
   /**
    * Records the overlapping tile and position of the coordinates
    * in that tile.
@@ -451,6 +462,13 @@ class Reader {
   /** The array schema. */
   const ArraySchema* array_schema_;
 
+  /**
+   * Scratch memory for a single read iteration (e.g., tile coordinates and
+   * var-sized cell destinations). It is reset at the start of every
+   * iteration.
+   */
+  Arena arena_;
+
   /** The names of the attributes involved in the query. */
   std::vector<std::string> attributes_;
 
@@ -572,20 +590,49 @@ class Reader {
   template <class T>
   Status compute_overlapping_tiles(OverlappingTileVec* tiles) const;
 
+  /**
+   * Computes the overlapping tiles like `compute_overlapping_tiles`, but
+   * first splits the current subarray partition until the memory
+   * needed by its tiles fits in the storage manager memory budget (or
+   * the partition cannot be split any further). The tile memory is then
+   * reserved in `reservation`, which blocks if other queries currently
+   * hold the budget.
+   *
+   * @tparam T The coords type.
+   * @param tiles The tiles to be computed.
+   * @param reservation The reservation the tile memory is added to.
+   * @return Status
+   */
+  template <class T>
+  Status compute_overlapping_tiles_in_budget(
+      OverlappingTileVec* tiles, MemoryReservation* reservation);
+
+  /**
+   * Computes the memory (in bytes) that reading and unfiltering the input
+   * tiles requires, i.e., the persisted plus the unfiltered tile sizes
+   * on all attributes that `read_all_tiles` would retrieve.
+   *
+   * @param tiles The tiles to compute the memory for.
+   * @param ensure_coords Whether the coordinate tiles are read as well.
+   * @return The number of bytes.
+   */
+  uint64_t compute_tiles_memory(
+      const OverlappingTileVec& tiles, bool ensure_coords = true) const;
+
   /**
    * Computes the tile coordinates for each OverlappingCoords and populates
-   * their `tile_coords_` field. The tile coordinates are placed in a
-   * newly-allocated array.
+   * their `tile_coords_` field. The tile coordinates are placed in an
+   * array allocated from the query arena, which lives until the next
+   * read iteration.
    *
    * @tparam T The coords type.
-   * @param all_tile_coords Pointer to the memory allocated by this function.
+   * @param all_tile_coords Set to the array allocated by this function.
    * @param coords The overlapping coords list
    * @return Status
    */
   template <class T>
   Status compute_tile_coords(
-      std::unique_ptr<T[]>* all_tile_coords,
-      OverlappingCoordsList<T>* coords) const;
+      T** all_tile_coords, OverlappingCoordsList<T>* coords);
 
   /**
    * Copies the cells for the input attribute and cell ranges, into
@@ -629,11 +676,13 @@ class Reader {
    *
    * @param attribute The variable-length attribute
    * @param cell_ranges The cell ranges to compute destinations for.
-   * @param offset_offsets_per_cr Output to hold one vector per cell range, and
-   *    one element per cell in the range. The elements are the destination
-   *    offsets for the attribute's offsets.
-   * @param var_offsets_per_cr Output to hold one vector per cell range, and
-   *    one element per cell in the range. The elements are the destination
+   * @param cr_first_cell Set to an arena-allocated array with one element
+   *    per cell range, holding the index of the first cell of the range
+   *    among all cells of the given cell ranges. The destination offset of
+   *    the attribute's offset of that cell is the index times the offset
+   *    size.
+   * @param var_offsets Set to an arena-allocated array with one element
+   *    per cell of the given cell ranges. The elements are the destination
    *    offsets for the attribute's variable-length data.
    * @param total_offset_size Output set to the total size in bytes of the
    *    offsets in the given list of cell ranges.
@@ -644,10 +693,10 @@ class Reader {
   Status compute_var_cell_destinations(
       const std::string& attribute,
       const OverlappingCellRangeList& cell_ranges,
-      std::vector<std::vector<uint64_t>>* offset_offsets_per_cr,
-      std::vector<std::vector<uint64_t>>* var_offsets_per_cr,
+      uint64_t** cr_first_cell,
+      uint64_t** var_offsets,
       uint64_t* total_offset_size,
-      uint64_t* total_var_size) const;
+      uint64_t* total_var_size);
 
   /**
    * Deduplicates the input coordinates, breaking ties giving preference
@@ -724,10 +773,15 @@ class Reader {
    * @param tiles Vector containing tiles to be filtered.
    * @param ensure_coords If true (the default), always filter the coordinate
    *    tiles.
+   * @param cell_ranges If not `nullptr`, only the chunks of the attribute
+   *    tiles that hold cells of these ranges are unfiltered. The coordinate
+   *    tiles are always unfiltered entirely.
    * @return Status
    */
   Status filter_all_tiles(
-      OverlappingTileVec* tiles, bool ensure_coords = true) const;
+      OverlappingTileVec* tiles,
+      bool ensure_coords = true,
+      const OverlappingCellRangeList* cell_ranges = nullptr) const;
 
   /**
    * Filters the tiles on a particular attribute from all input fragments
@@ -735,10 +789,14 @@ class Reader {
    *
    * @param attribute Attribute whose tiles will be filtered
    * @param tiles Vector containing the tiles to be filtered
+   * @param tile_cell_ranges If not `nullptr`, only the chunks of each tile
+   *    that hold the cells mapped to the tile are unfiltered.
    * @return Status
    */
   Status filter_tiles(
-      const std::string& attribute, OverlappingTileVec* tiles) const;
+      const std::string& attribute,
+      OverlappingTileVec* tiles,
+      const TileCellRangeMap* tile_cell_ranges = nullptr) const;
 
   /**
    * Runs the input tile for the input attribute through the filter pipeline.
@@ -748,10 +806,18 @@ class Reader {
    * @param tile The tile to be filtered.
    * @param offsets True if the tile to be filtered contains offsets for a
    *    var-sized attribute.
+   * @param byte_ranges If not `nullptr`, only the chunks overlapping these
+   *    byte ranges of the unfiltered tile are unfiltered.
+   * @param partial Set to `true` if some chunks of the tile were not
+   *    unfiltered, in which case the tile must not be cached.
    * @return Status
    */
   Status filter_tile(
-      const std::string& attribute, Tile* tile, bool offsets) const;
+      const std::string& attribute,
+      Tile* tile,
+      bool offsets,
+      const std::vector<std::pair<uint64_t, uint64_t>>* byte_ranges,
+      bool* partial) const;
 
   /**
    * Gets all the coordinates of the input tile into `coords`.
@@ -911,6 +977,17 @@ class Reader {
   template <class T>
   Status sparse_read();
 
+  /**
+   * Splits the current subarray partition in two. The current partition
+   * becomes the first half, whereas the second half is pushed to the front
+   * of the partition list so that it is processed next.
+   *
+   * @param split Set to `true` if the partition was split, and `false` if
+   *     it cannot be split any further.
+   * @return Status
+   */
+  Status split_cur_subarray_partition(bool* split);
+
   /** Zeroes out the user buffer sizes, indicating an empty result. */
   void zero_out_buffer_sizes();
 };
@@ -42,11 +42,56 @@
 #include "tiledb/sm/tile/tile_io.h"
 
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 namespace tiledb {
 namespace sm {
 
+/* ****************************** */
+/*             HELPERS            */
+/* ****************************** */
+
+/**
+ * Computes the duplicates bitmap of `cell_num` cells with a parallel
+ * adjacent-difference pass, where `equal(i)` returns `true` if cell `i`
+ * (with `i > 0`) has the same coordinates as cell `i - 1`. Every task
+ * sets whole bitmap words, so that no synchronization is needed.
+ */
+template <class EqualT>
+static void compute_dups_bitmap(
+    uint64_t cell_num, const EqualT& equal, Writer::CoordDups* coord_dups) {
+  const uint64_t chunk_words = 1024;
+  auto word_num = (cell_num + 63) / 64;
+  auto chunk_num = (word_num + chunk_words - 1) / chunk_words;
+  coord_dups->words_.clear();
+  coord_dups->count_ = 0;
+  if (cell_num < 2)
+    return;
+
+  std::vector<uint64_t> words(word_num, 0);
+  std::vector<uint64_t> counts(chunk_num, 0);
+  parallel_for(0, chunk_num, [&](uint64_t c) {
+    auto end_word = std::min(word_num, (c + 1) * chunk_words);
+    for (uint64_t w = c * chunk_words; w < end_word; ++w) {
+      uint64_t word = 0;
+      auto end = std::min(cell_num, (w + 1) * 64);
+      for (uint64_t i = std::max(w * 64, uint64_t(1)); i < end; ++i) {
+        if (equal(i))
+          word |= uint64_t(1) << (i % 64);
+      }
+      words[w] = word;
+      counts[c] += utils::math::popcount(word);
+    }
+    return Status::Ok();
+  });
+
+  for (auto count : counts)
+    coord_dups->count_ += count;
+  if (coord_dups->count_ != 0)
+    coord_dups->words_.swap(words);
+}
+
 /* ****************************** */
 /*   CONSTRUCTORS & DESTRUCTORS   */
 /* ****************************** */
@@ -338,6 +383,11 @@ Status Writer::write() {
   if (check_coord_oob_)
     RETURN_NOT_OK(check_coord_oob());
 
+  // Reserve the write memory, waiting for other queries to release
+  // theirs if the memory budget is exhausted
+  MemoryReservation reservation(storage_manager_->memory_budget());
+  RETURN_NOT_OK(reservation.reserve(compute_write_memory()));
+
   if (layout_ == Layout::COL_MAJOR || layout_ == Layout::ROW_MAJOR) {
     RETURN_NOT_OK(ordered_write());
   } else if (layout_ == Layout::UNORDERED) {
@@ -417,7 +467,9 @@ Status Writer::check_buffer_sizes() const {
   return Status::Ok();
 }
 
-Status Writer::check_coord_dups(const std::vector<uint64_t>& cell_pos) const {
+Status Writer::check_coord_dups(
+    const std::vector<uint64_t>& cell_pos,
+    const std::vector<uint64_t>& keys) const {
   STATS_FUNC_IN(writer_check_coord_dups);
 
   auto coords_buff_it = attr_buffers_.find(constants::coords);
@@ -430,6 +482,15 @@ Status Writer::check_coord_dups(const std::vector<uint64_t>& cell_pos) const {
   auto coords_size = array_schema_->coords_size();
   auto coords_num = cell_pos.size();
 
+  if (!keys.empty()) {
+    for (uint64_t i = 1; i < coords_num; ++i) {
+      if (keys[i] == keys[i - 1])
+        return LOG_STATUS(
+            Status::WriterError("Duplicate coordinates are not allowed"));
+    }
+    return Status::Ok();
+  }
+
   for (uint64_t i = 1; i < coords_num; ++i) {
     if (!memcmp(
             coords_buff + cell_pos[i] * coords_size,
@@ -638,7 +699,8 @@ Status Writer::close_files(FragmentMetadata* meta) const {
 
 Status Writer::compute_coord_dups(
     const std::vector<uint64_t>& cell_pos,
-    std::set<uint64_t>* coord_dups) const {
+    const std::vector<uint64_t>& keys,
+    CoordDups* coord_dups) const {
   STATS_FUNC_IN(writer_compute_coord_dups);
 
   auto coords_buff_it = attr_buffers_.find(constants::coords);
@@ -651,13 +713,21 @@ Status Writer::compute_coord_dups(
   auto coords_size = array_schema_->coords_size();
   auto coords_num = cell_pos.size();
 
-  for (uint64_t i = 1; i < coords_num; ++i) {
-    if (!memcmp(
-            coords_buff + cell_pos[i] * coords_size,
-            coords_buff + cell_pos[i - 1] * coords_size,
-            coords_size)) {
-      coord_dups->insert(cell_pos[i]);
-    }
+  if (!keys.empty()) {
+    compute_dups_bitmap(
+        coords_num,
+        [&](uint64_t i) { return keys[i] == keys[i - 1]; },
+        coord_dups);
+  } else {
+    compute_dups_bitmap(
+        coords_num,
+        [&](uint64_t i) {
+          return !memcmp(
+              coords_buff + cell_pos[i] * coords_size,
+              coords_buff + cell_pos[i - 1] * coords_size,
+              coords_size);
+        },
+        coord_dups);
   }
 
   return Status::Ok();
@@ -665,7 +735,7 @@ Status Writer::compute_coord_dups(
   STATS_FUNC_OUT(writer_compute_coord_dups);
 }
 
-Status Writer::compute_coord_dups(std::set<uint64_t>* coord_dups) const {
+Status Writer::compute_coord_dups(CoordDups* coord_dups) const {
   STATS_FUNC_IN(writer_compute_coord_dups_global);
 
   auto coords_buff_it = attr_buffers_.find(constants::coords);
@@ -679,14 +749,15 @@ Status Writer::compute_coord_dups(std::set<uint64_t>* coord_dups) const {
   auto coords_size = array_schema_->coords_size();
   auto coords_num = coords_buff_size / coords_size;
 
-  for (uint64_t i = 1; i < coords_num; ++i) {
-    if (!memcmp(
+  compute_dups_bitmap(
+      coords_num,
+      [&](uint64_t i) {
+        return !memcmp(
             coords_buff + i * coords_size,
             coords_buff + (i - 1) * coords_size,
-            coords_size)) {
-      coord_dups->insert(i);
-    }
-  }
+            coords_size);
+      },
+      coord_dups);
 
   return Status::Ok();
 
@@ -742,6 +813,13 @@ Status Writer::compute_coords_metadata(
     meta->set_bounding_coords(tile_id, &bcoords[0]);
   }
 
+  // Add the keys of a key-value store to the fragment Bloom filter
+  if (array_schema_->is_kv()) {
+    for (const auto& tile : tiles)
+      meta->add_bloom_filter_keys(
+          (const uint64_t*)tile.data(), tile.size() / coords_size);
+  }
+
   // Set last tile cell number
   meta->set_last_tile_cell_num(tiles.back().size() / coords_size);
 
@@ -750,6 +828,93 @@ Status Writer::compute_coords_metadata(
   STATS_FUNC_OUT(writer_compute_coords_metadata);
 }
 
+template <class T>
+bool Writer::compute_sort_keys(
+    std::vector<uint64_t>* keys, unsigned* key_bits) const {
+  STATS_FUNC_IN(writer_compute_sort_keys);
+
+  if (!std::numeric_limits<T>::is_integer)
+    return false;
+
+  // For easy reference
+  auto domain = array_schema_->domain();
+  auto dim_num = domain->dim_num();
+  auto dom = static_cast<const T*>(domain->domain());
+  auto tile_extents = static_cast<const T*>(domain->tile_extents());
+  auto it = attr_buffers_.find(constants::coords);
+  auto buffer = (const T*)it->second.buffer_;
+  uint64_t coords_num = *it->second.buffer_size_ / array_schema_->coords_size();
+  const uint64_t max = std::numeric_limits<uint64_t>::max();
+
+  // Compute the extent and the number of tiles per dimension. Arrays with
+  // null tile extents are treated as a single tile.
+  std::vector<uint64_t> extents(dim_num), tile_nums(dim_num);
+  for (unsigned d = 0; d < dim_num; ++d) {
+    uint64_t range = (uint64_t)dom[2 * d + 1] - (uint64_t)dom[2 * d];
+    if (tile_extents != nullptr) {
+      extents[d] = (uint64_t)tile_extents[d];
+      if (range / extents[d] == max)
+        return false;
+      tile_nums[d] = range / extents[d] + 1;
+    } else {
+      if (range == max)
+        return false;
+      extents[d] = range + 1;
+      tile_nums[d] = 1;
+    }
+  }
+
+  // Compute the position multipliers in the tile and cell order, and
+  // make sure that the keys fit in 64 bits
+  std::vector<uint64_t> tile_mults(dim_num), cell_mults(dim_num);
+  uint64_t tile_num = 1, cell_num_per_tile = 1;
+  for (unsigned i = 0; i < dim_num; ++i) {
+    auto td = (domain->tile_order() == Layout::ROW_MAJOR) ? dim_num - 1 - i : i;
+    auto cd = (domain->cell_order() == Layout::ROW_MAJOR) ? dim_num - 1 - i : i;
+    tile_mults[td] = tile_num;
+    cell_mults[cd] = cell_num_per_tile;
+    if (tile_num > max / tile_nums[td] ||
+        cell_num_per_tile > max / extents[cd])
+      return false;
+    tile_num *= tile_nums[td];
+    cell_num_per_tile *= extents[cd];
+  }
+  if (tile_num > 1 && cell_num_per_tile > max / (tile_num - 1))
+    return false;
+  uint64_t max_key = (tile_num - 1) * cell_num_per_tile;
+  if (cell_num_per_tile - 1 > max - max_key)
+    return false;
+  max_key += cell_num_per_tile - 1;
+  for (*key_bits = 0; *key_bits < 64 && (max_key >> *key_bits) != 0;
+       ++(*key_bits)) {
+  }
+
+  // Compute the keys in parallel
+  keys->resize(coords_num);
+  const uint64_t chunk_size = 65536;
+  uint64_t chunk_num = (coords_num + chunk_size - 1) / chunk_size;
+  if (chunk_num == 0)
+    return true;
+  parallel_for(0, chunk_num, [&](uint64_t c) {
+    auto end = std::min(coords_num, (c + 1) * chunk_size);
+    for (uint64_t i = c * chunk_size; i < end; ++i) {
+      const T* coords = &buffer[i * dim_num];
+      uint64_t tile_pos = 0, cell_pos = 0;
+      for (unsigned d = 0; d < dim_num; ++d) {
+        uint64_t offset = (uint64_t)coords[d] - (uint64_t)dom[2 * d];
+        tile_pos += (offset / extents[d]) * tile_mults[d];
+        cell_pos += (offset % extents[d]) * cell_mults[d];
+      }
+      (*keys)[i] = tile_pos * cell_num_per_tile + cell_pos;
+    }
+    return Status::Ok();
+  });
+
+  return true;
+
+  STATS_FUNC_OUT(writer_compute_sort_keys);
+}
+
 template <class T>
 Status Writer::compute_write_cell_ranges(
     DenseCellRangeIter<T>* iter, WriteCellRangeVec* write_cell_ranges) const {
@@ -809,6 +974,28 @@ Status Writer::compute_write_cell_ranges(
   STATS_FUNC_OUT(writer_compute_write_cell_ranges);
 }
 
+uint64_t Writer::compute_write_memory() const {
+  uint64_t memory = 0;
+  for (const auto& it : attr_buffers_) {
+    memory += *it.second.buffer_size_;
+    if (it.second.buffer_var_size_ != nullptr)
+      memory += *it.second.buffer_var_size_;
+  }
+
+  // One copy for the tiles and one for the filtered tiles
+  memory *= 2;
+
+  // The sorted positions, the sort keys and their radix sort copies
+  if (layout_ == Layout::UNORDERED) {
+    auto it = attr_buffers_.find(constants::coords);
+    if (it != attr_buffers_.end())
+      memory += *it->second.buffer_size_ / array_schema_->coords_size() *
+                4 * sizeof(uint64_t);
+  }
+
+  return memory;
+}
+
 Status Writer::create_fragment(
     bool dense, std::shared_ptr<FragmentMetadata>* frag_meta) const {
   STATS_FUNC_IN(writer_create_fragment);
@@ -1023,7 +1210,7 @@ Status Writer::global_write() {
     RETURN_CANCEL_OR_ERROR(check_coord_dups());
 
   // Retrieve coordinate duplicates
-  std::set<uint64_t> coord_dups;
+  CoordDups coord_dups;
   if (dedup_coords_)
     RETURN_CANCEL_OR_ERROR(compute_coord_dups(&coord_dups));
 
@@ -1425,7 +1612,7 @@ Status Writer::ordered_write() {
 
 Status Writer::prepare_full_tiles(
     const std::string& attribute,
-    const std::set<uint64_t>& coord_dups,
+    const CoordDups& coord_dups,
     std::vector<Tile>* tiles) const {
   return array_schema_->var_size(attribute) ?
              prepare_full_tiles_var(attribute, coord_dups, tiles) :
@@ -1434,7 +1621,7 @@ Status Writer::prepare_full_tiles(
 
 Status Writer::prepare_full_tiles_fixed(
     const std::string& attribute,
-    const std::set<uint64_t>& coord_dups,
+    const CoordDups& coord_dups,
     std::vector<Tile>* tiles) const {
   STATS_FUNC_IN(writer_prepare_full_tiles_fixed);
 
@@ -1465,9 +1652,11 @@ Status Writer::prepare_full_tiles_fixed(
       } while (!last_tile.full() && cell_idx != cell_num);
     } else {
       do {
-        if (coord_dups.find(cell_idx) == coord_dups.end())
-          RETURN_NOT_OK(
-              last_tile.write(buffer + cell_idx * cell_size, cell_size));
+        cell_idx = coord_dups.next_unique(cell_idx, cell_num);
+        if (cell_idx == cell_num)
+          break;
+        RETURN_NOT_OK(
+            last_tile.write(buffer + cell_idx * cell_size, cell_size));
         ++cell_idx;
       } while (!last_tile.full() && cell_idx != cell_num);
     }
@@ -1504,15 +1693,17 @@ Status Writer::prepare_full_tiles_fixed(
         i += cell_num_per_tile;
       }
     } else {
-      for (uint64_t tile_idx = 0, i = 0; i < cell_num_to_write;
-           ++cell_idx, ++i) {
-        if (coord_dups.find(cell_idx) == coord_dups.end()) {
-          if ((*tiles)[tile_idx].full())
-            ++tile_idx;
+      auto end = cell_idx + cell_num_to_write;
+      for (uint64_t tile_idx = 0;; ++cell_idx) {
+        cell_idx = coord_dups.next_unique(cell_idx, end);
+        if (cell_idx == end)
+          break;
+
+        if ((*tiles)[tile_idx].full())
+          ++tile_idx;
 
-          RETURN_NOT_OK((*tiles)[tile_idx].write(
-              buffer + cell_idx * cell_size, cell_size));
-        }
+        RETURN_NOT_OK((*tiles)[tile_idx].write(
+            buffer + cell_idx * cell_size, cell_size));
       }
     }
   }
@@ -1524,10 +1715,10 @@ Status Writer::prepare_full_tiles_fixed(
       RETURN_NOT_OK(last_tile.write(buffer + cell_idx * cell_size, cell_size));
     }
   } else {
-    for (; cell_idx < cell_num; ++cell_idx) {
-      if (coord_dups.find(cell_idx) == coord_dups.end())
-        RETURN_NOT_OK(
-            last_tile.write(buffer + cell_idx * cell_size, cell_size));
+    for (cell_idx = coord_dups.next_unique(cell_idx, cell_num);
+         cell_idx < cell_num;
+         cell_idx = coord_dups.next_unique(cell_idx + 1, cell_num)) {
+      RETURN_NOT_OK(last_tile.write(buffer + cell_idx * cell_size, cell_size));
     }
   }
 
@@ -1540,7 +1731,7 @@ Status Writer::prepare_full_tiles_fixed(
 
 Status Writer::prepare_full_tiles_var(
     const std::string& attribute,
-    const std::set<uint64_t>& coord_dups,
+    const CoordDups& coord_dups,
     std::vector<Tile>* tiles) const {
   STATS_FUNC_IN(writer_prepare_full_tiles_var);
 
@@ -1584,18 +1775,20 @@ Status Writer::prepare_full_tiles_var(
       } while (!last_tile.full() && cell_idx != cell_num);
     } else {
       do {
-        if (coord_dups.find(cell_idx) == coord_dups.end()) {
-          // Write offset
-          offset = last_tile_var.size();
-          RETURN_NOT_OK(last_tile.write(&offset, sizeof(offset)));
-
-          // Write var-sized value
-          var_size = (cell_idx == cell_num - 1) ?
-                         *buffer_var_size - buffer[cell_idx] :
-                         buffer[cell_idx + 1] - buffer[cell_idx];
-          RETURN_NOT_OK(
-              last_tile_var.write(&buffer_var[buffer[cell_idx]], var_size));
-        }
+        cell_idx = coord_dups.next_unique(cell_idx, cell_num);
+        if (cell_idx == cell_num)
+          break;
+
+        // Write offset
+        offset = last_tile_var.size();
+        RETURN_NOT_OK(last_tile.write(&offset, sizeof(offset)));
+
+        // Write var-sized value
+        var_size = (cell_idx == cell_num - 1) ?
+                       *buffer_var_size - buffer[cell_idx] :
+                       buffer[cell_idx + 1] - buffer[cell_idx];
+        RETURN_NOT_OK(
+            last_tile_var.write(&buffer_var[buffer[cell_idx]], var_size));
 
         ++cell_idx;
       } while (!last_tile.full() && cell_idx != cell_num);
@@ -1644,23 +1837,25 @@ Status Writer::prepare_full_tiles_var(
             &buffer_var[buffer[cell_idx]], var_size));
       }
     } else {
-      for (uint64_t tile_idx = 0, i = 0; i < cell_num_to_write;
-           ++cell_idx, ++i) {
-        if (coord_dups.find(cell_idx) == coord_dups.end()) {
-          if ((*tiles)[tile_idx].full())
-            tile_idx += 2;
-
-          // Write offset
-          offset = (*tiles)[tile_idx + 1].size();
-          RETURN_NOT_OK((*tiles)[tile_idx].write(&offset, sizeof(offset)));
-
-          // Write var-sized value
-          var_size = (cell_idx == cell_num - 1) ?
-                         *buffer_var_size - buffer[cell_idx] :
-                         buffer[cell_idx + 1] - buffer[cell_idx];
-          RETURN_NOT_OK((*tiles)[tile_idx + 1].write(
-              &buffer_var[buffer[cell_idx]], var_size));
-        }
+      auto end = cell_idx + cell_num_to_write;
+      for (uint64_t tile_idx = 0;; ++cell_idx) {
+        cell_idx = coord_dups.next_unique(cell_idx, end);
+        if (cell_idx == end)
+          break;
+
+        if ((*tiles)[tile_idx].full())
+          tile_idx += 2;
+
+        // Write offset
+        offset = (*tiles)[tile_idx + 1].size();
+        RETURN_NOT_OK((*tiles)[tile_idx].write(&offset, sizeof(offset)));
+
+        // Write var-sized value
+        var_size = (cell_idx == cell_num - 1) ?
+                       *buffer_var_size - buffer[cell_idx] :
+                       buffer[cell_idx + 1] - buffer[cell_idx];
+        RETURN_NOT_OK((*tiles)[tile_idx + 1].write(
+            &buffer_var[buffer[cell_idx]], var_size));
       }
     }
   }
@@ -1681,19 +1876,19 @@ Status Writer::prepare_full_tiles_var(
           last_tile_var.write(&buffer_var[buffer[cell_idx]], var_size));
     }
   } else {
-    for (; cell_idx < cell_num; ++cell_idx) {
-      if (coord_dups.find(cell_idx) == coord_dups.end()) {
-        // Write offset
-        offset = last_tile_var.size();
-        RETURN_NOT_OK(last_tile.write(&offset, sizeof(offset)));
+    for (cell_idx = coord_dups.next_unique(cell_idx, cell_num);
+         cell_idx < cell_num;
+         cell_idx = coord_dups.next_unique(cell_idx + 1, cell_num)) {
+      // Write offset
+      offset = last_tile_var.size();
+      RETURN_NOT_OK(last_tile.write(&offset, sizeof(offset)));
 
-        // Write var-sized value
-        var_size = (cell_idx == cell_num - 1) ?
-                       *buffer_var_size - buffer[cell_idx] :
-                       buffer[cell_idx + 1] - buffer[cell_idx];
-        RETURN_NOT_OK(
-            last_tile_var.write(&buffer_var[buffer[cell_idx]], var_size));
-      }
+      // Write var-sized value
+      var_size = (cell_idx == cell_num - 1) ?
+                     *buffer_var_size - buffer[cell_idx] :
+                     buffer[cell_idx + 1] - buffer[cell_idx];
+      RETURN_NOT_OK(
+          last_tile_var.write(&buffer_var[buffer[cell_idx]], var_size));
     }
   }
 
@@ -1781,7 +1976,7 @@ Status Writer::prepare_tiles(
 Status Writer::prepare_tiles(
     const std::string& attribute,
     const std::vector<uint64_t>& cell_pos,
-    const std::set<uint64_t>& coord_dups,
+    const CoordDups& coord_dups,
     std::vector<Tile>* tiles) const {
   return array_schema_->var_size(attribute) ?
              prepare_tiles_var(attribute, cell_pos, coord_dups, tiles) :
@@ -1791,7 +1986,7 @@ Status Writer::prepare_tiles(
 Status Writer::prepare_tiles_fixed(
     const std::string& attribute,
     const std::vector<uint64_t>& cell_pos,
-    const std::set<uint64_t>& coord_dups,
+    const CoordDups& coord_dups,
     std::vector<Tile>* tiles) const {
   STATS_FUNC_IN(writer_prepare_tiles_fixed);
 
@@ -1804,7 +1999,7 @@ Status Writer::prepare_tiles_fixed(
   auto buffer = (unsigned char*)it->second.buffer_;
   auto cell_num = (uint64_t)cell_pos.size();
   auto capacity = array_schema_->capacity();
-  auto dups_num = coord_dups.size();
+  auto dups_num = coord_dups.count_;
   auto tile_num = utils::math::ceil(cell_num - dups_num, capacity);
   auto cell_size = array_schema_->cell_size(attribute);
 
@@ -1823,10 +2018,9 @@ Status Writer::prepare_tiles_fixed(
           buffer + cell_pos[i] * cell_size, cell_size));
     }
   } else {
-    for (uint64_t i = 0, tile_idx = 0; i < cell_num; ++i) {
-      if (coord_dups.find(cell_pos[i]) != coord_dups.end())
-        continue;
-
+    for (uint64_t i = coord_dups.next_unique(0, cell_num), tile_idx = 0;
+         i < cell_num;
+         i = coord_dups.next_unique(i + 1, cell_num)) {
       if ((*tiles)[tile_idx].full())
         ++tile_idx;
 
@@ -1843,7 +2037,7 @@ Status Writer::prepare_tiles_fixed(
 Status Writer::prepare_tiles_var(
     const std::string& attribute,
     const std::vector<uint64_t>& cell_pos,
-    const std::set<uint64_t>& coord_dups,
+    const CoordDups& coord_dups,
     std::vector<Tile>* tiles) const {
   STATS_FUNC_IN(writer_prepare_tiles_var);
 
@@ -1854,7 +2048,7 @@ Status Writer::prepare_tiles_var(
   auto buffer_var_size = it->second.buffer_var_size_;
   auto cell_num = (uint64_t)cell_pos.size();
   auto capacity = array_schema_->capacity();
-  auto dups_num = coord_dups.size();
+  auto dups_num = coord_dups.count_;
   auto tile_num = utils::math::ceil(cell_num - dups_num, capacity);
   uint64_t offset;
   uint64_t var_size;
@@ -1883,10 +2077,9 @@ Status Writer::prepare_tiles_var(
           &buffer_var[buffer[cell_pos[i]]], var_size));
     }
   } else {
-    for (uint64_t i = 0, tile_idx = 0; i < cell_num; ++i) {
-      if (coord_dups.find(cell_pos[i]) != coord_dups.end())
-        continue;
-
+    for (uint64_t i = coord_dups.next_unique(0, cell_num), tile_idx = 0;
+         i < cell_num;
+         i = coord_dups.next_unique(i + 1, cell_num)) {
       if ((*tiles)[tile_idx].full())
         tile_idx += 2;
 
@@ -1915,7 +2108,8 @@ void Writer::reset() {
 }
 
 template <class T>
-Status Writer::sort_coords(std::vector<uint64_t>* cell_pos) const {
+Status Writer::sort_coords(
+    std::vector<uint64_t>* cell_pos, std::vector<uint64_t>* keys) const {
   STATS_FUNC_IN(writer_sort_coords);
 
   // For easy reference
@@ -1931,9 +2125,16 @@ Status Writer::sort_coords(std::vector<uint64_t>* cell_pos) const {
   for (uint64_t i = 0; i < coords_num; ++i)
     (*cell_pos)[i] = i;
 
-  // Sort the coordinates in global order
-  parallel_sort(
-      cell_pos->begin(), cell_pos->end(), GlobalCmp<T>(domain, buffer));
+  // Sort the coordinates in global order, with a radix sort on the sort
+  // keys if possible
+  unsigned key_bits;
+  if (compute_sort_keys<T>(keys, &key_bits)) {
+    parallel_radix_sort(keys, cell_pos, key_bits);
+  } else {
+    keys->clear();
+    parallel_sort(
+        cell_pos->begin(), cell_pos->end(), GlobalCmp<T>(domain, buffer));
+  }
 
   return Status::Ok();
 
@@ -1983,17 +2184,19 @@ Status Writer::unordered_write() {
 template <class T>
 Status Writer::unordered_write() {
   // Sort coordinates first
-  std::vector<uint64_t> cell_pos;
-  RETURN_CANCEL_OR_ERROR(sort_coords<T>(&cell_pos));
+  std::vector<uint64_t> cell_pos, keys;
+  RETURN_CANCEL_OR_ERROR(sort_coords<T>(&cell_pos, &keys));
 
   // Check for coordinate duplicates
   if (check_coord_dups_ && !dedup_coords_)
-    RETURN_CANCEL_OR_ERROR(check_coord_dups(cell_pos));
+    RETURN_CANCEL_OR_ERROR(check_coord_dups(cell_pos, keys));
 
   // Retrieve coordinate duplicates
-  std::set<uint64_t> coord_dups;
+  CoordDups coord_dups;
   if (dedup_coords_)
-    RETURN_CANCEL_OR_ERROR(compute_coord_dups(cell_pos, &coord_dups));
+    RETURN_CANCEL_OR_ERROR(compute_coord_dups(cell_pos, keys, &coord_dups));
+  keys.clear();
+  keys.shrink_to_fit();
 
   // Create new fragment
   std::shared_ptr<FragmentMetadata> frag_meta;
@@ -2010,8 +2213,8 @@ Status Writer::unordered_write() {
     return Status::Ok();
   });
 
-  // Clear the boolean vector for coordinate duplicates
-  coord_dups.clear();
+  // Clear the coordinate duplicates bitmap
+  coord_dups = CoordDups();
 
   // Check all statuses
   for (auto& st : statuses)
@@ -2060,8 +2263,13 @@ Status Writer::write_empty_cell_range_to_tile(uint64_t num, Tile* tile) const {
   auto fill_value = constants::fill_value(type);
   assert(fill_value != nullptr);
 
+  // Write all the fill values at once
+  RETURN_NOT_OK(tile->buffer()->reserve(num * fill_size));
+  auto values = (unsigned char*)tile->cur_data();
   for (uint64_t i = 0; i < num; ++i)
-    RETURN_NOT_OK(tile->write(fill_value, fill_size));
+    std::memcpy(values + i * fill_size, fill_value, fill_size);
+  tile->advance_offset(num * fill_size);
+  tile->set_size(tile->offset());
 
   return Status::Ok();
 }
@@ -2073,14 +2281,22 @@ Status Writer::write_empty_cell_range_to_tile_var(
   auto fill_value = constants::fill_value(type);
   assert(fill_value != nullptr);
 
-  for (uint64_t i = 0; i < num; ++i) {
-    // Write next offset
-    uint64_t next_offset = tile_var->size();
-    RETURN_NOT_OK(tile->write(&next_offset, sizeof(uint64_t)));
+  // Make room for all the offsets and values at once
+  RETURN_NOT_OK(tile->buffer()->reserve(num * sizeof(uint64_t)));
+  RETURN_NOT_OK(tile_var->buffer()->reserve(num * fill_size));
 
-    // Write variable-sized empty value
-    RETURN_NOT_OK(tile_var->write(fill_value, fill_size));
+  // Write the offsets and the variable-sized empty values
+  auto offsets = (uint64_t*)tile->cur_data();
+  auto values = (unsigned char*)tile_var->cur_data();
+  uint64_t next_offset = tile_var->size();
+  for (uint64_t i = 0; i < num; ++i) {
+    offsets[i] = next_offset + i * fill_size;
+    std::memcpy(values + i * fill_size, fill_value, fill_size);
   }
+  tile->advance_offset(num * sizeof(uint64_t));
+  tile->set_size(tile->offset());
+  tile_var->advance_offset(num * fill_size);
+  tile_var->set_size(tile_var->offset());
 
   return Status::Ok();
 }
@@ -2100,6 +2316,35 @@ Status Writer::write_cell_range_to_tile_var(
     Tile* tile,
     Tile* tile_var) const {
   auto buff_cell_num = buff->size() / sizeof(uint64_t);
+  auto buff_offsets = (const uint64_t*)buff->data();
+  auto cell_num = end - start + 1;
+  auto var_start = buff_offsets[start];
+  auto var_end =
+      (end == buff_cell_num - 1) ? buff_var->size() : buff_offsets[end + 1];
+
+  // Check if the values of the cells are laid out contiguously in the
+  // order of their offsets, which holds for any well-formed buffer
+  bool contiguous = (var_start <= var_end);
+  for (auto i = start + 1; i <= end && contiguous; ++i)
+    contiguous = (buff_offsets[i - 1] <= buff_offsets[i]);
+  contiguous = contiguous && (buff_offsets[end] <= var_end);
+
+  // Write the offsets, computed from the prefix sums of the cell sizes,
+  // and copy all the values at once
+  if (contiguous) {
+    RETURN_NOT_OK(tile->buffer()->reserve(cell_num * sizeof(uint64_t)));
+    auto offsets = (uint64_t*)tile->cur_data();
+    uint64_t next_offset = tile_var->size();
+    for (uint64_t i = 0; i < cell_num; ++i)
+      offsets[i] = next_offset + (buff_offsets[start + i] - var_start);
+    tile->advance_offset(cell_num * sizeof(uint64_t));
+    tile->set_size(tile->offset());
+
+    buff_var->set_offset(var_start);
+    return tile_var->write(buff_var, var_end - var_start);
+  }
+
+  // Write the cells one by one
   for (auto i = start; i <= end; ++i) {
     // Write next offset
     uint64_t next_offset = tile_var->size();
@@ -36,11 +36,13 @@
 #include "tiledb/sm/array_schema/array_schema.h"
 #include "tiledb/sm/filter/filter_pipeline.h"
 #include "tiledb/sm/fragment/fragment_metadata.h"
+#include "tiledb/sm/misc/memory_budget.h"
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/query/dense_cell_range_iter.h"
 #include "tiledb/sm/query/types.h"
 #include "tiledb/sm/tile/tile.h"
 
+#include <algorithm>
 #include <memory>
 #include <set>
 
@@ -100,6 +102,50 @@ class Writer {
   /** A vector of write cell ranges. */
   typedef std::vector<WriteCellRange> WriteCellRangeVec;
 
+  /**
+   * A bitmap over the cells of a write, in the order in which they are
+   * written into the tiles, where a set bit marks a cell whose coordinates
+   * are equal to those of the previous cell (i.e., a duplicate).
+   */
+  struct CoordDups {
+    /** The bitmap words; empty if there are no duplicates. */
+    std::vector<uint64_t> words_;
+    /** The number of duplicates. */
+    uint64_t count_ = 0;
+
+    /** Returns `true` if there are no duplicates. */
+    bool empty() const {
+      return count_ == 0;
+    }
+
+    /** Returns `true` if cell `i` is a duplicate. */
+    bool test(uint64_t i) const {
+      return !words_.empty() && ((words_[i / 64] >> (i % 64)) & 1);
+    }
+
+    /**
+     * Returns the first cell in `[i, end)` that is not a duplicate, or
+     * `end` if there is none. Words of duplicates are skipped at once.
+     */
+    uint64_t next_unique(uint64_t i, uint64_t end) const {
+      if (words_.empty())
+        return std::min(i, end);
+      while (i < end) {
+        auto word = words_[i / 64] >> (i % 64);
+        if (word == (~uint64_t(0) >> (i % 64))) {
+          i += 64 - i % 64;
+          continue;
+        }
+        while (word & 1) {
+          word >>= 1;
+          ++i;
+        }
+        return std::min(i, end);
+      }
+      return end;
+    }
+  };
+
   /* ********************************* */
   /*     CONSTRUCTORS & DESTRUCTORS    */
   /* ********************************* */
@@ -318,9 +364,15 @@ class Writer {
    *
    * @param cell_pos The sorted positions of the coordinates in the
    *     `attr_buffers_`.
+   * @param keys The sorted keys of the coordinates (see
+   *     `compute_sort_keys`), or empty if the coordinates were not sorted
+   *     by key. Equal coordinates have equal keys, so they are compared
+   *     instead of the coordinates if available.
    * @return Status
    */
-  Status check_coord_dups(const std::vector<uint64_t>& cell_pos) const;
+  Status check_coord_dups(
+      const std::vector<uint64_t>& cell_pos,
+      const std::vector<uint64_t>& keys) const;
 
   /**
    * Throws an error if there are coordinates falling out-of-bounds, i.e.,
@@ -367,14 +419,17 @@ class Writer {
    *
    * @param cell_pos The sorted positions of the coordinates in the
    *     `attr_buffers_`.
-   * @param A set indicating the positions of the duplicates.
-   *     If there are not duplicates, this vector will be **empty** after
-   *     the termination of the function.
+   * @param keys The sorted keys of the coordinates (see
+   *     `compute_sort_keys`), or empty if the coordinates were not sorted
+   *     by key.
+   * @param coord_dups The duplicates bitmap to be computed, indexed by
+   *     the position of the cells in `cell_pos`.
    * @return Status
    */
   Status compute_coord_dups(
       const std::vector<uint64_t>& cell_pos,
-      std::set<uint64_t>* coord_dups) const;
+      const std::vector<uint64_t>& keys,
+      CoordDups* coord_dups) const;
 
   /**
    * Computes the positions of the coordinate duplicates (if any). Note
@@ -385,12 +440,11 @@ class Writer {
    * This functions assumes that the coordinates are laid out in the
    * global order and, hence, they are sorted in the attribute buffers.
    *
-   * @param A set indicating the positions of the duplicates.
-   *     If there are not duplicates, this vector will be **empty** after
-   *     the termination of the function.
+   * @param coord_dups The duplicates bitmap to be computed, indexed by
+   *     the position of the cells in the attribute buffers.
    * @return Status
    */
-  Status compute_coord_dups(std::set<uint64_t>* coord_dups) const;
+  Status compute_coord_dups(CoordDups* coord_dups) const;
 
   /**
    * Computes the coordinates metadata (e.g., MBRs).
@@ -404,6 +458,23 @@ class Writer {
   Status compute_coords_metadata(
       const std::vector<Tile>& tiles, FragmentMetadata* meta) const;
 
+  /**
+   * Computes a sort key for every coordinate tuple of the user buffers,
+   * such that sorting the keys sorts the coordinates in the global order.
+   * The key of a cell is the position of its tile in the tile order,
+   * times the number of cells per tile, plus the position of the cell
+   * within the tile in the cell order. Applicable only to integer
+   * domains whose number of cells fits in 64 bits.
+   *
+   * @tparam T The domain type.
+   * @param keys The keys to be computed, one per cell.
+   * @param key_bits Set to the number of low-order bits used by the keys.
+   * @return `true` if the keys were computed, `false` if the domain does
+   *     not admit such keys.
+   */
+  template <class T>
+  bool compute_sort_keys(std::vector<uint64_t>* keys, unsigned* key_bits) const;
+
   /**
    * Computes the cell ranges to be written, derived from a
    * dense cell range iterator for a specific tile.
@@ -418,6 +489,14 @@ class Writer {
   Status compute_write_cell_ranges(
       DenseCellRangeIter<T>* iters, WriteCellRangeVec* write_cell_ranges) const;
 
+  /**
+   * Estimates the memory (in bytes) this write needs, i.e., the size of
+   * the tiles created from the user buffers plus their filtered copies,
+   * and the sorted cell positions (along with the sort keys and the radix
+   * sort scratch space) in the case of unordered writes.
+   */
+  uint64_t compute_write_memory() const;
+
   /**
    * Creates a new fragment.
    *
@@ -596,13 +675,14 @@ class Writer {
    * invocation.
    *
    * @param attribute The attribute to prepare the tiles for.
-   * @param coord_dups The positions of the duplicate coordinates.
+   * @param coord_dups The duplicates bitmap, indexed by the position of
+   *     the cells in the attribute buffers.
    * @param tiles The **full** tiles to be created.
    * @return Status
    */
   Status prepare_full_tiles(
       const std::string& attribute,
-      const std::set<uint64_t>& coord_dups,
+      const CoordDups& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /**
@@ -615,13 +695,14 @@ class Writer {
    * invocation. Applicable only to fixed-sized attributes.
    *
    * @param attribute The attribute to prepare the tiles for.
-   * @param coord_dups The positions of the duplicate coordinates.
+   * @param coord_dups The duplicates bitmap, indexed by the position of
+   *     the cells in the attribute buffers.
    * @param tiles The **full** tiles to be created.
    * @return Status
    */
   Status prepare_full_tiles_fixed(
       const std::string& attribute,
-      const std::set<uint64_t>& coord_dups,
+      const CoordDups& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /**
@@ -634,13 +715,14 @@ class Writer {
    * invocation. Applicable only to var-sized attributes.
    *
    * @param attribute The attribute to prepare the tiles for.
-   * @param coord_dups The positions of the duplicate coordinates.
+   * @param coord_dups The duplicates bitmap, indexed by the position of
+   *     the cells in the attribute buffers.
    * @param tiles The **full** tiles to be created.
    * @return Status
    */
   Status prepare_full_tiles_var(
       const std::string& attribute,
-      const std::set<uint64_t>& coord_dups,
+      const CoordDups& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /**
@@ -665,15 +747,15 @@ class Writer {
    * @param attribute The attribute to prepare the tiles for.
    * @param cell_pos The positions that resulted from sorting and
    *     according to which the cells must be re-arranged.
-   * @param coord_dups The set with the positions
-   *     of duplicate coordinates/cells.
+   * @param coord_dups The duplicates bitmap, indexed by the position of
+   *     the cells in `cell_pos`.
    * @param tiles The tiles to be created.
    * @return Status
    */
   Status prepare_tiles(
       const std::string& attribute,
       const std::vector<uint64_t>& cell_pos,
-      const std::set<uint64_t>& coord_dups,
+      const CoordDups& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /**
@@ -684,15 +766,15 @@ class Writer {
    * @param attribute The attribute to prepare the tiles for.
    * @param cell_pos The positions that resulted from sorting and
    *     according to which the cells must be re-arranged.
-   * @param coord_dups The set with the positions
-   *     of duplicate coordinates/cells.
+   * @param coord_dups The duplicates bitmap, indexed by the position of
+   *     the cells in `cell_pos`.
    * @param tiles The tiles to be created.
    * @return Status
    */
   Status prepare_tiles_fixed(
       const std::string& attribute,
       const std::vector<uint64_t>& cell_pos,
-      const std::set<uint64_t>& coord_dups,
+      const CoordDups& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /**
@@ -703,15 +785,15 @@ class Writer {
    * @param attribute The attribute to prepare the tiles for.
    * @param cell_pos The positions that resulted from sorting and
    *     according to which the cells must be re-arranged.
-   * @param coord_dups The set with the positions
-   *     of duplicate coordinates/cells.
+   * @param coord_dups The duplicates bitmap, indexed by the position of
+   *     the cells in `cell_pos`.
    * @param tiles The tiles to be created.
    * @return Status
    */
   Status prepare_tiles_var(
       const std::string& attribute,
       const std::vector<uint64_t>& cell_pos,
-      const std::set<uint64_t>& coord_dups,
+      const CoordDups& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /** Resets the writer object, rendering it incomplete. */
@@ -719,14 +801,19 @@ class Writer {
 
   /**
    * Sorts the coordinates of the user buffers, creating a vector with
-   * the sorted positions.
+   * the sorted positions. Integer coordinates are sorted with a radix
+   * sort on the keys of `compute_sort_keys`, otherwise a comparison sort
+   * is used.
    *
    * @tparam T The domain type.
    * @param cell_pos The sorted cell positions to be created.
+   * @param keys The sorted keys of the cells to be created, if the cells
+   *     were sorted by key. It is left empty otherwise.
    * @return Status
    */
   template <class T>
-  Status sort_coords(std::vector<uint64_t>* cell_pos) const;
+  Status sort_coords(
+      std::vector<uint64_t>* cell_pos, std::vector<uint64_t>* keys) const;
 
   /**
    * Writes in unordered layout. Applicable to both dense and sparse arrays.
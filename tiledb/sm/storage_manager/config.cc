@@ -165,10 +165,44 @@ Status Config::set(const std::string& param, const std::string& value) {
     RETURN_NOT_OK(set_sm_check_coord_oob(value));
   } else if (param == "sm.tile_cache_size") {
     RETURN_NOT_OK(set_sm_tile_cache_size(value));
+  } else if (param == "sm.memory_budget") {
+    RETURN_NOT_OK(set_sm_memory_budget(value));
+  } else if (param == "sm.buffer_pool.shared_cache_size") {
+    RETURN_NOT_OK(set_sm_buffer_pool_shared_cache_size(value));
+  } else if (param == "sm.buffer_pool.thread_cache_size") {
+    RETURN_NOT_OK(set_sm_buffer_pool_thread_cache_size(value));
+  } else if (param == "sm.consolidation.step_min_frags") {
+    RETURN_NOT_OK(set_sm_consolidation_step_min_frags(value));
+  } else if (param == "sm.consolidation.step_max_frags") {
+    RETURN_NOT_OK(set_sm_consolidation_step_max_frags(value));
+  } else if (param == "sm.consolidation.step_size_ratio") {
+    RETURN_NOT_OK(set_sm_consolidation_step_size_ratio(value));
+  } else if (param == "sm.consolidation.step_max_bytes") {
+    RETURN_NOT_OK(set_sm_consolidation_step_max_bytes(value));
+  } else if (param == "sm.consolidation.num_threads") {
+    RETURN_NOT_OK(set_sm_consolidation_num_threads(value));
+  } else if (param == "sm.consolidation.background") {
+    RETURN_NOT_OK(set_sm_consolidation_background(value));
+  } else if (param == "sm.consolidation.background_interval_ms") {
+    RETURN_NOT_OK(set_sm_consolidation_background_interval_ms(value));
+  } else if (param == "sm.consolidation.background_frag_num") {
+    RETURN_NOT_OK(set_sm_consolidation_background_frag_num(value));
+  } else if (param == "sm.consolidation.background_frag_bytes") {
+    RETURN_NOT_OK(set_sm_consolidation_background_frag_bytes(value));
+  } else if (param == "sm.consolidation.background_latency_ms") {
+    RETURN_NOT_OK(set_sm_consolidation_background_latency_ms(value));
   } else if (param == "sm.array_schema_cache_size") {
     RETURN_NOT_OK(set_sm_array_schema_cache_size(value));
   } else if (param == "sm.fragment_metadata_cache_size") {
     RETURN_NOT_OK(set_sm_fragment_metadata_cache_size(value));
+  } else if (param == "sm.fragment_manifest") {
+    RETURN_NOT_OK(set_sm_fragment_manifest(value));
+  } else if (param == "sm.kv.wal") {
+    RETURN_NOT_OK(set_sm_kv_wal(value));
+  } else if (param == "sm.kv.wal_sync") {
+    RETURN_NOT_OK(set_sm_kv_wal_sync(value));
+  } else if (param == "sm.kv.flush_threshold") {
+    RETURN_NOT_OK(set_sm_kv_flush_threshold(value));
   } else if (param == "sm.enable_signal_handlers") {
     RETURN_NOT_OK(set_sm_enable_signal_handlers(value));
   } else if (param == "sm.num_async_threads") {
@@ -268,6 +302,82 @@ Status Config::unset(const std::string& param) {
     value << sm_params_.tile_cache_size_;
     param_values_["sm.tile_cache_size"] = value.str();
     value.str(std::string());
+  } else if (param == "sm.memory_budget") {
+    sm_params_.memory_budget_ = constants::memory_budget;
+    value << sm_params_.memory_budget_;
+    param_values_["sm.memory_budget"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.buffer_pool.shared_cache_size") {
+    sm_params_.buffer_pool_shared_cache_size_ =
+        constants::buffer_pool_shared_cache_size;
+    value << sm_params_.buffer_pool_shared_cache_size_;
+    param_values_["sm.buffer_pool.shared_cache_size"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.buffer_pool.thread_cache_size") {
+    sm_params_.buffer_pool_thread_cache_size_ =
+        constants::buffer_pool_thread_cache_size;
+    value << sm_params_.buffer_pool_thread_cache_size_;
+    param_values_["sm.buffer_pool.thread_cache_size"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation.step_min_frags") {
+    sm_params_.consolidation_step_min_frags_ =
+        constants::consolidation_step_min_frags;
+    value << sm_params_.consolidation_step_min_frags_;
+    param_values_["sm.consolidation.step_min_frags"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation.step_max_frags") {
+    sm_params_.consolidation_step_max_frags_ =
+        constants::consolidation_step_max_frags;
+    value << sm_params_.consolidation_step_max_frags_;
+    param_values_["sm.consolidation.step_max_frags"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation.step_size_ratio") {
+    sm_params_.consolidation_step_size_ratio_ =
+        constants::consolidation_step_size_ratio;
+    value << sm_params_.consolidation_step_size_ratio_;
+    param_values_["sm.consolidation.step_size_ratio"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation.step_max_bytes") {
+    sm_params_.consolidation_step_max_bytes_ =
+        constants::consolidation_step_max_bytes;
+    value << sm_params_.consolidation_step_max_bytes_;
+    param_values_["sm.consolidation.step_max_bytes"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation.num_threads") {
+    sm_params_.consolidation_num_threads_ =
+        constants::consolidation_num_threads;
+    value << sm_params_.consolidation_num_threads_;
+    param_values_["sm.consolidation.num_threads"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation.background") {
+    sm_params_.consolidation_background_ = constants::consolidation_background;
+    value << (sm_params_.consolidation_background_ ? "true" : "false");
+    param_values_["sm.consolidation.background"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation.background_interval_ms") {
+    sm_params_.consolidation_background_interval_ms_ =
+        constants::consolidation_background_interval_ms;
+    value << sm_params_.consolidation_background_interval_ms_;
+    param_values_["sm.consolidation.background_interval_ms"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation.background_frag_num") {
+    sm_params_.consolidation_background_frag_num_ =
+        constants::consolidation_background_frag_num;
+    value << sm_params_.consolidation_background_frag_num_;
+    param_values_["sm.consolidation.background_frag_num"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation.background_frag_bytes") {
+    sm_params_.consolidation_background_frag_bytes_ =
+        constants::consolidation_background_frag_bytes;
+    value << sm_params_.consolidation_background_frag_bytes_;
+    param_values_["sm.consolidation.background_frag_bytes"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.consolidation.background_latency_ms") {
+    sm_params_.consolidation_background_latency_ms_ =
+        constants::consolidation_background_latency_ms;
+    value << sm_params_.consolidation_background_latency_ms_;
+    param_values_["sm.consolidation.background_latency_ms"] = value.str();
+    value.str(std::string());
   } else if (param == "sm.array_schema_cache_size") {
     sm_params_.array_schema_cache_size_ = constants::array_schema_cache_size;
     value << sm_params_.array_schema_cache_size_;
@@ -279,6 +389,26 @@ Status Config::unset(const std::string& param) {
     value << sm_params_.fragment_metadata_cache_size_;
     param_values_["sm.fragment_metadata_cache_size"] = value.str();
     value.str(std::string());
+  } else if (param == "sm.fragment_manifest") {
+    sm_params_.fragment_manifest_ = constants::fragment_manifest;
+    value << (sm_params_.fragment_manifest_ ? "true" : "false");
+    param_values_["sm.fragment_manifest"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.kv.wal") {
+    sm_params_.kv_wal_ = constants::kv_wal;
+    value << (sm_params_.kv_wal_ ? "true" : "false");
+    param_values_["sm.kv.wal"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.kv.wal_sync") {
+    sm_params_.kv_wal_sync_ = constants::kv_wal_sync;
+    value << (sm_params_.kv_wal_sync_ ? "true" : "false");
+    param_values_["sm.kv.wal_sync"] = value.str();
+    value.str(std::string());
+  } else if (param == "sm.kv.flush_threshold") {
+    sm_params_.kv_flush_threshold_ = constants::kv_flush_threshold;
+    value << sm_params_.kv_flush_threshold_;
+    param_values_["sm.kv.flush_threshold"] = value.str();
+    value.str(std::string());
   } else if (param == "sm.enable_signal_handlers") {
     sm_params_.enable_signal_handlers_ = constants::enable_signal_handlers;
     value << (sm_params_.enable_signal_handlers_ ? "true" : "false");
@@ -446,6 +576,58 @@ void Config::set_default_param_values() {
   param_values_["sm.tile_cache_size"] = value.str();
   value.str(std::string());
 
+  value << sm_params_.memory_budget_;
+  param_values_["sm.memory_budget"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.buffer_pool_shared_cache_size_;
+  param_values_["sm.buffer_pool.shared_cache_size"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.buffer_pool_thread_cache_size_;
+  param_values_["sm.buffer_pool.thread_cache_size"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_step_min_frags_;
+  param_values_["sm.consolidation.step_min_frags"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_step_max_frags_;
+  param_values_["sm.consolidation.step_max_frags"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_step_size_ratio_;
+  param_values_["sm.consolidation.step_size_ratio"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_step_max_bytes_;
+  param_values_["sm.consolidation.step_max_bytes"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_num_threads_;
+  param_values_["sm.consolidation.num_threads"] = value.str();
+  value.str(std::string());
+
+  value << (sm_params_.consolidation_background_ ? "true" : "false");
+  param_values_["sm.consolidation.background"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_background_interval_ms_;
+  param_values_["sm.consolidation.background_interval_ms"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_background_frag_num_;
+  param_values_["sm.consolidation.background_frag_num"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_background_frag_bytes_;
+  param_values_["sm.consolidation.background_frag_bytes"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.consolidation_background_latency_ms_;
+  param_values_["sm.consolidation.background_latency_ms"] = value.str();
+  value.str(std::string());
+
   value << sm_params_.array_schema_cache_size_;
   param_values_["sm.array_schema_cache_size"] = value.str();
   value.str(std::string());
@@ -454,6 +636,22 @@ void Config::set_default_param_values() {
   param_values_["sm.fragment_metadata_cache_size"] = value.str();
   value.str(std::string());
 
+  value << (sm_params_.fragment_manifest_ ? "true" : "false");
+  param_values_["sm.fragment_manifest"] = value.str();
+  value.str(std::string());
+
+  value << (sm_params_.kv_wal_ ? "true" : "false");
+  param_values_["sm.kv.wal"] = value.str();
+  value.str(std::string());
+
+  value << (sm_params_.kv_wal_sync_ ? "true" : "false");
+  param_values_["sm.kv.wal_sync"] = value.str();
+  value.str(std::string());
+
+  value << sm_params_.kv_flush_threshold_;
+  param_values_["sm.kv.flush_threshold"] = value.str();
+  value.str(std::string());
+
   value << (sm_params_.enable_signal_handlers_ ? "true" : "false");
   param_values_["sm.enable_signal_handlers"] = value.str();
   value.str(std::string());
@@ -619,6 +817,38 @@ Status Config::set_sm_fragment_metadata_cache_size(const std::string& value) {
   return Status::Ok();
 }
 
+Status Config::set_sm_fragment_manifest(const std::string& value) {
+  bool v;
+  RETURN_NOT_OK(parse_bool(value, &v));
+  sm_params_.fragment_manifest_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_kv_wal(const std::string& value) {
+  bool v;
+  RETURN_NOT_OK(parse_bool(value, &v));
+  sm_params_.kv_wal_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_kv_wal_sync(const std::string& value) {
+  bool v;
+  RETURN_NOT_OK(parse_bool(value, &v));
+  sm_params_.kv_wal_sync_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_kv_flush_threshold(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.kv_flush_threshold_ = v;
+
+  return Status::Ok();
+}
+
 Status Config::set_sm_enable_signal_handlers(const std::string& value) {
   bool v;
   RETURN_NOT_OK(parse_bool(value, &v));
@@ -667,6 +897,118 @@ Status Config::set_sm_tile_cache_size(const std::string& value) {
   return Status::Ok();
 }
 
+Status Config::set_sm_memory_budget(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.memory_budget_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_buffer_pool_shared_cache_size(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.buffer_pool_shared_cache_size_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_buffer_pool_thread_cache_size(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.buffer_pool_thread_cache_size_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_step_min_frags(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.consolidation_step_min_frags_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_step_max_frags(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.consolidation_step_max_frags_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_step_size_ratio(const std::string& value) {
+  float v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  if (v < 0.0f || v > 1.0f)
+    return LOG_STATUS(Status::ConfigError(
+        "Cannot set parameter; Consolidation step size ratio must be in "
+        "[0.0, 1.0]"));
+  sm_params_.consolidation_step_size_ratio_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_step_max_bytes(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.consolidation_step_max_bytes_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_num_threads(const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.consolidation_num_threads_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_background(const std::string& value) {
+  bool v;
+  RETURN_NOT_OK(parse_bool(value, &v));
+  sm_params_.consolidation_background_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_background_interval_ms(
+    const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.consolidation_background_interval_ms_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_background_frag_num(
+    const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.consolidation_background_frag_num_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_background_frag_bytes(
+    const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.consolidation_background_frag_bytes_ = v;
+
+  return Status::Ok();
+}
+
+Status Config::set_sm_consolidation_background_latency_ms(
+    const std::string& value) {
+  uint64_t v;
+  RETURN_NOT_OK(utils::parse::convert(value, &v));
+  sm_params_.consolidation_background_latency_ms_ = v;
+
+  return Status::Ok();
+}
+
 Status Config::set_vfs_num_threads(const std::string& value) {
   uint64_t v;
   RETURN_NOT_OK(utils::parse::convert(value, &v));
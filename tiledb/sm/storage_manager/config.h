@@ -54,12 +54,29 @@ class Config {
   struct SMParams {
     uint64_t array_schema_cache_size_;
     uint64_t fragment_metadata_cache_size_;
+    bool fragment_manifest_;
+    bool kv_wal_;
+    bool kv_wal_sync_;
+    uint64_t kv_flush_threshold_;
     bool enable_signal_handlers_;
     uint64_t num_async_threads_;
     uint64_t num_reader_threads_;
     uint64_t num_writer_threads_;
     int num_tbb_threads_;
     uint64_t tile_cache_size_;
+    uint64_t memory_budget_;
+    uint64_t buffer_pool_shared_cache_size_;
+    uint64_t buffer_pool_thread_cache_size_;
+    uint64_t consolidation_step_min_frags_;
+    uint64_t consolidation_step_max_frags_;
+    float consolidation_step_size_ratio_;
+    uint64_t consolidation_step_max_bytes_;
+    uint64_t consolidation_num_threads_;
+    bool consolidation_background_;
+    uint64_t consolidation_background_interval_ms_;
+    uint64_t consolidation_background_frag_num_;
+    uint64_t consolidation_background_frag_bytes_;
+    uint64_t consolidation_background_latency_ms_;
     bool dedup_coords_;
     bool check_coord_dups_;
     bool check_coord_oob_;
@@ -67,12 +84,35 @@ class Config {
     SMParams() {
       array_schema_cache_size_ = constants::array_schema_cache_size;
       fragment_metadata_cache_size_ = constants::fragment_metadata_cache_size;
+      fragment_manifest_ = constants::fragment_manifest;
+      kv_wal_ = constants::kv_wal;
+      kv_wal_sync_ = constants::kv_wal_sync;
+      kv_flush_threshold_ = constants::kv_flush_threshold;
       enable_signal_handlers_ = constants::enable_signal_handlers;
       num_async_threads_ = constants::num_async_threads;
       num_reader_threads_ = constants::num_reader_threads;
       num_writer_threads_ = constants::num_writer_threads;
       num_tbb_threads_ = constants::num_tbb_threads;
       tile_cache_size_ = constants::tile_cache_size;
+      memory_budget_ = constants::memory_budget;
+      buffer_pool_shared_cache_size_ =
+          constants::buffer_pool_shared_cache_size;
+      buffer_pool_thread_cache_size_ =
+          constants::buffer_pool_thread_cache_size;
+      consolidation_step_min_frags_ = constants::consolidation_step_min_frags;
+      consolidation_step_max_frags_ = constants::consolidation_step_max_frags;
+      consolidation_step_size_ratio_ = constants::consolidation_step_size_ratio;
+      consolidation_step_max_bytes_ = constants::consolidation_step_max_bytes;
+      consolidation_num_threads_ = constants::consolidation_num_threads;
+      consolidation_background_ = constants::consolidation_background;
+      consolidation_background_interval_ms_ =
+          constants::consolidation_background_interval_ms;
+      consolidation_background_frag_num_ =
+          constants::consolidation_background_frag_num;
+      consolidation_background_frag_bytes_ =
+          constants::consolidation_background_frag_bytes;
+      consolidation_background_latency_ms_ =
+          constants::consolidation_background_latency_ms;
       dedup_coords_ = false;
       check_coord_dups_ = true;
       check_coord_oob_ = true;
@@ -203,6 +243,71 @@ class Config {
    * - `sm.tile_cache_size` <br>
    *    The tile cache size in bytes. Any `uint64_t` value is acceptable. <br>
    *    **Default**: 10,000,000
+   * - `sm.memory_budget` <br>
+   *    The total number of bytes that the queries, the tile cache and the
+   *    filter pipelines of a context may hold in memory at any time.
+   *    Reads split their subarray partitions and writes queue until they
+   *    fit in the budget. Zero means unlimited. <br>
+   *    **Default**: 5,000,000,000
+   * - `sm.buffer_pool.shared_cache_size` <br>
+   *    The maximum number of bytes of released tile and filter buffers that
+   *    the process-wide buffer pool keeps for reuse across threads. The pool
+   *    is shared by all contexts of the process, and is sized by the first
+   *    context created. <br>
+   *    **Default**: 268,435,456
+   * - `sm.buffer_pool.thread_cache_size` <br>
+   *    The maximum number of bytes of released buffers that the buffer pool
+   *    keeps for reuse in each thread. Like the shared cache size, it is set
+   *    by the first context created. <br>
+   *    **Default**: 33,554,432
+   * - `sm.consolidation.step_min_frags` <br>
+   *    The minimum number of fragments that a consolidation step merges.
+   *    If no run of at least this many fragments qualifies, consolidation
+   *    is a no-op. <br>
+   *    **Default**: 2
+   * - `sm.consolidation.step_max_frags` <br>
+   *    The maximum number of fragments that a consolidation step merges
+   *    (i.e., the consolidation fan-in). <br>
+   *    **Default**: 4294967295
+   * - `sm.consolidation.step_size_ratio` <br>
+   *    Two adjacent fragments are merged in the same consolidation step only
+   *    if the size of the smaller one divided by the size of the larger one
+   *    is at least this ratio. A value in `[0.0, 1.0]`, where `0.0` merges
+   *    fragments of any size and values close to `1.0` merge only fragments
+   *    of similar size. <br>
+   *    **Default**: 0.0
+   * - `sm.consolidation.step_max_bytes` <br>
+   *    The maximum total size in bytes of the fragments that a consolidation
+   *    step merges. Zero means unlimited. <br>
+   *    **Default**: 0
+   * - `sm.consolidation.num_threads` <br>
+   *    The maximum number of subarray partitions that consolidation reads
+   *    concurrently. The partitions are slabs of space tiles. The buffers of
+   *    all partitions are bounded by half of `sm.memory_budget`. <br>
+   *    **Default**: number of cores
+   * - `sm.consolidation.background` <br>
+   *    If `true`, a background service consolidates the unencrypted arrays
+   *    opened through the context whenever they cross the
+   *    `sm.consolidation.background_*` thresholds. <br>
+   *    **Default**: false
+   * - `sm.consolidation.background_interval_ms` <br>
+   *    The period in milliseconds at which the background consolidation
+   *    service checks the watched arrays. <br>
+   *    **Default**: 1000
+   * - `sm.consolidation.background_frag_num` <br>
+   *    The background consolidation service consolidates an array once it
+   *    has at least this many fragments. <br>
+   *    **Default**: 8
+   * - `sm.consolidation.background_frag_bytes` <br>
+   *    The background consolidation service consolidates an array once the
+   *    total size in bytes of its fragments, excluding the largest one,
+   *    reaches this value. Zero disables the size threshold. <br>
+   *    **Default**: 0
+   * - `sm.consolidation.background_latency_ms` <br>
+   *    The target latency in milliseconds of the foreground queries. While
+   *    the recent foreground query latency exceeds it, background
+   *    consolidation pauses between its writes. Zero disables throttling. <br>
+   *    **Default**: 0
    * - `sm.array_schema_cache_size` <br>
    *    Array schema cache size in bytes. Any `uint64_t` value is acceptable.
    * <br>
@@ -211,6 +316,38 @@ class Config {
    *    The fragment metadata cache size in bytes. Any `uint64_t` value is
    *    acceptable. <br>
    *    **Default**: 10,000,000
+   * - `sm.fragment_manifest` <br>
+   *    If `true`, writers record the fragments they create and consolidation
+   *    removes in the array fragment manifest, and opening or reopening an
+   *    array reads the new manifest entries instead of listing the array
+   *    directory. All the writers of an array must set it consistently.
+   *    Local writers serialize their manifest updates with a lock file. S3
+   *    and HDFS have no file locks, so only one process may write to the
+   *    array at a time there. <br>
+   *    **Default**: false
+   * - `sm.kv.wal` <br>
+   *    If `true`, every item added to a key-value store is first appended to
+   *    a write-ahead log in the key-value directory, so that unflushed items
+   *    survive a process crash. Opening the key-value store for writes
+   *    flushes the items left in the log, and opening it for reads serves
+   *    them from memory before the persisted fragments. Each writer locks its
+   *    own log, so that only the logs of crashed writers are flushed. The log
+   *    is only supported on local filesystems, and not for encrypted
+   *    key-value stores. <br>
+   *    **Default**: false
+   * - `sm.kv.wal_sync` <br>
+   *    If `true`, every write-ahead log append is synced to persistent
+   *    storage before the item is added, so that added items also survive
+   *    an operating system crash or power loss. If `false`, the appends are
+   *    left to the operating system to write back, which is faster but only
+   *    protects against process crashes. <br>
+   *    **Default**: true
+   * - `sm.kv.flush_threshold` <br>
+   *    The size in bytes of the buffered key-value items that triggers a
+   *    flush in the background. Writers keep adding items while the flush is
+   *    in progress, and block only if a second flush becomes due before the
+   *    first one completes. If `0`, items are flushed only explicitly. <br>
+   *    **Default**: 0
    * - `sm.enable_signal_handlers` <br>
    *    Whether or not TileDB will install signal handlers. <br>
    *    **Default**: true
@@ -373,6 +510,18 @@ class Config {
   /** Sets the fragment metadata cache size, properly parsing the input value.*/
   Status set_sm_fragment_metadata_cache_size(const std::string& value);
 
+  /** Sets whether the fragment manifest is used. */
+  Status set_sm_fragment_manifest(const std::string& value);
+
+  /** Sets whether key-value writes use a write-ahead log. */
+  Status set_sm_kv_wal(const std::string& value);
+
+  /** Sets whether key-value write-ahead log appends are synced. */
+  Status set_sm_kv_wal_sync(const std::string& value);
+
+  /** Sets the key-value background flush threshold. */
+  Status set_sm_kv_flush_threshold(const std::string& value);
+
   /** Sets the enable signal handlers value, properly parsing the input value.*/
   Status set_sm_enable_signal_handlers(const std::string& value);
 
@@ -391,6 +540,45 @@ class Config {
   /** Sets the tile cache size, properly parsing the input value. */
   Status set_sm_tile_cache_size(const std::string& value);
 
+  /** Sets the memory budget, properly parsing the input value. */
+  Status set_sm_memory_budget(const std::string& value);
+
+  /** Sets the buffer pool shared cache size. */
+  Status set_sm_buffer_pool_shared_cache_size(const std::string& value);
+
+  /** Sets the buffer pool per-thread cache size. */
+  Status set_sm_buffer_pool_thread_cache_size(const std::string& value);
+
+  /** Sets the minimum number of fragments of a consolidation step. */
+  Status set_sm_consolidation_step_min_frags(const std::string& value);
+
+  /** Sets the maximum number of fragments of a consolidation step. */
+  Status set_sm_consolidation_step_max_frags(const std::string& value);
+
+  /** Sets the size ratio of the fragments of a consolidation step. */
+  Status set_sm_consolidation_step_size_ratio(const std::string& value);
+
+  /** Sets the maximum total size of the fragments of a consolidation step. */
+  Status set_sm_consolidation_step_max_bytes(const std::string& value);
+
+  /** Sets the number of concurrent partitions of consolidation. */
+  Status set_sm_consolidation_num_threads(const std::string& value);
+
+  /** Enables or disables the background consolidation service. */
+  Status set_sm_consolidation_background(const std::string& value);
+
+  /** Sets the period of the background consolidation service. */
+  Status set_sm_consolidation_background_interval_ms(const std::string& value);
+
+  /** Sets the fragment number that triggers background consolidation. */
+  Status set_sm_consolidation_background_frag_num(const std::string& value);
+
+  /** Sets the fragment size that triggers background consolidation. */
+  Status set_sm_consolidation_background_frag_bytes(const std::string& value);
+
+  /** Sets the foreground latency target of background consolidation. */
+  Status set_sm_consolidation_background_latency_ms(const std::string& value);
+
   /** Sets the number of VFS threads. */
   Status set_vfs_num_threads(const std::string& value);
 
@@ -0,0 +1,296 @@
+/**
+ * @file   consolidation_service.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class ConsolidationService.
+ */
+
+#include "tiledb/sm/storage_manager/consolidation_service.h"
+#include "tiledb/sm/array/array.h"
+#include "tiledb/sm/fragment/fragment_metadata.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/stats.h"
+#include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/storage_manager/storage_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+ConsolidationService::ConsolidationService(StorageManager* storage_manager)
+    : consolidator_(storage_manager)
+    , enabled_(false)
+    , frag_num_(0)
+    , frag_bytes_(0)
+    , interval_ms_(0)
+    , last_query_ms_(0)
+    , latency_ms_(0)
+    , latency_target_ms_(0)
+    , retry_(false)
+    , stopped_(false)
+    , storage_manager_(storage_manager) {
+}
+
+ConsolidationService::~ConsolidationService() {
+  stop();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status ConsolidationService::init() {
+  auto sm_params = storage_manager_->config().sm_params();
+  enabled_ = sm_params.consolidation_background_;
+  frag_num_ = sm_params.consolidation_background_frag_num_;
+  frag_bytes_ = sm_params.consolidation_background_frag_bytes_;
+  interval_ms_ =
+      std::max<uint64_t>(sm_params.consolidation_background_interval_ms_, 1);
+  latency_target_ms_ = sm_params.consolidation_background_latency_ms_;
+
+  if (!enabled_)
+    return Status::Ok();
+
+  consolidator_.set_throttle([this]() { throttle(); });
+  try {
+    thread_ = std::thread(&ConsolidationService::run, this);
+  } catch (const std::exception& e) {
+    enabled_ = false;
+    return LOG_STATUS(Status::StorageManagerError(
+        std::string("Cannot start consolidation service; ") + e.what()));
+  }
+
+  return Status::Ok();
+}
+
+void ConsolidationService::array_closed(const URI& array_uri) {
+  if (!enabled_)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (pending_.count(array_uri.to_string()) == 0)
+      return;
+    retry_ = true;
+  }
+  cv_.notify_all();
+}
+
+Status ConsolidationService::check_arrays() {
+  std::vector<std::string> arrays;
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    arrays.assign(arrays_.begin(), arrays_.end());
+  }
+  return check_arrays(arrays);
+}
+
+void ConsolidationService::record_query_latency(uint64_t latency_ms) {
+  if (!enabled_ || latency_target_ms_ == 0)
+    return;
+
+  std::unique_lock<std::mutex> lck(mtx_);
+  latency_ms_ = (7 * latency_ms_ + latency_ms) / 8;
+  last_query_ms_ = utils::time::timestamp_now_ms();
+}
+
+void ConsolidationService::stop() {
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+
+  if (thread_.joinable())
+    thread_.join();
+}
+
+void ConsolidationService::throttle() {
+  if (latency_target_ms_ == 0)
+    return;
+
+  // Pause while foreground queries are being issued and their latency is
+  // above the target. The latency estimate is only trusted if a query was
+  // seen within the last check period.
+  std::unique_lock<std::mutex> lck(mtx_);
+  while (!stopped_ && latency_ms_ > latency_target_ms_ &&
+         utils::time::timestamp_now_ms() < last_query_ms_ + interval_ms_) {
+    STATS_COUNTER_ADD(sm_consolidation_service_throttle_waits, 1);
+    cv_.wait_for(lck, std::chrono::milliseconds(latency_target_ms_));
+  }
+}
+
+void ConsolidationService::watch_array(const URI& array_uri) {
+  if (!enabled_)
+    return;
+
+  std::unique_lock<std::mutex> lck(mtx_);
+  if (arrays_.insert(array_uri.to_string()).second)
+    STATS_COUNTER_ADD(sm_consolidation_service_arrays_watched, 1);
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+Status ConsolidationService::check_array(const URI& array_uri) {
+  STATS_COUNTER_ADD(sm_consolidation_service_checks, 1);
+
+  // Stop watching arrays that have been removed
+  ObjectType obj_type;
+  RETURN_NOT_OK(storage_manager_->object_type(array_uri, &obj_type));
+  if (obj_type != ObjectType::ARRAY && obj_type != ObjectType::KEY_VALUE) {
+    std::unique_lock<std::mutex> lck(mtx_);
+    arrays_.erase(array_uri.to_string());
+    pending_.erase(array_uri.to_string());
+    return Status::Ok();
+  }
+
+  // Consolidation would block until the array is closed for reads, so
+  // skip the array and retry it once it is closed. It is marked pending
+  // before the check, so that a concurrent close triggers the retry.
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    pending_.insert(array_uri.to_string());
+  }
+  if (storage_manager_->is_array_open_for_reads(array_uri)) {
+    STATS_COUNTER_ADD(sm_consolidation_service_skips, 1);
+    return Status::Ok();
+  }
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    pending_.erase(array_uri.to_string());
+  }
+
+  uint64_t fragment_num, pending_bytes;
+  RETURN_NOT_OK(fragment_info(array_uri, &fragment_num, &pending_bytes));
+  while (!stopped() && fragment_num > 1 &&
+         (fragment_num >= frag_num_ ||
+          (frag_bytes_ != 0 && pending_bytes >= frag_bytes_))) {
+    RETURN_NOT_OK(consolidate(array_uri));
+
+    // Stop if the consolidation step merged nothing, e.g., because of the
+    // `sm.consolidation.step_*` configuration
+    uint64_t new_fragment_num;
+    RETURN_NOT_OK(fragment_info(array_uri, &new_fragment_num, &pending_bytes));
+    if (new_fragment_num >= fragment_num)
+      break;
+    STATS_COUNTER_ADD(
+        sm_consolidation_service_fragments_removed,
+        fragment_num - new_fragment_num);
+    fragment_num = new_fragment_num;
+  }
+
+  return Status::Ok();
+}
+
+Status ConsolidationService::check_arrays(
+    const std::vector<std::string>& arrays) {
+  std::unique_lock<std::mutex> lck(check_mtx_);
+  auto ret = Status::Ok();
+  for (const auto& array : arrays) {
+    if (stopped())
+      break;
+    auto st = check_array(URI(array));
+    if (!st.ok()) {
+      STATS_COUNTER_ADD(sm_consolidation_service_failures, 1);
+      if (ret.ok())
+        ret = st;
+    }
+  }
+
+  return ret;
+}
+
+Status ConsolidationService::consolidate(const URI& array_uri) {
+  STATS_FUNC_IN(sm_consolidation_service_consolidate);
+
+  STATS_COUNTER_ADD(sm_consolidation_service_runs, 1);
+  return consolidator_.consolidate(
+      array_uri.c_str(), EncryptionType::NO_ENCRYPTION, nullptr, 0);
+
+  STATS_FUNC_OUT(sm_consolidation_service_consolidate);
+}
+
+Status ConsolidationService::fragment_info(
+    const URI& array_uri, uint64_t* fragment_num, uint64_t* pending_bytes) {
+  Array array(array_uri, storage_manager_);
+  RETURN_NOT_OK(
+      array.open(QueryType::READ, EncryptionType::NO_ENCRYPTION, nullptr, 0));
+
+  auto fragment_metadata = array.fragment_metadata();
+  uint64_t total_bytes = 0, max_bytes = 0;
+  for (auto meta : fragment_metadata) {
+    auto size = meta->fragment_size();
+    total_bytes += size;
+    max_bytes = std::max(max_bytes, size);
+  }
+  *fragment_num = fragment_metadata.size();
+  *pending_bytes = total_bytes - max_bytes;
+
+  return array.close();
+}
+
+void ConsolidationService::run() {
+  std::unique_lock<std::mutex> lck(mtx_);
+  while (!stopped_) {
+    cv_.wait_for(lck, std::chrono::milliseconds(interval_ms_), [this]() {
+      return stopped_ || retry_;
+    });
+    if (stopped_)
+      break;
+
+    // Only retry the skipped arrays if a closed array woke the thread up.
+    // The arrays are checked without holding the lock, so that queries can
+    // keep reporting latencies and registering arrays.
+    std::vector<std::string> arrays;
+    if (retry_)
+      arrays.assign(pending_.begin(), pending_.end());
+    else
+      arrays.assign(arrays_.begin(), arrays_.end());
+    retry_ = false;
+    lck.unlock();
+    check_arrays(arrays);
+    lck.lock();
+  }
+}
+
+bool ConsolidationService::stopped() {
+  std::unique_lock<std::mutex> lck(mtx_);
+  return stopped_;
+}
+
+}  // namespace sm
+}  // namespace tiledb
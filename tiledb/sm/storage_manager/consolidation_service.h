@@ -0,0 +1,255 @@
+/**
+ * @file   consolidation_service.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2018 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class ConsolidationService.
+ */
+
+#ifndef TILEDB_CONSOLIDATION_SERVICE_H
+#define TILEDB_CONSOLIDATION_SERVICE_H
+
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/uri.h"
+#include "tiledb/sm/storage_manager/consolidator.h"
+
+namespace tiledb {
+namespace sm {
+
+class StorageManager;
+
+/**
+ * Consolidates arrays in the background of a storage manager.
+ *
+ * The service watches the unencrypted arrays opened through the storage
+ * manager. Every `sm.consolidation.background_interval_ms` it counts the
+ * fragments of each watched array and consolidates the array while it has
+ * at least `sm.consolidation.background_frag_num` fragments, or while its
+ * fragments but the largest one take at least
+ * `sm.consolidation.background_frag_bytes` bytes. Consolidation must lock
+ * an array exclusively, so arrays that are open for reads are skipped and
+ * counted by `sm_consolidation_service_skips`. A skipped array is checked
+ * again as soon as its last reader closes it.
+ *
+ * To keep foreground queries responsive, the storage manager reports the
+ * latency of every foreground query to the service. While the recent
+ * latency exceeds `sm.consolidation.background_latency_ms`, the
+ * consolidation pauses between its writes.
+ *
+ * The progress of the service is reported by the
+ * `sm_consolidation_service_*` statistics.
+ */
+class ConsolidationService {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param storage_manager The storage manager.
+   */
+  ConsolidationService(StorageManager* storage_manager);
+
+  /** Destructor. Stops the service. */
+  ~ConsolidationService();
+
+  ConsolidationService(const ConsolidationService&) = delete;
+  ConsolidationService& operator=(const ConsolidationService&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Initializes the service from the storage manager configuration, and
+   * starts the background thread if `sm.consolidation.background` is set.
+   *
+   * @return Status
+   */
+  Status init();
+
+  /**
+   * Notifies the service that an array is no longer open for reads. If the
+   * array was skipped for that reason, the background thread checks it
+   * again without waiting for the next period.
+   *
+   * @param array_uri The array URI.
+   */
+  void array_closed(const URI& array_uri);
+
+  /**
+   * Checks all watched arrays and consolidates them as needed, returning
+   * once the check is complete. This does not wait for the period of the
+   * background thread, and may be called whether or not the service is
+   * enabled.
+   *
+   * @return Status
+   */
+  Status check_arrays();
+
+  /**
+   * Records the latency of a foreground query.
+   *
+   * @param latency_ms The query latency in milliseconds.
+   */
+  void record_query_latency(uint64_t latency_ms);
+
+  /** Stops the service, waiting for an ongoing consolidation to finish. */
+  void stop();
+
+  /**
+   * Blocks while the recent foreground query latency exceeds the target.
+   * Called by the service consolidator between its writes.
+   */
+  void throttle();
+
+  /**
+   * Adds an array to the arrays watched by the service. This is a no-op if
+   * the service is disabled.
+   *
+   * @param array_uri The array URI.
+   */
+  void watch_array(const URI& array_uri);
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The URIs of the watched arrays. */
+  std::set<std::string> arrays_;
+
+  /** Serializes the array checks. */
+  std::mutex check_mtx_;
+
+  /** The consolidator used by the service. */
+  Consolidator consolidator_;
+
+  /** Notified when the service is stopped or an array must be retried. */
+  std::condition_variable cv_;
+
+  /** `true` if the service is enabled. */
+  bool enabled_;
+
+  /** The number of fragments that triggers consolidation. */
+  uint64_t frag_num_;
+
+  /** The unconsolidated fragment size that triggers consolidation. */
+  uint64_t frag_bytes_;
+
+  /** The period in milliseconds of the array checks. */
+  uint64_t interval_ms_;
+
+  /** The time in milliseconds of the last foreground query. */
+  uint64_t last_query_ms_;
+
+  /** The moving average of the foreground query latency. */
+  double latency_ms_;
+
+  /** The target foreground query latency (zero disables throttling). */
+  uint64_t latency_target_ms_;
+
+  /** Protects the state of the service. */
+  std::mutex mtx_;
+
+  /** The URIs of the watched arrays skipped because they were open. */
+  std::set<std::string> pending_;
+
+  /** `true` if a skipped array has been closed since the last check. */
+  bool retry_;
+
+  /** `true` once the service has been stopped. */
+  bool stopped_;
+
+  /** The storage manager. */
+  StorageManager* storage_manager_;
+
+  /** The background thread. */
+  std::thread thread_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Checks the fragments of an array and consolidates it while it exceeds
+   * the thresholds and consolidation makes progress.
+   *
+   * @param array_uri The array URI.
+   * @return Status
+   */
+  Status check_array(const URI& array_uri);
+
+  /**
+   * Checks the input arrays one after the other, stopping early if the
+   * service is stopped. Failures are counted and do not stop the check.
+   *
+   * @param arrays The array URIs.
+   * @return The status of the first failed check.
+   */
+  Status check_arrays(const std::vector<std::string>& arrays);
+
+  /**
+   * Performs one consolidation step on an array.
+   *
+   * @param array_uri The array URI.
+   * @return Status
+   */
+  Status consolidate(const URI& array_uri);
+
+  /**
+   * Retrieves the number of fragments of an array and their total size,
+   * excluding the largest fragment.
+   *
+   * @param array_uri The array URI.
+   * @param fragment_num The number of fragments.
+   * @param pending_bytes The total size of all fragments but the largest.
+   * @return Status
+   */
+  Status fragment_info(
+      const URI& array_uri, uint64_t* fragment_num, uint64_t* pending_bytes);
+
+  /** The main loop of the background thread. */
+  void run();
+
+  /** Returns `true` if the service has been stopped. */
+  bool stopped();
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_CONSOLIDATION_SERVICE_H
@@ -31,11 +31,18 @@
  */
 
 #include "tiledb/sm/storage_manager/consolidator.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/misc/comparators.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/thread_pool.h"
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/misc/uuid.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
+#include "tiledb/sm/tile/tile.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -56,6 +63,20 @@ Consolidator::Consolidator(StorageManager* storage_manager)
 
 Consolidator::~Consolidator() = default;
 
+Consolidator::BufferSet::BufferSet()
+    : capacity_(0) {
+}
+
+Consolidator::BufferSet::~BufferSet() {
+  for (auto buffer : buffers_)
+    std::free(buffer);
+}
+
+Consolidator::Partition::Partition()
+    : done_(false)
+    , cancelled_(false) {
+}
+
 /* ****************************** */
 /*               API              */
 /* ****************************** */
@@ -77,84 +98,96 @@ Status Consolidator::consolidate(
     return Status::Ok();
   }
 
-  // Open array for writing
-  Array array_for_writes(array_uri, storage_manager_);
-  RETURN_NOT_OK_ELSE(
-      array_for_writes.open(
-          QueryType::WRITE, encryption_type, encryption_key, key_length),
-      array_for_reads.close());
-
-  // Get schema
-  auto array_schema = array_for_reads.array_schema();
-
-  // Create subarray
+  // Select the fragments to consolidate
+  std::vector<FragmentMetadata*> to_consolidate;
   void* subarray = nullptr;
-  auto st = create_subarray(&array_for_reads, &subarray);
+  auto st =
+      compute_next_to_consolidate(&array_for_reads, &to_consolidate, &subarray);
   if (!st.ok()) {
+    std::free(subarray);
     array_for_reads.close();
-    array_for_writes.close();
     return st;
   }
+  if (to_consolidate.empty()) {  // Nothing to consolidate
+    std::free(subarray);
+    return array_for_reads.close();
+  }
 
-  // Prepare buffers
-  void** buffers;
-  uint64_t* buffer_sizes;
-  unsigned int buffer_num;
-  st = create_buffers(array_schema, &buffers, &buffer_sizes, &buffer_num);
+  // Open array for writing
+  Array array_for_writes(array_uri, storage_manager_);
+  st = array_for_writes.open(
+      QueryType::WRITE, encryption_type, encryption_key, key_length);
   if (!st.ok()) {
+    std::free(subarray);
     array_for_reads.close();
-    array_for_writes.close();
     return st;
   }
 
-  // Create queries
-  unsigned int fragment_num;
-  auto query_r = (Query*)nullptr;
-  auto query_w = (Query*)nullptr;
-  URI new_fragment_uri;
-  st = create_queries(
-      &query_r,
-      &query_w,
-      subarray,
-      &array_for_reads,
-      &array_for_writes,
-      buffers,
-      buffer_sizes,
-      &fragment_num,
-      &new_fragment_uri);
+  // Get schema
+  auto array_schema = array_for_reads.array_schema();
+
+  // Check if the persisted tiles can be copied verbatim
+  std::vector<FragmentMetadata*> tile_order;
+  bool copyable = false;
+  st = check_tiles_copyable(
+      array_schema, to_consolidate, &tile_order, &copyable);
   if (!st.ok()) {
-    storage_manager_->array_close(array_uri, QueryType::READ);
-    storage_manager_->array_close(array_uri, QueryType::WRITE);
-    clean_up(subarray, buffer_num, buffers, buffer_sizes, query_r, query_w);
+    std::free(subarray);
+    array_for_reads.close();
+    array_for_writes.close();
     return st;
   }
 
-  // Check number of fragments
-  if (fragment_num <= 1) {  // Nothing to consolidate
-    storage_manager_->array_close(array_uri, QueryType::READ);
-    storage_manager_->array_close(array_uri, QueryType::WRITE);
-    clean_up(subarray, buffer_num, buffers, buffer_sizes, query_r, query_w);
-    return Status::Ok();
-  }
+  auto query_w = (Query*)nullptr;
+  URI new_fragment_uri;
+  std::shared_ptr<FragmentMetadata> new_fragment_metadata;
+  if (copyable) {
+    // Copy the tiles of the fragments to the new fragment
+    st = copy_tiles(
+        &array_for_writes, to_consolidate, tile_order, &new_fragment_metadata);
+    if (!st.ok()) {
+      storage_manager_->array_close(array_uri, QueryType::READ);
+      storage_manager_->array_close(array_uri, QueryType::WRITE);
+      std::free(subarray);
+      return st;
+    }
+    new_fragment_uri = new_fragment_metadata->fragment_uri();
+  } else {
+    // Create the write query
+    st = create_write_query(
+        &array_for_writes,
+        subarray,
+        to_consolidate,
+        &query_w,
+        &new_fragment_uri);
+    if (!st.ok()) {
+      storage_manager_->array_close(array_uri, QueryType::READ);
+      storage_manager_->array_close(array_uri, QueryType::WRITE);
+      clean_up(subarray, query_w);
+      return st;
+    }
 
-  // Read from one array and write to the other
-  st = copy_array(query_r, query_w);
-  if (!st.ok()) {
-    storage_manager_->array_close(array_uri, QueryType::READ);
-    storage_manager_->array_close(array_uri, QueryType::WRITE);
-    clean_up(subarray, buffer_num, buffers, buffer_sizes, query_r, query_w);
-    return st;
+    // Read from one array and write to the other
+    st = copy_array(&array_for_reads, to_consolidate, subarray, query_w);
+    if (!st.ok()) {
+      storage_manager_->array_close(array_uri, QueryType::READ);
+      storage_manager_->array_close(array_uri, QueryType::WRITE);
+      storage_manager_->vfs()->remove_dir(new_fragment_uri);
+      clean_up(subarray, query_w);
+      return st;
+    }
   }
 
   // Get old fragment uris
-  old_fragment_uris = query_r->fragment_uris();
+  for (auto meta : to_consolidate)
+    old_fragment_uris.push_back(meta->fragment_uri());
 
   // Close array for reading
   st = storage_manager_->array_close(array_uri, QueryType::READ);
   if (!st.ok()) {
     storage_manager_->array_close(array_uri, QueryType::WRITE);
     storage_manager_->vfs()->remove_dir(new_fragment_uri);
-    clean_up(subarray, buffer_num, buffers, buffer_sizes, query_r, query_w);
+    clean_up(subarray, query_w);
     return st;
   }
 
@@ -163,15 +196,19 @@ Status Consolidator::consolidate(
   if (!st.ok()) {
     storage_manager_->array_close(array_uri, QueryType::WRITE);
     storage_manager_->vfs()->remove_dir(new_fragment_uri);
-    clean_up(subarray, buffer_num, buffers, buffer_sizes, query_r, query_w);
+    clean_up(subarray, query_w);
     return st;
   }
 
-  // Finalize both queries
-  st = query_w->finalize();
+  // Finalize the write query, or store the metadata of the copied tiles
+  if (copyable)
+    st = storage_manager_->store_fragment_metadata(
+        new_fragment_metadata.get(), array_for_writes.get_encryption_key());
+  else
+    st = query_w->finalize();
   if (!st.ok()) {
     storage_manager_->array_close(array_uri, QueryType::WRITE);
-    clean_up(subarray, buffer_num, buffers, buffer_sizes, query_r, query_w);
+    clean_up(subarray, query_w);
     storage_manager_->array_xunlock(array_uri);
     storage_manager_->vfs()->remove_dir(new_fragment_uri);
     return st;
@@ -181,7 +218,7 @@ Status Consolidator::consolidate(
   st = storage_manager_->array_close(array_uri, QueryType::WRITE);
   if (!st.ok()) {
     storage_manager_->array_xunlock(array_uri);
-    clean_up(subarray, buffer_num, buffers, buffer_sizes, query_r, query_w);
+    clean_up(subarray, query_w);
     storage_manager_->vfs()->remove_dir(new_fragment_uri);
     return st;
   }
@@ -191,7 +228,7 @@ Status Consolidator::consolidate(
   if (!st.ok()) {
     delete_old_fragments(old_fragment_uris);
     storage_manager_->array_xunlock(array_uri);
-    clean_up(subarray, buffer_num, buffers, buffer_sizes, query_r, query_w);
+    clean_up(subarray, query_w);
     return st;
   }
 
@@ -199,7 +236,7 @@ Status Consolidator::consolidate(
   st = storage_manager_->array_xunlock(array_uri);
   if (!st.ok()) {
     delete_old_fragments(old_fragment_uris);
-    clean_up(subarray, buffer_num, buffers, buffer_sizes, query_r, query_w);
+    clean_up(subarray, query_w);
     return st;
   }
 
@@ -207,147 +244,787 @@ Status Consolidator::consolidate(
   st = delete_old_fragments(old_fragment_uris);
 
   // Clean up
-  clean_up(subarray, buffer_num, buffers, buffer_sizes, query_r, query_w);
+  clean_up(subarray, query_w);
 
   return st;
 }
 
+Status Consolidator::consolidate_fragment_metadata(
+    const char* array_name,
+    EncryptionType encryption_type,
+    const void* encryption_key,
+    uint32_t key_length) {
+  URI array_uri = URI(array_name);
+
+  // Open array for reading, which loads the metadata of all fragments
+  Array array(array_uri, storage_manager_);
+  RETURN_NOT_OK(array.open(
+      QueryType::READ, encryption_type, encryption_key, key_length));
+  if (array.is_empty())
+    return array.close();
+
+  // Store the metadata in a single file
+  auto st = storage_manager_->store_consolidated_fragment_metadata(
+      array_uri, array.fragment_metadata(), array.get_encryption_key());
+  if (!st.ok()) {
+    array.close();
+    return st;
+  }
+
+  return array.close();
+}
+
+void Consolidator::set_throttle(std::function<void()> throttle) {
+  throttle_ = std::move(throttle);
+}
+
 /* ****************************** */
 /*        PRIVATE METHODS         */
 /* ****************************** */
 
-Status Consolidator::copy_array(Query* query_r, Query* query_w) {
-  do {
-    RETURN_NOT_OK(query_r->submit());
-    RETURN_NOT_OK(query_w->submit());
-  } while (query_r->status() == QueryStatus::INCOMPLETE);
+Status Consolidator::check_tiles_copyable(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& to_consolidate,
+    std::vector<FragmentMetadata*>* tile_order,
+    bool* copyable) const {
+  *copyable = false;
+  tile_order->clear();
+  if (array_schema->dense())
+    return Status::Ok();
+
+  switch (array_schema->coords_type()) {
+    case Datatype::INT32:
+      *copyable = check_tiles_copyable<int>(
+          array_schema, to_consolidate, tile_order);
+      break;
+    case Datatype::INT64:
+      *copyable = check_tiles_copyable<int64_t>(
+          array_schema, to_consolidate, tile_order);
+      break;
+    case Datatype::FLOAT32:
+      *copyable = check_tiles_copyable<float>(
+          array_schema, to_consolidate, tile_order);
+      break;
+    case Datatype::FLOAT64:
+      *copyable = check_tiles_copyable<double>(
+          array_schema, to_consolidate, tile_order);
+      break;
+    case Datatype::INT8:
+      *copyable = check_tiles_copyable<int8_t>(
+          array_schema, to_consolidate, tile_order);
+      break;
+    case Datatype::UINT8:
+      *copyable = check_tiles_copyable<uint8_t>(
+          array_schema, to_consolidate, tile_order);
+      break;
+    case Datatype::INT16:
+      *copyable = check_tiles_copyable<int16_t>(
+          array_schema, to_consolidate, tile_order);
+      break;
+    case Datatype::UINT16:
+      *copyable = check_tiles_copyable<uint16_t>(
+          array_schema, to_consolidate, tile_order);
+      break;
+    case Datatype::UINT32:
+      *copyable = check_tiles_copyable<uint32_t>(
+          array_schema, to_consolidate, tile_order);
+      break;
+    case Datatype::UINT64:
+      *copyable = check_tiles_copyable<uint64_t>(
+          array_schema, to_consolidate, tile_order);
+      break;
+    default:
+      return LOG_STATUS(Status::ConsolidationError(
+          "Cannot check if tiles are copyable; Invalid domain type"));
+  }
 
   return Status::Ok();
 }
 
-void Consolidator::clean_up(
-    void* subarray,
-    unsigned buffer_num,
-    void** buffers,
-    uint64_t* buffer_sizes,
-    Query* query_r,
-    Query* query_w) const {
-  std::free(subarray);
-  free_buffers(buffer_num, buffers, buffer_sizes);
-  delete query_r;
-  delete query_w;
+template <class T>
+bool Consolidator::check_tiles_copyable(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& to_consolidate,
+    std::vector<FragmentMetadata*>* tile_order) const {
+  // All fragments must be sparse, non-empty and in the current format
+  for (auto meta : to_consolidate) {
+    if (meta->dense() || meta->tile_num() == 0 ||
+        meta->format_version() != constants::format_version)
+      return false;
+  }
+
+  // Sort the fragments on the global order of their first cell. The first
+  // and last cell of a fragment are the bounding coordinates of its first
+  // and last tile, respectively.
+  auto dim_num = array_schema->dim_num();
+  auto first_coords = [](const FragmentMetadata* meta) {
+    return static_cast<const T*>(meta->bounding_coords().front());
+  };
+  auto last_coords = [dim_num](const FragmentMetadata* meta) {
+    return static_cast<const T*>(meta->bounding_coords().back()) + dim_num;
+  };
+  std::vector<T> coords(2 * dim_num);
+  GlobalCmp<T> cmp(array_schema->domain(), &coords[0]);
+  *tile_order = to_consolidate;
+  std::sort(
+      tile_order->begin(),
+      tile_order->end(),
+      [&](const FragmentMetadata* a, const FragmentMetadata* b) {
+        std::memcpy(&coords[0], first_coords(a), dim_num * sizeof(T));
+        std::memcpy(&coords[dim_num], first_coords(b), dim_num * sizeof(T));
+        return cmp(0, 1);
+      });
+
+  // Every fragment must end strictly before the next one starts on the
+  // global order, so that no cell is overwritten, and all but the last
+  // fragment must end with a full tile, since only the last tile of a
+  // sparse fragment may be partially filled
+  auto capacity = array_schema->capacity();
+  for (size_t i = 0; i + 1 < tile_order->size(); ++i) {
+    auto meta = (*tile_order)[i];
+    auto next = (*tile_order)[i + 1];
+    if (meta->last_tile_cell_num() != capacity)
+      return false;
+    std::memcpy(&coords[0], last_coords(meta), dim_num * sizeof(T));
+    std::memcpy(&coords[dim_num], first_coords(next), dim_num * sizeof(T));
+    if (!cmp(0, 1))
+      return false;
+  }
+
+  return true;
 }
 
-Status Consolidator::create_buffers(
-    const ArraySchema* array_schema,
-    void*** buffers,
-    uint64_t** buffer_sizes,
-    unsigned int* buffer_num) {
+Status Consolidator::copy_array(
+    Array* array_for_reads,
+    const std::vector<FragmentMetadata*>& to_consolidate,
+    void* subarray,
+    Query* query_w) {
   // For easy reference
-  auto attribute_num = array_schema->attribute_num();
-  auto dense = array_schema->dense();
+  auto array_schema = array_for_reads->array_schema();
+  auto memory_budget = storage_manager_->memory_budget();
+  auto num_threads = std::max<uint64_t>(
+      storage_manager_->config().sm_params().consolidation_num_threads_, 1);
 
-  // Calculate number of buffers
-  *buffer_num = 0;
-  for (unsigned int i = 0; i < attribute_num; ++i)
-    *buffer_num += (array_schema->attributes()[i]->var_size()) ? 2 : 1;
-  *buffer_num += (dense) ? 0 : 1;
+  // Split the consolidated region into partitions
+  std::vector<std::vector<uint8_t>> subarrays;
+  RETURN_NOT_OK(compute_partitions(
+      array_schema, to_consolidate, subarray, num_threads, &subarrays));
+  uint64_t partition_num = subarrays.size();
 
-  // Create buffers
-  *buffers = (void**)std::malloc(*buffer_num * sizeof(void*));
-  if (*buffers == nullptr) {
-    return LOG_STATUS(Status::ConsolidationError(
-        "Cannot create consolidation buffers; Memory allocation failed"));
+  // Calculate number of buffers per buffer set
+  unsigned buffer_num = 0;
+  for (const auto& attr : array_schema->attributes())
+    buffer_num += (attr->var_size()) ? 2 : 1;
+  buffer_num += (array_schema->dense()) ? 0 : 1;
+
+  // Shrink the buffers so that the two buffer sets of every partition fit
+  // in half of the memory budget, and account for them in the budget. If
+  // the rest of the budget is in use, the buffers are halved down to their
+  // minimum size, at which point the reservation waits for the running
+  // queries to release memory.
+  uint64_t buffer_size = constants::consolidation_buffer_size;
+  if (memory_budget->budget() != 0) {
+    auto max_buffer_size =
+        memory_budget->budget() / 2 / (2 * partition_num * buffer_num);
+    buffer_size = std::max(
+        std::min(buffer_size, max_buffer_size),
+        constants::consolidation_min_buffer_size);
   }
-  *buffer_sizes = new uint64_t[*buffer_num];
-  if (*buffer_sizes == nullptr) {
-    return LOG_STATUS(Status::ConsolidationError(
-        "Cannot create consolidation buffer sizes; Memory allocation failed"));
+  uint64_t total_size = 2 * partition_num * buffer_num * buffer_size;
+  while (!memory_budget->try_reserve(total_size)) {
+    if (buffer_size == constants::consolidation_min_buffer_size) {
+      memory_budget->reserve(total_size);
+      break;
+    }
+    buffer_size = std::max(
+        buffer_size / 2, constants::consolidation_min_buffer_size);
+    total_size = 2 * partition_num * buffer_num * buffer_size;
   }
 
-  // Allocate space for each buffer
-  bool error = false;
-  for (unsigned int i = 0; i < *buffer_num; ++i) {
-    (*buffers)[i] = std::malloc(constants::consolidation_buffer_size);
-    if ((*buffers)[i] == nullptr)  // The loop should continue to
-      error = true;                // allocate nullptr to each buffer
-    (*buffer_sizes)[i] = constants::consolidation_buffer_size;
+  // Create the partitions
+  std::vector<std::unique_ptr<Partition>> partitions;
+  Status st = Status::Ok();
+  for (const auto& partition_subarray : subarrays) {
+    std::unique_ptr<Partition> partition(new Partition());
+    st = create_partition(
+        array_for_reads,
+        to_consolidate,
+        partition_subarray,
+        buffer_num,
+        buffer_size,
+        partition.get());
+    if (!st.ok())
+      break;
+    partitions.push_back(std::move(partition));
   }
 
-  // Clean up upon error
-  if (error) {
-    free_buffers(*buffer_num, *buffers, *buffer_sizes);
-    *buffers = nullptr;
-    *buffer_sizes = nullptr;
-    return LOG_STATUS(Status::ConsolidationError(
-        "Cannot create consolidation buffers; Memory allocation failed"));
+  // Read the partitions concurrently and write them in order. A local
+  // thread pool is used, as the read queries use the reader thread pool.
+  if (st.ok()) {
+    ThreadPool thread_pool;
+    st = thread_pool.init(std::min(num_threads, partition_num));
+    if (st.ok()) {
+      std::vector<std::future<Status>> tasks;
+      for (const auto& partition : partitions) {
+        auto p = partition.get();
+        tasks.push_back(
+            thread_pool.enqueue([this, p]() { return read_partition(p); }));
+      }
+
+      st = write_partitions(query_w, partitions);
+
+      // Stop the readers upon error
+      if (!st.ok()) {
+        for (const auto& partition : partitions) {
+          {
+            std::lock_guard<std::mutex> lck(partition->mtx_);
+            partition->cancelled_ = true;
+          }
+          partition->cv_.notify_all();
+        }
+      }
+      thread_pool.wait_all(tasks);
+    }
+  }
+
+  // Free the buffers before releasing them from the budget
+  partitions.clear();
+  memory_budget->release(total_size);
+
+  return st;
+}
+
+Status Consolidator::copy_file(
+    const URI& uri, uint64_t nbytes, const URI& new_uri) const {
+  Buffer buffer;
+  for (uint64_t offset = 0; offset < nbytes;) {
+    auto chunk =
+        std::min(nbytes - offset, constants::consolidation_buffer_size);
+    RETURN_NOT_OK(storage_manager_->read(uri, offset, &buffer, chunk));
+    if (throttle_ != nullptr)
+      throttle_();
+    RETURN_NOT_OK(storage_manager_->write(new_uri, &buffer));
+    offset += chunk;
   }
 
-  // Success
   return Status::Ok();
 }
 
-Status Consolidator::create_queries(
-    Query** query_r,
-    Query** query_w,
-    void* subarray,
-    Array* array_for_reads,
+Status Consolidator::copy_bloom_filter_keys(
     Array* array_for_writes,
-    void** buffers,
-    uint64_t* buffer_sizes,
-    unsigned int* fragment_num,
-    URI* new_fragment_uri) {
-  // Create read query
-  *query_r = new Query(storage_manager_, array_for_reads);
-  if (!(*query_r)->array_schema()->is_kv())
-    RETURN_NOT_OK((*query_r)->set_layout(Layout::GLOBAL_ORDER));
-  RETURN_NOT_OK(set_query_buffers(*query_r, buffers, buffer_sizes));
-
-  // Get fragment num and terminate with success if it is <=1
-  *fragment_num = (*query_r)->fragment_num();
-  if (*fragment_num <= 1)
-    return Status::Ok();
+    const FragmentMetadata* meta,
+    FragmentMetadata* new_meta) const {
+  // For easy reference
+  auto array_schema = array_for_writes->array_schema();
+  auto coords_size = array_schema->coords_size();
+  auto coords_uri = meta->attr_uri(constants::coords);
 
-  // Get last fragment URI, which will be the URI of the consolidated fragment
-  *new_fragment_uri = (*query_r)->last_fragment_uri();
-  RETURN_NOT_OK(rename_new_fragment_uri(new_fragment_uri));
+  // Get a copy of the coordinates filter pipeline
+  FilterPipeline filters = *array_schema->coords_filters();
+  RETURN_NOT_OK(FilterPipeline::append_encryption_filter(
+      &filters, array_for_writes->get_encryption_key()));
 
-  // Create write query
-  *query_w = new Query(storage_manager_, array_for_writes, *new_fragment_uri);
-  if (!(*query_w)->array_schema()->is_kv())
-    RETURN_NOT_OK((*query_w)->set_layout(Layout::GLOBAL_ORDER));
-  RETURN_NOT_OK((*query_w)->set_subarray(subarray));
-  RETURN_NOT_OK(set_query_buffers(*query_w, buffers, buffer_sizes));
+  auto tile_num = meta->tile_num();
+  for (uint64_t t = 0; t < tile_num; ++t) {
+    Tile tile;
+    RETURN_NOT_OK(tile.init(
+        array_schema->coords_type(),
+        meta->tile_size(constants::coords, t),
+        coords_size,
+        array_schema->dim_num()));
+    RETURN_NOT_OK(storage_manager_->read(
+        coords_uri,
+        meta->file_offset(constants::coords, t),
+        tile.buffer(),
+        meta->persisted_tile_size(constants::coords, t)));
+    RETURN_NOT_OK(filters.run_reverse(&tile));
+    new_meta->add_bloom_filter_keys(
+        (const uint64_t*)tile.data(), tile.size() / coords_size);
+  }
+
+  return Status::Ok();
+}
+
+Status Consolidator::copy_tiles(
+    Array* array_for_writes,
+    const std::vector<FragmentMetadata*>& to_consolidate,
+    const std::vector<FragmentMetadata*>& tile_order,
+    std::shared_ptr<FragmentMetadata>* new_fragment_metadata) {
+  // For easy reference
+  auto array_schema = array_for_writes->array_schema();
+  std::vector<std::string> attributes;
+  for (const auto& attr : array_schema->attributes())
+    attributes.emplace_back(attr->name());
+  attributes.emplace_back(constants::coords);
+
+  // The new fragment takes the place of the last fragment in timestamp order
+  auto last_meta = to_consolidate.back();
+  auto new_fragment_uri = last_meta->fragment_uri();
+  RETURN_NOT_OK(rename_new_fragment_uri(&new_fragment_uri));
+  auto new_meta = std::make_shared<FragmentMetadata>(
+      array_schema, false, new_fragment_uri, last_meta->timestamp());
+  RETURN_NOT_OK(new_meta->init(array_schema->domain()->domain()));
+
+  // Concatenate the tile metadata in the global order of the fragments,
+  // shifting the tile offsets by the sizes of the preceding files
+  uint64_t tile_num = 0;
+  for (auto meta : tile_order)
+    tile_num += meta->tile_num();
+  RETURN_NOT_OK(new_meta->set_num_tiles(tile_num));
+  uint64_t tile = 0;
+  for (auto meta : tile_order) {
+    auto meta_tile_num = meta->tile_num();
+    for (uint64_t t = 0; t < meta_tile_num; ++t, ++tile) {
+      RETURN_NOT_OK(new_meta->set_mbr(tile, meta->mbrs()[t]));
+      new_meta->set_bounding_coords(tile, meta->bounding_coords()[t]);
+      for (const auto& attr : attributes) {
+        new_meta->set_tile_offset(
+            attr, tile, meta->persisted_tile_size(attr, t));
+        if (array_schema->var_size(attr)) {
+          new_meta->set_tile_var_offset(
+              attr, tile, meta->persisted_tile_var_size(attr, t));
+          new_meta->set_tile_var_size(
+              attr, tile, meta->tile_var_size(attr, t));
+        }
+      }
+    }
+  }
+  new_meta->set_last_tile_cell_num(tile_order.back()->last_tile_cell_num());
+
+  // Rebuild the Bloom filter of a key-value store from the copied keys
+  if (array_schema->is_kv()) {
+    for (auto meta : tile_order)
+      RETURN_NOT_OK(
+          copy_bloom_filter_keys(array_for_writes, meta, new_meta.get()));
+  }
+
+  // Concatenate the attribute files
+  RETURN_NOT_OK(storage_manager_->create_dir(new_fragment_uri));
+  auto st = Status::Ok();
+  for (const auto& attr : attributes) {
+    for (auto meta : tile_order) {
+      st = copy_file(
+          meta->attr_uri(attr),
+          meta->file_sizes(attr),
+          new_meta->attr_uri(attr));
+      if (st.ok() && array_schema->var_size(attr))
+        st = copy_file(
+            meta->attr_var_uri(attr),
+            meta->file_var_sizes(attr),
+            new_meta->attr_var_uri(attr));
+      if (!st.ok())
+        break;
+    }
+    if (st.ok())
+      st = storage_manager_->close_file(new_meta->attr_uri(attr));
+    if (st.ok() && array_schema->var_size(attr))
+      st = storage_manager_->close_file(new_meta->attr_var_uri(attr));
+    if (!st.ok())
+      break;
+  }
+  if (!st.ok()) {
+    storage_manager_->vfs()->remove_dir(new_fragment_uri);
+    return st;
+  }
+
+  *new_fragment_metadata = new_meta;
 
   return Status::Ok();
 }
 
-Status Consolidator::create_subarray(Array* array, void** subarray) const {
+void Consolidator::clean_up(void* subarray, Query* query_w) const {
+  std::free(subarray);
+  delete query_w;
+}
+
+Status Consolidator::compute_next_to_consolidate(
+    Array* array,
+    std::vector<FragmentMetadata*>* to_consolidate,
+    void** subarray) const {
   auto array_schema = array->array_schema();
   assert(array_schema != nullptr);
+  const auto& fragments = array->fragment_metadata();
 
   // Create subarray only for the dense case
   if (array_schema->dense()) {
     *subarray = std::malloc(2 * array_schema->coords_size());
     if (*subarray == nullptr)
       return LOG_STATUS(Status::ConsolidationError(
-          "Cannot create subarray; Failed to allocate memory"));
+          "Cannot compute fragments to consolidate; Failed to allocate "
+          "memory for the subarray"));
+  }
+
+  switch (array_schema->coords_type()) {
+    case Datatype::INT32:
+      compute_next_to_consolidate<int>(
+          array_schema, fragments, to_consolidate, (int*)*subarray);
+      break;
+    case Datatype::INT64:
+      compute_next_to_consolidate<int64_t>(
+          array_schema, fragments, to_consolidate, (int64_t*)*subarray);
+      break;
+    case Datatype::FLOAT32:
+      compute_next_to_consolidate<float>(
+          array_schema, fragments, to_consolidate, (float*)*subarray);
+      break;
+    case Datatype::FLOAT64:
+      compute_next_to_consolidate<double>(
+          array_schema, fragments, to_consolidate, (double*)*subarray);
+      break;
+    case Datatype::INT8:
+      compute_next_to_consolidate<int8_t>(
+          array_schema, fragments, to_consolidate, (int8_t*)*subarray);
+      break;
+    case Datatype::UINT8:
+      compute_next_to_consolidate<uint8_t>(
+          array_schema, fragments, to_consolidate, (uint8_t*)*subarray);
+      break;
+    case Datatype::INT16:
+      compute_next_to_consolidate<int16_t>(
+          array_schema, fragments, to_consolidate, (int16_t*)*subarray);
+      break;
+    case Datatype::UINT16:
+      compute_next_to_consolidate<uint16_t>(
+          array_schema, fragments, to_consolidate, (uint16_t*)*subarray);
+      break;
+    case Datatype::UINT32:
+      compute_next_to_consolidate<uint32_t>(
+          array_schema, fragments, to_consolidate, (uint32_t*)*subarray);
+      break;
+    case Datatype::UINT64:
+      compute_next_to_consolidate<uint64_t>(
+          array_schema, fragments, to_consolidate, (uint64_t*)*subarray);
+      break;
+    default:
+      return LOG_STATUS(Status::ConsolidationError(
+          "Cannot compute fragments to consolidate; Invalid domain type"));
+  }
+
+  return Status::Ok();
+}
+
+template <class T>
+void Consolidator::compute_next_to_consolidate(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& fragments,
+    std::vector<FragmentMetadata*>* to_consolidate,
+    T* subarray) const {
+  // For easy reference
+  auto sm_params = storage_manager_->config().sm_params();
+  auto min_frags =
+      std::max<uint64_t>(sm_params.consolidation_step_min_frags_, 2);
+  auto max_frags = sm_params.consolidation_step_max_frags_;
+  auto size_ratio = sm_params.consolidation_step_size_ratio_;
+  auto max_bytes = sm_params.consolidation_step_max_bytes_;
+  auto dense = array_schema->dense();
+  auto domain = array_schema->domain();
+  auto dim_num = array_schema->dim_num();
+  auto fragment_num = (uint64_t)fragments.size();
+
+  std::vector<uint64_t> sizes(fragment_num);
+  for (uint64_t i = 0; i < fragment_num; ++i)
+    sizes[i] = fragments[i]->fragment_size();
 
-    bool is_empty;
-    RETURN_NOT_OK_ELSE(
-        storage_manager_->array_get_non_empty_domain(
-            array, *subarray, &is_empty),
-        std::free(subarray));
-    if (is_empty)
-      return LOG_STATUS(
-          Status::ConsolidationError("Cannot create subarray; empty array."));
+  // Find the best run [start, start + num) of adjacent fragments. For
+  // dense arrays, `older_mbr` is the bounding box of the fragments before
+  // `start`, which lets most runs skip checking them one by one.
+  uint64_t best_start = 0, best_num = 0, best_bytes = 0;
+  std::vector<T> run_domain(2 * dim_num), run_expanded(2 * dim_num);
+  std::vector<T> next_domain(2 * dim_num), next_expanded(2 * dim_num);
+  std::vector<T> best_domain(2 * dim_num), older_mbr(2 * dim_num);
+  for (uint64_t start = 0; start + best_num <= fragment_num; ++start) {
+    if (dense && start > 0) {
+      auto non_empty_domain =
+          static_cast<const T*>(fragments[start - 1]->non_empty_domain());
+      for (unsigned d = 0; d < dim_num; ++d) {
+        auto low = non_empty_domain[2 * d];
+        auto high = non_empty_domain[2 * d + 1];
+        older_mbr[2 * d] = (start == 1) ? low : std::min(low, older_mbr[2 * d]);
+        older_mbr[2 * d + 1] =
+            (start == 1) ? high : std::max(high, older_mbr[2 * d + 1]);
+      }
+    }
+
+    uint64_t num = 0, bytes = 0;
+    for (uint64_t i = start; i < fragment_num && num < max_frags; ++i) {
+      // Check the size constraints
+      if (max_bytes != 0 && bytes + sizes[i] > max_bytes)
+        break;
+      if (i > start) {
+        auto min_size = std::min(sizes[i - 1], sizes[i]);
+        auto max_size = std::max(sizes[i - 1], sizes[i]);
+        if ((double)min_size < (double)size_ratio * max_size)
+          break;
+      }
+
+      // A dense run must not cover cells of older fragments, which the
+      // new fragment would otherwise overwrite with fill values
+      if (dense) {
+        auto non_empty_domain =
+            static_cast<const T*>(fragments[i]->non_empty_domain());
+        for (unsigned d = 0; d < dim_num; ++d) {
+          auto low = non_empty_domain[2 * d];
+          auto high = non_empty_domain[2 * d + 1];
+          if (i > start) {
+            low = std::min(low, run_domain[2 * d]);
+            high = std::max(high, run_domain[2 * d + 1]);
+          }
+          next_domain[2 * d] = low;
+          next_domain[2 * d + 1] = high;
+        }
+        next_expanded = next_domain;
+        domain->expand_domain(static_cast<void*>(&next_expanded[0]));
+
+        // Only a grown run that reaches into the bounding box of the older
+        // fragments needs checking against each of them
+        bool grown = i == start || next_expanded != run_expanded;
+        bool overlaps_older = false;
+        if (grown && start > 0 &&
+            utils::geometry::overlap(&older_mbr[0], &next_expanded[0], dim_num))
+          for (uint64_t j = 0; j < start && !overlaps_older; ++j)
+            overlaps_older = utils::geometry::overlap(
+                static_cast<const T*>(fragments[j]->non_empty_domain()),
+                &next_expanded[0],
+                dim_num);
+        if (overlaps_older)
+          break;
+        run_domain.swap(next_domain);
+        run_expanded.swap(next_expanded);
+      }
 
-    array_schema->domain()->expand_domain(*subarray);
+      ++num;
+      bytes += sizes[i];
+    }
+
+    if (num >= min_frags &&
+        (num > best_num || (num == best_num && bytes < best_bytes))) {
+      best_start = start;
+      best_num = num;
+      best_bytes = bytes;
+      if (dense)
+        best_domain = run_expanded;
+    }
+  }
+
+  to_consolidate->clear();
+  if (best_num == 0)
+    return;
+
+  to_consolidate->insert(
+      to_consolidate->end(),
+      fragments.begin() + best_start,
+      fragments.begin() + best_start + best_num);
+  if (dense)
+    std::memcpy(subarray, &best_domain[0], 2 * dim_num * sizeof(T));
+}
+
+Status Consolidator::compute_partitions(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& to_consolidate,
+    const void* subarray,
+    uint64_t max_partition_num,
+    std::vector<std::vector<uint8_t>>* partitions) const {
+  partitions->clear();
+
+  // Key-value stores are read in their entire domain
+  if (array_schema->is_kv()) {
+    partitions->emplace_back();
+    return Status::Ok();
+  }
+
+  auto coords_type = array_schema->coords_type();
+  switch (coords_type) {
+    case Datatype::INT8:
+      compute_partitions<int8_t>(
+          array_schema,
+          to_consolidate,
+          static_cast<const int8_t*>(subarray),
+          max_partition_num,
+          partitions);
+      break;
+    case Datatype::UINT8:
+      compute_partitions<uint8_t>(
+          array_schema,
+          to_consolidate,
+          static_cast<const uint8_t*>(subarray),
+          max_partition_num,
+          partitions);
+      break;
+    case Datatype::INT16:
+      compute_partitions<int16_t>(
+          array_schema,
+          to_consolidate,
+          static_cast<const int16_t*>(subarray),
+          max_partition_num,
+          partitions);
+      break;
+    case Datatype::UINT16:
+      compute_partitions<uint16_t>(
+          array_schema,
+          to_consolidate,
+          static_cast<const uint16_t*>(subarray),
+          max_partition_num,
+          partitions);
+      break;
+    case Datatype::INT32:
+      compute_partitions<int>(
+          array_schema,
+          to_consolidate,
+          static_cast<const int*>(subarray),
+          max_partition_num,
+          partitions);
+      break;
+    case Datatype::UINT32:
+      compute_partitions<unsigned>(
+          array_schema,
+          to_consolidate,
+          static_cast<const unsigned*>(subarray),
+          max_partition_num,
+          partitions);
+      break;
+    case Datatype::INT64:
+      compute_partitions<int64_t>(
+          array_schema,
+          to_consolidate,
+          static_cast<const int64_t*>(subarray),
+          max_partition_num,
+          partitions);
+      break;
+    case Datatype::UINT64:
+      compute_partitions<uint64_t>(
+          array_schema,
+          to_consolidate,
+          static_cast<const uint64_t*>(subarray),
+          max_partition_num,
+          partitions);
+      break;
+    case Datatype::FLOAT32:
+    case Datatype::FLOAT64:
+      // Real domains have no tile grid to split at; only sparse arrays
+      // have real domains, so the entire domain is read
+      partitions->emplace_back();
+      break;
+    default:
+      return LOG_STATUS(Status::ConsolidationError(
+          "Cannot partition subarray; Unsupported domain type"));
   }
 
   return Status::Ok();
 }
 
+template <class T>
+void Consolidator::compute_partitions(
+    const ArraySchema* array_schema,
+    const std::vector<FragmentMetadata*>& to_consolidate,
+    const T* subarray,
+    uint64_t max_partition_num,
+    std::vector<std::vector<uint8_t>>* partitions) const {
+  // For easy reference
+  auto domain = array_schema->domain();
+  auto dim_num = domain->dim_num();
+  auto dom = static_cast<const T*>(domain->domain());
+  auto tile_extents = static_cast<const T*>(domain->tile_extents());
+  auto subarray_size = 2 * dim_num * sizeof(T);
+
+  // Compute the region to be partitioned
+  std::vector<T> region(2 * dim_num);
+  if (subarray != nullptr) {
+    std::memcpy(&region[0], subarray, subarray_size);
+  } else {
+    for (size_t i = 0; i < to_consolidate.size(); ++i) {
+      auto non_empty_domain =
+          static_cast<const T*>(to_consolidate[i]->non_empty_domain());
+      for (unsigned d = 0; d < 2 * dim_num; d += 2) {
+        region[d] = (i == 0) ? non_empty_domain[d] :
+                               std::min(region[d], non_empty_domain[d]);
+        region[d + 1] = (i == 0) ?
+                            non_empty_domain[d + 1] :
+                            std::max(region[d + 1], non_empty_domain[d + 1]);
+      }
+    }
+  }
+
+  // Find the dimension that is slowest in the global order, along with the
+  // range of slabs of space tiles that the region spans on it. Differences
+  // are computed in uint64_t, which is exact for all integer domains.
+  auto order = (tile_extents != nullptr) ? domain->tile_order() :
+                                           domain->cell_order();
+  unsigned d = (order == Layout::ROW_MAJOR) ? 0 : dim_num - 1;
+  uint64_t extent =
+      (tile_extents != nullptr) ? (uint64_t)tile_extents[d] : (uint64_t)1;
+  auto low = (uint64_t)region[2 * d] - (uint64_t)dom[2 * d];
+  auto high = (uint64_t)region[2 * d + 1] - (uint64_t)dom[2 * d];
+  auto first_slab = low / extent;
+  auto last_slab = high / extent;
+  auto partition_num = std::min(max_partition_num, last_slab - first_slab + 1);
+  auto slabs_per_partition =
+      utils::math::ceil(last_slab - first_slab + 1, partition_num);
+
+  // Create a partition for every group of slabs
+  for (auto slab = first_slab; slab <= last_slab;) {
+    auto end_slab = std::min(last_slab, slab + slabs_per_partition - 1);
+    auto start = std::max(low, slab * extent);
+    auto end = (end_slab == last_slab) ? high : end_slab * extent + extent - 1;
+
+    std::vector<uint8_t> partition(subarray_size);
+    auto partition_subarray = reinterpret_cast<T*>(&partition[0]);
+    std::memcpy(partition_subarray, &region[0], subarray_size);
+    partition_subarray[2 * d] = (T)((uint64_t)dom[2 * d] + start);
+    partition_subarray[2 * d + 1] = (T)((uint64_t)dom[2 * d] + end);
+    partitions->push_back(std::move(partition));
+
+    if (end_slab == last_slab)
+      break;
+    slab = end_slab + 1;
+  }
+}
+
+Status Consolidator::create_partition(
+    Array* array_for_reads,
+    const std::vector<FragmentMetadata*>& to_consolidate,
+    const std::vector<uint8_t>& subarray,
+    unsigned buffer_num,
+    uint64_t buffer_size,
+    Partition* partition) {
+  // Create read query
+  partition->query_.reset(new Query(storage_manager_, array_for_reads));
+  auto query = partition->query_.get();
+  query->set_internal(true);
+  RETURN_NOT_OK(query->set_fragment_metadata(to_consolidate));
+  if (!query->array_schema()->is_kv())
+    RETURN_NOT_OK(query->set_layout(Layout::GLOBAL_ORDER));
+  if (!subarray.empty())
+    RETURN_NOT_OK(query->set_subarray(&subarray[0]));
+
+  // Create the buffer sets
+  for (auto& buffer_set : partition->buffer_sets_) {
+    RETURN_NOT_OK(buffer_set.alloc(buffer_num, buffer_size));
+    partition->free_sets_.push_back(&buffer_set);
+  }
+
+  return Status::Ok();
+}
+
+Status Consolidator::create_write_query(
+    Array* array_for_writes,
+    void* subarray,
+    const std::vector<FragmentMetadata*>& to_consolidate,
+    Query** query_w,
+    URI* new_fragment_uri) {
+  // Get last fragment URI, which will be the URI of the consolidated fragment
+  *new_fragment_uri = to_consolidate.back()->fragment_uri();
+  RETURN_NOT_OK(rename_new_fragment_uri(new_fragment_uri));
+
+  // Create write query
+  *query_w = new Query(storage_manager_, array_for_writes, *new_fragment_uri);
+  (*query_w)->set_internal(true);
+  if (!(*query_w)->array_schema()->is_kv())
+    RETURN_NOT_OK((*query_w)->set_layout(Layout::GLOBAL_ORDER));
+  RETURN_NOT_OK((*query_w)->set_subarray(subarray));
+
+  return Status::Ok();
+}
+
 Status Consolidator::delete_old_fragment_metadata(
     const std::vector<URI>& uris) {
   for (auto& uri : uris) {
@@ -355,6 +1032,11 @@ Status Consolidator::delete_old_fragment_metadata(
     RETURN_NOT_OK(storage_manager_->vfs()->remove_file(meta_uri));
   }
 
+  // Record the removal in the fragment manifest
+  if (!uris.empty())
+    RETURN_NOT_OK(storage_manager_->store_fragment_manifest(
+        uris.front().parent(), {}, uris));
+
   return Status::Ok();
 }
 
@@ -365,13 +1047,50 @@ Status Consolidator::delete_old_fragments(const std::vector<URI>& uris) {
   return Status::Ok();
 }
 
-void Consolidator::free_buffers(
-    unsigned int buffer_num, void** buffers, uint64_t* buffer_sizes) const {
-  for (unsigned int i = 0; i < buffer_num; ++i) {
-    std::free(buffers[i]);
+Status Consolidator::read_partition(Partition* partition) const {
+  auto query = partition->query_.get();
+  auto st = Status::Ok();
+  bool done = false;
+  while (!done) {
+    // Wait for a free buffer set
+    BufferSet* buffer_set;
+    {
+      std::unique_lock<std::mutex> lck(partition->mtx_);
+      partition->cv_.wait(lck, [partition]() {
+        return !partition->free_sets_.empty() || partition->cancelled_;
+      });
+      if (partition->cancelled_)
+        return Status::Ok();
+      buffer_set = partition->free_sets_.back();
+      partition->free_sets_.pop_back();
+    }
+
+    // Read the next chunk of cells
+    buffer_set->reset_sizes();
+    st = set_query_buffers(query, buffer_set);
+    if (st.ok())
+      st = query->submit();
+    bool empty = buffer_set->buffer_sizes_[0] == 0;
+    if (st.ok() && empty && query->status() == QueryStatus::INCOMPLETE)
+      st = LOG_STATUS(Status::ConsolidationError(
+          "Cannot read partition; Consolidation buffers too small to hold "
+          "a single cell"));
+    done = !st.ok() || query->status() != QueryStatus::INCOMPLETE;
+
+    // Hand the cells over to the writer
+    {
+      std::lock_guard<std::mutex> lck(partition->mtx_);
+      if (st.ok() && !empty)
+        partition->full_sets_.push_back(buffer_set);
+      else
+        partition->free_sets_.push_back(buffer_set);
+      partition->done_ = done;
+      partition->st_ = st;
+    }
+    partition->cv_.notify_all();
   }
-  std::free(buffers);
-  delete[] buffer_sizes;
+
+  return st;
 }
 
 Status Consolidator::rename_new_fragment_uri(URI* uri) const {
@@ -395,9 +1114,11 @@ Status Consolidator::rename_new_fragment_uri(URI* uri) const {
 }
 
 Status Consolidator::set_query_buffers(
-    Query* query, void** buffers, uint64_t* buffer_sizes) const {
+    Query* query, BufferSet* buffer_set) const {
   auto dense = query->array_schema()->dense();
   auto attributes = query->array_schema()->attributes();
+  auto buffers = &buffer_set->buffers_[0];
+  auto buffer_sizes = &buffer_set->buffer_sizes_[0];
   unsigned bid = 0;
   for (const auto& attr : attributes) {
     if (!attr->var_size()) {
@@ -421,5 +1142,66 @@ Status Consolidator::set_query_buffers(
   return Status::Ok();
 }
 
+Status Consolidator::write_partitions(
+    Query* query_w,
+    const std::vector<std::unique_ptr<Partition>>& partitions) const {
+  for (const auto& partition : partitions) {
+    while (true) {
+      // Wait for the next filled buffer set
+      BufferSet* buffer_set;
+      {
+        std::unique_lock<std::mutex> lck(partition->mtx_);
+        partition->cv_.wait(lck, [&partition]() {
+          return !partition->full_sets_.empty() || partition->done_;
+        });
+        if (partition->full_sets_.empty()) {
+          RETURN_NOT_OK(partition->st_);
+          break;
+        }
+        buffer_set = partition->full_sets_.front();
+        partition->full_sets_.pop_front();
+      }
+
+      // Write the cells and give the buffer set back to the reader
+      if (throttle_ != nullptr)
+        throttle_();
+      auto st = set_query_buffers(query_w, buffer_set);
+      if (st.ok())
+        st = query_w->submit();
+      {
+        std::lock_guard<std::mutex> lck(partition->mtx_);
+        partition->free_sets_.push_back(buffer_set);
+      }
+      partition->cv_.notify_all();
+      RETURN_NOT_OK(st);
+    }
+  }
+
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*          BUFFER SETS           */
+/* ****************************** */
+
+Status Consolidator::BufferSet::alloc(
+    unsigned buffer_num, uint64_t buffer_size) {
+  capacity_ = buffer_size;
+  buffer_sizes_.resize(buffer_num, buffer_size);
+  for (unsigned i = 0; i < buffer_num; ++i) {
+    auto buffer = std::malloc(buffer_size);
+    if (buffer == nullptr)
+      return LOG_STATUS(Status::ConsolidationError(
+          "Cannot create consolidation buffers; Memory allocation failed"));
+    buffers_.push_back(buffer);
+  }
+
+  return Status::Ok();
+}
+
+void Consolidator::BufferSet::reset_sizes() {
+  std::fill(buffer_sizes_.begin(), buffer_sizes_.end(), capacity_);
+}
+
 }  // namespace sm
 }  // namespace tiledb
@@ -37,12 +37,18 @@
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/storage_manager/open_array.h"
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace tiledb {
 namespace sm {
 
 class ArraySchema;
+class FragmentMetadata;
 class Query;
 class StorageManager;
 class URI;
@@ -69,7 +75,12 @@ class Consolidator {
   /* ********************************* */
 
   /**
-   * Consolidates the fragments of the input array.
+   * Performs one consolidation step on the input array. The step merges a
+   * run of fragments adjacent in timestamp order, selected according to the
+   * `sm.consolidation.step_*` configuration parameters, into a single new
+   * fragment and deletes the merged fragments. The rest of the fragments
+   * are left untouched. With the default configuration the step merges all
+   * the array fragments.
    *
    * @param array_name URI of array to consolidate.
    * @param encryption_type The encryption type of the array
@@ -84,7 +95,93 @@ class Consolidator {
       const void* encryption_key,
       uint32_t key_length);
 
+  /**
+   * Consolidates the metadata of all the current fragments of the input
+   * array into the consolidated fragment metadata file of the array.
+   *
+   * @param array_name URI of array whose metadata will be consolidated.
+   * @param encryption_type The encryption type of the array
+   * @param encryption_key If the array is encrypted, the private encryption
+   *    key. For unencrypted arrays, pass `nullptr`.
+   * @param key_length The length in bytes of the encryption key.
+   * @return Status
+   */
+  Status consolidate_fragment_metadata(
+      const char* array_name,
+      EncryptionType encryption_type,
+      const void* encryption_key,
+      uint32_t key_length);
+
+  /**
+   * Sets a function that is called before every write of the new fragment.
+   * It may block to throttle the consolidation I/O.
+   *
+   * @param throttle The throttling function.
+   */
+  void set_throttle(std::function<void()> throttle);
+
  private:
+  /* ********************************* */
+  /*           PRIVATE TYPES           */
+  /* ********************************* */
+
+  /**
+   * The buffers holding one chunk of consolidated cells. There is one buffer
+   * per fixed-sized attribute, two per var-sized attribute and, for sparse
+   * arrays, one for the coordinates, in the order expected by
+   * `set_query_buffers`.
+   */
+  struct BufferSet {
+    /** The buffers. */
+    std::vector<void*> buffers_;
+    /** The sizes of the buffer contents. */
+    std::vector<uint64_t> buffer_sizes_;
+    /** The allocated size of every buffer. */
+    uint64_t capacity_;
+
+    /** Constructor. */
+    BufferSet();
+    /** Destructor. Frees the buffers. */
+    ~BufferSet();
+
+    BufferSet(const BufferSet&) = delete;
+    BufferSet& operator=(const BufferSet&) = delete;
+
+    /** Allocates `buffer_num` buffers of `buffer_size` bytes each. */
+    Status alloc(unsigned buffer_num, uint64_t buffer_size);
+    /** Resets the buffer sizes to the allocated size. */
+    void reset_sizes();
+  };
+
+  /**
+   * A slab of space tiles of the consolidated region, read by its own query.
+   * The query alternates between two buffer sets, filling one while the
+   * cells of the other are being written to the new fragment.
+   */
+  struct Partition {
+    /** The read query of the partition. */
+    std::unique_ptr<Query> query_;
+    /** The two buffer sets of the partition. */
+    BufferSet buffer_sets_[2];
+    /** The buffer sets that can be filled by the read query. */
+    std::vector<BufferSet*> free_sets_;
+    /** The filled buffer sets, in read order. */
+    std::deque<BufferSet*> full_sets_;
+    /** `true` once the read query has completed or failed. */
+    bool done_;
+    /** `true` if the consolidation was aborted. */
+    bool cancelled_;
+    /** The status of the read query. */
+    Status st_;
+    /** Protects the state of the partition. */
+    std::mutex mtx_;
+    /** Notified whenever a buffer set changes hands. */
+    std::condition_variable cv_;
+
+    /** Constructor. */
+    Partition();
+  };
+
   /* ********************************* */
   /*        PRIVATE ATTRIBUTES         */
   /* ********************************* */
@@ -92,81 +189,244 @@ class Consolidator {
   /** The storage manager. */
   StorageManager* storage_manager_;
 
+  /** Called before every write of the new fragment, if set. */
+  std::function<void()> throttle_;
+
   /* ********************************* */
   /*          PRIVATE METHODS           */
   /* ********************************* */
 
   /**
-   * Copies the array by reading from the fragments to be consolidated
-   * (with `query_r`) and writing to the new fragment (with `query_w`).
+   * Checks whether the persisted tiles of the fragments to be consolidated
+   * can be copied verbatim into the new fragment, without unfiltering and
+   * refiltering them. This is the case for sparse fragments whose cells
+   * occupy disjoint, consecutive ranges of the global cell order and
+   * whose tiles, apart from the last tile of the last fragment, are full.
+   *
+   * @param array_schema The array schema.
+   * @param to_consolidate The fragments to be consolidated.
+   * @param tile_order The fragments in the global order of their cells,
+   *     i.e., the order in which their tiles must be copied.
+   * @param copyable Set to `true` if the tiles can be copied.
+   * @return Status
+   */
+  Status check_tiles_copyable(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& to_consolidate,
+      std::vector<FragmentMetadata*>* tile_order,
+      bool* copyable) const;
+
+  /**
+   * Checks whether the persisted tiles of the fragments to be consolidated
+   * can be copied verbatim into the new fragment.
+   *
+   * @tparam T The domain type.
+   * @param array_schema The array schema.
+   * @param to_consolidate The fragments to be consolidated.
+   * @param tile_order The fragments in the global order of their cells.
+   * @return `true` if the tiles can be copied.
+   */
+  template <class T>
+  bool check_tiles_copyable(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& to_consolidate,
+      std::vector<FragmentMetadata*>* tile_order) const;
+
+  /**
+   * Copies the cells of the fragments to be consolidated into the new
+   * fragment. The consolidated region is split into slabs of space tiles
+   * (see `compute_partitions`) that are read concurrently, each with its
+   * own query and double buffer, while the calling thread writes them in
+   * global order with `query_w`. The buffers take at most half of
+   * `sm.memory_budget`, if one is set.
    *
-   * @param query_r The read query.
+   * @param array_for_reads The opened array for reading the fragments
+   *     to be consolidated.
+   * @param to_consolidate The metadata of the fragments to be consolidated.
+   * @param subarray The subarray to write into (dense arrays only).
    * @param query_w The write query.
    * @return Status
    */
-  Status copy_array(Query* query_r, Query* query_w);
+  Status copy_array(
+      Array* array_for_reads,
+      const std::vector<FragmentMetadata*>& to_consolidate,
+      void* subarray,
+      Query* query_w);
+
+  /**
+   * Appends the first `nbytes` of the file at `uri` to the file at
+   * `new_uri`, in chunks of the consolidation buffer size. The throttling
+   * function is called before every chunk is written.
+   */
+  Status copy_file(const URI& uri, uint64_t nbytes, const URI& new_uri) const;
+
+  /**
+   * Adds the keys of a key-value fragment to the Bloom filter keys of the
+   * new fragment, by reading and unfiltering its coordinate tiles.
+   *
+   * @param array_for_writes The opened array for writing the consolidated
+   *     fragment.
+   * @param meta The metadata of the fragment whose keys are added.
+   * @param new_meta The metadata of the new fragment.
+   * @return Status
+   */
+  Status copy_bloom_filter_keys(
+      Array* array_for_writes,
+      const FragmentMetadata* meta,
+      FragmentMetadata* new_meta) const;
+
+  /**
+   * Creates the new fragment by concatenating the persisted tiles of the
+   * fragments to be consolidated, and computes its metadata by re-basing
+   * the tile offsets of the consolidated fragments. The metadata is not
+   * stored.
+   *
+   * @param array_for_writes The opened array for writing the consolidated
+   *     fragment.
+   * @param to_consolidate The fragments to be consolidated, in timestamp
+   *     order.
+   * @param tile_order The fragments in the global order of their cells.
+   * @param new_fragment_metadata The metadata of the new fragment.
+   * @return Status
+   */
+  Status copy_tiles(
+      Array* array_for_writes,
+      const std::vector<FragmentMetadata*>& to_consolidate,
+      const std::vector<FragmentMetadata*>& tile_order,
+      std::shared_ptr<FragmentMetadata>* new_fragment_metadata);
 
   /** Cleans up the inputs. */
-  void clean_up(
-      void* subarray,
-      unsigned buffer_num,
-      void** buffers,
-      uint64_t* buffer_sizes,
-      Query* query_r,
-      Query* query_w) const;
+  void clean_up(void* subarray, Query* query_w) const;
 
   /**
-   * Creates the buffers that will be used upon reading the input fragments and
-   * writing into the new fragment. It also retrieves the number of buffers
-   * created.
+   * Splits the region to be consolidated into at most `max_partition_num`
+   * partitions along the dimension that is slowest in the global order, at
+   * space tile boundaries, so that the concatenation of the partitions in
+   * global order is the region in global order. The region is `subarray`
+   * for dense arrays, and the union of the non-empty domains of the
+   * fragments to be consolidated for sparse arrays. Key-value stores and
+   * real domains are consolidated in a single partition.
    *
    * @param array_schema The array schema.
-   * @param buffers The buffers to be created.
-   * @param buffer_sizes The corresponding buffer sizes.
-   * @param buffer_num The number of buffers to be retrieved.
+   * @param to_consolidate The metadata of the fragments to be consolidated.
+   * @param subarray The subarray to write into (dense arrays only).
+   * @param max_partition_num The maximum number of partitions.
+   * @param partitions The subarrays of the partitions. An empty subarray
+   *     stands for the entire domain.
    * @return Status
    */
-  Status create_buffers(
+  Status compute_partitions(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& to_consolidate,
+      const void* subarray,
+      uint64_t max_partition_num,
+      std::vector<std::vector<uint8_t>>* partitions) const;
+
+  /**
+   * Splits the region to be consolidated into partitions. See the untyped
+   * overload for details.
+   *
+   * @tparam T The domain type.
+   */
+  template <class T>
+  void compute_partitions(
       const ArraySchema* array_schema,
-      void*** buffers,
-      uint64_t** buffer_sizes,
-      unsigned int* buffer_num);
+      const std::vector<FragmentMetadata*>& to_consolidate,
+      const T* subarray,
+      uint64_t max_partition_num,
+      std::vector<std::vector<uint8_t>>* partitions) const;
 
   /**
-   * Creates the queries needed for consolidation. It also retrieves
-   * the number of fragments to be consolidated and the URI of the
-   * new fragment to be created.
+   * Selects the fragments that the next consolidation step will merge. These
+   * form the longest run of fragments adjacent in timestamp order such that
+   * (i) it has at least `sm.consolidation.step_min_frags` and at most
+   * `sm.consolidation.step_max_frags` fragments, (ii) the sizes of every
+   * two consecutive fragments satisfy `sm.consolidation.step_size_ratio`,
+   * and (iii) the total fragment size does not exceed
+   * `sm.consolidation.step_max_bytes`. Among runs of equal length, the one
+   * with the smallest total size is preferred.
+   *
+   * For dense arrays, the function also computes the subarray of the new
+   * fragment, i.e., the union of the non-empty domains of the selected
+   * fragments expanded to the tile grid. A run is eligible only if no
+   * older fragment overlaps this subarray, since the new fragment would
+   * otherwise overwrite older cells with fill values.
+   *
+   * @param array The array opened for reads.
+   * @param to_consolidate The metadata of the selected fragments. It is
+   *     left empty if there is nothing to consolidate.
+   * @param subarray The subarray to write into (dense arrays only). It must
+   *     be freed by the caller.
+   * @return Status
+   */
+  Status compute_next_to_consolidate(
+      Array* array,
+      std::vector<FragmentMetadata*>* to_consolidate,
+      void** subarray) const;
+
+  /**
+   * Selects the fragments that the next consolidation step will merge.
+   * See the untyped overload for details.
+   *
+   * @tparam T The domain type.
+   * @param array_schema The array schema.
+   * @param fragments The array fragments in ascending timestamp order.
+   * @param to_consolidate The metadata of the selected fragments.
+   * @param subarray The subarray to write into (dense arrays only). It
+   *     must be allocated by the caller.
+   * @return void
+   */
+  template <class T>
+  void compute_next_to_consolidate(
+      const ArraySchema* array_schema,
+      const std::vector<FragmentMetadata*>& fragments,
+      std::vector<FragmentMetadata*>* to_consolidate,
+      T* subarray) const;
+
+  /**
+   * Creates the read query and the buffer sets of a partition.
    *
-   * @param query_r This query reads from the fragments to be consolidated.
-   * @param query_w This query writes to the new consolidated fragment.
-   * @param write_subarray The subarray to write into.
    * @param array_for_reads The opened array for reading the fragments
    *     to be consolidated.
+   * @param to_consolidate The metadata of the fragments to be consolidated.
+   * @param subarray The subarray of the partition (empty for the entire
+   *     domain).
+   * @param buffer_num The number of buffers per buffer set.
+   * @param buffer_size The size of every buffer.
+   * @param partition The partition to be created.
+   * @return Status
+   */
+  Status create_partition(
+      Array* array_for_reads,
+      const std::vector<FragmentMetadata*>& to_consolidate,
+      const std::vector<uint8_t>& subarray,
+      unsigned buffer_num,
+      uint64_t buffer_size,
+      Partition* partition);
+
+  /**
+   * Creates the query that writes the new fragment. The new fragment is
+   * named after the last of the fragments to be consolidated.
+   *
    * @param array_for_writes The opened array for writing the
-   *     consolidated fragments.
-   * @param buffers The buffers to be passed in the queries.
-   * @param buffer_sizes The corresponding buffer sizes.
-   * @param fragment_num The number of fragments to be retrieved.
+   *     consolidated fragment.
+   * @param subarray The subarray to write into (dense arrays only).
+   * @param to_consolidate The metadata of the fragments to be consolidated.
+   * @param query_w The write query to be created.
    * @param new_fragment_uri The URI of the new fragment to be created.
    * @return Status
    */
-  Status create_queries(
-      Query** query_r,
-      Query** query_w,
-      void* write_subarray,
-      Array* array_for_reads,
+  Status create_write_query(
       Array* array_for_writes,
-      void** buffers,
-      uint64_t* buffer_sizes,
-      unsigned int* fragment_num,
+      void* subarray,
+      const std::vector<FragmentMetadata*>& to_consolidate,
+      Query** query_w,
       URI* new_fragment_uri);
 
-  /** Creates the subarray that should represent the entire array domain. */
-  Status create_subarray(Array* array, void** subarray) const;
-
   /**
    * Deletes the fragment metadata files of the old fragments that
-   * got consolidated. This renders the old fragments "invisible".
+   * got consolidated, and records their removal in the fragment manifest.
+   * This renders the old fragments "invisible".
    *
    * @param uris The URIs of the old fragments.
    * @return Status
@@ -182,14 +442,11 @@ class Consolidator {
   Status delete_old_fragments(const std::vector<URI>& uris);
 
   /**
-   * Frees the input buffers.
-   *
-   * @param buffer_num The number of buffers.
-   * @param buffers The buffers to be freed.
-   * @param buffer_sizes The corresponding buffer sizes.
+   * Reads the cells of a partition into its free buffer sets, handing every
+   * filled set over to the writer, until the read query completes, fails or
+   * the partition is cancelled. Executed by the consolidation thread pool.
    */
-  void free_buffers(
-      unsigned int buffer_num, void** buffers, uint64_t* buffer_sizes) const;
+  Status read_partition(Partition* partition) const;
 
   /**
    * Renames the new fragment URI. The new name has the format
@@ -202,13 +459,20 @@ class Consolidator {
   Status rename_new_fragment_uri(URI* uri) const;
 
   /**
-   * Sets the buffers to the query, using all the attributes in the
-   * query schema. There is a 1-1 correspondence between the input `buffers`
+   * Sets the buffers of `buffer_set` to the query, using all the attributes
+   * in the query schema. There is a 1-1 correspondence between the buffers
    * and the attributes in the schema, considering also the coordinates
    * if the array is sparse in the end.
    */
-  Status set_query_buffers(
-      Query* query, void** buffers, uint64_t* buffer_sizes) const;
+  Status set_query_buffers(Query* query, BufferSet* buffer_set) const;
+
+  /**
+   * Writes the cells of the partitions to the new fragment with `query_w`,
+   * in partition order, as their buffer sets fill up.
+   */
+  Status write_partitions(
+      Query* query_w,
+      const std::vector<std::unique_ptr<Partition>>& partitions) const;
 };
 
 }  // namespace sm
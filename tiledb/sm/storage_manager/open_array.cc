@@ -48,6 +48,7 @@ OpenArray::OpenArray(const URI& array_uri, QueryType query_type)
   array_schema_ = nullptr;
   cnt_ = 0;
   filelock_ = INVALID_FILELOCK;
+  fragment_manifest_offset_ = 0;
 }
 
 OpenArray::~OpenArray() {
@@ -120,10 +121,19 @@ std::vector<FragmentMetadata*> OpenArray::fragment_metadata(
 }
 
 bool OpenArray::fragment_metadata_exists(const URI& uri) const {
-  return fragment_metadata_set_.find(uri.to_string()) !=
+  return fragment_metadata_set_.find(
+             uri.remove_trailing_slash().to_string()) !=
          fragment_metadata_set_.end();
 }
 
+std::set<std::string>* OpenArray::fragment_manifest_names() {
+  return &fragment_manifest_names_;
+}
+
+uint64_t OpenArray::fragment_manifest_offset() const {
+  return fragment_manifest_offset_;
+}
+
 void OpenArray::mtx_lock() {
   mtx_.lock();
 }
@@ -140,10 +150,15 @@ void OpenArray::set_array_schema(ArraySchema* array_schema) {
   array_schema_ = array_schema;
 }
 
+void OpenArray::set_fragment_manifest_offset(uint64_t offset) {
+  fragment_manifest_offset_ = offset;
+}
+
 void OpenArray::insert_fragment_metadata(FragmentMetadata* metadata) {
   assert(metadata != nullptr);
   fragment_metadata_.insert(metadata);
-  fragment_metadata_set_.insert(metadata->fragment_uri().to_string());
+  fragment_metadata_set_.insert(
+      metadata->fragment_uri().remove_trailing_slash().to_string());
 }
 
 /* ****************************** */
@@ -120,6 +120,18 @@ class OpenArray {
    */
   bool fragment_metadata_exists(const URI& uri) const;
 
+  /**
+   * Returns the names of the array fragments recorded in the fragment
+   * manifest up to `fragment_manifest_offset()`.
+   */
+  std::set<std::string>* fragment_manifest_names();
+
+  /**
+   * Returns the offset up to which the fragment manifest has been read,
+   * or zero if it has not been read.
+   */
+  uint64_t fragment_manifest_offset() const;
+
   /** Locks the array mutex. */
   void mtx_lock();
 
@@ -139,6 +151,9 @@ class OpenArray {
   /** Sets an array schema. */
   void set_array_schema(ArraySchema* array_schema);
 
+  /** Sets the offset up to which the fragment manifest has been read. */
+  void set_fragment_manifest_offset(uint64_t offset);
+
   /** Custom comparator for comparing fragment metadata pointers. */
   struct cmp_frag_meta_ptr {
     /**
@@ -177,6 +192,12 @@ class OpenArray {
    */
   std::set<std::string> fragment_metadata_set_;
 
+  /** The names of the fragments read from the fragment manifest. */
+  std::set<std::string> fragment_manifest_names_;
+
+  /** The offset up to which the fragment manifest has been read. */
+  uint64_t fragment_manifest_offset_;
+
   /**
    * A mutex used to lock the array when loading the array metadata and
    * any fragment metadata structures from the disk.
@@ -40,6 +40,7 @@
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/storage_manager/consolidation_service.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
 #include "tiledb/sm/tile/tile_io.h"
 
@@ -57,6 +58,8 @@
 namespace tiledb {
 namespace sm {
 
+std::mutex StorageManager::fragment_manifest_mtx_;
+
 /* ****************************** */
 /*   CONSTRUCTORS & DESTRUCTORS   */
 /* ****************************** */
@@ -69,12 +72,22 @@ StorageManager::StorageManager() {
   vfs_ = nullptr;
   cancellation_in_progress_ = false;
   queries_in_progress_ = 0;
+  xlock_cancelled_ = false;
 }
 
 StorageManager::~StorageManager() {
   global_state::GlobalState::GetGlobalState().unregister_storage_manager(this);
   cancel_all_tasks();
 
+  // Stop the consolidation service, which may wait for an exclusive lock
+  {
+    std::unique_lock<std::mutex> lck(open_array_for_reads_mtx_);
+    xlock_cancelled_ = true;
+  }
+  xlock_cv_.notify_all();
+  if (consolidation_service_ != nullptr)
+    consolidation_service_->stop();
+
   delete array_schema_cache_;
   delete consolidator_;
   delete fragment_metadata_cache_;
@@ -121,10 +134,18 @@ Status StorageManager::array_open(
     uint64_t timestamp) {
   STATS_FUNC_IN(sm_array_open);
 
-  if (query_type == QueryType::READ)
-    return array_open_for_reads(
-        array_uri, encryption_key, open_array, timestamp);
-  return array_open_for_writes(array_uri, encryption_key, open_array);
+  if (query_type == QueryType::READ) {
+    RETURN_NOT_OK(array_open_for_reads(
+        array_uri, encryption_key, open_array, timestamp));
+  } else {
+    RETURN_NOT_OK(array_open_for_writes(array_uri, encryption_key, open_array));
+  }
+
+  // The consolidation service does not store encryption keys
+  if (encryption_key.encryption_type() == EncryptionType::NO_ENCRYPTION)
+    consolidation_service_->watch_array(array_uri);
+
+  return Status::Ok();
 
   STATS_FUNC_OUT(sm_array_open);
 }
@@ -414,6 +435,29 @@ Status StorageManager::array_consolidate(
       array_name, encryption_type, encryption_key, key_length);
 }
 
+Status StorageManager::array_consolidate_metadata(
+    const char* array_name,
+    EncryptionType encryption_type,
+    const void* encryption_key,
+    uint32_t key_length) {
+  // Check array URI
+  URI array_uri(array_name);
+  if (array_uri.is_invalid()) {
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot consolidate array metadata; Invalid URI"));
+  }
+  // Check if array exists
+  ObjectType obj_type;
+  RETURN_NOT_OK(object_type(array_uri, &obj_type));
+
+  if (obj_type != ObjectType::ARRAY && obj_type != ObjectType::KEY_VALUE) {
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot consolidate array metadata; Array does not exist"));
+  }
+  return consolidator_->consolidate_fragment_metadata(
+      array_name, encryption_type, encryption_key, key_length);
+}
+
 Status StorageManager::array_create(
     const URI& array_uri,
     ArraySchema* array_schema,
@@ -534,9 +578,13 @@ Status StorageManager::array_xlock(const URI& array_uri) {
   // Wait until the array is closed for reads
   std::unique_lock<std::mutex> lk(open_array_for_reads_mtx_);
   xlock_cv_.wait(lk, [this, array_uri] {
-    return open_arrays_for_reads_.find(array_uri.to_string()) ==
-           open_arrays_for_reads_.end();
+    return xlock_cancelled_ ||
+           open_arrays_for_reads_.find(array_uri.to_string()) ==
+               open_arrays_for_reads_.end();
   });
+  if (xlock_cancelled_)
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot lock array exclusively; Storage manager is shutting down"));
 
   // Retrieve filelock
   filelock_t filelock = INVALID_FILELOCK;
@@ -619,6 +667,10 @@ Config StorageManager::config() const {
   return config_;
 }
 
+ConsolidationService* StorageManager::consolidation_service() const {
+  return consolidation_service_.get();
+}
+
 Status StorageManager::create_dir(const URI& uri) {
   return vfs_->create_dir(uri);
 }
@@ -663,6 +715,14 @@ void StorageManager::decrement_in_progress() {
   queries_in_progress_cv_.notify_all();
 }
 
+void* StorageManager::evict_tile_cache_object(
+    LRUCache::LRUCacheItem* item, void* memory_budget) {
+  std::free(item->object_);
+  item->object_ = nullptr;
+  static_cast<MemoryBudget*>(memory_budget)->release(item->size_);
+  return nullptr;
+}
+
 Status StorageManager::object_remove(const char* path) const {
   auto uri = URI(path);
   if (uri.is_invalid())
@@ -745,12 +805,20 @@ Status StorageManager::init(Config* config) {
   RETURN_NOT_OK(reader_thread_pool_->init(sm_params.num_reader_threads_));
   writer_thread_pool_ = std::unique_ptr<ThreadPool>(new ThreadPool());
   RETURN_NOT_OK(writer_thread_pool_->init(sm_params.num_writer_threads_));
-  tile_cache_ = new LRUCache(sm_params.tile_cache_size_);
+  memory_budget_ = std::unique_ptr<MemoryBudget>(new MemoryBudget());
+  RETURN_NOT_OK(memory_budget_->init(sm_params.memory_budget_));
+  tile_cache_ = new LRUCache(
+      sm_params.tile_cache_size_,
+      &evict_tile_cache_object,
+      memory_budget_.get());
   vfs_ = new VFS();
   RETURN_NOT_OK(vfs_->init(config_.vfs_params()));
   auto& global_state = global_state::GlobalState::GetGlobalState();
   RETURN_NOT_OK(global_state.initialize(config));
   global_state.register_storage_manager(this);
+  consolidation_service_ =
+      std::unique_ptr<ConsolidationService>(new ConsolidationService(this));
+  RETURN_NOT_OK(consolidation_service_->init());
 
   STATS_COUNTER_ADD(sm_contexts_created, 1);
 
@@ -769,6 +837,12 @@ Status StorageManager::is_array(const URI& uri, bool* is_array) const {
   return Status::Ok();
 }
 
+bool StorageManager::is_array_open_for_reads(const URI& array_uri) {
+  std::lock_guard<std::mutex> lock{open_array_for_reads_mtx_};
+  return open_arrays_for_reads_.find(array_uri.to_string()) !=
+         open_arrays_for_reads_.end();
+}
+
 Status StorageManager::is_file(const URI& uri, bool* is_file) const {
   RETURN_NOT_OK(vfs_->is_file(uri, is_file));
   return Status::Ok();
@@ -1137,8 +1211,14 @@ Status StorageManager::query_submit(Query* query) {
 
   // Process the query
   QueryInProgress in_progress(this);
+  auto start_ms = utils::time::timestamp_now_ms();
   auto st = query->process();
 
+  // Report the latency of foreground queries to the consolidation service
+  if (!query->internal())
+    consolidation_service_->record_query_latency(
+        utils::time::timestamp_now_ms() - start_ms);
+
   return st;
 
   STATS_FUNC_OUT(sm_query_submit);
@@ -1180,6 +1260,10 @@ Status StorageManager::read(
   return Status::Ok();
 }
 
+MemoryBudget* StorageManager::memory_budget() const {
+  return memory_budget_.get();
+}
+
 ThreadPool* StorageManager::reader_thread_pool() const {
   return reader_thread_pool_.get();
 }
@@ -1235,6 +1319,13 @@ Status StorageManager::store_fragment_metadata(
     return Status::Ok();
   }
 
+  // Record the new fragment in the fragment manifest before committing it
+  // with its metadata file, so that a crash in between never leaves a
+  // committed fragment missing from the manifest. Readers skip the
+  // manifest fragments without a metadata file.
+  RETURN_NOT_OK(
+      store_fragment_manifest(fragment_uri.parent(), {fragment_uri}, {}));
+
   // Serialize
   auto buff = new Buffer();
   Status st = metadata->serialize(buff);
@@ -1267,6 +1358,149 @@ Status StorageManager::store_fragment_metadata(
   return st;
 }
 
+// ===== FORMAT =====
+// op#1 (uint8_t) fragment_name_size#1 (uint64_t) fragment_name#1 (char*)
+// op#2 (uint8_t) fragment_name_size#2 (uint64_t) fragment_name#2 (char*)
+// ...
+Status StorageManager::store_fragment_manifest(
+    const URI& array_uri,
+    const std::vector<URI>& added,
+    const std::vector<URI>& removed) {
+  if (!config_.sm_params().fragment_manifest_)
+    return Status::Ok();
+
+  // Lock the manifest against the writers of other processes, which would
+  // otherwise append at the same offset. The lock file is left in place,
+  // since removing it could let two writers lock different files.
+  std::lock_guard<std::mutex> lock{fragment_manifest_mtx_};
+  if (!array_uri.is_file())
+    return store_fragment_manifest_locked(array_uri, added, removed);
+  auto lock_uri =
+      array_uri.join_path(constants::fragment_manifest_lock_filename);
+  RETURN_NOT_OK(vfs_->touch(lock_uri));
+  filelock_t filelock = INVALID_FILELOCK;
+  RETURN_NOT_OK(vfs_->filelock_lock(lock_uri, &filelock, false));
+  auto st = store_fragment_manifest_locked(array_uri, added, removed);
+  auto st_unlock = vfs_->filelock_unlock(lock_uri, filelock);
+  return st.ok() ? st_unlock : st;
+}
+
+Status StorageManager::store_fragment_manifest_locked(
+    const URI& array_uri,
+    const std::vector<URI>& added,
+    const std::vector<URI>& removed) {
+  auto manifest_uri =
+      array_uri.join_path(constants::fragment_manifest_filename);
+  bool exists;
+  RETURN_NOT_OK(vfs_->is_file(manifest_uri, &exists));
+
+  // Objects on S3 cannot be appended to, so the manifest is rewritten with
+  // the new records following its current contents
+  Buffer buff;
+  if (exists && array_uri.is_s3()) {
+    uint64_t size;
+    RETURN_NOT_OK(vfs_->file_size(manifest_uri, &size));
+    if (size > 0) {
+      RETURN_NOT_OK(buff.realloc(size));
+      RETURN_NOT_OK(vfs_->read(manifest_uri, 0, buff.data(), size));
+      buff.set_size(size);
+      buff.set_offset(size);
+    }
+  }
+
+  // A new manifest starts with all the fragments currently in the array
+  std::vector<URI> added_uris;
+  if (!exists)
+    RETURN_NOT_OK(get_fragment_uris(array_uri, &added_uris));
+  added_uris.insert(added_uris.end(), added.begin(), added.end());
+
+  // Serialize the records
+  auto write_record = [&buff](uint8_t op, const URI& uri) {
+    auto name = uri.remove_trailing_slash().last_path_part();
+    uint64_t name_size = name.size();
+    RETURN_NOT_OK(buff.write(&op, sizeof(uint8_t)));
+    RETURN_NOT_OK(buff.write(&name_size, sizeof(uint64_t)));
+    RETURN_NOT_OK(buff.write(name.data(), name_size));
+    return Status::Ok();
+  };
+  for (const auto& uri : added_uris)
+    RETURN_NOT_OK(write_record(1, uri));
+  for (const auto& uri : removed)
+    RETURN_NOT_OK(write_record(0, uri));
+
+  // Append the records
+  if (buff.size() == 0)
+    return Status::Ok();
+  RETURN_NOT_OK(vfs_->write(manifest_uri, buff.data(), buff.size()));
+  return close_file(manifest_uri);
+}
+
+// ===== FORMAT =====
+// version (uint32_t)
+// fragment_num (uint64_t)
+// fragment_name_size#1 (uint64_t) fragment_name#1 (char*)
+// timestamp#1 (uint64_t) dense#1 (uint8_t)
+// metadata_size#1 (uint64_t) metadata#1 (serialized FragmentMetadata)
+// fragment_name_size#2 (uint64_t) fragment_name#2 (char*)
+// ...
+Status StorageManager::store_consolidated_fragment_metadata(
+    const URI& array_uri,
+    const std::vector<FragmentMetadata*>& fragment_metadata,
+    const EncryptionKey& encryption_key) {
+  // Serialize
+  Buffer buff;
+  Buffer metadata_buff;
+  uint32_t version = constants::format_version;
+  RETURN_NOT_OK(buff.write(&version, sizeof(uint32_t)));
+  auto fragment_num = (uint64_t)fragment_metadata.size();
+  RETURN_NOT_OK(buff.write(&fragment_num, sizeof(uint64_t)));
+  for (auto meta : fragment_metadata) {
+    auto name = meta->fragment_uri().remove_trailing_slash().last_path_part();
+    auto name_size = (uint64_t)name.size();
+    auto timestamp = meta->timestamp();
+    auto dense = (uint8_t)meta->dense();
+    RETURN_NOT_OK(buff.write(&name_size, sizeof(uint64_t)));
+    RETURN_NOT_OK(buff.write(name.data(), name_size));
+    RETURN_NOT_OK(buff.write(&timestamp, sizeof(uint64_t)));
+    RETURN_NOT_OK(buff.write(&dense, sizeof(uint8_t)));
+
+    metadata_buff.reset_size();
+    metadata_buff.reset_offset();
+    RETURN_NOT_OK(meta->serialize(&metadata_buff));
+    auto metadata_size = metadata_buff.size();
+    RETURN_NOT_OK(buff.write(&metadata_size, sizeof(uint64_t)));
+    RETURN_NOT_OK(buff.write(metadata_buff.data(), metadata_size));
+  }
+
+  // Write to a temporary file, and then replace the previous file, so that
+  // readers never see a partially written file
+  auto uri =
+      array_uri.join_path(constants::consolidated_fragment_metadata_filename);
+  auto tmp_uri = URI(uri.to_string() + ".tmp");
+  bool exists;
+  RETURN_NOT_OK(vfs_->is_file(tmp_uri, &exists));
+  if (exists)
+    RETURN_NOT_OK(vfs_->remove_file(tmp_uri));
+
+  buff.reset_offset();
+  Tile tile(
+      constants::generic_tile_datatype,
+      constants::generic_tile_cell_size,
+      0,
+      &buff,
+      false);
+  TileIO tile_io(this, tmp_uri);
+  RETURN_NOT_OK(tile_io.write_generic(&tile, encryption_key));
+  RETURN_NOT_OK(close_file(tmp_uri));
+
+  RETURN_NOT_OK(vfs_->is_file(uri, &exists));
+  if (exists)
+    RETURN_NOT_OK(vfs_->remove_file(uri));
+  RETURN_NOT_OK(vfs_->move_file(tmp_uri, uri));
+
+  return Status::Ok();
+}
+
 Status StorageManager::close_file(const URI& uri) {
   return vfs_->close_file(uri);
 }
@@ -1310,11 +1544,18 @@ Status StorageManager::write_to_cache(
   std::stringstream key;
   key << uri.to_string() << "+" << offset;
 
+  // Do not cache if the object does not fit in the memory budget. The
+  // reserved bytes are released when the object is evicted.
+  if (!memory_budget_->try_reserve(object_size))
+    return Status::Ok();
+
   // Insert to cache
   void* object = std::malloc(object_size);
-  if (object == nullptr)
+  if (object == nullptr) {
+    memory_budget_->release(object_size);
     return LOG_STATUS(Status::StorageManagerError(
         "Cannot write to cache; Object memory allocation failed"));
+  }
   std::memcpy(object, buffer->data(), object_size);
   RETURN_NOT_OK(tile_cache_->insert(key.str(), object, object_size, false));
 
@@ -1501,6 +1742,9 @@ Status StorageManager::array_close_for_reads(const URI& array_uri) {
     open_array->mtx_unlock();
     delete open_array;
     open_arrays_for_reads_.erase(it);
+
+    // Retry the consolidation if the service skipped the array
+    consolidation_service_->array_closed(array_uri);
   } else {  // Just unlock the array mutex
     open_array->mtx_unlock();
   }
@@ -1712,6 +1956,57 @@ Status StorageManager::get_fragment_uris(
   return Status::Ok();
 }
 
+Status StorageManager::get_fragment_uris(
+    OpenArray* open_array, std::vector<URI>* fragment_uris, bool* found) {
+  const URI& array_uri = open_array->array_uri();
+  auto manifest_uri =
+      array_uri.join_path(constants::fragment_manifest_filename);
+  RETURN_NOT_OK(vfs_->is_file(manifest_uri, found));
+  if (!*found)
+    return Status::Ok();
+
+  // Start over if the manifest was recreated since the last call
+  auto names = open_array->fragment_manifest_names();
+  auto offset = open_array->fragment_manifest_offset();
+  uint64_t size;
+  RETURN_NOT_OK(vfs_->file_size(manifest_uri, &size));
+  if (size < offset) {
+    names->clear();
+    offset = 0;
+  }
+
+  // Apply the records appended since the last call. A trailing record that
+  // is still being written is left for the next call.
+  if (size > offset) {
+    Buffer buff;
+    RETURN_NOT_OK(buff.realloc(size - offset));
+    RETURN_NOT_OK(vfs_->read(manifest_uri, offset, buff.data(), size - offset));
+    ConstBuffer cbuff(buff.data(), size - offset);
+    uint8_t op;
+    uint64_t name_size;
+    std::string name;
+    while (cbuff.nbytes_left_to_read() >= sizeof(uint8_t) + sizeof(uint64_t)) {
+      RETURN_NOT_OK(cbuff.read(&op, sizeof(uint8_t)));
+      RETURN_NOT_OK(cbuff.read(&name_size, sizeof(uint64_t)));
+      if (name_size > cbuff.nbytes_left_to_read())
+        break;
+      name.resize(name_size);
+      RETURN_NOT_OK(cbuff.read(&name[0], name_size));
+      if (op != 0)
+        names->insert(name);
+      else
+        names->erase(name);
+      offset = size - cbuff.nbytes_left_to_read();
+    }
+  }
+  open_array->set_fragment_manifest_offset(offset);
+
+  for (const auto& name : *names)
+    fragment_uris->push_back(array_uri.join_path(name));
+
+  return Status::Ok();
+}
+
 Status StorageManager::load_array_schema(
     const URI& array_uri,
     ObjectType object_type,
@@ -1730,15 +2025,82 @@ Status StorageManager::load_array_schema(
   return Status::Ok();
 }
 
+Status StorageManager::load_consolidated_fragment_metadata(
+    const URI& array_uri,
+    const EncryptionKey& encryption_key,
+    std::unique_ptr<Buffer>* buff,
+    std::unordered_map<std::string, uint64_t>* offsets) {
+  // Do nothing if the metadata have not been consolidated
+  auto uri =
+      array_uri.join_path(constants::consolidated_fragment_metadata_filename);
+  bool exists;
+  RETURN_NOT_OK(vfs_->is_file(uri, &exists));
+  if (!exists)
+    return Status::Ok();
+
+  // Read the file
+  TileIO tile_io(this, uri);
+  auto tile = (Tile*)nullptr;
+  RETURN_NOT_OK(tile_io.read_generic(&tile, 0, encryption_key));
+  tile->disown_buff();
+  buff->reset(tile->buffer());
+  delete tile;
+
+  // Index the fragment entries
+  ConstBuffer cbuff(buff->get());
+  uint32_t version;
+  uint64_t fragment_num;
+  RETURN_NOT_OK(cbuff.read(&version, sizeof(uint32_t)));
+  if (version == 0 || version > constants::format_version)
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot load consolidated fragment metadata; Unsupported format "
+        "version " +
+        std::to_string(version)));
+  RETURN_NOT_OK(cbuff.read(&fragment_num, sizeof(uint64_t)));
+
+  // Every size is checked against the bytes left, so that a truncated or
+  // corrupted file never causes a large allocation or an overrun
+  auto corrupted = [offsets]() {
+    offsets->clear();
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot load consolidated fragment metadata; File is corrupted"));
+  };
+  std::string name;
+  for (uint64_t i = 0; i < fragment_num; ++i) {
+    uint64_t name_size, metadata_size;
+    RETURN_NOT_OK(cbuff.read(&name_size, sizeof(uint64_t)));
+    if (name_size > cbuff.nbytes_left_to_read())
+      return corrupted();
+    name.resize(name_size);
+    RETURN_NOT_OK(cbuff.read(&name[0], name_size));
+    auto offset = cbuff.offset();
+    if (sizeof(uint64_t) + sizeof(uint8_t) > cbuff.nbytes_left_to_read())
+      return corrupted();
+    cbuff.advance_offset(sizeof(uint64_t) + sizeof(uint8_t));
+    RETURN_NOT_OK(cbuff.read(&metadata_size, sizeof(uint64_t)));
+    if (metadata_size > cbuff.nbytes_left_to_read())
+      return corrupted();
+    (*offsets)[name] = offset;
+    cbuff.advance_offset(metadata_size);
+  }
+
+  return Status::Ok();
+}
+
 Status StorageManager::load_fragment_metadata(
     OpenArray* open_array,
     const EncryptionKey& encryption_key,
     bool* in_cache,
     uint64_t timestamp) {
-  // Get all the fragment uris, sorted by timestamp
+  // Get all the fragment uris, from the fragment manifest if enabled and
+  // present, or else by listing the array directory
   std::vector<URI> fragment_uris;
   const URI& array_uri = open_array->array_uri();
-  RETURN_NOT_OK(get_fragment_uris(array_uri, &fragment_uris));
+  bool found = false;
+  if (config_.sm_params().fragment_manifest_)
+    RETURN_NOT_OK(get_fragment_uris(open_array, &fragment_uris, &found));
+  if (!found)
+    RETURN_NOT_OK(get_fragment_uris(array_uri, &fragment_uris));
 
   // Check if the array is empty
   if (fragment_uris.empty())
@@ -1749,12 +2111,51 @@ Status StorageManager::load_fragment_metadata(
   std::vector<std::pair<uint64_t, URI>> sorted_fragment_uris;
   sort_fragment_uris(fragment_uris, &sorted_fragment_uris);
 
-  // Load the metadata for each fragment, only if they are not already loaded
+  // Find the fragments whose metadata are not already loaded
+  std::vector<std::pair<uint64_t, URI>> to_load;
   for (auto& sf : sorted_fragment_uris) {
+    if (!open_array->fragment_metadata_exists(sf.second) &&
+        sf.first <= timestamp)
+      to_load.push_back(sf);
+  }
+
+  // Read the consolidated fragment metadata if there are several fragments
+  // to load. Entries of fragments that no longer exist are ignored.
+  std::unique_ptr<Buffer> consolidated_buff;
+  std::unordered_map<std::string, uint64_t> offsets;
+  if (to_load.size() > 1)
+    RETURN_NOT_OK(load_consolidated_fragment_metadata(
+        array_uri, encryption_key, &consolidated_buff, &offsets));
+
+  // Load the metadata for each fragment
+  for (auto& sf : to_load) {
     auto frag_timestamp = sf.first;
     auto frag_uri = sf.second;
-    if (!open_array->fragment_metadata_exists(frag_uri) &&
-        frag_timestamp <= timestamp) {
+    auto it = offsets.find(frag_uri.remove_trailing_slash().last_path_part());
+    if (it != offsets.end()) {
+      // Load from the consolidated fragment metadata
+      ConstBuffer cbuff(consolidated_buff.get());
+      cbuff.set_offset(it->second + sizeof(uint64_t));
+      uint8_t dense;
+      uint64_t metadata_size;
+      RETURN_NOT_OK(cbuff.read(&dense, sizeof(uint8_t)));
+      RETURN_NOT_OK(cbuff.read(&metadata_size, sizeof(uint64_t)));
+      ConstBuffer metadata_buff(
+          (const char*)cbuff.data() + cbuff.offset(), metadata_size);
+      auto metadata = new FragmentMetadata(
+          open_array->array_schema(), dense != 0, frag_uri, frag_timestamp);
+      RETURN_NOT_OK_ELSE(
+          metadata->deserialize(&metadata_buff), delete metadata);
+      open_array->insert_fragment_metadata(metadata);
+    } else {
+      // A fragment is recorded in the manifest before it is committed, so
+      // skip it if it is not committed yet, or never was
+      if (found) {
+        bool committed;
+        RETURN_NOT_OK(is_fragment(frag_uri, &committed));
+        if (!committed)
+          continue;
+      }
       URI coords_uri =
           frag_uri.join_path(constants::coords + constants::file_suffix);
       bool sparse;
@@ -38,6 +38,7 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
@@ -50,6 +51,7 @@
 #include "tiledb/sm/enums/object_type.h"
 #include "tiledb/sm/enums/walk_order.h"
 #include "tiledb/sm/filesystem/vfs.h"
+#include "tiledb/sm/misc/memory_budget.h"
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/misc/thread_pool.h"
 #include "tiledb/sm/misc/uri.h"
@@ -62,6 +64,7 @@ namespace tiledb {
 namespace sm {
 
 class Array;
+class ConsolidationService;
 class Consolidator;
 
 /** The storage manager that manages pretty much everything in TileDB. */
@@ -265,6 +268,26 @@ class StorageManager {
       const void* encryption_key,
       uint32_t key_length);
 
+  /**
+   * Consolidates the metadata of all the current fragments of an array into
+   * a single file in the array directory, so that opening the array reads
+   * one object instead of one per fragment. The fragments themselves are
+   * left untouched.
+   *
+   * @param array_name The name of the array whose metadata will be
+   *     consolidated.
+   * @param encryption_type The encryption type of the array
+   * @param encryption_key If the array is encrypted, the private encryption
+   *    key. For unencrypted arrays, pass `nullptr`.
+   * @param key_length The length in bytes of the encryption key.
+   * @return Status
+   */
+  Status array_consolidate_metadata(
+      const char* array_name,
+      EncryptionType encryption_type,
+      const void* encryption_key,
+      uint32_t key_length);
+
   /**
    * Creates a TileDB array storing its schema.
    *
@@ -328,6 +351,9 @@ class StorageManager {
   /** Returns the configuration parameters. */
   Config config() const;
 
+  /** Returns the background consolidation service. */
+  ConsolidationService* consolidation_service() const;
+
   /** Creates a directory with the input URI. */
   Status create_dir(const URI& uri);
 
@@ -359,6 +385,9 @@ class StorageManager {
    */
   Status is_array(const URI& uri, bool* is_array) const;
 
+  /** Returns `true` if the input array is currently open for reads. */
+  bool is_array_open_for_reads(const URI& array_uri);
+
   /**
    * Checks if the input URI represents a directory.
    *
@@ -440,6 +469,9 @@ class StorageManager {
       const EncryptionKey& encryption_key,
       bool* in_cache);
 
+  /** Returns the memory budget shared by all queries and the tile cache. */
+  MemoryBudget* memory_budget() const;
+
   /** Removes a TileDB object (group, array, kv). */
   Status object_remove(const char* path) const;
 
@@ -601,6 +633,51 @@ class StorageManager {
   Status store_fragment_metadata(
       FragmentMetadata* metadata, const EncryptionKey& encryption_key);
 
+  /**
+   * Appends records for added and removed fragments to the fragment
+   * manifest of an array. This is a no-op unless `sm.fragment_manifest`
+   * is set. If the manifest does not exist yet, it is created with a record
+   * for every fragment currently in the array.
+   *
+   * Fragments are added before their metadata file is written, and removed
+   * after it is deleted, so the manifest lists every committed fragment
+   * even after a crash. Fragments listed without a metadata file are not
+   * committed and are skipped when loading.
+   *
+   * On local filesystems, the update holds an exclusive lock on the array
+   * manifest lock file, so that the records of concurrent writers, in this
+   * or other processes, never interleave. File locks are not available on
+   * S3 and HDFS, where only one process may write to the array at a time.
+   *
+   * The manifest is a sequence of records, each made of an operation
+   * (`uint8_t`, 1 for added and 0 for removed), the fragment name size
+   * (`uint64_t`) and the fragment name. Readers can therefore resume
+   * reading it from the end of the last record they have read.
+   *
+   * @param array_uri The array URI.
+   * @param added The URIs of the added fragments.
+   * @param removed The URIs of the removed fragments.
+   * @return Status
+   */
+  Status store_fragment_manifest(
+      const URI& array_uri,
+      const std::vector<URI>& added,
+      const std::vector<URI>& removed);
+
+  /**
+   * Stores the metadata of the input fragments into the consolidated
+   * fragment metadata file of the array, replacing any previous one.
+   *
+   * @param array_uri The array URI.
+   * @param fragment_metadata The metadata of the fragments to be stored.
+   * @param encryption_key The encryption key to use.
+   * @return Status
+   */
+  Status store_consolidated_fragment_metadata(
+      const URI& array_uri,
+      const std::vector<FragmentMetadata*>& fragment_metadata,
+      const EncryptionKey& encryption_key);
+
   /** Closes a file, flushing its contents to persistent storage. */
   Status close_file(const URI& uri);
 
@@ -684,6 +761,12 @@ class StorageManager {
    */
   std::condition_variable xlock_cv_;
 
+  /**
+   * Set to `true` upon destruction, so that `array_xlock` stops waiting for
+   * arrays to be closed. Protected by `open_array_for_reads_mtx_`.
+   */
+  bool xlock_cancelled_;
+
   /** Mutex for providing thread-safety upon creating TileDB objects. */
   std::mutex object_create_mtx_;
 
@@ -693,12 +776,28 @@ class StorageManager {
   /** Object that handles array consolidation. */
   Consolidator* consolidator_;
 
+  /** Consolidates the opened arrays in the background, if enabled. */
+  std::unique_ptr<ConsolidationService> consolidation_service_;
+
   /** Stores exclusive filelocks for arrays. */
   std::unordered_map<std::string, filelock_t> xfilelocks_;
 
   /** A fragment metadata cache. */
   LRUCache* fragment_metadata_cache_;
 
+  /**
+   * The memory budget (`sm.memory_budget`) that the queries and the tile
+   * cache reserve their memory against.
+   */
+  std::unique_ptr<MemoryBudget> memory_budget_;
+
+  /**
+   * Mutex serializing the updates of the fragment manifests. It is shared
+   * by all storage managers, since the manifest file locks are held per
+   * process.
+   */
+  static std::mutex fragment_manifest_mtx_;
+
   /** Mutex for managing OpenArray objects for reads. */
   std::mutex open_array_for_reads_mtx_;
 
@@ -863,10 +962,30 @@ class StorageManager {
   /** Decrement the count of in-progress queries. */
   void decrement_in_progress();
 
+  /**
+   * Eviction callback of the tile cache. It frees the cached object and
+   * releases its bytes from the memory budget passed as `memory_budget`.
+   */
+  static void* evict_tile_cache_object(
+      LRUCache::LRUCacheItem* item, void* memory_budget);
+
   /** Retrieves all the fragment URI's of an array. */
   Status get_fragment_uris(
       const URI& array_uri, std::vector<URI>* fragment_uris) const;
 
+  /**
+   * Retrieves the fragment URI's of an open array from the array fragment
+   * manifest. Only the manifest records after those read by a previous
+   * call are fetched.
+   *
+   * @param open_array The open array object.
+   * @param fragment_uris The fragment URI's.
+   * @param found Set to `false` if the manifest does not exist.
+   * @return Status
+   */
+  Status get_fragment_uris(
+      OpenArray* open_array, std::vector<URI>* fragment_uris, bool* found);
+
   /** Increment the count of in-progress queries. */
   void increment_in_progress();
 
@@ -887,9 +1006,28 @@ class StorageManager {
       const EncryptionKey& encryption_key,
       bool* in_cache);
 
+  /**
+   * Loads the consolidated fragment metadata file of an array, if it
+   * exists, and indexes its entries by fragment name.
+   *
+   * @param array_uri The array URI.
+   * @param encryption_key The encryption key to use.
+   * @param buff Set to the buffer holding the file contents.
+   * @param offsets Map from fragment name to the offset in `buff` of the
+   *     entry of the fragment, right after its name. Left empty if the file
+   *     does not exist.
+   * @return Status
+   */
+  Status load_consolidated_fragment_metadata(
+      const URI& array_uri,
+      const EncryptionKey& encryption_key,
+      std::unique_ptr<Buffer>* buff,
+      std::unordered_map<std::string, uint64_t>* offsets);
+
   /**
    * Retrieves the fragment metadata of an open array that are not already
-   * loaded.
+   * loaded. If more than one fragment must be loaded, their metadata are
+   * read from the consolidated fragment metadata file when it covers them.
    *
    * @param open_array The open array object.
    * @param encryption_key The encryption key to use.
@@ -915,6 +1053,20 @@ class StorageManager {
       const std::vector<URI>& fragment_uris,
       std::vector<std::pair<uint64_t, URI>>* sorted_fragment_uris) const;
 
+  /**
+   * Appends records to the fragment manifest of an array, once the caller
+   * holds the locks of `store_fragment_manifest`.
+   *
+   * @param array_uri The array URI.
+   * @param added The URIs of the added fragments.
+   * @param removed The URIs of the removed fragments.
+   * @return Status
+   */
+  Status store_fragment_manifest_locked(
+      const URI& array_uri,
+      const std::vector<URI>& added,
+      const std::vector<URI>& removed);
+
   /** Block until there are zero in-progress queries. */
   void wait_for_zero_in_progress();
 };
@@ -31,6 +31,7 @@
  */
 
 #include "tiledb/sm/tile/tile.h"
+#include "tiledb/sm/buffer/buffer_pool.h"
 #include "tiledb/sm/misc/logger.h"
 
 #include <iostream>
@@ -228,7 +229,9 @@ void Tile::split_coordinates() {
   uint64_t ptr = 0, ptr_tmp = 0;
 
   // Create a tile clone
-  auto tile_tmp = (char*)std::malloc(tile_size);
+  auto& pool = BufferPool::buffer_pool();
+  uint64_t tile_tmp_capacity;
+  auto tile_tmp = (char*)pool.allocate(tile_size, &tile_tmp_capacity);
   std::memcpy(tile_tmp, tile_c, tile_size);
 
   // Split coordinates
@@ -242,7 +245,7 @@ void Tile::split_coordinates() {
   }
 
   // Clean up
-  std::free((void*)tile_tmp);
+  pool.deallocate(tile_tmp, tile_tmp_capacity);
 }
 
 bool Tile::stores_coords() const {
@@ -286,7 +289,9 @@ void Tile::zip_coordinates() {
   uint64_t ptr = 0, ptr_tmp = 0;
 
   // Create a tile clone
-  auto tile_tmp = (char*)std::malloc(tile_size);
+  auto& pool = BufferPool::buffer_pool();
+  uint64_t tile_tmp_capacity;
+  auto tile_tmp = (char*)pool.allocate(tile_size, &tile_tmp_capacity);
   std::memcpy(tile_tmp, tile_c, tile_size);
 
   // Zip coordinates
@@ -300,7 +305,7 @@ void Tile::zip_coordinates() {
   }
 
   // Clean up
-  std::free((void*)tile_tmp);
+  pool.deallocate(tile_tmp, tile_tmp_capacity);
 }
 
 Tile& Tile::operator=(const Tile& tile) {